@@ -64,11 +64,14 @@ install(FILES
               ${CMAKE_SOURCE_DIR}/core/utilities/imageeditor/widgets/previewtoolbar.h
 
               ${CMAKE_SOURCE_DIR}/core/libs/dimg/dimg.h
+              ${CMAKE_SOURCE_DIR}/core/libs/dimg/dimgbufferpool.h
+              ${CMAKE_SOURCE_DIR}/core/libs/dimg/dimgmatview.h
               ${CMAKE_SOURCE_DIR}/core/libs/dimg/color/dcolor.h
               ${CMAKE_SOURCE_DIR}/core/libs/dimg/color/dcolorpixelaccess.h
               ${CMAKE_SOURCE_DIR}/core/libs/dimg/color/dcolorcomposer.h
               ${CMAKE_SOURCE_DIR}/core/libs/dimg/color/dcolorblend.h
               ${CMAKE_SOURCE_DIR}/core/libs/dimg/loaders/dimgloader.h
+              ${CMAKE_SOURCE_DIR}/core/libs/dimg/loaders/dimgloaderdecimator.h
               ${CMAKE_SOURCE_DIR}/core/libs/dimg/loaders/dimgloaderobserver.h
               ${CMAKE_SOURCE_DIR}/core/libs/dimg/loaders/dimgloadersettings.h
               ${CMAKE_SOURCE_DIR}/core/libs/dimg/history/historyimageid.h
@@ -103,6 +106,7 @@ install(FILES
               ${CMAKE_SOURCE_DIR}/core/libs/widgets/graphicsview/dimgpreviewitem.h
               ${CMAKE_SOURCE_DIR}/core/libs/widgets/graphicsview/graphicsdimgview.h
               ${CMAKE_SOURCE_DIR}/core/libs/widgets/graphicsview/graphicsdimgitem.h
+              ${CMAKE_SOURCE_DIR}/core/libs/widgets/graphicsview/dimgtiledsource.h
               ${CMAKE_SOURCE_DIR}/core/libs/widgets/layout/dexpanderbox.h
               ${CMAKE_SOURCE_DIR}/core/libs/widgets/layout/statesavingobject.h
               ${CMAKE_SOURCE_DIR}/core/libs/widgets/text/modelcompleter.h
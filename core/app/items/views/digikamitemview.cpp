@@ -27,6 +27,7 @@
 #include <QMenu>
 #include <QIcon>
 #include <QUrl>
+#include <QScrollBar>
 
 // Local includes
 
@@ -88,6 +89,17 @@ DigikamItemView::DigikamItemView(QWidget* const parent)
     imageFilterModel()->setCategorizationMode(ItemSortSettings::CategoryByAlbum);
 
     imageAlbumModel()->setThumbnailLoadThread(ThumbnailLoadThread::defaultIconViewThread());
+    ThumbnailLoadThread::defaultIconViewThread()->addPriorityProvider(d);
+
+    d->priorityTimer = new QTimer(this);
+    d->priorityTimer->setSingleShot(true);
+    d->priorityTimer->setInterval(100);
+
+    connect(verticalScrollBar(), SIGNAL(valueChanged(int)),
+            d->priorityTimer, SLOT(start()));
+
+    connect(d->priorityTimer, SIGNAL(timeout()),
+            d, SLOT(slotUpdateThumbnailPriorities()));
 
     // Virtual method: use Dynamic binding.
 
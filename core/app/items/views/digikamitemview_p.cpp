@@ -28,6 +28,11 @@ DigikamItemView::Private::Private(DigikamItemView* const qq)
 {
 }
 
+DigikamItemView::Private::~Private()
+{
+    ThumbnailLoadThread::defaultIconViewThread()->removePriorityProvider(this);
+}
+
 void DigikamItemView::Private::updateOverlays()
 {
     Q_Q(DigikamItemView);
@@ -93,6 +98,66 @@ void DigikamItemView::Private::updateOverlays()
     }
 }
 
+int DigikamItemView::Private::distanceToViewport(const QString& filePath)
+{
+    Q_Q(DigikamItemView);
+
+    const QModelIndex index = q->imageFilterModel()->indexForPath(filePath);
+
+    if (!index.isValid() || (firstVisibleRow == -1))
+    {
+        return -1;
+    }
+
+    const int row = index.row();
+
+    if      (row < firstVisibleRow)
+    {
+        return (firstVisibleRow - row);
+    }
+    else if (row > lastVisibleRow)
+    {
+        return (row - lastVisibleRow);
+    }
+
+    return 0;
+}
+
+void DigikamItemView::Private::slotUpdateThumbnailPriorities()
+{
+    Q_Q(DigikamItemView);
+
+    firstVisibleRow = -1;
+    lastVisibleRow  = -1;
+
+    const QModelIndexList visible = q->categorizedIndexesIn(q->viewport()->rect());
+
+    Q_FOREACH (const QModelIndex& index, visible)
+    {
+        const int row = index.row();
+
+        if ((firstVisibleRow == -1) || (row < firstVisibleRow))
+        {
+            firstVisibleRow = row;
+        }
+
+        if (row > lastVisibleRow)
+        {
+            lastVisibleRow = row;
+        }
+    }
+
+    if (firstVisibleRow == -1)
+    {
+        return;
+    }
+
+    // Keep the thumbnails of about two screens around the viewport, the others are
+    // requested again by the delegate if they are scrolled back into view.
+
+    ThumbnailLoadThread::defaultIconViewThread()->updatePriorities(2 * visible.size());
+}
+
 } // namespace Digikam
 
 #include "moc_digikamitemview_p.cpp"
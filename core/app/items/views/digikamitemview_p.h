@@ -19,6 +19,7 @@
 // Qt includes
 
 #include <QObject>
+#include <QTimer>
 
 // Local includes
 
@@ -29,6 +30,7 @@
 #include "itemfullscreenoverlay.h"
 #include "applicationsettings.h"
 #include "facepipeline.h"
+#include "thumbnailloadthread.h"
 
 namespace Digikam
 {
@@ -36,7 +38,8 @@ namespace Digikam
 class DigikamItemDelegate;
 class ItemFaceDelegate;
 
-class Q_DECL_HIDDEN DigikamItemView::Private : public QObject
+class Q_DECL_HIDDEN DigikamItemView::Private : public QObject,
+                                                public ThumbnailPriorityProvider
 {
     Q_OBJECT
     Q_DECLARE_PUBLIC(DigikamItemView)
@@ -44,11 +47,23 @@ class Q_DECL_HIDDEN DigikamItemView::Private : public QObject
 public:
 
     explicit Private(DigikamItemView* const qq);
-    ~Private() override = default;
+    ~Private() override;
 
     void updateOverlays();
     void triggerRotateAction(const char* actionName);
 
+    /**
+     * Distance in rows to the visible items, for the thumbnail loading workers.
+     */
+    int distanceToViewport(const QString& filePath) override;
+
+public Q_SLOTS:
+
+    /**
+     * Give the priority to the visible thumbnails, after the view was scrolled.
+     */
+    void slotUpdateThumbnailPriorities();
+
 public:
 
     ItemViewUtilities*       utilities          = nullptr;
@@ -67,6 +82,10 @@ public:
 
     bool                     faceMode           = false;
 
+    QTimer*                  priorityTimer      = nullptr;
+    int                      firstVisibleRow    = -1;
+    int                      lastVisibleRow     = -1;
+
 private:
 
     DigikamItemView*         q_ptr              = nullptr;
@@ -70,6 +70,13 @@ private:
     bool readHEICImageByHandle(struct heif_image_handle* image_handle,
                                struct heif_image* heif_image, bool loadImageData);
 
+    /**
+     * Return the smallest thumbnail of image_handle with a side of at least minSize,
+     * or nullptr if there is none. The caller releases the returned handle.
+     */
+    struct heif_image_handle* findHEICThumbnail(struct heif_image_handle* const image_handle,
+                                                int minSize);
+
     /// Save operations
 
     bool saveHEICColorProfile(struct heif_image* const image);
@@ -21,7 +21,9 @@
 // Qt includes
 
 #include <QFile>
+#include <QVector>
 #include <QVariant>
+#include <QScopedPointer>
 #include <QByteArray>
 #include <QTextStream>
 #include <qplatformdefs.h>
@@ -32,6 +34,7 @@
 #include "digikam_config.h"
 #include "dimg.h"
 #include "dimgloaderobserver.h"
+#include "dimgloaderdecimator.h"
 #include "metaengine.h"
 
 namespace Digikam
@@ -282,6 +285,34 @@ bool DImgHEIFLoader::readHEICImageByID(struct heif_context* const heif_context,
         m_observer->progressInfo(0.2F);
     }
 
+    // Scaled loading: the smallest thumbnail large enough is decoded instead of the main image.
+    // The other top level images of the file are not used, they can be different pictures.
+
+    const int scaledLoadingSize = imageGetAttribute(QLatin1String("scaledLoadingSize")).toInt();
+
+    if ((m_loadFlags & LoadImageData) && !(m_loadFlags & LoadPreview) && (scaledLoadingSize > 0))
+    {
+        struct heif_image_handle* const thumbnail_handle = findHEICThumbnail(image_handle, scaledLoadingSize);
+
+        if (thumbnail_handle)
+        {
+            QSize originalSize(heif_image_handle_get_width(image_handle),
+                               heif_image_handle_get_height(image_handle));
+
+            heif_image_handle_release(image_handle);
+
+            qCDebug(DIGIKAM_DIMG_LOG_HEIF) << "HEIF scaled loading from thumbnail chunk";
+
+            bool ret = readHEICImageByHandle(thumbnail_handle, heif_image, true);
+
+            // Restore original size.
+
+            imageSetAttribute(QLatin1String("originalSize"), originalSize);
+
+            return ret;
+        }
+    }
+
     if (m_loadFlags & LoadPreview)
     {
         heif_item_id thumbnail_ID = 0;
@@ -329,6 +360,54 @@ bool DImgHEIFLoader::readHEICImageByID(struct heif_context* const heif_context,
     return readHEICImageByHandle(image_handle, heif_image, (m_loadFlags & LoadImageData));
 }
 
+struct heif_image_handle* DImgHEIFLoader::findHEICThumbnail(struct heif_image_handle* const image_handle,
+                                                            int minSize)
+{
+    const int nThumbnails = heif_image_handle_get_number_of_thumbnails(image_handle);
+
+    if (nThumbnails <= 0)
+    {
+        return nullptr;
+    }
+
+    QVector<heif_item_id> thumbnail_IDs(nThumbnails);
+    heif_image_handle_get_list_of_thumbnail_IDs(image_handle, thumbnail_IDs.data(), nThumbnails);
+
+    struct heif_image_handle* best = nullptr;
+    int bestSize                   = 0;
+
+    Q_FOREACH (heif_item_id thumbnail_ID, thumbnail_IDs)
+    {
+        struct heif_image_handle* thumbnail_handle = nullptr;
+        struct heif_error error                    = heif_image_handle_get_thumbnail(image_handle, thumbnail_ID, &thumbnail_handle);
+
+        if (error.code != heif_error_Ok)
+        {
+            continue;
+        }
+
+        const int size = qMax(heif_image_handle_get_width(thumbnail_handle),
+                              heif_image_handle_get_height(thumbnail_handle));
+
+        if ((size >= minSize) && (!best || (size < bestSize)))
+        {
+            if (best)
+            {
+                heif_image_handle_release(best);
+            }
+
+            best     = thumbnail_handle;
+            bestSize = size;
+        }
+        else
+        {
+            heif_image_handle_release(thumbnail_handle);
+        }
+    }
+
+    return best;
+}
+
 bool DImgHEIFLoader::readHEICImageByHandle(struct heif_image_handle* image_handle,
                                            struct heif_image* heif_image, bool loadImageData)
 {
@@ -444,6 +523,19 @@ bool DImgHEIFLoader::readHEICImageByHandle(struct heif_image_handle* image_handl
         return false;
     }
 
+    // Without a thumbnail large enough, a scaled loading reduces the rows while they are converted.
+
+    const QSize originalSize(imageWidth(), imageHeight());
+    const int   factor = loadImageData ? scaledLoadingFactor(imageWidth(), imageHeight()) : 1;
+    QScopedPointer<DImgLoaderDecimator> decimator;
+
+    if (factor > 1)
+    {
+        decimator.reset(new DImgLoaderDecimator(imageWidth(), imageHeight(), m_sixteenBit, factor));
+    }
+
+    const uint dataRows = decimator ? 1 : imageHeight();
+
     uchar* data    = nullptr;
     int colorModel = DImg::RGB;
     int colorMul   = (colorDepth > 8) ? (16 - colorDepth)
@@ -455,15 +547,16 @@ bool DImgHEIFLoader::readHEICImageByHandle(struct heif_image_handle* image_handl
     {
         if (m_sixteenBit)
         {
-            data = new_failureTolerant(imageWidth(), imageHeight(), 8); // 16 bits/color/pixel
+            data = new_failureTolerant(imageWidth(), dataRows, 8); // 16 bits/color/pixel
         }
         else
         {
-            data = new_failureTolerant(imageWidth(), imageHeight(), 4); // 8 bits/color/pixel
+            data = new_failureTolerant(imageWidth(), dataRows, 4); // 8 bits/color/pixel
         }
 
-        if (!data)
+        if (!data || (decimator && !decimator->isValid()))
         {
+            delete [] data;
             qCWarning(DIGIKAM_DIMG_LOG_HEIF) << "Cannot allocate memory!";
             loadingFailed();
             heif_image_release(heif_image);
@@ -488,6 +581,12 @@ bool DImgHEIFLoader::readHEICImageByHandle(struct heif_image_handle* image_handl
             src   = reinterpret_cast<unsigned char*>(ptr + (y * stride));
             src16 = reinterpret_cast<unsigned short*>(src);
 
+            if (decimator)
+            {
+                dst   = data;
+                dst16 = reinterpret_cast<unsigned short*>(data);
+            }
+
             for (unsigned int x = 0 ; x < imageWidth() ; ++x)
             {
                 if (!m_sixteenBit)   // 8 bits image.
@@ -550,12 +649,22 @@ bool DImgHEIFLoader::readHEICImageByHandle(struct heif_image_handle* image_handl
                 }
             }
 
+            if (decimator)
+            {
+                decimator->addRows(data, 1);
+            }
+
             if (m_observer && y >= checkPoint)
             {
                 checkPoint += granularity(m_observer, y, 0.8F);
 
                 if (!m_observer->continueQuery())
                 {
+                    if (decimator)
+                    {
+                        delete [] data;
+                    }
+
                     loadingFailed();
                     heif_image_release(heif_image);
                     heif_image_handle_release(image_handle);
@@ -566,13 +675,22 @@ bool DImgHEIFLoader::readHEICImageByHandle(struct heif_image_handle* image_handl
                 m_observer->progressInfo(0.4F + (0.8F * (((float)y) / ((float)imageHeight()))));
             }
         }
+
+        if (decimator)
+        {
+            delete [] data;
+
+            imageWidth()  = decimator->width();
+            imageHeight() = decimator->height();
+            data          = decimator->takeData();
+        }
     }
 
     imageData() = data;
     imageSetAttribute(QLatin1String("format"),             QLatin1String("HEIF"));
     imageSetAttribute(QLatin1String("originalColorModel"), colorModel);
     imageSetAttribute(QLatin1String("originalBitDepth"),   m_sixteenBit ? 16 : 8);
-    imageSetAttribute(QLatin1String("originalSize"),       QSize(imageWidth(), imageHeight()));
+    imageSetAttribute(QLatin1String("originalSize"),       originalSize);
 
     if (m_observer)
     {
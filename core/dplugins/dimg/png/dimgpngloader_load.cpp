@@ -43,6 +43,7 @@ extern "C"
 #include "digikam_config.h"
 #include "digikam_version.h"
 #include "dimgloaderobserver.h"
+#include "dimgloaderdecimator.h"
 
 // libPNG includes
 
@@ -76,6 +77,28 @@ typedef png_charp iCCP_data;
 
 #endif
 
+/**
+ * Swap the bytes of 16 bits/color/pixel data from libpng for DImg.
+ */
+static void swapBytes16(uchar* const data, quint64 pixels)
+{
+    uchar ptr[8];   // One pixel to swap
+
+    for (quint64 p = 0 ; p < pixels * 8 ; p += 8)
+    {
+        memcpy(&ptr[0], &data[p], 8);   // Current pixel
+
+        data[  p  ] = ptr[1]; // Blue
+        data[p + 1] = ptr[0];
+        data[p + 2] = ptr[3]; // Green
+        data[p + 3] = ptr[2];
+        data[p + 4] = ptr[5]; // Red
+        data[p + 5] = ptr[4];
+        data[p + 6] = ptr[7]; // Alpha
+        data[p + 7] = ptr[6];
+    }
+}
+
 bool DImgPNGLoader::load(const QString& filePath, DImgLoaderObserver* const observer)
 {
     png_uint_32  w32, h32;
@@ -181,6 +204,8 @@ bool DImgPNGLoader::load(const QString& filePath, DImgLoaderObserver* const obse
         ~CleanupData()
         {
             delete [] data;
+            delete [] buffer;
+            delete decimator;
             freeLines();
 
             if (file)
@@ -194,6 +219,16 @@ bool DImgPNGLoader::load(const QString& filePath, DImgLoaderObserver* const obse
             data = d;
         }
 
+        void setBuffer(uchar* const b)
+        {
+            buffer = b;
+        }
+
+        void setDecimator(DImgLoaderDecimator* const dec)
+        {
+            decimator = dec;
+        }
+
         void setLines(uchar** const l)
         {
             lines = l;
@@ -235,6 +270,11 @@ bool DImgPNGLoader::load(const QString& filePath, DImgLoaderObserver* const obse
         uchar** lines   = { nullptr };
         FILE*   file    = nullptr;
 
+        /// With a scaled loading, the decoded rows before their reduction.
+
+        uchar*               buffer    = nullptr;
+        DImgLoaderDecimator* decimator = nullptr;
+
         QSize  size;
         int    cmod     = 0;
     };
@@ -331,6 +371,8 @@ bool DImgPNGLoader::load(const QString& filePath, DImgLoaderObserver* const obse
     width  = (int)w32;
     height = (int)h32;
 
+    const QSize originalSize(width, height);
+
     int colorModel = DImg::COLORMODELUNKNOWN;
     m_sixteenBit   = (bit_depth == 16);
 
@@ -380,7 +422,8 @@ bool DImgPNGLoader::load(const QString& filePath, DImgLoaderObserver* const obse
     cleanupData->setColorModel(colorModel);
     cleanupData->setSize(QSize(width, height));
 
-    uchar* data  = nullptr;
+    uchar* data          = nullptr;
+    bool   allPassesRead = true;
 
     if (m_loadFlags & LoadImageData)
     {
@@ -543,30 +586,71 @@ bool DImgPNGLoader::load(const QString& filePath, DImgLoaderObserver* const obse
         // -------------------------------------------------------------------
         // Get image data.
 
+        // Scaled loading of thumbnails and previews. The first pass of an Adam7 interlaced
+        // image is the image reduced by 8, decoded alone when it is large enough.
+        // Else the rows are reduced while they are decoded: a non-interlaced image
+        // is decoded one row at a time, an interlaced image needs all rows for the passes.
+        // A decoding error is fatal with a scaled loading, the reduced rows are not complete.
+
+        const int  factor        = scaledLoadingFactor(width, height);
+        const bool firstPassOnly = (factor >= 8) && (interlace_type == PNG_INTERLACE_ADAM7);
+        int decodedWidth         = width;
+        int decodedHeight        = height;
+
         // Call before png_read_update_info and png_start_read_image()
         // for non-interlaced images number_passes will be 1
 
-        int number_passes = png_set_interlace_handling(png_ptr);
+        int number_passes        = 1;
+
+        if (firstPassOnly)
+        {
+            decodedWidth  = (width  + 7) / 8;
+            decodedHeight = (height + 7) / 8;
+            allPassesRead = false;
+        }
+        else
+        {
+            number_passes = png_set_interlace_handling(png_ptr);
+        }
 
         png_read_update_info(png_ptr, info_ptr);
 
+        DImgLoaderDecimator* decimator = nullptr;
+
+        if (factor > 1)
+        {
+            decimator = new DImgLoaderDecimator(decodedWidth, decodedHeight, m_sixteenBit,
+                                                firstPassOnly ? (factor / 8) : factor);
+            cleanupData->setDecimator(decimator);
+        }
+
+        const bool rowByRow = decimator && (number_passes == 1);
+        const int  dataRows = rowByRow ? 1 : height;
+
         if (m_sixteenBit)
         {
-            data = new_failureTolerant(width, height, 8); // 16 bits/color/pixel
+            data = new_failureTolerant(width, dataRows, 8); // 16 bits/color/pixel
         }
         else
         {
-            data = new_failureTolerant(width, height, 4); // 8 bits/color/pixel
+            data = new_failureTolerant(width, dataRows, 4); // 8 bits/color/pixel
         }
 
-        cleanupData->setData(data);
+        if (decimator)
+        {
+            cleanupData->setBuffer(data);
+        }
+        else
+        {
+            cleanupData->setData(data);
+        }
 
         uchar** lines = nullptr;
         (void)lines;    // to prevent cppcheck warnings.
         lines         = (uchar**)malloc(height * sizeof(uchar*));
         cleanupData->setLines(lines);
 
-        if (!data || !lines)
+        if (!data || !lines || (decimator && !decimator->isValid()))
         {
             qCDebug(DIGIKAM_DIMG_LOG_PNG) << "Cannot allocate memory to load PNG image data.";
             png_read_end(png_ptr, info_ptr);
@@ -579,16 +663,20 @@ bool DImgPNGLoader::load(const QString& filePath, DImgLoaderObserver* const obse
 
         for (int i = 0 ; i < height ; ++i)
         {
+            const quint64 row = rowByRow ? 0 : i;
+
             if (m_sixteenBit)
             {
-                lines[i] = data + ((quint64)i * (quint64)width * 8);
+                lines[i] = data + (row * (quint64)width * 8);
             }
             else
             {
-                lines[i] = data + ((quint64)i * (quint64)width * 4);
+                lines[i] = data + (row * (quint64)width * 4);
             }
         }
 
+        const bool swapBytes = m_sixteenBit && (QSysInfo::ByteOrder == QSysInfo::LittleEndian);
+
         // The easy way to read the whole image
         // png_read_image(png_ptr, lines);
         // The other way to read images is row by row. Necessary for observer.
@@ -598,11 +686,11 @@ bool DImgPNGLoader::load(const QString& filePath, DImgLoaderObserver* const obse
         {
             int checkPoint = 0;
 
-            for (int y = 0 ; y < height ; ++y)
+            for (int y = 0 ; y < decodedHeight ; ++y)
             {
                 if (observer && (y == checkPoint))
                 {
-                    checkPoint += granularity(observer, height, 0.7F);
+                    checkPoint += granularity(observer, decodedHeight, 0.7F);
 
                     if (!observer->continueQuery())
                     {
@@ -615,38 +703,47 @@ bool DImgPNGLoader::load(const QString& filePath, DImgLoaderObserver* const obse
 
                     // use 10% - 80% for progress while reading rows
 
-                    observer->progressInfo(0.1F + (0.7F * (((float)y) / ((float)height))));
+                    observer->progressInfo(0.1F + (0.7F * (((float)y) / ((float)decodedHeight))));
                 }
 
                 png_read_rows(png_ptr, lines + y, nullptr, 1);
+
+                if (rowByRow)
+                {
+                    if (swapBytes)
+                    {
+                        swapBytes16(data, decodedWidth);
+                    }
+
+                    decimator->addRows(data, 1);
+                }
             }
         }
 
         cleanupData->freeLines();
 
-        if (QSysInfo::ByteOrder == QSysInfo::LittleEndian)
+        if (!rowByRow)
         {
             // Swap bytes in 16 bits/color/pixel for DImg
 
-            if (m_sixteenBit)
+            if (swapBytes)
             {
-                uchar ptr[8];   // One pixel to swap
+                swapBytes16(data, (quint64)width * height);
+            }
 
-                for (uint p = 0 ; p < (uint)width * height * 8 ; p += 8)
-                {
-                    memcpy(&ptr[0], &data[p], 8);   // Current pixel
-
-                    data[  p  ] = ptr[1]; // Blue
-                    data[p + 1] = ptr[0];
-                    data[p + 2] = ptr[3]; // Green
-                    data[p + 3] = ptr[2];
-                    data[p + 4] = ptr[5]; // Red
-                    data[p + 5] = ptr[4];
-                    data[p + 6] = ptr[7]; // Alpha
-                    data[p + 7] = ptr[6];
-                }
+            if (decimator)
+            {
+                decimator->addRows(data, height);
             }
         }
+
+        if (decimator)
+        {
+            width  = decimator->width();
+            height = decimator->height();
+            data   = decimator->takeData();
+            cleanupData->setData(data);
+        }
     }
 
     if (observer)
@@ -725,7 +822,9 @@ bool DImgPNGLoader::load(const QString& filePath, DImgLoaderObserver* const obse
 
     // -------------------------------------------------------------------
 
-    if (m_loadFlags & LoadImageData)
+    // The other passes of an interlaced image are not read with a scaled loading.
+
+    if ((m_loadFlags & LoadImageData) && allPassesRead)
     {
         png_read_end(png_ptr, info_ptr);
     }
@@ -745,7 +844,7 @@ bool DImgPNGLoader::load(const QString& filePath, DImgLoaderObserver* const obse
     imageSetAttribute(QLatin1String("format"),             QLatin1String("PNG"));
     imageSetAttribute(QLatin1String("originalColorModel"), colorModel);
     imageSetAttribute(QLatin1String("originalBitDepth"),   bit_depth);
-    imageSetAttribute(QLatin1String("originalSize"),       QSize(width, height));
+    imageSetAttribute(QLatin1String("originalSize"),       originalSize);
 
     return true;
 }
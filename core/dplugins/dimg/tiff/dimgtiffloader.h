@@ -72,6 +72,27 @@ private:
     // cppcheck-suppress unusedPrivateFunction
     void tiffSetExifDataTag(TIFF* const tif, ttag_t tiffTag, const DMetadata& metaData, const char* const exifTagName);
 
+    /**
+     * Make current the smallest reduced resolution image of the file whose largest side
+     * is at least minSize, and which is stored like the main image. The SubIFDs of the main
+     * image and the next IFDs are checked. Return false if there is none, the main image
+     * stays current.
+     */
+    bool tiffSelectReducedImage(TIFF* const tif, uint minSize);
+
+    /**
+     * Decode only the region of the current image, in stored coordinates, reading the tiles
+     * or the strips which intersect it. Return the region data in the DImg pixel format,
+     * or nullptr if the image layout is not supported.
+     */
+    uchar* tiffReadRegion(TIFF* const tif, const QRect& region, DImgLoaderObserver* const observer);
+
+    /**
+     * Return the rows decoded at once: the rows per strip, or the height of the tiles of
+     * a tiled image, read by rows of tiles.
+     */
+    static uint32 tiffRowsPerBlock(TIFF* const tif, uint32 rowsPerStrip, uint32 h);
+
     static void dimg_tiff_warning(const char* module, const char* format, va_list warnings); // clazy:exclude=function-args-by-ref
     static void dimg_tiff_error(const char* module, const char* format, va_list errors);     // clazy:exclude=function-args-by-ref
 
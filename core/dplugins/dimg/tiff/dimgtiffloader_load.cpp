@@ -27,14 +27,17 @@ extern "C"
 // Qt includes
 
 #include <QFile>
+#include <QList>
 #include <QFloat16>
 #include <QByteArray>
+#include <QScopedPointer>
 
 // Local includes
 
 #include "digikam_debug.h"
 #include "digikam_config.h"
 #include "dimgloaderobserver.h"
+#include "dimgloaderdecimator.h"
 #include "dimgtiffloader.h"     //krazy:exclude=includes
 
 namespace DigikamTIFFDImgPlugin
@@ -102,6 +105,8 @@ bool DImgTIFFLoader::load(const QString& filePath, DImgLoaderObserver* const obs
     TIFFGetFieldDefaulted(tif, TIFFTAG_IMAGEWIDTH, &w);
     TIFFGetFieldDefaulted(tif, TIFFTAG_IMAGELENGTH, &h);
 
+    const QSize originalSize(w, h);
+
     TIFFGetFieldDefaulted(tif, TIFFTAG_BITSPERSAMPLE, &bits_per_sample);
     TIFFGetFieldDefaulted(tif, TIFFTAG_SAMPLESPERPIXEL, &samples_per_pixel);
     TIFFGetFieldDefaulted(tif, TIFFTAG_SAMPLEFORMAT, &sample_format);
@@ -122,6 +127,10 @@ bool DImgTIFFLoader::load(const QString& filePath, DImgLoaderObserver* const obs
         rows_per_strip = h;
     }
 
+    // The tiled images have no strip, they are read by rows of tiles.
+
+    rows_per_strip = tiffRowsPerBlock(tif, rows_per_strip, h);
+
     if (
         (bits_per_sample   == 0) ||
         (samples_per_pixel == 0) ||
@@ -270,10 +279,24 @@ bool DImgTIFFLoader::load(const QString& filePath, DImgLoaderObserver* const obs
         }
     }
 
+    // The blocks decoded at once by the region loading: the tiles, or the strips of full width.
+
+    if (TIFFIsTiled(tif))
+    {
+        uint32 tileWidth = 0;
+        TIFFGetField(tif, TIFFTAG_TILEWIDTH, &tileWidth);
+        imageSetAttribute(QLatin1String("regionLoadingBlock"), QSize(tileWidth, rows_per_strip));
+    }
+    else
+    {
+        imageSetAttribute(QLatin1String("regionLoadingBlock"), QSize(w, rows_per_strip));
+    }
+
     // -------------------------------------------------------------------
     // Get image data.
 
     QScopedArrayPointer<uchar> data;
+    QScopedPointer<DImgLoaderDecimator> decimator;
 
     if (m_loadFlags & LoadImageData)
     {
@@ -282,12 +305,90 @@ bool DImgTIFFLoader::load(const QString& filePath, DImgLoaderObserver* const obs
             observer->progressInfo(0.1F);
         }
 
+        // Region loading for the tiled display of large images: only the tiles or the strips
+        // intersecting the region are decoded.
+
+        const QRect region = imageGetAttribute(QLatin1String("loadingRegion")).toRect();
+
+        if (region.isValid())
+        {
+            const QRect area = region.intersected(QRect(0, 0, w, h));
+
+            if (!area.isEmpty())
+            {
+                data.reset(tiffReadRegion(tif, area, observer));
+            }
+
+            TIFFClose(tif);
+
+            if (!data)
+            {
+                loadingFailed();
+
+                return false;
+            }
+
+            imageWidth()  = area.width();
+            imageHeight() = area.height();
+            imageData()   = data.take();
+            imageSetAttribute(QLatin1String("format"),             QLatin1String("TIFF"));
+            imageSetAttribute(QLatin1String("originalColorModel"), colorModel);
+            imageSetAttribute(QLatin1String("originalBitDepth"),   bits_per_sample);
+            imageSetAttribute(QLatin1String("originalSize"),       originalSize);
+
+            return true;
+        }
+
+        // Scaled loading of thumbnails and previews: decode a reduced resolution image stored
+        // in the file if there is one large enough, else reduce the image while decoding the strips.
+
+        if (
+            (scaledLoadingFactor(w, h) > 1) &&
+            tiffSelectReducedImage(tif, imageGetAttribute(QLatin1String("scaledLoadingSize")).toUInt())
+           )
+        {
+            TIFFGetFieldDefaulted(tif, TIFFTAG_IMAGEWIDTH,   &w);
+            TIFFGetFieldDefaulted(tif, TIFFTAG_IMAGELENGTH,  &h);
+            TIFFGetFieldDefaulted(tif, TIFFTAG_ROWSPERSTRIP, &rows_per_strip);
+
+            rows_per_strip = tiffRowsPerBlock(tif, qBound((uint32)1, rows_per_strip, h), h);
+
+            qCDebug(DIGIKAM_DIMG_LOG_TIFF) << "Loading TIFF reduced resolution image" << w << "x" << h
+                                           << "instead of" << originalSize;
+        }
+
+        const int factor = scaledLoadingFactor(w, h);
+
+        // The strips of separated planes give the channels one after the other,
+        // the whole image is needed before reducing it.
+
+        const bool separatePlanes = (planar_config == PLANARCONFIG_SEPARATE) && (samples_per_pixel > 1);
+        const bool convertedByLib = (bits_per_sample != 16) && ((bits_per_sample != 32) || (sample_format != SAMPLEFORMAT_IEEEFP));
+
+        if ((factor > 1) && (convertedByLib || !separatePlanes))
+        {
+            decimator.reset(new DImgLoaderDecimator(w, h, !convertedByLib, factor));
+
+            if (!decimator->isValid())
+            {
+                qCWarning(DIGIKAM_DIMG_LOG_TIFF) << "Failed to allocate memory for TIFF image" << filePath;
+                TIFFClose(tif);
+                loadingFailed();
+
+                return false;
+            }
+        }
+
+        // With a reduction, data only holds the rows of one strip.
+
+        const uint32 data_rows = decimator ? rows_per_strip : h;
+
         strip_size    = TIFFStripSize(tif);
         num_of_strips = TIFFNumberOfStrips(tif);
 
         if (bits_per_sample == 16)          // 16 bits image.
         {
-            data.reset(new_failureTolerant(w, h, 8));
+            data.reset(new_failureTolerant(w, data_rows, 8));
             QScopedArrayPointer<uchar> strip(new_failureTolerant(strip_size));
 
             if (!data || strip.isNull())
@@ -588,12 +689,18 @@ bool DImgTIFFLoader::load(const QString& filePath, DImgLoaderObserver* const obs
 
                     offset += bytesRead / 2 * 8;
                 }
+
+                if (decimator)
+                {
+                    decimator->addRows(data.data(), offset / ((qint64)w * 8));
+                    offset = 0;
+                }
             }
         }
 
         else if ((bits_per_sample == 32) && (sample_format == SAMPLEFORMAT_IEEEFP))          // 32 bits float image.
         {
-            data.reset(new_failureTolerant(w, h, 8));
+            data.reset(new_failureTolerant(w, data_rows, 8));
             QScopedArrayPointer<uchar> strip(new_failureTolerant(strip_size));
 
             if (!data || strip.isNull())
@@ -832,12 +939,18 @@ bool DImgTIFFLoader::load(const QString& filePath, DImgLoaderObserver* const obs
 
                     offset += bytesRead / 4 * 8;
                 }
+
+                if (decimator)
+                {
+                    decimator->addRows(data.data(), offset / ((qint64)w * 8));
+                    offset = 0;
+                }
             }
         }
 
         else       // Non 16 or 32 bits images ==> get it on BGRA 8 bits.
         {
-            data.reset(new_failureTolerant(w, h, 4));
+            data.reset(new_failureTolerant(w, data_rows, 4));
             QScopedArrayPointer<uchar> strip(new_failureTolerant(w, rows_per_strip, 4));
 
             if (!data || strip.isNull())
@@ -939,10 +1052,23 @@ bool DImgTIFFLoader::load(const QString& filePath, DImgLoaderObserver* const obs
                 }
 
                 offset += pixelsRead * 4;
+
+                if (decimator)
+                {
+                    decimator->addRows(data.data(), rows_to_read);
+                    offset = 0;
+                }
             }
 
             TIFFRGBAImageEnd(&img);
         }
+
+        if (decimator)
+        {
+            w = decimator->width();
+            h = decimator->height();
+            data.reset(decimator->takeData());
+        }
     }
 
     // -------------------------------------------------------------------
@@ -960,9 +1086,126 @@ bool DImgTIFFLoader::load(const QString& filePath, DImgLoaderObserver* const obs
     imageSetAttribute(QLatin1String("format"),             QLatin1String("TIFF"));
     imageSetAttribute(QLatin1String("originalColorModel"), colorModel);
     imageSetAttribute(QLatin1String("originalBitDepth"),   bits_per_sample);
-    imageSetAttribute(QLatin1String("originalSize"),       QSize(w, h));
+    imageSetAttribute(QLatin1String("originalSize"),       originalSize);
 
     return true;
 }
 
+uint32 DImgTIFFLoader::tiffRowsPerBlock(TIFF* const tif, uint32 rowsPerStrip, uint32 h)
+{
+    if (!TIFFIsTiled(tif))
+    {
+        return rowsPerStrip;
+    }
+
+    // ROWSPERSTRIP defaults to the whole image: the buffers of one strip would have the full size.
+
+    uint32 tileLength = 0;
+
+    if (TIFFGetField(tif, TIFFTAG_TILELENGTH, &tileLength) && (tileLength > 0))
+    {
+        return qMin(tileLength, h);
+    }
+
+    return rowsPerStrip;
+}
+
+bool DImgTIFFLoader::tiffSelectReducedImage(TIFF* const tif, uint minSize)
+{
+    const tdir_t mainDir = TIFFCurrentDirectory(tif);
+
+    // The layout of the main image, the reduced image is read with the same code path.
+
+    auto layout = [tif]()
+    {
+        uint16 bits_per_sample   = 0;
+        uint16 samples_per_pixel = 0;
+        uint16 sample_format     = 0;
+        uint16 photometric       = 0;
+        uint16 planar_config     = 0;
+        uint16 orientation       = 0;
+
+        TIFFGetFieldDefaulted(tif, TIFFTAG_BITSPERSAMPLE,   &bits_per_sample);
+        TIFFGetFieldDefaulted(tif, TIFFTAG_SAMPLESPERPIXEL, &samples_per_pixel);
+        TIFFGetFieldDefaulted(tif, TIFFTAG_SAMPLEFORMAT,    &sample_format);
+        TIFFGetFieldDefaulted(tif, TIFFTAG_PHOTOMETRIC,     &photometric);
+        TIFFGetFieldDefaulted(tif, TIFFTAG_PLANARCONFIG,    &planar_config);
+        TIFFGetFieldDefaulted(tif, TIFFTAG_ORIENTATION,     &orientation);
+
+        return (QList<int>() << bits_per_sample << samples_per_pixel << sample_format
+                             << photometric     << planar_config     << orientation
+                             << TIFFIsTiled(tif));
+    };
+
+    const QList<int> mainLayout = layout();
+
+    // Copy the SubIFD offsets, they are not valid anymore when the directory changes.
+
+    QList<toff_t> subIFDs;
+    uint16 count          = 0;
+    toff_t* offsets       = nullptr;
+
+    if (TIFFGetField(tif, TIFFTAG_SUBIFD, &count, &offsets) && offsets)
+    {
+        for (uint16 i = 0 ; i < count ; ++i)
+        {
+            subIFDs << offsets[i];
+        }
+    }
+
+    toff_t bestSubIFD     = 0;
+    tdir_t bestDir        = mainDir;
+    quint64 bestSize      = 0;
+
+    auto isCandidate      = [tif, &layout, &mainLayout, minSize](quint64& size)
+    {
+        uint32 subfile_type = 0;
+        uint32 width        = 0;
+        uint32 height       = 0;
+
+        TIFFGetFieldDefaulted(tif, TIFFTAG_SUBFILETYPE, &subfile_type);
+        TIFFGetFieldDefaulted(tif, TIFFTAG_IMAGEWIDTH,  &width);
+        TIFFGetFieldDefaulted(tif, TIFFTAG_IMAGELENGTH, &height);
+
+        size = qMax(width, height);
+
+        return ((subfile_type & FILETYPE_REDUCEDIMAGE) && (size >= minSize) && (layout() == mainLayout));
+    };
+
+    Q_FOREACH (toff_t offset, subIFDs)
+    {
+        quint64 size = 0;
+
+        if (TIFFSetSubDirectory(tif, offset) && isCandidate(size) && (!bestSize || (size < bestSize)))
+        {
+            bestSize   = size;
+            bestSubIFD = offset;
+        }
+    }
+
+    for (tdir_t dir = mainDir + 1 ; TIFFSetDirectory(tif, dir) ; ++dir)
+    {
+        quint64 size = 0;
+
+        if (isCandidate(size) && (!bestSize || (size < bestSize)))
+        {
+            bestSize   = size;
+            bestSubIFD = 0;
+            bestDir    = dir;
+        }
+    }
+
+    if (
+        (bestSubIFD         && TIFFSetSubDirectory(tif, bestSubIFD)) ||
+        ((bestDir != mainDir) && TIFFSetDirectory(tif, bestDir))
+       )
+    {
+        return true;
+    }
+
+    TIFFSetDirectory(tif, mainDir);
+
+    return false;
+}
+
 } // namespace DigikamTIFFDImgPlugin
@@ -0,0 +1,243 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-17
+ * Description : A TIFF IO file for DImg framework - region load operations
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+// Qt includes
+
+#include <QRect>
+#include <QFloat16>
+#include <QScopedPointer>
+
+// Local includes
+
+#include "digikam_debug.h"
+#include "dimgloaderobserver.h"
+#include "dimgtiffloader.h"     //krazy:exclude=includes
+
+namespace DigikamTIFFDImgPlugin
+{
+
+uchar* DImgTIFFLoader::tiffReadRegion(TIFF* const tif, const QRect& region, DImgLoaderObserver* const observer)
+{
+    uint32 w                 = 0;
+    uint32 h                 = 0;
+    uint16 bits_per_sample   = 0;
+    uint16 samples_per_pixel = 0;
+    uint16 sample_format     = 0;
+    uint16 photometric       = 0;
+    uint16 planar_config     = 0;
+    uint16 orientation       = 0;
+
+    TIFFGetFieldDefaulted(tif, TIFFTAG_IMAGEWIDTH,      &w);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_IMAGELENGTH,     &h);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_BITSPERSAMPLE,   &bits_per_sample);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_SAMPLESPERPIXEL, &samples_per_pixel);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_SAMPLEFORMAT,    &sample_format);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_PHOTOMETRIC,     &photometric);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_PLANARCONFIG,    &planar_config);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_ORIENTATION,     &orientation);
+
+    // The region is given in the stored image coordinates.
+
+    if (orientation != ORIENTATION_TOPLEFT)
+    {
+        qCDebug(DIGIKAM_DIMG_LOG_TIFF) << "TIFF region loading is not supported with orientation" << orientation;
+
+        return nullptr;
+    }
+
+    QScopedArrayPointer<uchar> data(new_failureTolerant(region.width(), region.height(), m_sixteenBit ? 8 : 4));
+
+    if (!data)
+    {
+        return nullptr;
+    }
+
+    if (bits_per_sample != 16)
+    {
+        // The 32 bits float images are normalized with the maximum of the whole image.
+
+        if (bits_per_sample == 32)
+        {
+            qCDebug(DIGIKAM_DIMG_LOG_TIFF) << "TIFF region loading is not supported with 32 bits samples";
+
+            return nullptr;
+        }
+
+        // libtiff reads only the tiles or the strips intersecting the region.
+
+        char emsg[1024] = "";
+        TIFFRGBAImage img;
+
+        if (!TIFFRGBAImageOK(tif, emsg) || !TIFFRGBAImageBegin(&img, tif, 0, emsg))
+        {
+            qCWarning(DIGIKAM_DIMG_LOG_TIFF) << "Failed to set up RGBA reading of image region:" << emsg;
+
+            return nullptr;
+        }
+
+        img.req_orientation = img.orientation;
+        img.row_offset      = region.y();
+        img.col_offset      = region.x();
+
+        uint32* const raster = reinterpret_cast<uint32*>(data.data());
+        const int ret        = TIFFRGBAImageGet(&img, raster, region.width(), region.height());
+
+        TIFFRGBAImageEnd(&img);
+
+        if (ret == -1)
+        {
+            qCWarning(DIGIKAM_DIMG_LOG_TIFF) << "Failed to read image region";
+
+            return nullptr;
+        }
+
+        // Reverse red and blue
+
+        uchar* p = data.data();
+
+        for (qint64 i = 0 ; i < (qint64)region.width() * region.height() ; ++i)
+        {
+            qSwap(p[0], p[2]);
+            p += 4;
+        }
+
+        return data.take();
+    }
+
+    if (
+        ((photometric   != PHOTOMETRIC_RGB) && (photometric != PHOTOMETRIC_MINISBLACK)) ||
+        ((samples_per_pixel != 1) && (samples_per_pixel != 3) && (samples_per_pixel != 4))
+       )
+    {
+        qCDebug(DIGIKAM_DIMG_LOG_TIFF) << "TIFF region loading is not supported with photometric" << photometric
+                                       << "and" << samples_per_pixel << "samples per pixel";
+
+        return nullptr;
+    }
+
+    // The blocks are the tiles, or the strips of full width.
+
+    const bool tiled         = TIFFIsTiled(tif);
+    const bool separate      = (planar_config == PLANARCONFIG_SEPARATE) && (samples_per_pixel > 1);
+    const int  planes        = separate ? samples_per_pixel : 1;
+    const int  blockSamples  = separate ? 1 : samples_per_pixel;
+    uint32     blockWidth    = w;
+    uint32     blockHeight   = 0;
+
+    if (tiled)
+    {
+        TIFFGetField(tif, TIFFTAG_TILEWIDTH,  &blockWidth);
+        TIFFGetField(tif, TIFFTAG_TILELENGTH, &blockHeight);
+    }
+    else
+    {
+        TIFFGetFieldDefaulted(tif, TIFFTAG_ROWSPERSTRIP, &blockHeight);
+        blockHeight = qMin(blockHeight, h);
+    }
+
+    if ((blockWidth == 0) || (blockHeight == 0))
+    {
+        return nullptr;
+    }
+
+    const tsize_t blockSize = tiled ? TIFFTileSize(tif) : TIFFStripSize(tif);
+    QScopedArrayPointer<uchar> block(new_failureTolerant(blockSize));
+
+    if (block.isNull())
+    {
+        return nullptr;
+    }
+
+    // Only the alpha channel of the images without one is not written below.
+
+    ushort* const dst16 = reinterpret_cast<ushort*>(data.data());
+
+    if (samples_per_pixel != 4)
+    {
+        for (qint64 i = 0 ; i < (qint64)region.width() * region.height() ; ++i)
+        {
+            dst16[i * 4 + 3] = 0xFFFF;
+        }
+    }
+
+    // DImg channel of each sample: Blue, Green, Red, Alpha order.
+
+    const int rgbaChannels[4] = { 2, 1, 0, 3 };
+    const bool halfFloat      = (sample_format == SAMPLEFORMAT_IEEEFP);
+
+    for (uint32 by = (region.top() / blockHeight) * blockHeight ; by <= (uint32)region.bottom() ; by += blockHeight)
+    {
+        if (observer && !observer->continueQuery())
+        {
+            return nullptr;
+        }
+
+        for (uint32 bx = (region.left() / blockWidth) * blockWidth ; bx <= (uint32)region.right() ; bx += blockWidth)
+        {
+            for (int plane = 0 ; plane < planes ; ++plane)
+            {
+                const uint32 index = tiled ? TIFFComputeTile(tif, bx, by, 0, plane)
+                                           : TIFFComputeStrip(tif, by, plane);
+
+                const tsize_t read = tiled ? TIFFReadEncodedTile(tif, index, block.data(), blockSize)
+                                           : TIFFReadEncodedStrip(tif, index, block.data(), blockSize);
+
+                if (read == -1)
+                {
+                    qCWarning(DIGIKAM_DIMG_LOG_TIFF) << "Failed to read image block" << index;
+
+                    return nullptr;
+                }
+
+                const QRect area      = QRect(bx, by, blockWidth, blockHeight).intersected(region);
+                const ushort* samples = reinterpret_cast<const ushort*>(block.data());
+
+                for (int y = area.top() ; y <= area.bottom() ; ++y)
+                {
+                    const ushort* src = samples + ((quint64)(y - by) * blockWidth + (area.left() - bx)) * blockSamples;
+                    ushort* dst       = dst16   + ((quint64)(y - region.top()) * region.width() + (area.left() - region.left())) * 4;
+
+                    for (int x = area.left() ; x <= area.right() ; ++x)
+                    {
+                        for (int s = 0 ; s < blockSamples ; ++s)
+                        {
+                            const ushort value = halfFloat ? (ushort)qBound(0.0F, (*reinterpret_cast<const qfloat16*>(src)) * 65535.0F, 65535.0F)
+                                                           : *src;
+                            ++src;
+
+                            if (samples_per_pixel == 1)
+                            {
+                                // Greyscale: RGB have to be set to the same value.
+
+                                dst[0] = value;
+                                dst[1] = value;
+                                dst[2] = value;
+                            }
+                            else
+                            {
+                                dst[rgbaChannels[separate ? plane : s]] = value;
+                            }
+                        }
+
+                        dst += 4;
+                    }
+                }
+            }
+        }
+    }
+
+    return data.take();
+}
+
+} // namespace DigikamTIFFDImgPlugin
@@ -21,6 +21,9 @@
 #include <QDateTime>
 #include <QFileInfo>
 #include <QDir>
+#include <QHash>
+#include <QSet>
+#include <QTimer>
 
 // Local includes
 
@@ -33,6 +36,8 @@
 #include "applicationsettings.h"
 #include "scancontroller.h"
 #include "dio.h"
+#include "albumwatchinotify.h"
+#include "albumwatchpoller.h"
 
 namespace Digikam
 {
@@ -47,13 +52,41 @@ public:
     bool             inDirWatchParametersBlackList(const QFileInfo& info, const QString& path);
     QList<QDateTime> buildDirectoryModList(const QFileInfo& dbFile) const;
 
-public:
+    void             addDirectory(const QString& dir);
+    void             invokePoller(const char* const method, const QString& dir);
+    void             removeDirectory(const QString& dir);
+    QStringList      directories() const;
 
-    QFileSystemWatcher* dirWatch = nullptr;
+public:
 
-    DbEngineParameters  params;
-    QStringList         fileNameBlackList;
-    QList<QDateTime>    dbPathModificationDateList;
+    /**
+     * Only one backend is used: inotify on Linux, QFileSystemWatcher elsewhere.
+     */
+    QFileSystemWatcher*       dirWatch              = nullptr;
+    AlbumWatchInotify*        inotify               = nullptr;
+
+    /**
+     * Directories which cannot be watched because the inotify watch limit is reached.
+     * Their modification date is polled instead in a thread, which detects created,
+     * removed and renamed files.
+     */
+    QSet<QString>             polledDirs;
+    AlbumWatchPoller*         poller                = nullptr;
+    QTimer*                   pollTimer             = nullptr;
+
+    /**
+     * Changes are collected for a short time, then sent to ScanController at once.
+     */
+    QSet<QString>             dirtyDirs;
+    QSet<QString>             dirtyFiles;
+    QTimer*                   coalesceTimer         = nullptr;
+
+    /// Above this number of changed files, their directory is scanned instead.
+    static const int          maxFileScansPerDirectory = 10;
+
+    DbEngineParameters        params;
+    QStringList               fileNameBlackList;
+    QList<QDateTime>          dbPathModificationDateList;
 };
 
 bool AlbumWatch::Private::inBlackList(const QString& path) const
@@ -140,23 +173,155 @@ QList<QDateTime> AlbumWatch::Private::buildDirectoryModList(const QFileInfo& dbF
     return modList;
 }
 
+void AlbumWatch::Private::addDirectory(const QString& dir)
+{
+    if (dirWatch)
+    {
+        dirWatch->addPath(dir);
+
+        return;
+    }
+
+    if (polledDirs.isEmpty())
+    {
+        switch (inotify->addDirectory(dir))
+        {
+            case AlbumWatchInotify::Added:
+            {
+                return;
+            }
+
+            case AlbumWatchInotify::WatchLimitReached:
+            {
+                qCWarning(DIGIKAM_GENERAL_LOG) << "Inotify watch limit reached after"
+                                               << inotify->directories().size()
+                                               << "folders (fs.inotify.max_user_watches ="
+                                               << AlbumWatchInotify::maxUserWatches()
+                                               << "). The other folders are polled.";
+                break;
+            }
+
+            case AlbumWatchInotify::Failed:
+            {
+                return;
+            }
+        }
+    }
+
+    // Once the limit is reached, do not try again for each new album.
+
+    polledDirs.insert(dir);
+    invokePoller("addDirectory", dir);
+
+    if (!pollTimer->isActive())
+    {
+        pollTimer->start();
+    }
+}
+
+void AlbumWatch::Private::removeDirectory(const QString& dir)
+{
+    if (dirWatch)
+    {
+        dirWatch->removePath(dir);
+
+        return;
+    }
+
+    inotify->removeDirectory(dir);
+
+    if (polledDirs.remove(dir))
+    {
+        invokePoller("removeDirectory", dir);
+
+        if (polledDirs.isEmpty())
+        {
+            pollTimer->stop();
+        }
+    }
+}
+
+void AlbumWatch::Private::invokePoller(const char* const method, const QString& dir)
+{
+    poller->schedule();
+
+    if (dir.isNull())
+    {
+        QMetaObject::invokeMethod(poller, method, Qt::QueuedConnection);
+    }
+    else
+    {
+        QMetaObject::invokeMethod(poller, method, Qt::QueuedConnection, Q_ARG(QString, dir));
+    }
+}
+
+QStringList AlbumWatch::Private::directories() const
+{
+    if (dirWatch)
+    {
+        return dirWatch->directories();
+    }
+
+    return (inotify->directories() + polledDirs.values());
+}
+
 // -------------------------------------------------------------------------------------
 
 AlbumWatch::AlbumWatch(AlbumManager* const parent)
     : QObject(parent),
       d      (new Private)
 {
-    d->dirWatch = new QFileSystemWatcher(this);
-
     if (ApplicationSettings::instance()->getAlbumMonitoring())
     {
-        qCDebug(DIGIKAM_GENERAL_LOG) << "AlbumWatch use QFileSystemWatcher";
+        d->inotify = new AlbumWatchInotify(this);
+
+        if (d->inotify->isValid())
+        {
+            qCDebug(DIGIKAM_GENERAL_LOG) << "AlbumWatch use inotify";
+
+            connect(d->inotify, SIGNAL(signalDirectoryChanged(QString)),
+                    this, SLOT(slotDirectoryDirty(QString)));
+
+            connect(d->inotify, SIGNAL(signalFileChanged(QString)),
+                    this, SLOT(slotFileDirty(QString)));
+
+            connect(d->inotify, SIGNAL(signalFileRemoved(QString)),
+                    this, SLOT(slotFileRemoved(QString)));
+
+            connect(d->inotify, SIGNAL(signalEventsLost()),
+                    this, SLOT(slotEventsLost()));
+
+            d->poller    = new AlbumWatchPoller;
+            d->pollTimer = new QTimer(this);
+            d->pollTimer->setInterval(30000);
+
+            d->poller->connectAndSchedule(d->pollTimer, SIGNAL(timeout()),
+                                          SLOT(poll()));
 
-        connect(d->dirWatch, SIGNAL(directoryChanged(QString)),
-                this, SLOT(slotQFSWatcherDirty(QString)));
+            connect(d->poller, SIGNAL(signalDirectoryChanged(QString)),
+                    this, SLOT(slotDirectoryDirty(QString)));
+        }
+        else
+        {
+            qCDebug(DIGIKAM_GENERAL_LOG) << "AlbumWatch use QFileSystemWatcher";
 
-        connect(d->dirWatch, SIGNAL(fileChanged(QString)),
-                this, SLOT(slotQFSWatcherDirty(QString)));
+            delete d->inotify;
+            d->inotify  = nullptr;
+            d->dirWatch = new QFileSystemWatcher(this);
+
+            connect(d->dirWatch, SIGNAL(directoryChanged(QString)),
+                    this, SLOT(slotQFSWatcherDirty(QString)));
+
+            connect(d->dirWatch, SIGNAL(fileChanged(QString)),
+                    this, SLOT(slotQFSWatcherDirty(QString)));
+        }
+
+        d->coalesceTimer = new QTimer(this);
+        d->coalesceTimer->setSingleShot(true);
+        d->coalesceTimer->setInterval(500);
+
+        connect(d->coalesceTimer, SIGNAL(timeout()),
+                this, SLOT(slotFlushDirty()));
 
         connect(parent, SIGNAL(signalAlbumAdded(Album*)),
                 this, SLOT(slotAlbumAdded(Album*)));
@@ -178,6 +343,7 @@ AlbumWatch::AlbumWatch(AlbumManager* const parent)
 
 AlbumWatch::~AlbumWatch()
 {
+    delete d->poller;
     delete d;
 }
 
@@ -187,20 +353,39 @@ void AlbumWatch::clear()
     {
         d->dirWatch->removePaths(d->dirWatch->directories());
     }
+
+    if (d->inotify)
+    {
+        d->inotify->clear();
+        d->pollTimer->stop();
+
+        if (!d->polledDirs.isEmpty())
+        {
+            d->polledDirs.clear();
+            d->invokePoller("clear", QString());
+        }
+    }
+
+    if (d->coalesceTimer)
+    {
+        d->coalesceTimer->stop();
+        d->dirtyDirs.clear();
+        d->dirtyFiles.clear();
+    }
 }
 
 void AlbumWatch::removeWatchedPAlbums(const PAlbum* const album)
 {
-    if (!album || d->dirWatch->directories().isEmpty())
+    if (!album || (!d->dirWatch && !d->inotify))
     {
         return;
     }
 
-    Q_FOREACH (const QString& dir, d->dirWatch->directories())
+    Q_FOREACH (const QString& dir, d->directories())
     {
         if (dir.startsWith(album->folderPath()))
         {
-            d->dirWatch->removePath(dir);
+            d->removeDirectory(dir);
         }
     }
 }
@@ -252,7 +437,7 @@ void AlbumWatch::slotAlbumAdded(Album* a)
         return;
     }
 
-    d->dirWatch->addPath(dir);
+    d->addDirectory(dir);
 }
 
 void AlbumWatch::slotAlbumAboutToBeDeleted(Album* a)
@@ -270,7 +455,7 @@ void AlbumWatch::slotAlbumAboutToBeDeleted(Album* a)
         return;
     }
 
-    d->dirWatch->removePath(dir);
+    d->removeDirectory(dir);
 }
 
 void AlbumWatch::rescanDirectory(const QString& dir)
@@ -301,11 +486,119 @@ void AlbumWatch::slotQFSWatcherDirty(const QString& path)
 
     if (info.isDir())
     {
-        rescanDirectory(path);
+        slotDirectoryDirty(path);
     }
     else
     {
-        rescanDirectory(info.path());
+        slotDirectoryDirty(info.path());
+    }
+}
+
+void AlbumWatch::slotDirectoryDirty(const QString& dir)
+{
+    d->dirtyDirs << dir;
+
+    if (!d->coalesceTimer->isActive())
+    {
+        d->coalesceTimer->start();
+    }
+}
+
+void AlbumWatch::slotFileDirty(const QString& filePath)
+{
+    if (d->inBlackList(filePath))
+    {
+        return;
+    }
+
+    d->dirtyFiles << filePath;
+
+    if (!d->coalesceTimer->isActive())
+    {
+        d->coalesceTimer->start();
+    }
+}
+
+void AlbumWatch::slotFileRemoved(const QString& filePath)
+{
+    // Filter out the journal files of the databases.
+
+    if (d->inBlackList(filePath))
+    {
+        return;
+    }
+
+    // A removed file is found by the scan of its directory.
+
+    slotDirectoryDirty(QFileInfo(filePath).path());
+}
+
+void AlbumWatch::slotEventsLost()
+{
+    // Scan the album roots. With the fast scan setting, only the folders
+    // with a changed modification date are read again.
+
+    Q_FOREACH (const CollectionLocation& location, CollectionManager::instance()->allAvailableLocations())
+    {
+        slotDirectoryDirty(location.albumRootPath());
+    }
+}
+
+void AlbumWatch::slotFlushDirty()
+{
+    QSet<QString>       dirs  = d->dirtyDirs;
+    const QSet<QString> files = d->dirtyFiles;
+    d->dirtyDirs.clear();
+    d->dirtyFiles.clear();
+
+    // Group the changed files by directory. The files written by digiKam itself,
+    // as the metadata of the items, are already scanned after the writing.
+
+    QHash<QString, QStringList> filesByDir;
+
+    Q_FOREACH (const QString& filePath, files)
+    {
+        if (!ScanController::instance()->isFileMetadataWrite(filePath))
+        {
+            filesByDir[QFileInfo(filePath).path()] << filePath;
+        }
+    }
+
+    // A burst of changes in a directory, as a copy of many files, is found by one scan of the directory.
+
+    for (auto it = filesByDir.constBegin() ; it != filesByDir.constEnd() ; ++it)
+    {
+        if (it.value().size() > Private::maxFileScansPerDirectory)
+        {
+            dirs << it.key();
+        }
+    }
+
+    Q_FOREACH (const QString& dir, dirs)
+    {
+        rescanDirectory(dir);
+    }
+
+    if (DIO::itemsUnderProcessing())
+    {
+        return;
+    }
+
+    for (auto it = filesByDir.constBegin() ; it != filesByDir.constEnd() ; ++it)
+    {
+        // A file in a directory to scan is scanned with it.
+
+        if (dirs.contains(it.key()))
+        {
+            continue;
+        }
+
+        Q_FOREACH (const QString& filePath, it.value())
+        {
+            qCDebug(DIGIKAM_GENERAL_LOG) << "Detected change, triggering scan of" << filePath;
+
+            ScanController::instance()->scheduleFileScanExternal(filePath);
+        }
     }
 }
 
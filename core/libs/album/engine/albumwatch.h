@@ -47,6 +47,11 @@ protected Q_SLOTS:
     void slotAlbumAdded(Album* album);
     void slotAlbumAboutToBeDeleted(Album* album);
     void slotQFSWatcherDirty(const QString& path);
+    void slotDirectoryDirty(const QString& dir);
+    void slotFileDirty(const QString& filePath);
+    void slotFileRemoved(const QString& filePath);
+    void slotEventsLost();
+    void slotFlushDirty();
 
 private:
 
@@ -0,0 +1,306 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-17
+ * Description : Linux inotify backend of the directory watch
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "albumwatchinotify.h"
+
+// C ANSI includes
+
+#ifdef Q_OS_LINUX
+#   include <sys/inotify.h>
+#   include <unistd.h>
+#   include <errno.h>
+#endif
+
+// Qt includes
+
+#include <QHash>
+#include <QFile>
+#include <QFileInfo>
+#include <QSocketNotifier>
+
+// Local includes
+
+#include "digikam_debug.h"
+
+namespace Digikam
+{
+
+class Q_DECL_HIDDEN AlbumWatchInotify::Private
+{
+public:
+
+    Private() = default;
+
+    void forget(int wd)
+    {
+        dirs.remove(wds.take(wd));
+    }
+
+public:
+
+    int                 fd          = -1;
+    QSocketNotifier*    notifier    = nullptr;
+
+    QHash<int, QString> wds;        ///< watch descriptor -> directory
+    QHash<QString, int> dirs;       ///< directory -> watch descriptor
+};
+
+AlbumWatchInotify::AlbumWatchInotify(QObject* const parent)
+    : QObject(parent),
+      d      (new Private)
+{
+
+#ifdef Q_OS_LINUX
+
+    d->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+    if (d->fd == -1)
+    {
+        qCWarning(DIGIKAM_GENERAL_LOG) << "Cannot create inotify instance, errno:" << errno;
+
+        return;
+    }
+
+    d->notifier = new QSocketNotifier(d->fd, QSocketNotifier::Read, this);
+
+#   if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+
+    connect(d->notifier, SIGNAL(activated(QSocketDescriptor,QSocketNotifier::Type)),
+            this, SLOT(slotReadEvents()));
+
+#   else
+
+    connect(d->notifier, SIGNAL(activated(int)),
+            this, SLOT(slotReadEvents()));
+
+#   endif
+
+#endif
+
+}
+
+AlbumWatchInotify::~AlbumWatchInotify()
+{
+
+#ifdef Q_OS_LINUX
+
+    if (d->fd != -1)
+    {
+        delete d->notifier;
+        close(d->fd);
+    }
+
+#endif
+
+    delete d;
+}
+
+bool AlbumWatchInotify::isValid() const
+{
+    return (d->fd != -1);
+}
+
+AlbumWatchInotify::AddResult AlbumWatchInotify::addDirectory(const QString& dir)
+{
+    if (d->dirs.contains(dir))
+    {
+        return Added;
+    }
+
+#ifdef Q_OS_LINUX
+
+    if (d->fd != -1)
+    {
+        // IN_CREATE is only needed for the sub-directories: a new file is reported
+        // when it is closed after writing, not while it is still empty.
+
+        const uint32_t mask = IN_CREATE      | IN_DELETE      |
+                              IN_MOVED_FROM  | IN_MOVED_TO    |
+                              IN_CLOSE_WRITE | IN_DELETE_SELF |
+                              IN_MOVE_SELF   | IN_ONLYDIR;
+
+        const int wd        = inotify_add_watch(d->fd, QFile::encodeName(dir).constData(), mask);
+
+        if (wd == -1)
+        {
+            return ((errno == ENOSPC) ? WatchLimitReached : Failed);
+        }
+
+        // Another path to the same directory shares the watch descriptor.
+
+        if (d->wds.contains(wd))
+        {
+            d->dirs.remove(d->wds.value(wd));
+        }
+
+        d->wds.insert(wd, dir);
+        d->dirs.insert(dir, wd);
+
+        return Added;
+    }
+
+#endif
+
+    return Failed;
+}
+
+void AlbumWatchInotify::removeDirectory(const QString& dir)
+{
+    const int wd = d->dirs.value(dir, -1);
+
+    if (wd == -1)
+    {
+        return;
+    }
+
+#ifdef Q_OS_LINUX
+
+    inotify_rm_watch(d->fd, wd);
+
+#endif
+
+    d->forget(wd);
+}
+
+void AlbumWatchInotify::clear()
+{
+
+#ifdef Q_OS_LINUX
+
+    for (auto it = d->wds.constBegin() ; it != d->wds.constEnd() ; ++it)
+    {
+        inotify_rm_watch(d->fd, it.key());
+    }
+
+#endif
+
+    d->wds.clear();
+    d->dirs.clear();
+}
+
+QStringList AlbumWatchInotify::directories() const
+{
+    return d->dirs.keys();
+}
+
+int AlbumWatchInotify::maxUserWatches()
+{
+    QFile file(QLatin1String("/proc/sys/fs/inotify/max_user_watches"));
+
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return -1;
+    }
+
+    bool ok   = false;
+    int value = QString::fromLatin1(file.readAll()).trimmed().toInt(&ok);
+
+    return (ok ? value : -1);
+}
+
+void AlbumWatchInotify::slotReadEvents()
+{
+
+#ifdef Q_OS_LINUX
+
+    // Buffer aligned for struct inotify_event, large enough for many events per read.
+
+    alignas(struct inotify_event) char buffer[64 * 1024];
+
+    Q_FOREVER
+    {
+        const ssize_t length = read(d->fd, buffer, sizeof(buffer));
+
+        if (length <= 0)
+        {
+            // EAGAIN: all pending events are read.
+
+            return;
+        }
+
+        for (ssize_t offset = 0 ; offset < length ; )
+        {
+            const struct inotify_event* const event = reinterpret_cast<const struct inotify_event*>(buffer + offset);
+            offset                                 += sizeof(struct inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW)
+            {
+                qCWarning(DIGIKAM_GENERAL_LOG) << "Inotify event queue overflow, events are lost";
+
+                Q_EMIT signalEventsLost();
+
+                continue;
+            }
+
+            if (event->mask & IN_IGNORED)
+            {
+                // The watch was removed, explicitly or because the directory was removed.
+
+                d->forget(event->wd);
+
+                continue;
+            }
+
+            const QString dir = d->wds.value(event->wd);
+
+            if (dir.isEmpty())
+            {
+                continue;
+            }
+
+            if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF))
+            {
+                // The album itself disappeared from its parent. A renamed album gets a new watch
+                // with its new path from AlbumManager, the old path is not valid anymore.
+
+                if (event->mask & IN_MOVE_SELF)
+                {
+                    inotify_rm_watch(d->fd, event->wd);
+                    d->forget(event->wd);
+                }
+
+                Q_EMIT signalDirectoryChanged(QFileInfo(dir).path());
+
+                continue;
+            }
+
+            if (event->len == 0)
+            {
+                continue;
+            }
+
+            const QString path = dir + QLatin1Char('/') + QFile::decodeName(event->name);
+
+            if      (event->mask & IN_ISDIR)
+            {
+                Q_EMIT signalDirectoryChanged(dir);
+            }
+            else if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+            {
+                Q_EMIT signalFileChanged(path);
+            }
+            else if (event->mask & (IN_DELETE | IN_MOVED_FROM))
+            {
+                Q_EMIT signalFileRemoved(path);
+            }
+        }
+    }
+
+#endif
+
+}
+
+} // namespace Digikam
+
+#include "moc_albumwatchinotify.cpp"
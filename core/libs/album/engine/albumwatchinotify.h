@@ -0,0 +1,106 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-17
+ * Description : Linux inotify backend of the directory watch
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#pragma once
+
+// Qt includes
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+namespace Digikam
+{
+
+/**
+ * Watch directories with one inotify instance, without recursion. Unlike QFileSystemWatcher,
+ * which only reports that a directory changed, the events tell which file was written,
+ * created, removed or renamed, so the collection scanner can be fed with the changed
+ * files only.
+ *
+ * inotify watches are limited per user (see /proc/sys/fs/inotify/max_user_watches).
+ * When the limit is reached, addDirectory() fails and the caller must watch the
+ * directory by other means.
+ *
+ * On other platforms than Linux, isValid() returns false.
+ */
+class AlbumWatchInotify : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    enum AddResult
+    {
+        Added = 0,
+        WatchLimitReached,          ///< The per user limit of inotify watches is reached.
+        Failed                      ///< The directory cannot be watched: removed, no permission...
+    };
+
+public:
+
+    explicit AlbumWatchInotify(QObject* const parent = nullptr);
+    ~AlbumWatchInotify() override;
+
+    /**
+     * Return true if the inotify instance was created.
+     */
+    bool isValid()                                      const;
+
+    AddResult addDirectory(const QString& dir);
+    void removeDirectory(const QString& dir);
+    void clear();
+
+    QStringList directories()                           const;
+
+    /**
+     * The per user limit of inotify watches, or -1 if it cannot be read.
+     */
+    static int maxUserWatches();
+
+Q_SIGNALS:
+
+    /**
+     * Sub-directories of the watched directory were created, removed or renamed,
+     * or the directory itself was removed or renamed.
+     */
+    void signalDirectoryChanged(const QString& dir);
+
+    /**
+     * A file in a watched directory was written and closed, or moved in.
+     */
+    void signalFileChanged(const QString& filePath);
+
+    /**
+     * A file in a watched directory was removed, or moved out.
+     */
+    void signalFileRemoved(const QString& filePath);
+
+    /**
+     * The kernel event queue overflowed, events were lost:
+     * all watched directories can have changed.
+     */
+    void signalEventsLost();
+
+private Q_SLOTS:
+
+    void slotReadEvents();
+
+private:
+
+    class Private;
+    Private* const d = nullptr;
+};
+
+} // namespace Digikam
@@ -0,0 +1,82 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-17
+ * Description : Polling of the directories which cannot be watched
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "albumwatchpoller.h"
+
+// Qt includes
+
+#include <QDateTime>
+#include <QFileInfo>
+#include <QHash>
+
+namespace Digikam
+{
+
+class Q_DECL_HIDDEN AlbumWatchPoller::Private
+{
+public:
+
+    Private() = default;
+
+public:
+
+    /// directory -> modification date seen by the previous poll
+    QHash<QString, QDateTime> dirs;
+};
+
+AlbumWatchPoller::AlbumWatchPoller()
+    : d(new Private)
+{
+}
+
+AlbumWatchPoller::~AlbumWatchPoller()
+{
+    shutDown();
+
+    delete d;
+}
+
+void AlbumWatchPoller::addDirectory(const QString& dir)
+{
+    d->dirs.insert(dir, QFileInfo(dir).lastModified());
+}
+
+void AlbumWatchPoller::removeDirectory(const QString& dir)
+{
+    d->dirs.remove(dir);
+}
+
+void AlbumWatchPoller::clear()
+{
+    d->dirs.clear();
+}
+
+void AlbumWatchPoller::poll()
+{
+    for (auto it = d->dirs.begin() ; it != d->dirs.end() ; ++it)
+    {
+        const QDateTime modified = QFileInfo(it.key()).lastModified();
+
+        if (modified != it.value())
+        {
+            it.value() = modified;
+
+            Q_EMIT signalDirectoryChanged(it.key());
+        }
+    }
+}
+
+} // namespace Digikam
+
+#include "moc_albumwatchpoller.cpp"
@@ -0,0 +1,67 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-17
+ * Description : Polling of the directories which cannot be watched
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#pragma once
+
+// Qt includes
+
+#include <QString>
+
+// Local includes
+
+#include "workerobject.h"
+
+namespace Digikam
+{
+
+/**
+ * Check in a thread the modification date of the directories which cannot be watched,
+ * to not block the user interface while stating a lot of folders, maybe on a network share.
+ * A created, removed or renamed file changes the date of its directory.
+ *
+ * All slots are called by queued connections: the list of directories is only
+ * accessed from the worker thread.
+ */
+class AlbumWatchPoller : public WorkerObject         // clazy:exclude=ctor-missing-parent-argument
+{
+    Q_OBJECT
+
+public:
+
+    AlbumWatchPoller();
+    ~AlbumWatchPoller() override;
+
+public Q_SLOTS:
+
+    void addDirectory(const QString& dir);
+    void removeDirectory(const QString& dir);
+    void clear();
+
+    /**
+     * Check all directories, and emit signalDirectoryChanged()
+     * for the ones modified since the previous poll.
+     */
+    void poll();
+
+Q_SIGNALS:
+
+    void signalDirectoryChanged(const QString& dir);
+
+private:
+
+    class Private;
+    Private* const d = nullptr;
+};
+
+} // namespace Digikam
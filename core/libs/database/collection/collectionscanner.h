@@ -36,6 +36,8 @@ class QFileInfo;
 namespace Digikam
 {
 
+class ItemScanner;
+
 class DIGIKAM_DATABASE_EXPORT CollectionScanner : public QObject
 {
     Q_OBJECT
@@ -213,6 +215,7 @@ protected:
 
     qlonglong scanFile(const QFileInfo& fi, int albumId, qlonglong id, FileScanMode mode);
     qlonglong scanNewFile(const QFileInfo& info, int albumId);
+    qlonglong scanNewFile(ItemScanner& scanner, const QFileInfo& info, int albumId);
     qlonglong scanNewFileFullScan(const QFileInfo& info, int albumId);
 
     //@}
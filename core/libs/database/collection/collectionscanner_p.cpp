@@ -214,6 +214,130 @@ void CollectionScannerHintContainerImplementation::clear()
 
 // --------------------------------------------------------------------
 
+class Q_DECL_HIDDEN CollectionScannerLoader::Task : public QRunnable
+{
+public:
+
+    Task(CollectionScannerLoader* const loader, Entry* const entry)
+        : m_loader(loader),
+          m_entry (entry)
+    {
+    }
+
+    void run() override
+    {
+        m_entry->scanner->loadFromDisk();
+        m_loader->setLoaded(m_entry);
+    }
+
+private:
+
+    CollectionScannerLoader* const m_loader = nullptr;
+    Entry*                   const m_entry  = nullptr;
+
+private:
+
+    Q_DISABLE_COPY(Task)
+};
+
+CollectionScannerLoader::CollectionScannerLoader()
+{
+    const int threads = qMax(1, QThread::idealThreadCount());
+
+    m_pool.setMaxThreadCount(threads);
+    m_maxQueued       = threads * 4;
+}
+
+CollectionScannerLoader::~CollectionScannerLoader()
+{
+    clear();
+}
+
+void CollectionScannerLoader::load(ItemScanner* const scanner, const QFileInfo& info)
+{
+    Entry* const entry = new Entry;
+    entry->scanner     = scanner;
+    entry->info        = info;
+
+    {
+        QMutexLocker lock(&m_mutex);
+        m_queue << entry;
+    }
+
+    m_pool.start(new Task(this, entry));
+}
+
+ItemScanner* CollectionScannerLoader::takeNext(QFileInfo* const info)
+{
+    QMutexLocker lock(&m_mutex);
+
+    if (m_queue.isEmpty())
+    {
+        return nullptr;
+    }
+
+    Entry* const entry = m_queue.first();
+
+    while (!entry->loaded)
+    {
+        m_condVar.wait(&m_mutex);
+    }
+
+    m_queue.removeFirst();
+
+    ItemScanner* const scanner = entry->scanner;
+    *info                      = entry->info;
+    delete entry;
+
+    return scanner;
+}
+
+bool CollectionScannerLoader::isEmpty() const
+{
+    QMutexLocker lock(&m_mutex);
+
+    return m_queue.isEmpty();
+}
+
+int CollectionScannerLoader::batchSize() const
+{
+    return qMax(1, m_maxQueued / 2);
+}
+
+bool CollectionScannerLoader::isFull() const
+{
+    QMutexLocker lock(&m_mutex);
+
+    return (m_queue.size() >= m_maxQueued);
+}
+
+void CollectionScannerLoader::clear()
+{
+    // Remove the tasks not yet started, and wait for the running ones.
+
+    m_pool.clear();
+    m_pool.waitForDone();
+
+    QMutexLocker lock(&m_mutex);
+
+    Q_FOREACH (Entry* const entry, m_queue)
+    {
+        delete entry->scanner;
+        delete entry;
+    }
+
+    m_queue.clear();
+}
+
+void CollectionScannerLoader::setLoaded(Entry* const entry)
+{
+    QMutexLocker lock(&m_mutex);
+    entry->loaded = true;
+    m_condVar.wakeAll();
+}
+
+// --------------------------------------------------------------------
+
 void CollectionScanner::Private::resetRemovedItemsTime()
 {
     removedItemsTime = QDateTime();
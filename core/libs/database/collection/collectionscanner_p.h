@@ -39,6 +39,9 @@
 #include <QSet>
 #include <QElapsedTimer>
 #include <QScopedPointer>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QThreadPool>
 
 // Local includes
 
@@ -61,6 +64,7 @@
 #include "tagscache.h"
 #include "thumbsdbaccess.h"
 #include "thumbsdb.h"
+#include "thumbnailloadthread.h"
 
 namespace Digikam
 {
@@ -126,6 +130,114 @@ public:
 
 // --------------------------------------------------------------------
 
+/**
+ * The parallel stage of the scan pipeline: new files found by the directory walk are
+ * read from disk (metadata, image properties and unique hash, see ItemScanner::loadFromDisk())
+ * by a pool of threads. The loaded scanners are given back in the order they were queued,
+ * the database write stays serialized in the scanning thread.
+ */
+class Q_DECL_HIDDEN CollectionScannerLoader
+{
+public:
+
+    CollectionScannerLoader();
+    ~CollectionScannerLoader();
+
+    /**
+     * Queue the scanner to be loaded. The loader takes the ownership until takeNext().
+     */
+    void load(ItemScanner* const scanner, const QFileInfo& info);
+
+    /**
+     * Wait for the oldest queued scanner to be loaded and return it with its file info.
+     * The caller takes the ownership. Return nullptr if the queue is empty.
+     */
+    ItemScanner* takeNext(QFileInfo* const info);
+
+    bool isEmpty()                                      const;
+
+    /**
+     * Number of loaded scanners to commit in one database transaction.
+     */
+    int  batchSize()                                    const;
+
+    /**
+     * Return true if enough scanners are queued to keep all threads busy.
+     * Scanners hold the file metadata in memory, the queue must not grow more.
+     */
+    bool isFull()                                       const;
+
+    /**
+     * Wait for the running loads and drop all queued scanners.
+     */
+    void clear();
+
+private:
+
+    class Task;
+
+    class Q_DECL_HIDDEN Entry
+    {
+    public:
+
+        ItemScanner* scanner = nullptr;
+        QFileInfo    info;
+        bool         loaded  = false;
+    };
+
+    void setLoaded(Entry* const entry);
+
+private:
+
+    QThreadPool                                   m_pool;
+    mutable QMutex                                m_mutex;
+    QWaitCondition                                m_condVar;
+    QList<Entry*>                                 m_queue;
+    int                                           m_maxQueued       = 0;
+
+private:
+
+    Q_DISABLE_COPY(CollectionScannerLoader)
+};
+
+// --------------------------------------------------------------------
+
+/**
+ * Read the unique hash version from the database once for a scan session,
+ * see ItemScanner::setSessionUniqueHashVersion(). Nested sessions keep the outer one.
+ */
+class Q_DECL_HIDDEN CollectionScannerHashSession
+{
+public:
+
+    CollectionScannerHashSession()
+        : m_owner(ItemScanner::sessionUniqueHashVersion() == -1)
+    {
+        if (m_owner)
+        {
+            ItemScanner::setSessionUniqueHashVersion(CoreDbAccess().db()->getUniqueHashVersion());
+        }
+    }
+
+    ~CollectionScannerHashSession()
+    {
+        if (m_owner)
+        {
+            ItemScanner::setSessionUniqueHashVersion(-1);
+        }
+    }
+
+private:
+
+    const bool m_owner = false;
+
+private:
+
+    Q_DISABLE_COPY(CollectionScannerHashSession)
+};
+
+// --------------------------------------------------------------------
+
 class Q_DECL_HIDDEN CollectionScanner::Private
 {
 
@@ -173,6 +285,8 @@ public:
     QList<qlonglong>                              newIdsList;
 
     CollectionScannerObserver*                    observer                  = nullptr;
+
+    QScopedPointer<CollectionScannerLoader>       loader;
 };
 
 } // namespace Digikam
@@ -713,6 +713,8 @@ void CollectionScanner::scanAlbum(const CollectionLocation& location, const QStr
         Q_EMIT startScanningAlbum(location.albumRootPath(), album);
     }
 
+    CollectionScannerHashSession hashSession;
+
     int albumID                          = checkAlbum(location, album);
     QDateTime albumDateTime              = asDateTimeUTC(QFileInfo(dir.path()).lastModified());
     QDateTime albumModified              = CoreDbAccess().db()->getAlbumModificationDate(albumID);
@@ -755,10 +757,97 @@ void CollectionScanner::scanAlbum(const CollectionLocation& location, const QStr
     QDate albumDateNew   = albumDateTime.date();
     const QString xmpExt(QLatin1String(".xmp"));
 
+    // Read the creation date of each new image to determine the oldest one
+
+    const auto checkItemDate = [&](qlonglong imageId)
+    {
+        if (imageId <= 0)
+        {
+            return;
+        }
+
+        ItemInfo itemInfo(imageId);
+        QDate itemDate    = itemInfo.dateTime().date();
+
+        if (itemDate.isValid())
+        {
+            if (
+                (settings.albumDateFrom == MetaEngineSettingsContainer::NewestItemDate) ||
+                (settings.albumDateFrom == MetaEngineSettingsContainer::AverageDate)
+               )
+            {
+                // Change album date only if the item date is newer.
+
+                if (itemDate > albumDateNew)
+                {
+                    albumDateNew    = itemDate;
+                    updateAlbumDate = true;
+                }
+            }
+
+            if (
+                (settings.albumDateFrom == MetaEngineSettingsContainer::OldestItemDate) ||
+                (settings.albumDateFrom == MetaEngineSettingsContainer::AverageDate)
+               )
+            {
+                // Change album date only if the item date is older.
+
+                if (itemDate < albumDateOld)
+                {
+                    albumDateOld    = itemDate;
+                    updateAlbumDate = true;
+                }
+            }
+        }
+    };
+
+    // Commit stage of the new files loaded in the thread pool, in the order of the directory listing.
+    // Each batch is written in one transaction. If all is false, only one batch is committed,
+    // to make room in the queue.
+
+    if (!d->loader)
+    {
+        d->loader.reset(new CollectionScannerLoader);
+    }
+
+    const auto commitLoadedFiles = [&](bool all)
+    {
+        while (!d->loader->isEmpty())
+        {
+            QList<ItemScanner*> scanners;
+            QList<QFileInfo>    infos;
+            QFileInfo           loadedInfo;
+            ItemScanner*        scanner = nullptr;
+
+            while ((scanners.size() < d->loader->batchSize()) && (scanner = d->loader->takeNext(&loadedInfo)))
+            {
+                scanners << scanner;
+                infos    << loadedInfo;
+            }
+
+            {
+                CoreDbOperationGroup group;
+
+                for (int i = 0 ; i < scanners.size() ; ++i)
+                {
+                    checkItemDate(scanNewFile(*scanners.at(i), infos.at(i), albumID));
+                    delete scanners.at(i);
+                }
+            }
+
+            if (!all)
+            {
+                break;
+            }
+        }
+    };
+
     Q_FOREACH (const QFileInfo& info, list)
     {
         if (!d->checkObserver())
         {
+            d->loader->clear();
+
             return; // return directly, do not go to cleanup code after loop!
         }
 
@@ -826,44 +915,17 @@ void CollectionScanner::scanAlbum(const CollectionLocation& location, const QStr
             }
             else
             {
-                // Read the creation date of each image to determine the oldest one
-
-                qlonglong imageId = scanNewFile(info, albumID);
-
-                if (imageId > 0)
+                if (!d->checkDeferred(info))
                 {
-                    ItemInfo itemInfo(imageId);
-                    QDate itemDate    = itemInfo.dateTime().date();
+                    // Read the file in the thread pool, the database is written by batches below.
 
-                    if (itemDate.isValid())
-                    {
-                        if (
-                            (settings.albumDateFrom == MetaEngineSettingsContainer::NewestItemDate) ||
-                            (settings.albumDateFrom == MetaEngineSettingsContainer::AverageDate)
-                           )
-                        {
-                            // Change album date only if the item date is newer.
-
-                            if (itemDate > albumDateNew)
-                            {
-                                albumDateNew    = itemDate;
-                                updateAlbumDate = true;
-                            }
-                        }
-
-                        if (
-                            (settings.albumDateFrom == MetaEngineSettingsContainer::OldestItemDate) ||
-                            (settings.albumDateFrom == MetaEngineSettingsContainer::AverageDate)
-                           )
-                        {
-                            // Change album date only if the item date is older.
+                    ItemScanner* const scanner = new ItemScanner(info);
+                    scanner->setCategory(category(info));
+                    d->loader->load(scanner, info);
 
-                            if (itemDate < albumDateOld)
-                            {
-                                albumDateOld    = itemDate;
-                                updateAlbumDate = true;
-                            }
-                        }
+                    if (d->loader->isFull())
+                    {
+                        commitLoadedFiles(false);
                     }
                 }
 
@@ -905,10 +967,16 @@ void CollectionScanner::scanAlbum(const CollectionLocation& location, const QStr
                 subAlbum += QLatin1Char('/');
             }
 
+            // The sub-albums share the loader, finish the files of this album first.
+
+            commitLoadedFiles(true);
+
             scanAlbum(location, subAlbum + info.fileName(), checkDate);
         }
     }
 
+    commitLoadedFiles(true);
+
     if (!d->deferredFileScanning && !s_modificationDateEquals(albumDateTime, albumModified))
     {
         CoreDbAccess().db()->setAlbumModificationDate(albumID, albumDateTime);
@@ -1084,6 +1152,11 @@ qlonglong CollectionScanner::scanNewFile(const QFileInfo& info, int albumId)
     ItemScanner scanner(info);
     scanner.setCategory(category(info));
 
+    return scanNewFile(scanner, info, albumId);
+}
+
+qlonglong CollectionScanner::scanNewFile(ItemScanner& scanner, const QFileInfo& info, int albumId)
+{
     // Check copy/move hints for single items
 
     qlonglong srcId = 0;
@@ -1174,6 +1247,10 @@ void CollectionScanner::scanFileUpdateHashReuseThumbnail(const QFileInfo& info,
 
     if (ThumbsDbAccess::isInitialized())
     {
+        // A pending thumbnail must be stored with the old hash before it is updated.
+
+        ThumbnailLoadThread::writePendingThumbnails();
+
         if (fileWasEdited)
         {
             // The file was edited in such a way that we know that the pixel content did not change, so we can reuse the thumbnail.
@@ -54,6 +54,7 @@ void AlbumsJob::run()
         ItemLister lister;
         lister.setRecursive(m_jobInfo.isRecursive());
         lister.setListOnlyAvailable(m_jobInfo.isListAvailableImagesOnly());
+        lister.setCursorMode(true);
 
         // Send data every 200 images to be more responsive
 
@@ -233,6 +234,7 @@ void TagsJob::run()
         ItemLister lister;
         lister.setRecursive(m_jobInfo.isRecursive());
         lister.setListOnlyAvailable(m_jobInfo.isListAvailableImagesOnly());
+        lister.setCursorMode(true);
 
         // Send data every 200 images to be more responsive
 
@@ -295,6 +297,7 @@ void SearchesJob::runSearches()
 
     ItemLister lister;
     lister.setListOnlyAvailable(m_jobInfo.isListAvailableImagesOnly());
+    lister.setCursorMode(true);
 
     // Send data every 200 images to be more responsive
 
@@ -14,6 +14,10 @@
 
 #include "dbjobsthread.h"
 
+// C++ includes
+
+#include <iterator>
+
 // Local includes
 
 #include "coredbaccess.h"
@@ -192,32 +196,40 @@ void SearchesDBJobsThread::searchesListing(const SearchesDBJobInfo& info)
     if (info.isDuplicatesJob())
     {
         m_results.clear();
+        m_resultsIndex.clear();
         m_haarIface.reset(new HaarIface(info.imageIds()));
         m_isAlbumUpdate    = info.isAlbumUpdate();
         m_processedImages  = 0;
+        m_lastProgress     = -1;
         m_totalImages2Scan = info.imageIds().count();
 
         const int threadsCount         = (m_totalImages2Scan < 200) ? 1 : qMax(1, maximumNumberOfThreads());
-        const int images2ScanPerThread = m_totalImages2Scan / threadsCount;
+
+        // Use more shards than threads: the time to process a shard depends on the number
+        // of duplicates found inside, and the thread pool balances small shards better.
+
+        const int shardsCount          = (threadsCount == 1) ? 1
+                                                             : qBound(threadsCount,
+                                                                      m_totalImages2Scan / 100,
+                                                                      threadsCount * 8);
+        const int images2ScanPerShard  = m_totalImages2Scan / shardsCount;
 
         QSet<qlonglong>::const_iterator begin = info.imageIds().constBegin();
         QSet<qlonglong>::const_iterator end   = info.imageIds().constBegin();
 
-        // Split job on multiple threads
+        // Split job on multiple shards
 
-        for (int i = 0; i < threadsCount; ++i)
+        for (int i = 0 ; i < shardsCount ; ++i)
         {
-            // The last thread should read until the end of the list.
+            // The last shard should read until the end of the list.
 
-            if (i == threadsCount - 1)
+            if (i == shardsCount - 1)
             {
                 end = info.imageIds().constEnd();
             }
             else
             {
-                // TODO: port to std::advance https://en.cppreference.com/w/cpp/iterator/advance
-
-                for (int j = 0; ((end != info.imageIds().constEnd()) && (j < images2ScanPerThread)) ; ++j, ++end);
+                std::advance(end, images2ScanPerShard);
             }
 
             SearchesJob* const job = new SearchesJob(info, begin, end, m_haarIface.data());
@@ -225,10 +237,12 @@ void SearchesDBJobsThread::searchesListing(const SearchesDBJobInfo& info)
             begin = end;
 
             connect(job, &SearchesJob::signalDuplicatesResults,
-                    this, &SearchesDBJobsThread::slotDuplicatesResults);
+                    this, &SearchesDBJobsThread::slotDuplicatesResults,
+                    Qt::QueuedConnection);
 
             connect(job, &SearchesJob::signalImageProcessed,
-                    this, &SearchesDBJobsThread::slotImageProcessed);
+                    this, &SearchesDBJobsThread::slotImageProcessed,
+                    Qt::QueuedConnection);
 
             collection.insert(job, 0);
         }
@@ -249,29 +263,38 @@ void SearchesDBJobsThread::searchesListing(const SearchesDBJobInfo& info)
 
 void SearchesDBJobsThread::slotImageProcessed()
 {
-    Q_EMIT signalProgress((++m_processedImages * 100) / m_totalImages2Scan);
+    const int progress = (int)(((qint64)++m_processedImages * 100) / m_totalImages2Scan);
+
+    // Do not flood the event loop with one signal per image.
+
+    if (progress != m_lastProgress)
+    {
+        m_lastProgress = progress;
+
+        Q_EMIT signalProgress(progress);
+    }
 }
 
 void SearchesDBJobsThread::slotDuplicatesResults(const HaarIface::DuplicatesResultsMap& incoming)
 {
-    auto searchResults = [&](qlonglong imageId) -> HaarIface::DuplicatesResultsMap::iterator
+    // NOTE: the shards emit their results through a queued connection,
+    //       so the union of the groups is always done in this object thread.
+
+    for (auto it = incoming.constBegin() ; it != incoming.constEnd() ; ++it)
     {
-        for (auto it = m_results.begin() ; it != m_results.end() ; ++it)
+        // A group is dropped if its reference image is already part of a group found by another shard.
+
+        if (m_resultsIndex.contains(it.key()))
         {
-            if ((imageId == it.key()) || (it->second.contains(imageId)))
-            {
-                return it;
-            }
+            continue;
         }
 
-        return m_results.end();
-    };
+        m_results.insert(it.key(), it.value());
+        m_resultsIndex.insert(it.key());
 
-    for (const auto& referenceImage : incoming.keys())
-    {
-        if (searchResults(referenceImage) == m_results.end())
+        for (const qlonglong& id : it.value().second)
         {
-            m_results.insert(referenceImage, incoming.value(referenceImage));
+            m_resultsIndex.insert(id);
         }
     }
 
@@ -172,9 +172,11 @@ Q_SIGNALS:
 
 private:
     HaarIface::DuplicatesResultsMap m_results;
+    QSet<qlonglong>                 m_resultsIndex;         ///< All image ids already part of a result group.
     QScopedPointer<HaarIface>       m_haarIface;
     bool                            m_isAlbumUpdate     = false;
     int                             m_processedImages   = 0;
+    int                             m_lastProgress      = -1;
     int                             m_totalImages2Scan  = 0;
 };
 
@@ -55,6 +55,13 @@ BdEngineBackendPrivate::ErrorLocker::ErrorLocker(BdEngineBackendPrivate* const d
 
 // -----------------------------------------------------------------------------------------
 
+DbEngineThreadData::DbEngineThreadData()
+{
+    // Most hot paths use a few dozens of different statements per thread.
+
+    preparedQueries.setMaxCost(64);
+}
+
 DbEngineThreadData::~DbEngineThreadData()
 {
     if (transactionCount)
@@ -68,6 +75,10 @@ DbEngineThreadData::~DbEngineThreadData()
 
 void DbEngineThreadData::closeDatabase()
 {
+    // Queries must be released before the connection is removed.
+
+    clearPreparedQueries();
+
     if (!connectionName.isNull())
     {
         {
@@ -92,6 +103,12 @@ void DbEngineThreadData::closeDatabase()
     lastError        = QSqlError();
 }
 
+void DbEngineThreadData::clearPreparedQueries()
+{
+    preparedQueries.clear();
+    ++preparedQueriesEpoch;
+}
+
 BdEngineBackendPrivate::BdEngineBackendPrivate(BdEngineBackend* const backend)
     : q(backend)
 {
@@ -400,6 +417,84 @@ void BdEngineBackendPrivate::transactionFinished()
     busyWaitCondVar.wakeOne();
 }
 
+DbEngineSqlQuery BdEngineBackendPrivate::takePreparedQuery(const QString& sql, int* const epoch)
+{
+    // Make sure the connection of this thread is up to date before looking in its cache.
+
+    databaseForThread();
+
+    DbEngineThreadData* const threadData = threadDataStorage.localData();
+    const int generation                 = preparedQueriesGeneration.loadAcquire();
+
+    if (threadData->preparedQueriesGeneration != generation)
+    {
+        threadData->clearPreparedQueries();
+        threadData->preparedQueriesGeneration = generation;
+    }
+
+    *epoch = threadData->preparedQueriesEpoch;
+
+    if (!isSchemaChange(sql))
+    {
+        DbEngineSqlQuery* const cached = threadData->preparedQueries.take(sql);
+
+        if (cached)
+        {
+            DbEngineSqlQuery query(*cached);
+            delete cached;
+            preparedQueriesHits.ref();
+
+            return query;
+        }
+    }
+
+    preparedQueriesMisses.ref();
+
+    return q->prepareQuery(sql);
+}
+
+void BdEngineBackendPrivate::recyclePreparedQuery(const QString& sql, DbEngineSqlQuery& query, int epoch)
+{
+    if (!threadDataStorage.hasLocalData() || isSchemaChange(sql))
+    {
+        return;
+    }
+
+    DbEngineThreadData* const threadData = threadDataStorage.localData();
+
+    // The connection was reset, or the schema changed, while the query was used.
+
+    if (
+        (threadData->preparedQueriesEpoch      != epoch)                                  ||
+        (threadData->preparedQueriesGeneration != preparedQueriesGeneration.loadAcquire()) ||
+        query.lastError().isValid()
+       )
+    {
+        return;
+    }
+
+    // Release the result set and the locks held by the statement, keep it prepared.
+
+    query.finish();
+    threadData->preparedQueries.insert(sql, new DbEngineSqlQuery(query));
+}
+
+bool BdEngineBackendPrivate::isSchemaChange(const QString& sql) const
+{
+    const QString statement = sql.trimmed();
+
+    return (
+            statement.startsWith(QLatin1String("CREATE "), Qt::CaseInsensitive) ||
+            statement.startsWith(QLatin1String("ALTER "),  Qt::CaseInsensitive) ||
+            statement.startsWith(QLatin1String("DROP "),   Qt::CaseInsensitive)
+           );
+}
+
+void BdEngineBackendPrivate::invalidatePreparedQueries()
+{
+    preparedQueriesGeneration.ref();
+}
+
 /**
  * Set the wait flag to queryStatus. Typically, call this with Wait.
  */
@@ -950,6 +1045,10 @@ void BdEngineBackend::close()
 {
     Q_D(BdEngineBackend);
 
+    qCDebug(DIGIKAM_DBENGINE_LOG) << "Prepared query cache of" << d->backendName << ":"
+                                  << d->preparedQueriesHits.loadRelaxed()   << "hits,"
+                                  << d->preparedQueriesMisses.loadRelaxed() << "misses";
+
     d->closeDatabaseForThread();
     d->status = Unavailable;
 }
@@ -1039,15 +1138,37 @@ BdEngineBackend::QueryState BdEngineBackend::handleQueryResult(DbEngineSqlQuery&
     return BdEngineBackend::QueryState(BdEngineBackend::NoErrors);
 }
 
+BdEngineBackend::QueryState BdEngineBackend::handlePreparedQueryResult(const QString& sql,
+                                                                       DbEngineSqlQuery& query,
+                                                                       int epoch,
+                                                                       QList<QVariant>* const values,
+                                                                       QVariant* const lastInsertId)
+{
+    Q_D(BdEngineBackend);
+
+    BdEngineBackend::QueryState state = handleQueryResult(query, values, lastInsertId);
+
+    if (state == BdEngineBackend::NoErrors)
+    {
+        d->recyclePreparedQuery(sql, query, epoch);
+    }
+
+    return state;
+}
+
 // -------------------------------------------------------------------------------------
 
 BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql,
                                                      QList<QVariant>* const values,
                                                      QVariant* const lastInsertId)
 {
-    DbEngineSqlQuery query = execQuery(sql);
+    Q_D(BdEngineBackend);
 
-    return handleQueryResult(query, values, lastInsertId);
+    int epoch              = 0;
+    DbEngineSqlQuery query = d->takePreparedQuery(sql, &epoch);
+    exec(query);
+
+    return handlePreparedQueryResult(sql, query, epoch, values, lastInsertId);
 }
 
 BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql,
@@ -1055,9 +1176,13 @@ BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql,
                                                      QList<QVariant>* const values,
                                                      QVariant* const lastInsertId)
 {
-    DbEngineSqlQuery query = execQuery(sql, boundValue1);
+    Q_D(BdEngineBackend);
 
-    return handleQueryResult(query, values, lastInsertId);
+    int epoch              = 0;
+    DbEngineSqlQuery query = d->takePreparedQuery(sql, &epoch);
+    execQuery(query, boundValue1);
+
+    return handlePreparedQueryResult(sql, query, epoch, values, lastInsertId);
 }
 
 BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql,
@@ -1066,9 +1191,13 @@ BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql,
                                                      QList<QVariant>* const values,
                                                      QVariant* const lastInsertId)
 {
-    DbEngineSqlQuery query = execQuery(sql, boundValue1, boundValue2);
+    Q_D(BdEngineBackend);
 
-    return handleQueryResult(query, values, lastInsertId);
+    int epoch              = 0;
+    DbEngineSqlQuery query = d->takePreparedQuery(sql, &epoch);
+    execQuery(query, boundValue1, boundValue2);
+
+    return handlePreparedQueryResult(sql, query, epoch, values, lastInsertId);
 }
 
 BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql,
@@ -1078,9 +1207,13 @@ BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql,
                                                      QList<QVariant>* const values,
                                                      QVariant* const lastInsertId)
 {
-    DbEngineSqlQuery query = execQuery(sql, boundValue1, boundValue2, boundValue3);
+    Q_D(BdEngineBackend);
 
-    return handleQueryResult(query, values, lastInsertId);
+    int epoch              = 0;
+    DbEngineSqlQuery query = d->takePreparedQuery(sql, &epoch);
+    execQuery(query, boundValue1, boundValue2, boundValue3);
+
+    return handlePreparedQueryResult(sql, query, epoch, values, lastInsertId);
 }
 
 BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql,
@@ -1091,9 +1224,13 @@ BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql,
                                                      QList<QVariant>* const values,
                                                      QVariant* const lastInsertId)
 {
-    DbEngineSqlQuery query = execQuery(sql, boundValue1, boundValue2, boundValue3, boundValue4);
+    Q_D(BdEngineBackend);
 
-    return handleQueryResult(query, values, lastInsertId);
+    int epoch              = 0;
+    DbEngineSqlQuery query = d->takePreparedQuery(sql, &epoch);
+    execQuery(query, boundValue1, boundValue2, boundValue3, boundValue4);
+
+    return handlePreparedQueryResult(sql, query, epoch, values, lastInsertId);
 }
 
 BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql,
@@ -1101,9 +1238,13 @@ BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql,
                                                      QList<QVariant>* const values,
                                                      QVariant* const lastInsertId)
 {
-    DbEngineSqlQuery query = execQuery(sql, boundValues);
+    Q_D(BdEngineBackend);
 
-    return handleQueryResult(query, values, lastInsertId);
+    int epoch              = 0;
+    DbEngineSqlQuery query = d->takePreparedQuery(sql, &epoch);
+    execQuery(query, boundValues);
+
+    return handlePreparedQueryResult(sql, query, epoch, values, lastInsertId);
 }
 
 BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql, const QMap<QString, QVariant>& bindingMap,
@@ -1619,6 +1760,11 @@ BdEngineBackend::QueryState BdEngineBackend::execDirectSql(const QString& sql)
     {
         if (query.exec(sql))
         {
+            if (d->isSchemaChange(sql))
+            {
+                d->invalidatePreparedQueries();
+            }
+
             break;
         }
         else
@@ -1655,6 +1801,11 @@ BdEngineBackend::QueryState BdEngineBackend::execDirectSqlWithResult(const QStri
     {
         if (query.exec(sql))
         {
+            if (d->isSchemaChange(sql))
+            {
+                d->invalidatePreparedQueries();
+            }
+
             handleQueryResult(query, values, lastInsertId);
             break;
         }
@@ -1697,6 +1848,11 @@ bool BdEngineBackend::exec(DbEngineSqlQuery& query)
 
         if (query.exec())   // krazy:exclude=crashy
         {
+            if (d->isSchemaChange(query.lastQuery()))
+            {
+                d->invalidatePreparedQueries();
+            }
+
             break;
         }
         else
@@ -1984,6 +2140,20 @@ int BdEngineBackend::maximumBoundValues() const
     }
 }
 
+int BdEngineBackend::preparedQueryCacheHits() const
+{
+    Q_D(const BdEngineBackend);
+
+    return d->preparedQueriesHits.loadRelaxed();
+}
+
+int BdEngineBackend::preparedQueryCacheMisses() const
+{
+    Q_D(const BdEngineBackend);
+
+    return d->preparedQueriesMisses.loadRelaxed();
+}
+
 void BdEngineBackend::setForeignKeyChecks(bool check)
 {
     Q_D(BdEngineBackend);
@@ -339,6 +339,15 @@ public:
                                  QList<QVariant>* const values,
                                  QVariant* const lastInsertId);
 
+    /**
+     * As handleQueryResult(), then gives the query taken from the prepared query cache back.
+     */
+    QueryState handlePreparedQueryResult(const QString& sql,
+                                         DbEngineSqlQuery& query,
+                                         int epoch,
+                                         QList<QVariant>* const values,
+                                         QVariant* const lastInsertId);
+
     /**
      * Method which accepts a map for named binding.
      * For special cases it's also possible to add a DbEngineActionType which wraps another
@@ -512,6 +521,12 @@ public:
      */
     void setForeignKeyChecks(bool check);
 
+    /**
+     * Statistics of the prepared query cache used by execSql(), cumulated for all threads.
+     */
+    int preparedQueryCacheHits()   const;
+    int preparedQueryCacheMisses() const;
+
     /*
         Qt SQL driver supported features
         SQLITE3:
@@ -19,6 +19,8 @@
 
 // Qt includes
 
+#include <QAtomicInt>
+#include <QCache>
 #include <QHash>
 #include <QSqlDatabase>
 #include <QThread>
@@ -30,6 +32,7 @@
 #include "digikam_export.h"
 #include "dbengineparameters.h"
 #include "dbengineerrorhandler.h"
+#include "dbenginesqlquery.h"
 
 namespace Digikam
 {
@@ -38,17 +41,26 @@ class Q_DECL_HIDDEN DbEngineThreadData
 {
 public:
 
-    DbEngineThreadData() = default;
+    DbEngineThreadData();
     ~DbEngineThreadData();
 
     void closeDatabase();
+    void clearPreparedQueries();
 
 public:
 
-    int       valid             = 0;
-    int       transactionCount  = 0;
-    QString   connectionName;
-    QSqlError lastError;
+    int                                valid             = 0;
+    int                                transactionCount  = 0;
+    QString                            connectionName;
+    QSqlError                          lastError;
+
+    /**
+     * Prepared queries of this connection, keyed by SQL statement, least recently used dropped first.
+     * The epoch changes each time the cache is cleared, a query taken before must not be put back.
+     */
+    QCache<QString, DbEngineSqlQuery>  preparedQueries;
+    int                                preparedQueriesEpoch       = 0;
+    int                                preparedQueriesGeneration  = 0;
 };
 
 // ------------------------------------------------------------------------
@@ -100,6 +112,20 @@ public:
 
     virtual void transactionFinished();
 
+    /**
+     * Prepared query cache of the current thread. takePreparedQuery() returns a query prepared
+     * with sql, taken out of the cache while it is used, and recyclePreparedQuery() puts it back
+     * when its result was read.
+     */
+    DbEngineSqlQuery takePreparedQuery(const QString& sql, int* const epoch);
+    void             recyclePreparedQuery(const QString& sql, DbEngineSqlQuery& query, int epoch);
+
+    /**
+     * Statements changing the schema invalidate the prepared queries of all threads.
+     */
+    bool isSchemaChange(const QString& sql)                          const;
+    void invalidatePreparedQueries();
+
 public:
 
     QThreadStorage<DbEngineThreadData*>       threadDataStorage;
@@ -131,6 +157,10 @@ public:
 
     DbEngineErrorHandler*                     errorHandler              = nullptr;
 
+    QAtomicInt                                preparedQueriesGeneration;
+    QAtomicInt                                preparedQueriesHits;
+    QAtomicInt                                preparedQueriesMisses;
+
 public:
 
     class Q_DECL_HIDDEN AbstractUnlocker
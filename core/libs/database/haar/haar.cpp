@@ -100,12 +100,32 @@ void ImageData::fillPixelData(const QImage& im)
  */
 void ImageData::fillPixelData(const DImg& im)
 {
-    DImg image(im);
-    image.convertToEightBit();
-    image      = image.smoothScale(Haar::NumberOfPixels, Haar::NumberOfPixels, Qt::IgnoreAspectRatio);
-    uchar* ptr = image.bits();
+    // Only the reduced image is converted to 8 bits, the shared data of im are left unchanged.
+
+    DImg image = im.smoothScale(Haar::NumberOfPixels, Haar::NumberOfPixels, Qt::IgnoreAspectRatio);
     int cn     = 0;
 
+    if (image.sixteenBit())
+    {
+        const ushort* ptr = reinterpret_cast<const ushort*>(image.bits());
+
+        for (int h = 0 ; h < Haar::NumberOfPixels ; ++h)
+        {
+            for (int w = 0 ; w < Haar::NumberOfPixels ; ++w)
+            {
+                data1[cn] = ptr[2] >> 8;
+                data2[cn] = ptr[1] >> 8;
+                data3[cn] = ptr[0] >> 8;
+                ptr      += 4;
+                ++cn;
+            }
+        }
+
+        return;
+    }
+
+    const uchar* ptr = image.bits();
+
     for (int h = 0 ; h < Haar::NumberOfPixels ; ++h)
     {
         for (int w = 0 ; w < Haar::NumberOfPixels ; ++w)
@@ -143,6 +143,10 @@ bool HaarIface::indexImage(qlonglong imageid)
                                                                   " (imageid, modificationDate, uniqueHash, matrix) "
                                                                   " VALUES(?, ?, ?, ?);"),
                                                 imageid, asDateTimeLocal(info.modDateTime()), info.uniqueHash(), array);
+
+        // Keep an already built cache and its inverted index in sync with the database.
+
+        d->updateSignatureCache(imageid, info.albumRootId(), info.albumId(), sig);
     }
 
     return true;
@@ -338,13 +342,6 @@ QPair<double, QMap<qlonglong, double> > HaarIface::bestMatchesWithThreshold(qlon
                                                                             searchResultRestriction,
                                                                             SketchType type)
 {
-    int albumId                    = CoreDbAccess().db()->getItemAlbum(imageid);
-    QMap<qlonglong, double> scores = searchDatabase(querySig,
-                                                    type,
-                                                    targetAlbums,
-                                                    searchResultRestriction,
-                                                    imageid,
-                                                    albumId);
     double lowest, highest;
     getBestAndWorstPossibleScore(querySig, type, &lowest, &highest);
 
@@ -370,6 +367,15 @@ QPair<double, QMap<qlonglong, double> > HaarIface::bestMatchesWithThreshold(qlon
 
     double supremum = (floor(maximumPercentage * 100 + 1.0)) / 100;
 
+    int albumId                    = CoreDbAccess().db()->getItemAlbum(imageid);
+    QMap<qlonglong, double> scores = searchDatabase(querySig,
+                                                    type,
+                                                    targetAlbums,
+                                                    searchResultRestriction,
+                                                    imageid,
+                                                    albumId,
+                                                    requiredScore);
+
     QMap<qlonglong, double> bestMatches;
     double score, percentage, avgPercentage = 0.0;
     QPair<double, QMap<qlonglong, double> > result;
@@ -463,19 +469,13 @@ QMap<qlonglong, double> HaarIface::searchDatabase(Haar::SignatureData* const que
                                                   SketchType type, const QList<int>& targetAlbums,
                                                   DuplicatesSearchRestrictions searchResultRestriction,
                                                   qlonglong originalImageId,
-                                                  int originalAlbumId)
+                                                  int originalAlbumId,
+                                                  double maximumScore)
 {
-    // The table of constant weight factors applied to each channel and the weight bin
+    // layout the query signature for fast lookup, with the table of
+    // constant weight factors applied to each channel and the weight bin
 
-    Haar::Weights weights((Haar::Weights::SketchType)type);
-
-    // layout the query signature for fast lookup
-
-    Haar::SignatureMap queryMapY, queryMapI, queryMapQ;
-    queryMapY.fill(querySig->sig[0]);
-    queryMapI.fill(querySig->sig[1]);
-    queryMapQ.fill(querySig->sig[2]);
-    std::reference_wrapper<Haar::SignatureMap> queryMaps[3] = { queryMapY, queryMapI, queryMapQ };
+    const SignatureScorer scorer(*querySig, (Haar::Weights::SketchType)type);
 
     // Map imageid -> score. Lowest score is best.
     // any newly inserted value will be initialized with a score of 0, as required
@@ -484,26 +484,82 @@ QMap<qlonglong, double> HaarIface::searchDatabase(Haar::SignatureData* const que
 
     // if no cache is used or the cache signature map is empty, query the database
 
-    if (!d->hasSignatureCache())
     {
-        d->rebuildSignatureCache();
+        QMutexLocker locker(&d->cacheMutex);
+
+        if (!d->hasSignatureCache())
+        {
+            d->rebuildSignatureCache();
+        }
     }
 
-    for (auto it = d->signatureCache()->constBegin() ; it != d->signatureCache()->constEnd() ; ++it)
+    const SignatureStore* const store = d->signatureCache();
+
+    // An image without any significant coefficient in common with the query
+    // keeps the score of the averages term only, which is never negative.
+    // It cannot reach the maximum score, so only the images found in the
+    // inverted index need to be looked at, if none of the query coefficients
+    // is too frequent to be indexed.
+
+    QVector<qlonglong> candidates;
+
+    if ((maximumScore < 0.0) && d->signatureIndex()->candidates(*querySig, candidates))
     {
-        // If the image is the original one or
-        // No restrictions apply or
-        // SameAlbum restriction applies and the albums are equal or
-        // DifferentAlbum restriction applies and the albums differ
-        // then calculate the score.
+        double score = 0.0;
+
+        for (const qlonglong& imageId : candidates)
+        {
+            const int row = store->indexOf(imageId);
 
-        const qlonglong& imageId = it.key();
+            if (row == -1)
+            {
+                continue;
+            }
 
-        if (fulfillsRestrictions(imageId, d->albumCache()->value(imageId), originalImageId,
-                                 originalAlbumId, targetAlbums, searchResultRestriction))
+            if (fulfillsRestrictions(imageId, store->albumIdAt(row), originalImageId,
+                                     originalAlbumId, targetAlbums, searchResultRestriction))
+            {
+                scorer.score(store->coefficientsAt(row), store->averagesAt(row), 1, &score);
+                scores[imageId] = score;
+            }
+        }
+
+        return scores;
+    }
+
+    // Score the contiguous rows of the store by blocks.
+
+    const int blockSize = 256;
+    double    blockScores[blockSize];
+
+    for (int first = 0 ; first < store->rows() ; first += blockSize)
+    {
+        const int count = qMin(blockSize, store->rows() - first);
+
+        scorer.score(store->coefficientsAt(first), store->averagesAt(first), count, blockScores);
+
+        for (int i = 0 ; i < count ; ++i)
         {
-            const Haar::SignatureData& data = it.value();
-            scores[imageId]                 = calculateScore(*querySig, data, weights, queryMaps);
+            const int row = first + i;
+
+            if (store->isRemoved(row))
+            {
+                continue;
+            }
+
+            // If the image is the original one or
+            // No restrictions apply or
+            // SameAlbum restriction applies and the albums are equal or
+            // DifferentAlbum restriction applies and the albums differ
+            // then keep the score.
+
+            const qlonglong imageId = store->imageIdAt(row);
+
+            if (fulfillsRestrictions(imageId, store->albumIdAt(row), originalImageId,
+                                     originalAlbumId, targetAlbums, searchResultRestriction))
+            {
+                scores[imageId] = blockScores[i];
+            }
         }
     }
 
@@ -779,9 +835,13 @@ HaarIface::DuplicatesResultsMap HaarIface::findDuplicates(const QSet<qlonglong>&
 
     // create signature cache map for fast lookup
 
-    if (!d->hasSignatureCache())
     {
-        d->rebuildSignatureCache(images2Scan);
+        QMutexLocker locker(&d->cacheMutex);
+
+        if (!d->hasSignatureCache())
+        {
+            d->rebuildSignatureCache(images2Scan);
+        }
     }
 
     for (images2ScanIterator = rangeBegin ; images2ScanIterator != rangeEnd ; ++images2ScanIterator)
@@ -803,7 +863,13 @@ HaarIface::DuplicatesResultsMap HaarIface::findDuplicates(const QSet<qlonglong>&
             break;
         }
 
-        if (!resultsCandidates.contains(*images2ScanIterator))
+        // When the search is split in shards, skip also the images
+        // already grouped by the other shards.
+
+        if (
+            !resultsCandidates.contains(*images2ScanIterator) &&
+            (singleThread || !d->isDuplicatesCandidate(*images2ScanIterator))
+           )
         {
             // find images with required similarity
 
@@ -986,6 +1052,11 @@ HaarIface::DuplicatesResultsMap HaarIface::findDuplicates(const QSet<qlonglong>&
 
                 resultsCandidates << *images2ScanIterator;
                 resultsCandidates.unite(QSet<qlonglong>(duplicates.begin(), duplicates.end()));
+
+                if (!singleThread)
+                {
+                    d->addDuplicatesCandidates(QList<qlonglong>(duplicates) << *images2ScanIterator);
+                }
             }
         }
 
@@ -995,7 +1066,7 @@ HaarIface::DuplicatesResultsMap HaarIface::findDuplicates(const QSet<qlonglong>&
 
         if (singleThread && !resultsCandidates.contains(*images2ScanIterator))
         {
-            d->signatureCache()->remove(*images2ScanIterator);
+            d->removeFromSignatureCache(*images2ScanIterator);
         }
 
         if (observer)
@@ -1020,46 +1091,4 @@ HaarIface::DuplicatesResultsMap HaarIface::findDuplicates(const QSet<qlonglong>&
     return resultsMap;
 }
 
-double HaarIface::calculateScore(const Haar::SignatureData& querySig,
-                                 const Haar::SignatureData& targetSig,
-                                 const Haar::Weights& weights,
-                                 std::reference_wrapper<Haar::SignatureMap>* const queryMaps)
-{
-    double score = 0.0;
-
-    // Step 1: Initialize scores with average intensity values of all three channels
-
-    for (int channel = 0 ; channel < 3 ; ++channel)
-    {
-        score += weights.weightForAverage(channel) * fabs(querySig.avg[channel] - targetSig.avg[channel]);
-    }
-
-    // Step 2: Decrease the score if query and target have significant coefficients in common
-
-    int x        = 0;
-
-    for (int channel = 0 ; channel < 3 ; ++channel)
-    {
-        const Haar::SignatureMap& queryMap = queryMaps[channel];
-
-        for (int coef = 0 ; coef < Haar::NumberOfCoefficients ; ++coef)
-        {
-            // x is a pixel index, either positive or negative, 0..16384
-
-            x = targetSig.sig[channel][coef];
-
-            // If x is a significant coefficient with the same sign in the query signature as well,
-            // decrease the score (lower is better)
-            // Note: both method calls called with x accept positive or negative values
-
-            if ((queryMap)[x])
-            {
-                score -= weights.weight(d->weightBin.binAbs(x), channel);
-            }
-        }
-    }
-
-    return score;
-}
-
 } // namespace Digikam
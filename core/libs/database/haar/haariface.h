@@ -18,6 +18,10 @@
 
 #pragma once
 
+// C++ includes
+
+#include <limits>
+
 // Qt includes
 
 #include <QSet>
@@ -272,6 +276,8 @@ private:
      * @param searchResultRestriction restrictions to apply to the generated map, i.e. None (default), same album or different album.
      * @param originalImageId the id of the original image to compare to other images. -1 is only used for sketch search.
      * @param albumId The album which images must or must not belong to (depending on searchResultRestriction).
+     * @param maximumScore Images with a higher score are not wanted by the caller and can be omitted.
+     *                     A negative value permits to use the inverted coefficient index.
      * @return The map of image ids and scores which fulfill the restrictions, if any.
      */
     QMap<qlonglong, double> searchDatabase(Haar::SignatureData* const data,
@@ -279,12 +285,8 @@ private:
                                            const QList<int>& targetAlbums,
                                            DuplicatesSearchRestrictions searchResultRestriction = None,
                                            qlonglong originalImageId = -1,
-                                           int albumId = -1);
-
-    double calculateScore(const Haar::SignatureData& querySig,
-                          const Haar::SignatureData& targetSig,
-                          const Haar::Weights& weights,
-                          std::reference_wrapper<Haar::SignatureMap>* const queryMaps);
+                                           int albumId = -1,
+                                           double maximumScore = std::numeric_limits<double>::max());
 
 private:
 
@@ -89,33 +89,207 @@ QByteArray DatabaseBlob::write(Haar::SignatureData& data)
 
 // -----------------------------------------------------------------------------------------------------
 
+void SignatureIndex::clear()
+{
+    m_buckets.clear();
+    m_saturated.clear();
+    m_count = 0;
+}
+
+bool SignatureIndex::isEmpty() const
+{
+    return m_buckets.isEmpty();
+}
+
+void SignatureIndex::insert(qlonglong imageId, const qint16* const coefs)
+{
+    if (m_buckets.isEmpty())
+    {
+        m_buckets.resize(3 * 2 * Haar::NumberOfPixelsSquared);
+        m_saturated.fill(false, 3 * 2 * Haar::NumberOfPixelsSquared);
+    }
+
+    ++m_count;
+
+    const int maxSize = (m_count >= MinSaturationSize) ? (m_count / MaxBucketRatio) : m_count;
+
+    for (int channel = 0 ; channel < 3 ; ++channel)
+    {
+        for (int coef = 0 ; coef < Haar::NumberOfCoefficients ; ++coef)
+        {
+            const int index = bucket(channel, coefs[channel * Haar::NumberOfCoefficients + coef]);
+
+            if (m_saturated.at(index))
+            {
+                continue;
+            }
+
+            QVector<qlonglong>& list = m_buckets[index];
+
+            if (list.size() >= maxSize)
+            {
+                // A saturated list is never rebuilt, even if images are removed later.
+
+                m_saturated[index] = true;
+                list               = QVector<qlonglong>();
+
+                continue;
+            }
+
+            // Fast path: the ids are read in ascending order from the database.
+
+            if (list.isEmpty() || (imageId > list.last()))
+            {
+                list << imageId;
+            }
+            else
+            {
+                auto it = std::lower_bound(list.begin(), list.end(), imageId);
+
+                if (*it != imageId)
+                {
+                    list.insert(it, imageId);
+                }
+            }
+        }
+    }
+}
+
+void SignatureIndex::remove(qlonglong imageId, const qint16* const coefs)
+{
+    if (m_buckets.isEmpty())
+    {
+        return;
+    }
+
+    m_count = qMax(0, m_count - 1);
+
+    for (int channel = 0 ; channel < 3 ; ++channel)
+    {
+        for (int coef = 0 ; coef < Haar::NumberOfCoefficients ; ++coef)
+        {
+            QVector<qlonglong>& list = m_buckets[bucket(channel, coefs[channel * Haar::NumberOfCoefficients + coef])];
+            auto it                  = std::lower_bound(list.begin(), list.end(), imageId);
+
+            if ((it != list.end()) && (*it == imageId))
+            {
+                list.erase(it);
+            }
+        }
+    }
+}
+
+bool SignatureIndex::candidates(const Haar::SignatureData& querySig, QVector<qlonglong>& ids) const
+{
+    ids.clear();
+
+    if (m_buckets.isEmpty())
+    {
+        return true;
+    }
+
+    int size = 0;
+
+    for (int channel = 0 ; channel < 3 ; ++channel)
+    {
+        for (int coef = 0 ; coef < Haar::NumberOfCoefficients ; ++coef)
+        {
+            const int index = bucket(channel, querySig.sig[channel][coef]);
+
+            if (m_saturated.at(index))
+            {
+                return false;
+            }
+
+            size += m_buckets.at(index).size();
+        }
+    }
+
+    // Merge the posting lists: a sorted array is a lot more compact than a hash set.
+
+    ids.reserve(size);
+
+    for (int channel = 0 ; channel < 3 ; ++channel)
+    {
+        for (int coef = 0 ; coef < Haar::NumberOfCoefficients ; ++coef)
+        {
+            ids << m_buckets.at(bucket(channel, querySig.sig[channel][coef]));
+        }
+    }
+
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------------------------------
+
 HaarIface::Private::Private()
     : m_data(new Haar::ImageData)
 {
 }
 
-void HaarIface::Private::rebuildSignatureCache(const QSet<qlonglong>& imageIds)
+template <class Source>
+void HaarIface::Private::fillSignatureCache(const Source& source,
+                                            const QHash<qlonglong, QPair<int, int> >& itemAlbumHash)
 {
-    m_signatureCache.reset(new SignatureCache);
-    m_albumCache.reset(new AlbumCache);
+    // reference for easier access
 
-    // Variables for data read from DB
+    SignatureStore& sigCache      = *m_signatureCache;
+    SignatureIndex& sigIndex      = *m_signatureIndex;
+    const bool filterByAlbumRoots = !m_albumRootsToSearch.isEmpty();
+    const int  count              = qMin(source.count(), (int)itemAlbumHash.size());
 
-    DatabaseBlob        blob;
-    qlonglong           imageid;
-    int                 albumid;
-    Haar::SignatureData targetSig;
+    sigCache.reserve(count);
 
-    // reference for easier access
+    for (int row = 0 ; row < source.count() ; ++row)
+    {
+        const qlonglong imageid = source.imageIdAt(row);
+        auto it                 = itemAlbumHash.constFind(imageid);
+
+        if (it == itemAlbumHash.constEnd())
+        {
+            continue;
+        }
 
-    SignatureCache& sigCache = *m_signatureCache;
-    AlbumCache&     albCache = *m_albumCache;
+        // Pair storage of <albumroootid, albumid>
 
-    DbEngineSqlQuery query   = SimilarityDbAccess().backend()->prepareQuery(signatureQuery);
+        const QPair<int, int>& albumPair = it.value();
 
-    if (!SimilarityDbAccess().backend()->exec(query))
+        if (filterByAlbumRoots)
+        {
+            if (!m_albumRootsToSearch.contains(albumPair.first))
+            {
+                continue;
+            }
+        }
+
+        sigCache.insert(imageid, albumPair.second, source.coefficientsAt(row), source.averagesAt(row));
+        sigIndex.insert(imageid, source.coefficientsAt(row));
+    }
+}
+
+void HaarIface::Private::rebuildSignatureCache(const QSet<qlonglong>& imageIds)
+{
+    // Release the previous cache before filling the new one, to not hold both in memory.
+
+    if (m_signatureCache.isNull())
     {
-        return;
+        m_signatureCache.reset(new SignatureStore);
+        m_signatureIndex.reset(new SignatureIndex);
+    }
+    else
+    {
+        m_signatureCache->clear();
+        m_signatureIndex->clear();
+    }
+
+    m_partialCache = !imageIds.isEmpty();
+
+    {
+        QWriteLocker locker(&m_candidatesLock);
+        m_duplicatesCandidates.clear();
     }
 
     QHash<qlonglong, QPair<int, int> > itemAlbumHash = CoreDbAccess().db()->getAllItemsWithAlbum();
@@ -123,7 +297,7 @@ void HaarIface::Private::rebuildSignatureCache(const QSet<qlonglong>& imageIds)
     // Remove all ids from the fully created itemAlbumHash that are not needed for the duplicates search.
     // This is usually faster then starting a query for every single id in imageIds.
 
-    if (!imageIds.isEmpty())
+    if (m_partialCache)
     {
         for (auto it = itemAlbumHash.begin() ; it != itemAlbumHash.end() ; )
         {
@@ -138,32 +312,135 @@ void HaarIface::Private::rebuildSignatureCache(const QSet<qlonglong>& imageIds)
         }
     }
 
+    // The snapshot holds all signatures of the database. It is only worth to check and
+    // to write it when the whole cache is built, a subset only decodes its own blobs.
+
+    QByteArray        fingerprint;
+    const QString     filePath = snapshotFilePath();
+    SignatureSnapshot snapshot(filePath);
+
+    if (!m_partialCache)
+    {
+        fingerprint = signaturesFingerprint();
+
+        if (!fingerprint.isEmpty() && snapshot.open(fingerprint))
+        {
+            qCDebug(DIGIKAM_DATABASE_LOG) << "Haar signatures loaded from snapshot" << filePath;
+
+            fillSignatureCache(snapshot, itemAlbumHash);
+
+            return;
+        }
+    }
+
+    // Read the signatures from the database.
+
+    DbEngineSqlQuery query = SimilarityDbAccess().backend()->prepareQuery(signatureQuery);
+
+    if (!SimilarityDbAccess().backend()->exec(query))
+    {
+        return;
+    }
+
+    // reference for easier access
+
+    SignatureStore& sigCache      = *m_signatureCache;
+    SignatureIndex& sigIndex      = *m_signatureIndex;
     const bool filterByAlbumRoots = !m_albumRootsToSearch.isEmpty();
+    const bool writeSnapshot      = !fingerprint.isEmpty();
+    DatabaseBlob                  blob;
+    Haar::SignatureData           targetSig;
+
+    sigCache.reserve(itemAlbumHash.size());
 
     while (query.next())
     {
-        imageid = query.value(0).toLongLong();
+        const qlonglong imageid = query.value(0).toLongLong();
+        auto it                 = itemAlbumHash.constFind(imageid);
+
+        // Pair storage of <albumroootid, albumid>
 
-        if (itemAlbumHash.contains(imageid))
+        bool wanted = (it != itemAlbumHash.constEnd());
+
+        if (wanted && filterByAlbumRoots)
         {
-            // Pair storage of <albumroootid, albumid>
+            wanted = m_albumRootsToSearch.contains(it.value().first);
+        }
 
-            const QPair<int, int>& albumPair = itemAlbumHash.value(imageid);
+        // Without snapshot to write, only the blobs of the searched images are decoded.
 
-            if (filterByAlbumRoots)
-            {
-                if (!m_albumRootsToSearch.contains(albumPair.first))
-                {
-                    continue;
-                }
-            }
+        if (!wanted && !writeSnapshot)
+        {
+            continue;
+        }
 
-            blob.read(query.value(1).toByteArray(), targetSig);
-            albumid           = albumPair.second;
-            sigCache[imageid] = targetSig;
-            albCache[imageid] = albumid;
+        blob.read(query.value(1).toByteArray(), targetSig);
+        sigCache.insert(imageid, wanted ? it.value().second : 0, targetSig);
+
+        if (wanted)
+        {
+            sigIndex.insert(imageid, sigCache.coefficientsAt(sigCache.indexOf(imageid)));
         }
     }
+
+    if (!writeSnapshot)
+    {
+        return;
+    }
+
+    // The snapshot is written from the cache itself, without a second copy of all signatures.
+    // The entries not searched are only kept until then.
+
+    SignatureSnapshot::write(filePath, fingerprint, sigCache);
+
+    for (int row = 0 ; row < sigCache.rows() ; ++row)
+    {
+        const qlonglong imageid = sigCache.imageIdAt(row);
+        auto it                 = itemAlbumHash.constFind(imageid);
+
+        if (
+            (it == itemAlbumHash.constEnd()) ||
+            (filterByAlbumRoots && !m_albumRootsToSearch.contains(it.value().first))
+           )
+        {
+            sigCache.remove(imageid);
+        }
+    }
+}
+
+QByteArray HaarIface::Private::signaturesFingerprint() const
+{
+    DbEngineSqlQuery query = SimilarityDbAccess().backend()->prepareQuery(fingerprintQuery);
+
+    if (!SimilarityDbAccess().backend()->exec(query))
+    {
+        return QByteArray();
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+
+    while (query.next())
+    {
+        hash.addData(QByteArray::number(query.value(0).toLongLong()));
+        hash.addData(query.value(1).toString().toUtf8());
+        hash.addData(query.value(2).toString().toUtf8());
+    }
+
+    return hash.result().toHex();
+}
+
+QString HaarIface::Private::snapshotFilePath() const
+{
+    // One snapshot per similarity database.
+
+    const DbEngineParameters params = SimilarityDbAccess::parameters();
+    const QByteArray dbId           = QCryptographicHash::hash((params.databaseType                     +
+                                                                params.hostName                         +
+                                                                params.getSimilarityDatabaseNameOrDir()).toUtf8(),
+                                                               QCryptographicHash::Sha1).toHex().left(16);
+
+    return (QStandardPaths::writableLocation(QStandardPaths::CacheLocation) +
+            QLatin1String("/haar/signatures-") + QString::fromLatin1(dbId) + QLatin1String(".bin"));
 }
 
 bool HaarIface::Private::hasSignatureCache() const
@@ -178,14 +455,49 @@ bool HaarIface::Private::retrieveSignatureFromCache(qlonglong imageId, Haar::Sig
         return false;
     }
 
-    if (m_signatureCache->contains(imageId))
+    return m_signatureCache->retrieve(imageId, data);
+}
+
+void HaarIface::Private::updateSignatureCache(qlonglong imageId, int albumRootId, int albumId,
+                                              const Haar::SignatureData& data)
+{
+    if (m_signatureCache.isNull())
     {
-        data = m_signatureCache.data()->value(imageId);
+        return;
+    }
 
-        return true;
+    if (m_partialCache && !m_signatureCache->contains(imageId))
+    {
+        return;
     }
 
-    return false;
+    removeFromSignatureCache(imageId);
+
+    if (!m_albumRootsToSearch.isEmpty() && !m_albumRootsToSearch.contains(albumRootId))
+    {
+        return;
+    }
+
+    m_signatureCache->insert(imageId, albumId, data);
+    m_signatureIndex->insert(imageId, m_signatureCache->coefficientsAt(m_signatureCache->indexOf(imageId)));
+}
+
+void HaarIface::Private::removeFromSignatureCache(qlonglong imageId)
+{
+    if (m_signatureCache.isNull())
+    {
+        return;
+    }
+
+    const int row = m_signatureCache->indexOf(imageId);
+
+    if (row == -1)
+    {
+        return;
+    }
+
+    m_signatureIndex->remove(imageId, m_signatureCache->coefficientsAt(row));
+    m_signatureCache->remove(imageId);
 }
 
 void HaarIface::Private::setImageDataFromImage(const QImage& image)
@@ -198,14 +510,14 @@ void HaarIface::Private::setImageDataFromImage(const DImg& image)
     m_data->fillPixelData(image);
 }
 
-SignatureCache* HaarIface::Private::signatureCache() const
+SignatureStore* HaarIface::Private::signatureCache() const
 {
     return m_signatureCache.data();
 }
 
-AlbumCache* HaarIface::Private::albumCache() const
+SignatureIndex* HaarIface::Private::signatureIndex() const
 {
-    return m_albumCache.data();
+    return m_signatureIndex.data();
 }
 
 Haar::ImageData* HaarIface::Private::imageData() const
@@ -223,4 +535,18 @@ const QSet<int>& HaarIface::Private::albumRootsToSearch() const
     return m_albumRootsToSearch;
 }
 
+bool HaarIface::Private::isDuplicatesCandidate(qlonglong imageId) const
+{
+    QReadLocker locker(&m_candidatesLock);
+
+    return m_duplicatesCandidates.contains(imageId);
+}
+
+void HaarIface::Private::addDuplicatesCandidates(const QList<qlonglong>& imageIds)
+{
+    QWriteLocker locker(&m_candidatesLock);
+
+    m_duplicatesCandidates.unite(QSet<qlonglong>(imageIds.begin(), imageIds.end()));
+}
+
 } // namespace Digikam
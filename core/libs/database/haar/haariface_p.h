@@ -22,6 +22,7 @@
 
 // C++ includes
 
+#include <algorithm>
 #include <fstream>
 #include <cmath>
 #include <cstring>
@@ -30,10 +31,16 @@
 // Qt includes
 
 #include <QByteArray>
+#include <QCryptographicHash>
 #include <QDataStream>
 #include <QImage>
 #include <QImageReader>
 #include <QMap>
+#include <QMutex>
+#include <QReadWriteLock>
+#include <QSet>
+#include <QStandardPaths>
+#include <QVector>
 
 // Local includes
 
@@ -50,6 +57,8 @@
 #include "dbenginesqlquery.h"
 #include "similaritydb.h"
 #include "similaritydbaccess.h"
+#include "haarsignaturestore.h"
+#include "haarsignaturescorer.h"
 
 using namespace std;
 
@@ -58,9 +67,6 @@ using namespace std;
 namespace Digikam
 {
 
-typedef QMap<qlonglong, Haar::SignatureData> SignatureCache;
-typedef QMap<qlonglong, int>                 AlbumCache;
-
 /**
  * This class encapsulates the Haar signature in a QByteArray
  * that can be stored as a BLOB in the database.
@@ -91,6 +97,69 @@ public:
 
 // -----------------------------------------------------------------------------------------------------
 
+/**
+ * Inverted index of the Haar signatures, as done by the original imgSeek bucket design.
+ * For each channel and each signed coefficient index, a posting list holds the ids of
+ * all images having this coefficient in their signature. A query only has to look at
+ * the images sharing at least one coefficient with the query signature.
+ *
+ * Posting lists are sorted by image id, to find an entry to remove by binary search.
+ * A coefficient present in too many images is not worth to be indexed: its posting list
+ * is dropped and marked as saturated, and a query using it has to scan all signatures.
+ */
+class Q_DECL_HIDDEN SignatureIndex
+{
+public:
+
+    SignatureIndex()  = default;
+    ~SignatureIndex() = default;
+
+    void clear();
+    bool isEmpty()                                                      const;
+
+    /**
+     * Coefficients are given in the SignatureStore layout.
+     */
+    void insert(qlonglong imageId, const qint16* const coefs);
+    void remove(qlonglong imageId, const qint16* const coefs);
+
+    /**
+     * Fill ids in ascending order with all images which have at least one coefficient
+     * with the same sign and channel in common with the query signature.
+     * Return false if the query uses a saturated posting list: the candidates are
+     * not known and all signatures have to be scanned.
+     */
+    bool candidates(const Haar::SignatureData& querySig,
+                    QVector<qlonglong>& ids)                            const;
+
+private:
+
+    /**
+     * Posting list position for a channel and a signed coefficient index (-16383..16383).
+     */
+    static int bucket(int channel, Haar::Idx coef)
+    {
+        return ((channel * 2 * Haar::NumberOfPixelsSquared) + coef + Haar::NumberOfPixelsSquared);
+    }
+
+private:
+
+    enum
+    {
+        /// A posting list holding more than 1/MaxBucketRatio of the images is saturated.
+        MaxBucketRatio   = 4,
+
+        /// Number of indexed images before lists can be saturated.
+        MinSaturationSize = 1024
+    };
+
+    QVector<QVector<qlonglong> > m_buckets;
+    QVector<bool>                m_saturated;
+    int                          m_count     = 0;
+};
+
+// -----------------------------------------------------------------------------------------------------
+
 class Q_DECL_HIDDEN HaarIface::Private
 {
 public:
@@ -105,29 +174,74 @@ public:
 
     bool retrieveSignatureFromCache(qlonglong imageId, Haar::SignatureData& data);
 
+    /**
+     * Update incrementally the signature cache and the inverted index
+     * with a new or changed signature, if a cache is already built.
+     */
+    void updateSignatureCache(qlonglong imageId, int albumRootId, int albumId,
+                              const Haar::SignatureData& data);
+    void removeFromSignatureCache(qlonglong imageId);
+
     void setImageDataFromImage(const QImage& image);
     void setImageDataFromImage(const DImg& image);
 
-    SignatureCache*  signatureCache()     const;
-    AlbumCache*      albumCache()         const;
+    SignatureStore*  signatureCache()     const;
+    SignatureIndex*  signatureIndex()     const;
     Haar::ImageData* imageData()          const;
 
     void setAlbumRootsToSearch(const QSet<int>& albumRootIds);
     const QSet<int>& albumRootsToSearch() const;
 
+    /**
+     * Images already assigned to a duplicates group, shared between all shards
+     * of a parallel duplicates search to not search them again.
+     * The list is cleared when the signature cache is rebuilt.
+     */
+    bool isDuplicatesCandidate(qlonglong imageId)               const;
+    void addDuplicatesCandidates(const QList<qlonglong>& imageIds);
+
 public:
 
-    const QString                   signatureQuery = QString::fromUtf8("SELECT imageid, matrix FROM ImageHaarMatrix;");
+    /// Serialize the lazy creation of the signature cache between the shards.
+    QMutex                          cacheMutex;
+
+    const QString                   signatureQuery   = QString::fromUtf8("SELECT imageid, matrix FROM ImageHaarMatrix "
+                                                                         "ORDER BY imageid;");
+    const QString                   fingerprintQuery = QString::fromUtf8("SELECT imageid, modificationDate, uniqueHash "
+                                                                         "FROM ImageHaarMatrix ORDER BY imageid;");
     const Haar::WeightBin           weightBin;
 
 private:
 
-    QScopedPointer<SignatureCache>  m_signatureCache;
-    QScopedPointer<AlbumCache>      m_albumCache;
+    /**
+     * Hash of the ids, dates and unique hashes of all signatures stored in the database.
+     * Used to check if the signatures snapshot is still valid without reading the blobs.
+     */
+    QByteArray signaturesFingerprint()    const;
+    QString    snapshotFilePath()         const;
+
+    /**
+     * Fill the signature cache from all rows of the snapshot,
+     * applying the image ids and the album roots filters.
+     */
+    template <class Source>
+    void fillSignatureCache(const Source& source,
+                            const QHash<qlonglong, QPair<int, int> >& itemAlbumHash);
+
+private:
+
+    QScopedPointer<SignatureStore>  m_signatureCache;
+    QScopedPointer<SignatureIndex>  m_signatureIndex;
+
+    /// True if the cache was built for a subset of image ids only.
+    bool                            m_partialCache = false;
 
     QScopedPointer<Haar::ImageData> m_data;
 
     QSet<int>                       m_albumRootsToSearch;
+
+    QSet<qlonglong>                 m_duplicatesCandidates;
+    mutable QReadWriteLock          m_candidatesLock;
 };
 
 } // namespace Digikam
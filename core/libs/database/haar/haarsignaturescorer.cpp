@@ -0,0 +1,340 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-17
+ * Description : Vectorized scoring of Haar signatures
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "haarsignaturescorer.h"
+
+// C++ includes
+
+#include <cmath>
+#include <cstring>
+
+// Qt includes
+
+#include <QtAlgorithms>
+
+// Local includes
+
+#include "haarsignaturestore.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#   define HAAR_AVX2_KERNEL 1
+#   define HAAR_TARGET_AVX2 __attribute__((target("avx2")))
+#   include <immintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#   define HAAR_AVX2_KERNEL 1
+#   define HAAR_TARGET_AVX2
+#   include <immintrin.h>
+#   include <intrin.h>
+#else
+#   define HAAR_AVX2_KERNEL 0
+#endif
+
+namespace Digikam
+{
+
+namespace
+{
+
+/**
+ * One bit per signed coefficient index, for each channel.
+ */
+enum
+{
+    BitsetWords = (2 * Haar::NumberOfPixelsSquared) / 32
+};
+
+bool cpuHasAVX2()
+{
+
+#if HAAR_AVX2_KERNEL
+
+#   if defined(_MSC_VER)
+
+    int info[4];
+    __cpuid(info, 0);
+
+    if (info[0] < 7)
+    {
+        return false;
+    }
+
+    // AVX and OS support of the YMM registers.
+
+    __cpuid(info, 1);
+
+    const bool osxsave = (info[2] & (1 << 27));
+    const bool avx     = (info[2] & (1 << 28));
+
+    if (!osxsave || !avx || ((_xgetbv(0) & 0x6) != 0x6))
+    {
+        return false;
+    }
+
+    __cpuidex(info, 7, 0);
+
+    return (info[1] & (1 << 5));
+
+#   else
+
+    return __builtin_cpu_supports("avx2");
+
+#   endif
+
+#else
+
+    return false;
+
+#endif
+
+}
+
+} // namespace
+
+// -----------------------------------------------------------------------------------------------------
+
+class Q_DECL_HIDDEN SignatureScorer::Private
+{
+public:
+
+    explicit Private(Haar::Weights::SketchType type)
+        : weights(type)
+    {
+    }
+
+    /**
+     * Accumulate the weights of the coefficients of one channel set in the match mask,
+     * in the order of the target signature.
+     */
+    inline double subtractMatches(double score, const qint16* const coefs, int channel, quint64 mask) const
+    {
+        while (mask)
+        {
+            const int coef = qCountTrailingZeroBits(mask);
+            score         -= weights.weight(weightBin().binAbs(coefs[coef]), channel);
+            mask          &= (mask - 1);
+        }
+
+        return score;
+    }
+
+    inline double averagesScore(const double* const avgs) const
+    {
+        double score = 0.0;
+
+        for (int channel = 0 ; channel < 3 ; ++channel)
+        {
+            score += weights.weightForAverage(channel) * fabs(queryAvg[channel] - avgs[channel]);
+        }
+
+        return score;
+    }
+
+    inline bool isSet(int channel, int coef) const
+    {
+        const int index = coef + Haar::NumberOfPixelsSquared;
+
+        return ((bitset[channel][index >> 5] >> (index & 31)) & 1U);
+    }
+
+    void scoreScalar(const qint16* const coefs, const double* const avgs,
+                     int count, double* const scores) const;
+
+#if HAAR_AVX2_KERNEL
+
+    HAAR_TARGET_AVX2
+    void scoreAVX2(const qint16* const coefs, const double* const avgs,
+                   int count, double* const scores) const;
+
+#endif
+
+    static const Haar::WeightBin& weightBin()
+    {
+        static const Haar::WeightBin bin;
+
+        return bin;
+    }
+
+public:
+
+    quint32             bitset[3][BitsetWords];
+    double              queryAvg[3]             = { 0.0 };
+    const Haar::Weights weights;
+    Kernel              kernel                  = Scalar;
+};
+
+void SignatureScorer::Private::scoreScalar(const qint16* const coefs, const double* const avgs,
+                                           int count, double* const scores) const
+{
+    for (int i = 0 ; i < count ; ++i)
+    {
+        const qint16* const sig = coefs + i * SignatureStore::CoefficientsPerImage;
+        double score            = averagesScore(avgs + i * SignatureStore::AveragesPerImage);
+
+        for (int channel = 0 ; channel < 3 ; ++channel)
+        {
+            const qint16* const channelCoefs = sig + channel * Haar::NumberOfCoefficients;
+
+            for (int coef = 0 ; coef < Haar::NumberOfCoefficients ; ++coef)
+            {
+                if (isSet(channel, channelCoefs[coef]))
+                {
+                    score -= weights.weight(weightBin().binAbs(channelCoefs[coef]), channel);
+                }
+            }
+        }
+
+        scores[i] = score;
+    }
+}
+
+#if HAAR_AVX2_KERNEL
+
+HAAR_TARGET_AVX2
+void SignatureScorer::Private::scoreAVX2(const qint16* const coefs, const double* const avgs,
+                                         int count, double* const scores) const
+{
+    static_assert((Haar::NumberOfCoefficients % 8) == 0, "AVX2 kernel works on 8 coefficients per step");
+
+    const __m256i offset = _mm256_set1_epi32(Haar::NumberOfPixelsSquared);
+    const __m256i bits   = _mm256_set1_epi32(31);
+    const __m256i one    = _mm256_set1_epi32(1);
+
+    for (int i = 0 ; i < count ; ++i)
+    {
+        const qint16* const sig = coefs + i * SignatureStore::CoefficientsPerImage;
+        double score            = averagesScore(avgs + i * SignatureStore::AveragesPerImage);
+
+        for (int channel = 0 ; channel < 3 ; ++channel)
+        {
+            const qint16* const channelCoefs = sig + channel * Haar::NumberOfCoefficients;
+            const int* const    words        = reinterpret_cast<const int*>(bitset[channel]);
+            quint64             mask         = 0;
+
+            for (int coef = 0 ; coef < Haar::NumberOfCoefficients ; coef += 8)
+            {
+                // 8 signed indexes to 32 bits, then lookup of the bits in the query bitset.
+
+                const __m128i raw   = _mm_loadu_si128(reinterpret_cast<const __m128i*>(channelCoefs + coef));
+                const __m256i index = _mm256_add_epi32(_mm256_cvtepi16_epi32(raw), offset);
+                const __m256i word  = _mm256_i32gather_epi32(words, _mm256_srli_epi32(index, 5), 4);
+                const __m256i bit   = _mm256_and_si256(_mm256_srlv_epi32(word, _mm256_and_si256(index, bits)), one);
+                const int     found = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(bit, one)));
+
+                mask               |= ((quint64)found << coef);
+            }
+
+            score = subtractMatches(score, channelCoefs, channel, mask);
+        }
+
+        scores[i] = score;
+    }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------------------------------
+
+SignatureScorer::SignatureScorer(const Haar::SignatureData& querySig,
+                                 Haar::Weights::SketchType type,
+                                 Kernel kernel)
+    : d(new Private(type))
+{
+    memset(d->bitset, 0, sizeof(d->bitset));
+
+    for (int channel = 0 ; channel < 3 ; ++channel)
+    {
+        d->queryAvg[channel] = querySig.avg[channel];
+
+        for (int coef = 0 ; coef < Haar::NumberOfCoefficients ; ++coef)
+        {
+            const int index = querySig.sig[channel][coef] + Haar::NumberOfPixelsSquared;
+            d->bitset[channel][index >> 5] |= (1U << (index & 31));
+        }
+    }
+
+    if (kernel == Best)
+    {
+        kernel = isSupported(AVX2) ? AVX2 : Scalar;
+    }
+
+    d->kernel = isSupported(kernel) ? kernel : Scalar;
+}
+
+SignatureScorer::~SignatureScorer()
+{
+    delete d;
+}
+
+SignatureScorer::Kernel SignatureScorer::kernel() const
+{
+    return d->kernel;
+}
+
+bool SignatureScorer::isSupported(Kernel kernel)
+{
+    switch (kernel)
+    {
+        case AVX2:
+        {
+            static const bool hasAVX2 = cpuHasAVX2();
+
+            return hasAVX2;
+        }
+
+        default:
+        {
+            return true;
+        }
+    }
+}
+
+void SignatureScorer::score(const qint16* const coefs,
+                            const double* const avgs,
+                            int count,
+                            double* const scores) const
+{
+
+#if HAAR_AVX2_KERNEL
+
+    if (d->kernel == AVX2)
+    {
+        d->scoreAVX2(coefs, avgs, count, scores);
+
+        return;
+    }
+
+#endif
+
+    d->scoreScalar(coefs, avgs, count, scores);
+}
+
+double SignatureScorer::score(const Haar::SignatureData& targetSig) const
+{
+    qint16 coefs[SignatureStore::CoefficientsPerImage];
+
+    for (int channel = 0 ; channel < 3 ; ++channel)
+    {
+        for (int coef = 0 ; coef < Haar::NumberOfCoefficients ; ++coef)
+        {
+            coefs[channel * Haar::NumberOfCoefficients + coef] = (qint16)targetSig.sig[channel][coef];
+        }
+    }
+
+    double result = 0.0;
+    score(coefs, targetSig.avg, 1, &result);
+
+    return result;
+}
+
+} // namespace Digikam
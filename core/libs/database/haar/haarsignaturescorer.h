@@ -0,0 +1,84 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-17
+ * Description : Vectorized scoring of Haar signatures
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#pragma once
+
+// Local includes
+
+#include "haar.h"
+#include "digikam_export.h"
+
+namespace Digikam
+{
+
+/**
+ * Compute the similarity score of many target signatures against one query signature.
+ *
+ * The query coefficients are laid out as a bitset (4 KB per channel, which fits in
+ * the L1 cache), and the target coefficients are read in the compact layout of
+ * the SignatureStore (3 x 40 signed 16 bits indexes per image), by blocks of images.
+ * The coefficient lookups are done with AVX2 gathers when the CPU supports it,
+ * with a scalar fallback otherwise.
+ *
+ * The weights of the matching coefficients are accumulated in the order of the target
+ * signature, as HaarIface did before, so all kernels give exactly the same scores.
+ */
+class DIGIKAM_DATABASE_EXPORT SignatureScorer
+{
+public:
+
+    enum Kernel
+    {
+        Scalar = 0,
+        AVX2,
+        Best                    ///< The fastest kernel supported by the running CPU.
+    };
+
+public:
+
+    explicit SignatureScorer(const Haar::SignatureData& querySig,
+                             Haar::Weights::SketchType type = Haar::Weights::ScannedSketch,
+                             Kernel kernel = Best);
+    ~SignatureScorer();
+
+    /**
+     * Return the kernel really used, after runtime CPU detection.
+     */
+    Kernel kernel()                                                                 const;
+
+    /**
+     * Score count consecutive images. Coefficients and averages are in the SignatureStore layout.
+     * Lowest score is best.
+     */
+    void score(const qint16* const coefs,
+               const double* const avgs,
+               int count,
+               double* const scores)                                                const;
+
+    double score(const Haar::SignatureData& targetSig)                              const;
+
+    static bool isSupported(Kernel kernel);
+
+private:
+
+    SignatureScorer(const SignatureScorer&)            = delete;
+    SignatureScorer& operator=(const SignatureScorer&) = delete;
+
+private:
+
+    class Private;
+    Private* const d = nullptr;
+};
+
+} // namespace Digikam
@@ -0,0 +1,421 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-17
+ * Description : Compact storage of Haar signatures for similarity searches
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "haarsignaturestore.h"
+
+// C++ includes
+
+#include <algorithm>
+#include <cstring>
+
+// Qt includes
+
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+
+// Local includes
+
+#include "digikam_debug.h"
+
+namespace Digikam
+{
+
+void SignatureStore::clear()
+{
+    m_imageIds.clear();
+    m_coefficients.clear();
+    m_averages.clear();
+    m_albumIds.clear();
+    m_removed.clear();
+    m_count = 0;
+}
+
+void SignatureStore::reserve(int size)
+{
+    m_imageIds.reserve(size);
+    m_coefficients.reserve(size * CoefficientsPerImage);
+    m_averages.reserve(size * AveragesPerImage);
+    m_albumIds.reserve(size);
+    m_removed.reserve(size);
+}
+
+int SignatureStore::count() const
+{
+    return m_count;
+}
+
+bool SignatureStore::isEmpty() const
+{
+    return (m_count == 0);
+}
+
+int SignatureStore::rows() const
+{
+    return m_imageIds.size();
+}
+
+int SignatureStore::indexOf(qlonglong imageId) const
+{
+    auto it = std::lower_bound(m_imageIds.constBegin(), m_imageIds.constEnd(), imageId);
+
+    if ((it == m_imageIds.constEnd()) || (*it != imageId))
+    {
+        return -1;
+    }
+
+    const int row = (int)(it - m_imageIds.constBegin());
+
+    return (m_removed.at(row) ? -1 : row);
+}
+
+bool SignatureStore::contains(qlonglong imageId) const
+{
+    return (indexOf(imageId) != -1);
+}
+
+bool SignatureStore::retrieve(qlonglong imageId, Haar::SignatureData& data) const
+{
+    const int row = indexOf(imageId);
+
+    if (row == -1)
+    {
+        return false;
+    }
+
+    signatureAt(row, data);
+
+    return true;
+}
+
+int SignatureStore::albumId(qlonglong imageId) const
+{
+    const int row = indexOf(imageId);
+
+    return ((row == -1) ? 0 : m_albumIds.at(row));
+}
+
+void SignatureStore::insert(qlonglong imageId, int albumId, const Haar::SignatureData& data)
+{
+    qint16 coefs[CoefficientsPerImage];
+
+    for (int channel = 0 ; channel < 3 ; ++channel)
+    {
+        for (int coef = 0 ; coef < Haar::NumberOfCoefficients ; ++coef)
+        {
+            coefs[channel * Haar::NumberOfCoefficients + coef] = (qint16)data.sig[channel][coef];
+        }
+    }
+
+    insert(imageId, albumId, coefs, data.avg);
+}
+
+void SignatureStore::insert(qlonglong imageId, int albumId, const qint16* const coefs, const double* const avgs)
+{
+    // Fast path: the ids are read in ascending order from the database.
+
+    if (m_imageIds.isEmpty() || (imageId > m_imageIds.last()))
+    {
+        m_imageIds     << imageId;
+        m_albumIds     << albumId;
+        m_removed      << false;
+        m_coefficients.resize(m_coefficients.size() + CoefficientsPerImage);
+        m_averages.resize(m_averages.size() + AveragesPerImage);
+        setRow(m_imageIds.size() - 1, imageId, albumId, coefs, avgs);
+        ++m_count;
+
+        return;
+    }
+
+    auto it       = std::lower_bound(m_imageIds.begin(), m_imageIds.end(), imageId);
+    const int row = (int)(it - m_imageIds.begin());
+
+    if (*it == imageId)
+    {
+        if (m_removed.at(row))
+        {
+            m_removed[row] = false;
+            ++m_count;
+        }
+
+        setRow(row, imageId, albumId, coefs, avgs);
+
+        return;
+    }
+
+    m_imageIds.insert(row, imageId);
+    m_albumIds.insert(row, albumId);
+    m_removed.insert(row, false);
+    m_coefficients.insert(row * CoefficientsPerImage, CoefficientsPerImage, 0);
+    m_averages.insert(row * AveragesPerImage, AveragesPerImage, 0.0);
+    setRow(row, imageId, albumId, coefs, avgs);
+    ++m_count;
+}
+
+bool SignatureStore::remove(qlonglong imageId)
+{
+    const int row = indexOf(imageId);
+
+    if (row == -1)
+    {
+        return false;
+    }
+
+    m_removed[row] = true;
+    --m_count;
+
+    return true;
+}
+
+bool SignatureStore::isRemoved(int row) const
+{
+    return m_removed.at(row);
+}
+
+qlonglong SignatureStore::imageIdAt(int row) const
+{
+    return m_imageIds.at(row);
+}
+
+int SignatureStore::albumIdAt(int row) const
+{
+    return m_albumIds.at(row);
+}
+
+const qint16* SignatureStore::coefficientsAt(int row) const
+{
+    return (m_coefficients.constData() + row * CoefficientsPerImage);
+}
+
+const double* SignatureStore::averagesAt(int row) const
+{
+    return (m_averages.constData() + row * AveragesPerImage);
+}
+
+void SignatureStore::signatureAt(int row, Haar::SignatureData& data) const
+{
+    const qint16* const coefs = coefficientsAt(row);
+    const double* const avgs  = averagesAt(row);
+
+    for (int channel = 0 ; channel < 3 ; ++channel)
+    {
+        data.avg[channel] = avgs[channel];
+
+        for (int coef = 0 ; coef < Haar::NumberOfCoefficients ; ++coef)
+        {
+            data.sig[channel][coef] = coefs[channel * Haar::NumberOfCoefficients + coef];
+        }
+    }
+}
+
+void SignatureStore::setRow(int row, qlonglong imageId, int albumId, const qint16* const coefs, const double* const avgs)
+{
+    m_imageIds[row] = imageId;
+    m_albumIds[row] = albumId;
+
+    memcpy(m_coefficients.data() + row * CoefficientsPerImage, coefs, sizeof(qint16) * CoefficientsPerImage);
+    memcpy(m_averages.data()     + row * AveragesPerImage,     avgs,  sizeof(double) * AveragesPerImage);
+}
+
+// -----------------------------------------------------------------------------------------------------
+
+namespace
+{
+
+static const quint32 s_snapshotMagic   = 0x444B4853;  // "DKHS"
+static const quint32 s_snapshotVersion = 1;
+
+/**
+ * Fixed size header, keep the size a multiple of 8 to align the arrays following it.
+ */
+struct SnapshotHeader
+{
+    quint32 magic;
+    quint32 version;
+    quint32 count;
+    quint32 coefficients;
+    char    fingerprint[48];
+};
+
+} // namespace
+
+SignatureSnapshot::SignatureSnapshot(const QString& filePath)
+    : m_file(filePath)
+{
+}
+
+SignatureSnapshot::~SignatureSnapshot()
+{
+    close();
+}
+
+bool SignatureSnapshot::open(const QByteArray& fingerprint)
+{
+    close();
+
+    if (!m_file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+
+    const qint64 size = m_file.size();
+
+    if (size < (qint64)sizeof(SnapshotHeader))
+    {
+        close();
+
+        return false;
+    }
+
+    m_data = m_file.map(0, size);
+
+    if (!m_data)
+    {
+        qCWarning(DIGIKAM_DATABASE_LOG) << "Cannot map Haar signatures snapshot" << m_file.fileName();
+        close();
+
+        return false;
+    }
+
+    SnapshotHeader header;
+    memcpy(&header, m_data, sizeof(SnapshotHeader));
+
+    const qint64 rowSize = sizeof(qlonglong)                                     +
+                           sizeof(double) * SignatureStore::AveragesPerImage     +
+                           sizeof(qint16) * SignatureStore::CoefficientsPerImage;
+
+    if (
+        (header.magic        != s_snapshotMagic)                                       ||
+        (header.version      != s_snapshotVersion)                                     ||
+        (header.coefficients != (quint32)SignatureStore::CoefficientsPerImage)         ||
+        (size                != (qint64)sizeof(SnapshotHeader) + header.count * rowSize) ||
+        (fingerprint.left(sizeof(header.fingerprint)) !=
+         QByteArray(header.fingerprint, qstrnlen(header.fingerprint, sizeof(header.fingerprint))))
+       )
+    {
+        qCDebug(DIGIKAM_DATABASE_LOG) << "Haar signatures snapshot is outdated" << m_file.fileName();
+        close();
+
+        return false;
+    }
+
+    const uchar* data = m_data + sizeof(SnapshotHeader);
+    m_count           = (int)header.count;
+    m_imageIds        = reinterpret_cast<const qlonglong*>(data);
+    data             += sizeof(qlonglong) * m_count;
+    m_averages        = reinterpret_cast<const double*>(data);
+    data             += sizeof(double) * SignatureStore::AveragesPerImage * m_count;
+    m_coefficients    = reinterpret_cast<const qint16*>(data);
+
+    return true;
+}
+
+void SignatureSnapshot::close()
+{
+    if (m_data)
+    {
+        m_file.unmap(m_data);
+        m_data = nullptr;
+    }
+
+    m_file.close();
+
+    m_count        = 0;
+    m_imageIds     = nullptr;
+    m_averages     = nullptr;
+    m_coefficients = nullptr;
+}
+
+int SignatureSnapshot::count() const
+{
+    return m_count;
+}
+
+qlonglong SignatureSnapshot::imageIdAt(int row) const
+{
+    return m_imageIds[row];
+}
+
+const qint16* SignatureSnapshot::coefficientsAt(int row) const
+{
+    return (m_coefficients + row * SignatureStore::CoefficientsPerImage);
+}
+
+const double* SignatureSnapshot::averagesAt(int row) const
+{
+    return (m_averages + row * SignatureStore::AveragesPerImage);
+}
+
+bool SignatureSnapshot::write(const QString& filePath,
+                              const QByteArray& fingerprint,
+                              const SignatureStore& store)
+{
+    if (!QDir().mkpath(QFileInfo(filePath).absolutePath()))
+    {
+        return false;
+    }
+
+    // QSaveFile replaces the file atomically: a snapshot mapped by another instance stays valid.
+
+    QSaveFile file(filePath);
+
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        qCWarning(DIGIKAM_DATABASE_LOG) << "Cannot write Haar signatures snapshot" << filePath;
+
+        return false;
+    }
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(SnapshotHeader));
+    header.magic        = s_snapshotMagic;
+    header.version      = s_snapshotVersion;
+    header.count        = (quint32)store.count();
+    header.coefficients = (quint32)SignatureStore::CoefficientsPerImage;
+    memcpy(header.fingerprint, fingerprint.constData(),
+           qMin((size_t)fingerprint.size(), sizeof(header.fingerprint)));
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(SnapshotHeader));
+
+    for (int row = 0 ; row < store.rows() ; ++row)
+    {
+        if (!store.isRemoved(row))
+        {
+            const qlonglong id = store.imageIdAt(row);
+            file.write(reinterpret_cast<const char*>(&id), sizeof(qlonglong));
+        }
+    }
+
+    for (int row = 0 ; row < store.rows() ; ++row)
+    {
+        if (!store.isRemoved(row))
+        {
+            file.write(reinterpret_cast<const char*>(store.averagesAt(row)),
+                       sizeof(double) * SignatureStore::AveragesPerImage);
+        }
+    }
+
+    for (int row = 0 ; row < store.rows() ; ++row)
+    {
+        if (!store.isRemoved(row))
+        {
+            file.write(reinterpret_cast<const char*>(store.coefficientsAt(row)),
+                       sizeof(qint16) * SignatureStore::CoefficientsPerImage);
+        }
+    }
+
+    return file.commit();
+}
+
+} // namespace Digikam
@@ -0,0 +1,162 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-17
+ * Description : Compact storage of Haar signatures for similarity searches
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#pragma once
+
+// Qt includes
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QVector>
+
+// Local includes
+
+#include "haar.h"
+
+namespace Digikam
+{
+
+/**
+ * Flat structure-of-arrays storage of the Haar signatures, sorted by image id.
+ * Coefficients of all images are stored in one contiguous array of 16 bits integers
+ * (the signed pixel index fits in the -16383..16383 range), averages in a second one,
+ * and album ids in a third one. Compared to one map node per image, this is a lot
+ * more compact and cache friendly when all signatures are scanned.
+ *
+ * Removed entries are only flagged, to keep the removal cheap while scanning.
+ */
+class Q_DECL_HIDDEN SignatureStore
+{
+public:
+
+    enum
+    {
+        CoefficientsPerImage = 3 * Haar::NumberOfCoefficients,
+        AveragesPerImage     = 3
+    };
+
+public:
+
+    SignatureStore()  = default;
+    ~SignatureStore() = default;
+
+    void clear();
+    void reserve(int size);
+
+    /**
+     * Number of valid entries.
+     */
+    int  count()                                                                    const;
+    bool isEmpty()                                                                  const;
+
+    /**
+     * Number of rows, including the removed ones.
+     * Use this value as bound to iterate over the rows.
+     */
+    int  rows()                                                                     const;
+
+    /**
+     * Return the row of the image id, or -1 if the image is not in the store.
+     */
+    int  indexOf(qlonglong imageId)                                                 const;
+    bool contains(qlonglong imageId)                                                const;
+
+    bool retrieve(qlonglong imageId, Haar::SignatureData& data)                     const;
+    int  albumId(qlonglong imageId)                                                 const;
+
+    /**
+     * Add or replace an entry. Appending images by ascending ids is fast,
+     * other ids are inserted at their sorted position.
+     */
+    void insert(qlonglong imageId, int albumId, const Haar::SignatureData& data);
+    void insert(qlonglong imageId, int albumId, const qint16* const coefs, const double* const avgs);
+    bool remove(qlonglong imageId);
+
+    /**
+     * Row based accessors.
+     */
+    bool          isRemoved(int row)                                                const;
+    qlonglong     imageIdAt(int row)                                                const;
+    int           albumIdAt(int row)                                                const;
+    const qint16* coefficientsAt(int row)                                           const;
+    const double* averagesAt(int row)                                               const;
+    void          signatureAt(int row, Haar::SignatureData& data)                   const;
+
+private:
+
+    void setRow(int row, qlonglong imageId, int albumId, const qint16* const coefs, const double* const avgs);
+
+private:
+
+    QVector<qlonglong> m_imageIds;
+    QVector<qint16>    m_coefficients;
+    QVector<double>    m_averages;
+    QVector<int>       m_albumIds;
+    QVector<bool>      m_removed;
+    int                m_count      = 0;
+};
+
+// -----------------------------------------------------------------------------------------------------
+
+/**
+ * Persisted snapshot of all the signatures from the similarity database, memory-mapped
+ * on reading. This avoid to read and decode again all signature blobs from the database
+ * after a restart. The snapshot is only valid for the fingerprint of the database
+ * content it was written with.
+ *
+ * The file is a cache in native byte order:
+ * header, image ids (qint64), averages (3 doubles per image), coefficients (120 qint16 per image).
+ */
+class Q_DECL_HIDDEN SignatureSnapshot
+{
+public:
+
+    explicit SignatureSnapshot(const QString& filePath);
+    ~SignatureSnapshot();
+
+    /**
+     * Map the snapshot file. Return false if the file does not exist,
+     * is corrupted or was written for another fingerprint.
+     */
+    bool open(const QByteArray& fingerprint);
+    void close();
+
+    int           count()                                                           const;
+    qlonglong     imageIdAt(int row)                                                const;
+    const qint16* coefficientsAt(int row)                                           const;
+    const double* averagesAt(int row)                                               const;
+
+    /**
+     * Write all valid entries of the store to the snapshot file.
+     */
+    static bool write(const QString& filePath,
+                      const QByteArray& fingerprint,
+                      const SignatureStore& store);
+
+private:
+
+    QFile               m_file;
+    uchar*              m_data          = nullptr;
+    int                 m_count         = 0;
+    const qlonglong*    m_imageIds      = nullptr;
+    const double*       m_averages      = nullptr;
+    const qint16*       m_coefficients  = nullptr;
+
+private:
+
+    Q_DISABLE_COPY(SignatureSnapshot)
+};
+
+} // namespace Digikam
@@ -41,6 +41,11 @@ void ItemLister::setListOnlyAvailable(bool listOnlyAvailable)
     d->listOnlyAvailableImages = listOnlyAvailable;
 }
 
+void ItemLister::setCursorMode(bool cursorMode)
+{
+    d->cursorMode = cursorMode;
+}
+
 void ItemLister::list(ItemListerReceiver* const receiver,
                       const CoreDbUrl& url)
 {
@@ -54,6 +54,15 @@ public:
      */
     void setListOnlyAvailable(bool listOnlyAvailable);
 
+    /**
+     * Adjust the setting if the album, tag and search listings read the result set with
+     * a forward-only cursor, passing the records to the receiver while the query is running,
+     * instead of reading the whole result set first. Together with a receiver sending the
+     * records by parts, this bounds the memory used and the first records arrive at once.
+     * Default: false.
+     */
+    void setCursorMode(bool cursorMode);
+
     /**
      * Convenience method for Album, Tag and Date URLs, _not_ for Search URLs.
      */
@@ -34,6 +34,8 @@
 #include <QDataStream>
 #include <QRegularExpression>
 #include <QDir>
+#include <QSqlQuery>
+#include <QSqlRecord>
 
 // Local includes
 
@@ -73,10 +75,50 @@ public:
 
     Private() = default;
 
+    /**
+     * Read the result set with the forward-only cursor of query, calling handler
+     * with an iterator on the values of each row, as soon as the row is fetched.
+     */
+    template <typename Handler>
+    void readRows(QSqlQuery& query, Handler handler) const
+    {
+        const int columns = query.record().count();
+        QList<QVariant> row;
+        row.reserve(columns);
+
+        for (int i = 0 ; i < columns ; ++i)
+        {
+            row << QVariant();
+        }
+
+        while (query.next())
+        {
+            for (int i = 0 ; i < columns ; ++i)
+            {
+                row[i] = query.value(i);
+            }
+
+            handler(row.constBegin());
+        }
+    }
+
+    /**
+     * Same as above, for a result set already read in a flat list of values.
+     */
+    template <typename Handler>
+    void readRows(const QList<QVariant>& values, int columns, Handler handler) const
+    {
+        for (QList<QVariant>::const_iterator it = values.constBegin() ; it != values.constEnd() ; it += columns)
+        {
+            handler(it);
+        }
+    }
+
 public:
 
     bool recursive                  = true;
     bool listOnlyAvailableImages    = true;
+    bool cursorMode                 = false;
 };
 
 } // namespace Digikam
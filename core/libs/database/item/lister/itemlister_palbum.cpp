@@ -60,8 +60,6 @@ void ItemLister::listPAlbum(ItemListerReceiver* const receiver,
         albumIds << albumId;
     }
 
-    QList<QVariant> values;
-
     QString query = QString::fromUtf8("SELECT DISTINCT Images.id, Images.name, Images.album, "
                     "       ImageInformation.rating, Images.category, "
                     "       ImageInformation.format, ImageInformation.creationDate, "
@@ -71,39 +69,7 @@ void ItemLister::listPAlbum(ItemListerReceiver* const receiver,
                     "       LEFT JOIN ImageInformation ON Images.id=ImageInformation.imageid "
                     " WHERE Images.status=1 AND ");
 
-    if (d->recursive)
-    {
-        // SQLite allows no more than 999 parameters
-
-        const int maxParams = CoreDbAccess().backend()->maximumBoundValues();
-
-        for (int i = 0 ; i < albumIds.size() ; ++i)
-        {
-            QString q           = query;
-            QList<QVariant> ids =  (albumIds.size() <= maxParams) ? albumIds : albumIds.mid(i, maxParams);
-            i                  += ids.count();
-
-            QList<QVariant> v;
-            CoreDbAccess  access;
-            q += QString::fromUtf8("Images.album IN (");
-            access.db()->addBoundValuePlaceholders(q, ids.size());
-            q += QString::fromUtf8(");");
-            access.backend()->execSql(q, ids, &v);
-
-            values += v;
-        }
-    }
-    else
-    {
-        CoreDbAccess access;
-        query += QString::fromUtf8("Images.album = ?;");
-        access.backend()->execSql(query, albumIds, &values);
-    }
-
-    int width  = 0;
-    int height = 0;
-
-    for (QList<QVariant>::const_iterator it = values.constBegin(); it != values.constEnd();)
+    const auto readRecord = [receiver, albumRootId](QList<QVariant>::const_iterator it)
     {
         ItemListerRecord record;
         record.imageID           = (*it).toLongLong();
@@ -124,16 +90,65 @@ void ItemLister::listPAlbum(ItemListerReceiver* const receiver,
         ++it;
         record.fileSize          = (*it).toLongLong();
         ++it;
-        width                    = (*it).toInt();
-        ++it;
-        height                   = (*it).toInt();
+        int width                = (*it).toInt();
         ++it;
+        int height               = (*it).toInt();
 
         record.imageSize         = QSize(width, height);
 
         record.albumRootID = albumRootId;
 
         receiver->receive(record);
+    };
+
+    const int columns = 11;
+
+    if (d->recursive)
+    {
+        // SQLite allows no more than 999 parameters
+
+        const int maxParams = CoreDbAccess().backend()->maximumBoundValues();
+
+        for (int i = 0 ; i < albumIds.size() ; ++i)
+        {
+            QString q           = query;
+            QList<QVariant> ids =  (albumIds.size() <= maxParams) ? albumIds : albumIds.mid(i, maxParams);
+            i                  += ids.count();
+
+            CoreDbAccess  access;
+            q += QString::fromUtf8("Images.album IN (");
+            access.db()->addBoundValuePlaceholders(q, ids.size());
+            q += QString::fromUtf8(");");
+
+            if (d->cursorMode)
+            {
+                DbEngineSqlQuery cursor = access.backend()->execQuery(q, ids);
+                d->readRows(cursor, readRecord);
+            }
+            else
+            {
+                QList<QVariant> values;
+                access.backend()->execSql(q, ids, &values);
+                d->readRows(values, columns, readRecord);
+            }
+        }
+    }
+    else
+    {
+        CoreDbAccess access;
+        query += QString::fromUtf8("Images.album = ?;");
+
+        if (d->cursorMode)
+        {
+            DbEngineSqlQuery cursor = access.backend()->execQuery(query, albumIds);
+            d->readRows(cursor, readRecord);
+        }
+        else
+        {
+            QList<QVariant> values;
+            access.backend()->execSql(query, albumIds, &values);
+            d->readRows(values, columns, readRecord);
+        }
     }
 }
 
@@ -72,32 +72,10 @@ void ItemLister::listSearch(ItemListerReceiver* const receiver,
 
     qCDebug(DIGIKAM_DATABASE_LOG) << "Search query:\n" << sqlQuery << "\n" << boundValues;
 
-    bool executionSuccess;
-    {
-        CoreDbAccess access;
-        executionSuccess = access.backend()->execSql(sqlQuery, boundValues, &values);
-
-        if (!executionSuccess)
-        {
-            errMsg = access.backend()->lastError();
-        }
-    }
-
-    if (!executionSuccess)
-    {
-        receiver->error(errMsg);
-        return;
-    }
-
-    qCDebug(DIGIKAM_DATABASE_LOG) << "Search result:" << values.size() / 14;
-
     QSet<int> albumRoots = albumRootsToList();
-    int       width      = 0;
-    int       height     = 0;
-    double    lat        = 0.0;
-    double    lon        = 0.0;
+    int       count      = 0;
 
-    for (QList<QVariant>::const_iterator it = values.constBegin() ; it != values.constEnd() ;)
+    const auto readRecord = [this, receiver, referenceImageId, &hooks, &albumRoots, &count](QList<QVariant>::const_iterator it)
     {
         ItemListerRecord record;
 
@@ -121,14 +99,15 @@ void ItemLister::listSearch(ItemListerReceiver* const receiver,
         ++it;
         record.fileSize          = (*it).toLongLong();
         ++it;
-        width                    = (*it).toInt();
+        int width                = (*it).toInt();
         ++it;
-        height                   = (*it).toInt();
+        int height               = (*it).toInt();
         ++it;
-        lat                      = (*it).toDouble();
-        ++it;
-        lon                      = (*it).toDouble();
+        double lat               = (*it).toDouble();
         ++it;
+        double lon               = (*it).toDouble();
+
+        ++count;
 
         record.currentSimilarity                = 0.0;
         record.currentFuzzySearchReferenceImage = referenceImageId;
@@ -145,18 +124,60 @@ void ItemLister::listSearch(ItemListerReceiver* const receiver,
 
         if (d->listOnlyAvailableImages && !albumRoots.contains(record.albumRootID))
         {
-            continue;
+            return;
         }
 
         if (!hooks.checkPosition(lat, lon))
         {
-            continue;
+            return;
         }
 
         record.imageSize = QSize(width, height);
 
         receiver->receive(record);
+    };
+
+    // The similarity database is queried for each record with a reference image.
+    // Do not do this while the core database is locked by the cursor.
+
+    if (d->cursorMode && (referenceImageId == -1))
+    {
+        CoreDbAccess access;
+        DbEngineSqlQuery cursor = access.backend()->execQuery(sqlQuery, boundValues);
+
+        if (!cursor.isActive())
+        {
+            errMsg = access.backend()->lastError();
+            receiver->error(errMsg);
+
+            return;
+        }
+
+        d->readRows(cursor, readRecord);
+    }
+    else
+    {
+        bool executionSuccess;
+        {
+            CoreDbAccess access;
+            executionSuccess = access.backend()->execSql(sqlQuery, boundValues, &values);
+
+            if (!executionSuccess)
+            {
+                errMsg = access.backend()->lastError();
+            }
+        }
+
+        if (!executionSuccess)
+        {
+            receiver->error(errMsg);
+            return;
+        }
+
+        d->readRows(values, 14, readRecord);
     }
+
+    qCDebug(DIGIKAM_DATABASE_LOG) << "Search result:" << count;
 }
 
 void ItemLister::listHaarSearch(ItemListerReceiver* const receiver,
@@ -23,78 +23,80 @@ namespace Digikam
 void ItemLister::listTag(ItemListerReceiver* const receiver,
                          const QList<int>& tagIds)
 {
-    QSet<ItemListerRecord> records;
-    QList<int>::const_iterator it;
+    // An image can be listed for several tags, pass it only once to the receiver.
 
-    for (it = tagIds.constBegin() ; it != tagIds.constEnd() ; ++it)
+    QSet<qlonglong> listedIds;
+    const QSet<int> albumRoots = albumRootsToList();
+
+    const auto readRecord = [this, receiver, &listedIds, &albumRoots](QList<QVariant>::const_iterator it)
     {
-        QList<QVariant>         values;
-        QMap<QString, QVariant> parameters;
-        parameters.insert(QLatin1String(":tagPID"), *it);
-        parameters.insert(QLatin1String(":tagID"),  *it);
+        ItemListerRecord record;
+
+        record.imageID           = (*it).toLongLong();
+        ++it;
+        record.name              = (*it).toString();
+        ++it;
+        record.albumID           = (*it).toInt();
+        ++it;
+        record.albumRootID       = (*it).toInt();
+        ++it;
+        record.rating            = (*it).toInt();
+        ++it;
+        record.category          = (DatabaseItem::Category)(*it).toInt();
+        ++it;
+        record.format            = (*it).toString();
+        ++it;
+        record.creationDate      = (*it).toDateTime();
+        ++it;
+        record.modificationDate  = (*it).toDateTime();
+        ++it;
+        record.fileSize          = (*it).toLongLong();
+        ++it;
+        int width                = (*it).toInt();
+        ++it;
+        int height               = (*it).toInt();
 
+        if (d->listOnlyAvailableImages && !albumRoots.contains(record.albumRootID))
         {
-            CoreDbAccess access;
+            return;
+        }
 
-            if (d->recursive)
-            {
-                access.backend()->execDBAction(access.backend()->getDBAction(QLatin1String("listTagRecursive")),
-                                                                             parameters, &values);
-            }
-            else
-            {
-                access.backend()->execDBAction(access.backend()->getDBAction(QLatin1String("listTag")),
-                                                                             parameters, &values);
-            }
+        if (listedIds.contains(record.imageID))
+        {
+            return;
         }
 
-        QSet<int> albumRoots = albumRootsToList();
-        int width            = 0;
-        int height           = 0;
+        listedIds.insert(record.imageID);
 
-        for (QList<QVariant>::const_iterator it2 = values.constBegin() ; it2 != values.constEnd() ; )
-        {
-            ItemListerRecord record;
-
-            record.imageID           = (*it2).toLongLong();
-            ++it2;
-            record.name              = (*it2).toString();
-            ++it2;
-            record.albumID           = (*it2).toInt();
-            ++it2;
-            record.albumRootID       = (*it2).toInt();
-            ++it2;
-            record.rating            = (*it2).toInt();
-            ++it2;
-            record.category          = (DatabaseItem::Category)(*it2).toInt();
-            ++it2;
-            record.format            = (*it2).toString();
-            ++it2;
-            record.creationDate      = (*it2).toDateTime();
-            ++it2;
-            record.modificationDate  = (*it2).toDateTime();
-            ++it2;
-            record.fileSize          = (*it2).toLongLong();
-            ++it2;
-            width                    = (*it2).toInt();
-            ++it2;
-            height                   = (*it2).toInt();
-            ++it2;
-
-            if (d->listOnlyAvailableImages && !albumRoots.contains(record.albumRootID))
-            {
-                continue;
-            }
+        record.imageSize         = QSize(width, height);
 
-            record.imageSize         = QSize(width, height);
+        receiver->receive(record);
+    };
 
-            records.insert(record);
-        }
-    }
+    const int columns = 12;
+    QList<int>::const_iterator it;
 
-    for (QSet<ItemListerRecord>::iterator it3 = records.begin() ; it3 != records.end() ; ++it3)
+    for (it = tagIds.constBegin() ; it != tagIds.constEnd() ; ++it)
     {
-        receiver->receive(*it3);
+        QMap<QString, QVariant> parameters;
+        parameters.insert(QLatin1String(":tagPID"), *it);
+        parameters.insert(QLatin1String(":tagID"),  *it);
+
+        CoreDbAccess access;
+        const DbEngineAction action = access.backend()->getDBAction(d->recursive ? QLatin1String("listTagRecursive")
+                                                                                 : QLatin1String("listTag"));
+
+        if (d->cursorMode)
+        {
+            QSqlQuery cursor = access.backend()->execDBActionQuery(action, parameters);
+            d->readRows(cursor, readRecord);
+        }
+        else
+        {
+            QList<QVariant> values;
+            access.backend()->execDBAction(action, parameters, &values);
+            d->readRows(values, columns, readRecord);
+        }
     }
 }
 
@@ -338,6 +338,14 @@ public:
      */
     static QList<qlonglong> resolveHistoryImageId(const HistoryImageId& historyId);
 
+    /**
+     * Use this unique hash version for all files scanned until it is reset with -1,
+     * instead of reading it from the database for each file. CollectionScanner sets it
+     * for the duration of a scan session.
+     */
+    static void setSessionUniqueHashVersion(int version);
+    static int  sessionUniqueHashVersion();
+
 protected:
 
     void scanImageHistory();
@@ -15,9 +15,23 @@
 
 #include "itemscanner_p.h"
 
+// Qt includes
+
+#include <QAtomicInt>
+
 namespace Digikam
 {
 
+namespace
+{
+
+/**
+ * The unique hash version of the current scan session, or -1.
+ */
+QAtomicInt s_sessionUniqueHashVersion(-1);
+
+} // namespace
+
 void ItemScanner::scanImageHistory()
 {
     // Stage 1 of history scanning.
@@ -439,11 +453,29 @@ bool ItemScanner::hasHistoryToResolve() const
     return d->hasHistoryToResolve;
 }
 
+void ItemScanner::setSessionUniqueHashVersion(int version)
+{
+    s_sessionUniqueHashVersion.storeRelease(version);
+}
+
+int ItemScanner::sessionUniqueHashVersion()
+{
+    return s_sessionUniqueHashVersion.loadAcquire();
+}
+
 QString ItemScanner::uniqueHash() const
 {
     // the QByteArray is an ASCII hex string
 
-    const int version = CoreDbAccess().db()->getUniqueHashVersion();
+    // Within a scan session, do not lock the database for each file:
+    // the loader threads would wait for the transactions of the scanner.
+
+    int version = sessionUniqueHashVersion();
+
+    if (version == -1)
+    {
+        version = CoreDbAccess().db()->getUniqueHashVersion();
+    }
 
     if (d->scanInfo.category == DatabaseItem::Image)
     {
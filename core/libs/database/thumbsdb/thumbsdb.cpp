@@ -209,6 +209,33 @@ QList<int> ThumbsDb::findAll()
     return thumbIds;
 }
 
+QList<int> ThumbsDb::findAllNotOfType(DatabaseThumbnail::Type type)
+{
+    QList<QVariant> values;
+    d->db->execSql(QLatin1String("SELECT id FROM Thumbnails WHERE type<>? AND type>=?;"),
+                   (int)type, (int)DatabaseThumbnail::PGF, &values);
+
+    QList<int> thumbIds;
+
+    Q_FOREACH (const QVariant& object, values)
+    {
+        thumbIds << object.toInt();
+    }
+
+    return thumbIds;
+}
+
+ThumbsDbInfo ThumbsDb::findById(int thumbId)
+{
+    QList<QVariant> values;
+    d->db->execSql(QLatin1String("SELECT id, type, modificationDate, orientationHint, data "
+                                 "FROM Thumbnails "
+                                 "  WHERE id=?;"),
+                   thumbId, &values);
+
+    return fillThumbnailInfo(values);
+}
+
 QHash<QString, int> ThumbsDb::getFilePathsWithThumbnail()
 {
     DbEngineSqlQuery query = d->db->prepareQuery(QString::fromLatin1("SELECT path, thumbId "
@@ -216,7 +243,7 @@ QHash<QString, int> ThumbsDb::getFilePathsWithThumbnail()
                                                         " INNER JOIN Thumbnails ON thumbId = id "
                                                         "  WHERE type BETWEEN %1 AND %2;")
                                                  .arg(DatabaseThumbnail::PGF)
-                                                 .arg(DatabaseThumbnail::PNG));
+                                                 .arg(DatabaseThumbnail::LastThumbnailType));
 
     if (!d->db->exec(query))
     {
@@ -329,6 +356,21 @@ BdEngineBackend::QueryState ThumbsDb::updateModificationDate(int thumbId, const
                           asDateTimeLocal(modificationDate), thumbId);
 }
 
+BdEngineBackend::QueryState ThumbsDb::updateData(const ThumbsDbInfo& info, DatabaseThumbnail::Type type, const QByteArray& data)
+{
+    if (!info.modificationDate.isValid())
+    {
+        return d->db->execSql(QLatin1String("UPDATE Thumbnails SET type=?, data=? "
+                                            " WHERE id=? AND type=? AND modificationDate IS NULL;"),
+                              QList<QVariant>() << (int)type << data << info.id << info.type);
+    }
+
+    return d->db->execSql(QLatin1String("UPDATE Thumbnails SET type=?, data=? "
+                                        " WHERE id=? AND type=? AND modificationDate=?;"),
+                          QList<QVariant>() << (int)type << data << info.id << info.type
+                                            << asDateTimeLocal(info.modificationDate));
+}
+
 void ThumbsDb::replaceUniqueHash(const QString& oldUniqueHash, int oldFileSize,
                                  const QString& newUniqueHash, int newFileSize)
 {
@@ -42,8 +42,12 @@ enum Type
     PGF,
     JPEG,              // Warning : no alpha channel support. Cannot be used as well.
     JPEG2000,
-    PNG
+    PNG,
     //FreeDesktopHash
+    WEBP,              ///< Lossy WebP, the most compact with alpha channel support.
+    JXL,               ///< Lossy JPEG-XL, if the Qt image plugin is available.
+    RAW,               ///< Uncompressed pixels packed with the fastest zlib level, the fastest to decode.
+    LastThumbnailType  = RAW
 };
 
 } // namespace DatabaseThumbnail
@@ -90,6 +94,13 @@ public:
      */
     QList<int> findAll();
 
+    /**
+     * Returns the thumbnail ids which are not stored with the given type.
+     */
+    QList<int> findAllNotOfType(DatabaseThumbnail::Type type);
+
+    ThumbsDbInfo findById(int thumbId);
+
     BdEngineBackend::QueryState insertUniqueHash(const QString& uniqueHash, qlonglong fileSize, int thumbId);
     BdEngineBackend::QueryState insertFilePath(const QString& path, int thumbId);
     BdEngineBackend::QueryState insertCustomIdentifier(const QString& id, int thumbId);
@@ -117,6 +128,13 @@ public:
     void replaceUniqueHash(const QString& oldUniqueHash, int oldFileSize, const QString& newUniqueHash, int newFileSize);
     BdEngineBackend::QueryState updateModificationDate(int thumbId, const QDateTime& modificationDate);
 
+    /**
+     * Replaces the stored image of the thumbnail read as info, keeping its modification date
+     * and its orientation. Nothing is changed if the thumbnail was regenerated since it was read,
+     * i.e. if its type or its modification date is not the one of info anymore.
+     */
+    BdEngineBackend::QueryState updateData(const ThumbsDbInfo& info, DatabaseThumbnail::Type type, const QByteArray& data);
+
     // ----------- Database shrinking methods ----------
 
     /**
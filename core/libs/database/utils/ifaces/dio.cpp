@@ -46,6 +46,7 @@
 #include "itemscanner.h"
 #include "thumbsdb.h"
 #include "thumbsdbaccess.h"
+#include "thumbnailloadthread.h"
 #include "iojobsmanager.h"
 #include "collectionmanager.h"
 #include "collectionlocation.h"
@@ -786,6 +787,8 @@ void DIO::slotOneProccessed(const QUrl& url)
                 QString newName = data->destUrl(url).fileName();
                 QString newPath = data->destUrl(url).toLocalFile();
 
+                ThumbnailLoadThread::writePendingThumbnails();
+
                 if (data->fileConflict() == IOJobData::Overwrite)
                 {
                     ThumbsDbAccess().db()->removeByFilePath(newPath);
@@ -169,6 +169,7 @@ void ScanController::run()
         bool doScanDeferred     = false;
         bool doFinishScan       = false;
         bool doPartialScan      = false;
+        bool doFileScan         = false;
         bool doUpdateUniqueHash = false;
 
         QString task;
@@ -202,6 +203,11 @@ void ScanController::run()
                 doPartialScan = true;
                 task          = d->scanTasks.takeFirst();
             }
+            else if (!d->fileScanTasks.isEmpty() && !d->scanSuspended)
+            {
+                doFileScan    = true;
+                task          = d->fileScanTasks.takeFirst();
+            }
             else
             {
                 d->idle = true;
@@ -294,6 +300,21 @@ void ScanController::run()
 
             Q_EMIT partialScanDone(task);
         }
+        else if (doFileScan)
+        {
+            if (QFileInfo::exists(task))
+            {
+                CollectionScanner scanner;
+                scanner.setHintContainer(d->hints);
+                scanner.scanFile(task, CollectionScanner::NormalScan);
+            }
+            else
+            {
+                // Removed or renamed again before the scan: look at the whole directory.
+
+                scheduleCollectionScan(QFileInfo(task).path());
+            }
+        }
         else if (doUpdateUniqueHash)
         {
             CoreDbAccess access;
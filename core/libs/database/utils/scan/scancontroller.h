@@ -182,6 +182,20 @@ public:
      */
     void scheduleCollectionScanExternal(const QString& path);
 
+    /**
+     * Schedules a scan of the specified file, as scheduleCollectionScanExternal()
+     * does for a directory. If the file does not exist anymore, its directory is scanned.
+     * This method is only for the directory watch.
+     */
+    void scheduleFileScanExternal(const QString& filePath);
+
+    /**
+     * Return true if the file is being written by a FileMetadataWrite, or was written
+     * by one and did not change since. The file is already scanned after the writing.
+     * This method is only for the directory watch.
+     */
+    bool isFileMetadataWrite(const QString& filePath);
+
     /**
      * Implementation of FileMetadataWrite, see there. Calling these methods is equivalent.
      */
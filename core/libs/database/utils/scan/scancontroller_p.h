@@ -21,6 +21,8 @@
 // Qt includes
 
 #include <QStringList>
+#include <QHash>
+#include <QPair>
 #include <QFileInfo>
 #include <QPixmap>
 #include <QIcon>
@@ -121,6 +123,7 @@ public:
     int                             scanSuspended           = 0;
 
     QStringList                     scanTasks;
+    QStringList                     fileScanTasks;
 
     QStringList                     completeScanDeferredAlbums;
     bool                            deferFileScanning       = false;
@@ -159,6 +162,15 @@ public:
     int                             totalFilesToScan        = 0;
 
     QList<qlonglong>                newIdsList;
+
+    /**
+     * Files written by a FileMetadataWrite, with their modification date after the writing,
+     * or an invalid date while writing. The directory watch must not scan them again.
+     * The entries expire after one minute, in the order of writing.
+     */
+    QHash<QString, QDateTime>       metadataWrites;
+    QList<QPair<QDateTime, QString> > metadataWritesExpiry;
+    QMutex                          metadataWritesMutex;
 };
 
 // ------------------------------------------------------------------------------
@@ -145,6 +145,32 @@ void ScanController::scheduleCollectionScanExternal(const QString& path)
     }
 }
 
+void ScanController::scheduleFileScanExternal(const QString& filePath)
+{
+    d->externalTimer->start();
+
+    QMutexLocker lock(&d->mutex);
+
+    if (!d->fileScanTasks.contains(filePath))
+    {
+        d->fileScanTasks << filePath;
+    }
+}
+
+bool ScanController::isFileMetadataWrite(const QString& filePath)
+{
+    QMutexLocker lock(&d->metadataWritesMutex);
+
+    auto it = d->metadataWrites.constFind(filePath);
+
+    if (it == d->metadataWrites.constEnd())
+    {
+        return false;
+    }
+
+    return (!it.value().isValid() || (QFileInfo(filePath).lastModified() == it.value()));
+}
+
 void ScanController::scanFileDirectly(const QString& filePath)
 {
     suspendCollectionScan();
@@ -268,6 +294,11 @@ void ScanController::beginFileMetadataWrite(const ItemInfo& info)
         FileReadLocker locker(info.filePath());
     }
 
+    {
+        QMutexLocker lock(&d->metadataWritesMutex);
+        d->metadataWrites.insert(info.filePath(), QDateTime());
+    }
+
     QFileInfo fi(info.filePath());
     d->hints->recordHint(ItemMetadataAdjustmentHint(info.id(),
                                                     ItemMetadataAdjustmentHint::AboutToEditMetadata,
@@ -107,6 +107,30 @@ void ScanController::finishFileMetadataWrite(const ItemInfo& info, bool changed)
                                                     fi.lastModified(),
                                                     fi.size()));
 
+    {
+        QMutexLocker lock(&d->metadataWritesMutex);
+
+        const QDateTime current = QDateTime::currentDateTime();
+
+        while (
+               !d->metadataWritesExpiry.isEmpty() &&
+               (d->metadataWritesExpiry.first().first.secsTo(current) > 60)
+              )
+        {
+            const QString path = d->metadataWritesExpiry.takeFirst().second;
+
+            // Do not forget a file being written again.
+
+            if (d->metadataWrites.value(path).isValid())
+            {
+                d->metadataWrites.remove(path);
+            }
+        }
+
+        d->metadataWrites.insert(info.filePath(), fi.lastModified());
+        d->metadataWritesExpiry << qMakePair(current, info.filePath());
+    }
+
     scanFileDirectlyNormal(info);
 }
 
@@ -570,6 +570,14 @@ public:
     QImage     copyQImage(const QRectF& relativeRect) const;
     QImage     copyQImage(int x, int y, int w, int h) const;
 
+    /**
+     * Return a QImage using the pixels of this image without copy when the memory layouts match,
+     * for the 8 bits images on little endian hosts, or a copy as copyQImage() otherwise.
+     * The QImage is read-only and keeps a reference on the pixel data: it detaches if it is
+     * written, and it must not be used after this image is changed in place.
+     */
+    QImage     sharedQImage()                         const;
+
     /**
      * Crop image to the specified region
      */
@@ -617,6 +625,13 @@ public:
     DImg       smoothScaleSection(int sx, int sy, int sw, int sh, int dw, int dh) const;
     DImg       smoothScaleSection(const QRect& sourceRect, const QSize& destSize) const;
 
+    /**
+     * The smooth scaling methods above use SIMD instructions when the CPU supports them,
+     * and split large images between threads. Both are enabled by default and give the same
+     * pixels as the plain implementation. Disabling them is only useful for tests and benchmarks.
+     */
+    static void setSmoothScaleAccelerated(bool simd, bool multithreaded);
+
     void       rotate(ANGLE angle);
     void       flip(FLIP direction);
 
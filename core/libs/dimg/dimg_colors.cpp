@@ -64,7 +64,13 @@ void DImg::convertDepth(int depth)
     {
         // downgrading from 16 bit to 8 bit
 
-        uchar*  data = new uchar[width()*height() * 4];
+        uchar*  data = Private::allocateBuffer(width()*height() * 4);
+
+        if (!data)
+        {
+            return;
+        }
+
         uchar*  dptr = data;
         ushort* sptr = reinterpret_cast<ushort*>(bits());
         uint dim     = width() * height() * 4;
@@ -74,7 +80,7 @@ void DImg::convertDepth(int depth)
             *dptr++ = (*sptr++ * 256UL) / 65536UL;
         }
 
-        delete [] m_priv->data;
+        Private::releaseBuffer(m_priv->data, m_priv->bufferSize());
         m_priv->data       = data;
         m_priv->sixteenBit = false;
     }
@@ -82,7 +88,13 @@ void DImg::convertDepth(int depth)
     {
         // upgrading from 8 bit to 16 bit
 
-        uchar*  data = new uchar[width()*height() * 8];
+        uchar*  data = Private::allocateBuffer(width()*height() * 8);
+
+        if (!data)
+        {
+            return;
+        }
+
         ushort* dptr = reinterpret_cast<ushort*>(data);
         uchar*  sptr = bits();
 
@@ -107,7 +119,7 @@ void DImg::convertDepth(int depth)
             *dptr++ = (*sptr++ * 65536ULL) / 256ULL + noise;
         }
 
-        delete [] m_priv->data;
+        Private::releaseBuffer(m_priv->data, m_priv->bufferSize());
         m_priv->data       = data;
         m_priv->sixteenBit = true;
     }
@@ -62,7 +62,8 @@ void DImg::putImageData(uint width, uint height, bool sixteenBit, bool alpha, uc
 {
     // set image data, metadata is untouched
 
-    bool null = (width == 0) || (height == 0);
+    bool null         = (width == 0) || (height == 0);
+    const size_t size = m_priv->bufferSize();
 
     // allocateData, or code below will set null to false
 
@@ -70,7 +71,7 @@ void DImg::putImageData(uint width, uint height, bool sixteenBit, bool alpha, uc
 
     // replace data
 
-    delete [] m_priv->data;
+    Private::releaseBuffer(m_priv->data, size);
     m_priv->data = nullptr;
 
     if (null)
@@ -107,7 +108,7 @@ void DImg::putImageData(uchar* const data, bool copyData)
 {
     if      (!data)
     {
-        delete [] m_priv->data;
+        Private::releaseBuffer(m_priv->data, m_priv->bufferSize());
         m_priv->data = nullptr;
         m_priv->null = true;
     }
@@ -134,6 +135,15 @@ uchar* DImg::stripImageData()
     m_priv->data       = nullptr;
     m_priv->null       = true;
 
+    // The caller frees the data with delete[].
+
+    DImgBufferPool* const pool = DImgBufferPool::instance();
+
+    if (pool)
+    {
+        pool->take(data);
+    }
+
     return data;
 }
 
@@ -166,7 +176,14 @@ size_t DImg::allocateData() const
         return 0;
     }
 
-    m_priv->data = DImgLoader::new_failureTolerant(size);
+    if (DImgLoader::checkAllocation(size) == 0)
+    {
+        m_priv->null = true;
+
+        return 0;
+    }
+
+    m_priv->data = Private::allocateBuffer(size);
 
     if (!m_priv->data)
     {
@@ -180,6 +197,34 @@ size_t DImg::allocateData() const
     return size;
 }
 
+uchar* DImg::Private::allocateBuffer(size_t size)
+{
+    DImgBufferPool* const pool = DImgBufferPool::instance();
+    uchar* const data          = pool ? pool->allocate(size)
+                                      : new (std::nothrow) uchar[size];
+
+    if (!data)
+    {
+        qCCritical(DIGIKAM_DIMG_LOG) << "Failed to allocate chunk of memory of size" << size;
+    }
+
+    return data;
+}
+
+void DImg::Private::releaseBuffer(uchar* const data, size_t size)
+{
+    DImgBufferPool* const pool = DImgBufferPool::instance();
+
+    if (pool)
+    {
+        pool->release(data, size);
+    }
+    else
+    {
+        delete [] data;
+    }
+}
+
 void DImg::setImageDimension(uint width, uint height)
 {
     m_priv->width  = width;
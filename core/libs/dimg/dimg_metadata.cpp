@@ -16,6 +16,17 @@
 
 #include "dimg_p.h"
 
+// C ANSI includes
+
+#if defined(Q_OS_LINUX)
+#   include <fcntl.h>
+#endif
+
+// Qt includes
+
+#include <QList>
+#include <QPair>
+
 namespace Digikam
 {
 
@@ -545,6 +556,96 @@ QByteArray DImg::createUniqueHash(const QString& filePath, const QByteArray& ba)
     return hash;
 }
 
+namespace
+{
+
+/**
+ * A byte range of a file: offset and length.
+ */
+typedef QPair<qint64, qint64> HashRange;
+
+/**
+ * Ranges spanning less than this are read with a single read call.
+ */
+const qint64 singleReadSpan = 1024 * 1024;  // 1 MB
+
+/**
+ * Add the byte ranges of the file to the hash, in order. Ranges are within the file.
+ * If the ranges are close together, as for all files up to 1 MB, the span covering
+ * them is read at once, else the kernel is told to read all ranges ahead, so that
+ * the scattered reads are served together.
+ */
+void hashFileRanges(QFile& file, const QList<HashRange>& ranges, QCryptographicHash& md5)
+{
+    if (ranges.isEmpty())
+    {
+        return;
+    }
+
+    qint64 begin   = ranges.first().first;
+    qint64 end     = 0;
+    qint64 largest = 0;
+
+    for (const HashRange& range : ranges)
+    {
+        begin   = qMin(begin, range.first);
+        end     = qMax(end,   range.first + range.second);
+        largest = qMax(largest, range.second);
+    }
+
+    if ((end - begin) <= singleReadSpan)
+    {
+        QScopedArrayPointer<char> databuf(new char[end - begin]);
+
+        if (!file.seek(begin))
+        {
+            return;
+        }
+
+        const qint64 read = file.read(databuf.data(), end - begin);
+
+        for (const HashRange& range : ranges)
+        {
+            const qint64 length = qMin(range.second, read - (range.first - begin));
+
+            if (length > 0)
+            {
+                md5.addData(databuf.data() + (range.first - begin), length);
+            }
+        }
+
+        return;
+    }
+
+#if defined(Q_OS_LINUX)
+
+    const int fd = file.handle();
+
+    if (fd != -1)
+    {
+        for (const HashRange& range : ranges)
+        {
+            posix_fadvise(fd, range.first, range.second, POSIX_FADV_WILLNEED);
+        }
+    }
+
+#endif
+
+    QScopedArrayPointer<char> databuf(new char[largest]);
+
+    for (const HashRange& range : ranges)
+    {
+        qint64 read = 0;
+
+        if (file.seek(range.first) && ((read = file.read(databuf.data(), range.second)) > 0))
+        {
+            md5.addData(databuf.data(), read);
+        }
+    }
+}
+
+} // namespace
+
 QByteArray DImg::createUniqueHashV2(const QString& filePath)
 {
     QFile file(filePath);
@@ -559,28 +660,18 @@ QByteArray DImg::createUniqueHashV2(const QString& filePath)
     // Specified size: 100 kB; but limit to file size
 
     const qint64 specifiedSize = 100 * 1024; // 100 kB
-    qint64 size                = qMin(file.size(), specifiedSize);
+    const qint64 fileSize      = file.size();
+    const qint64 size          = qMin(fileSize, specifiedSize);
 
     if (size)
     {
-        QScopedArrayPointer<char> databuf(new char[size]);
-        int read;
-
-        // Read first 100 kB
-
-        if ((read = file.read(databuf.data(), size)) > 0)
-        {
-            md5.addData(databuf.data(), read);
-        }
+        // First 100 kB and last 100 kB. Up to 200 kB, they overlap and the file is read once.
 
-        // Read last 100 kB
+        QList<HashRange> ranges;
+        ranges << HashRange(0, size);
+        ranges << HashRange(fileSize - size, size);
 
-        file.seek(file.size() - size);
-
-        if ((read = file.read(databuf.data(), size)) > 0)
-        {
-            md5.addData(databuf.data(), read);
-        }
+        hashFileRanges(file, ranges, md5);
     }
 
     file.close();
@@ -602,10 +693,11 @@ QByteArray DImg::createUniqueHashV3(const QString& filePath)
     // maximum size: 100 kB for the first block, all other
     // possible 5 blocks up to 25 kB; but limit to file size
 
+    const qint64 fileSize  = file.size();
     const qint64 firstSize = 100 * 1024;         // 100 kB
     const qint64 nextSize  = 25  * 1024;         //  25 kB
-    const qint64 fsize     = qMin(file.size(), firstSize);
-    const qint64 bsize     = file.size() - fsize;
+    const qint64 fsize     = qMin(fileSize, firstSize);
+    const qint64 bsize     = fileSize - fsize;
 
     const qint64 block     = (bsize < nextSize) ? bsize
                                                 : nextSize;
@@ -613,27 +705,31 @@ QByteArray DImg::createUniqueHashV3(const QString& filePath)
 
     if (fsize)
     {
-        QScopedArrayPointer<char> databuf(new char[fsize]);
-        qint64 read;
+        // Compute the blocks first, exactly as they were read one by one
+        // up to the end of the file, then read them together.
+
+        QList<HashRange> ranges;
 
         for (int i = 0 ; i < 6 ; ++i)
         {
             qint64 rsize = (i == 0) ? fsize : block;
-            qint64 rstep = (i == 5) ? file.size() - rsize
+            qint64 rstep = (i == 5) ? fileSize - rsize
                                     : step * i + firstSize;
+            qint64 pos   = qMin((i == 0) ? 0 : rstep, fileSize - rsize);
+            qint64 read  = qMin(rsize, fileSize - pos);
 
-            file.seek(qMin((i == 0) ? 0 : rstep, file.size() - rsize));
-
-            if ((read = file.read(databuf.data(), rsize)) > 0)
+            if (read > 0)
             {
-                md5.addData(databuf.data(), read);
+                ranges << HashRange(pos, read);
             }
 
-            if (file.atEnd())
+            if ((pos + qMax(read, (qint64)0)) >= fileSize)
             {
                 break;
             }
         }
+
+        hashFileRanges(file, ranges, md5);
     }
 
     file.close();
@@ -62,6 +62,7 @@ extern "C"
 
 #include "digikam_globals.h"
 #include "dimg.h"
+#include "dimgbufferpool.h"
 #include "dplugindimg.h"
 #include "digikam_export.h"
 #include "digikam_debug.h"
@@ -120,10 +121,21 @@ public:
 
     ~Private()
     {
-        delete [] data;
+        releaseBuffer(data, bufferSize());
         delete [] lanczos_func;
     }
 
+    size_t bufferSize() const
+    {
+        return ((size_t)width * (size_t)height * (sixteenBit ? 8 : 4));
+    }
+
+    /**
+     * The pixel buffers are allocated and released with DImgBufferPool, while it exists.
+     */
+    static uchar* allocateBuffer(size_t size);
+    static void   releaseBuffer(uchar* const data, size_t size);
+
 public:
 
     bool                    null            = true;
@@ -67,6 +67,30 @@ QImage DImg::copyQImage() const
     return img;
 }
 
+static void s_releaseSharedQImage(void* info)
+{
+    delete static_cast<DImg*>(info);
+}
+
+QImage DImg::sharedQImage() const
+{
+
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+
+    if (!isNull() && !sixteenBit())
+    {
+        // The 8 bits pixels are stored as 0xAARRGGBB integers, as QImage::Format_ARGB32.
+        // The copy of the DImg, shared with this one, is released with the QImage data.
+
+        return QImage(static_cast<const uchar*>(bits()), width(), height(), width() * 4, QImage::Format_ARGB32,
+                      s_releaseSharedQImage, new DImg(*this));
+    }
+
+#endif
+
+    return copyQImage();
+}
+
 QImage DImg::copyQImage(const QRect& rect) const
 {
     return (copyQImage(rect.x(), rect.y(), rect.width(), rect.height()));
@@ -95,7 +119,7 @@ QImage DImg::copyQImage(int x, int y, int w, int h) const
 
     DImg img = copy(x, y, w, h);
 
-    return img.copyQImage();
+    return img.sharedQImage();
 }
 
 } // namespace Digikam
@@ -33,6 +33,15 @@ extern "C"
 #include <cstring>
 #include <cstdlib>
 #include <cstdio>
+#include <functional>
+
+// Qt includes
+
+#include <QList>
+#include <QFuture>
+#include <QAtomicInt>
+#include <QThreadPool>
+#include <QtConcurrent>    // krazy:exclude=includes
 
 // Local includes
 
@@ -40,6 +49,21 @@ extern "C"
 #include "dimg.h"
 #include "dimg_p.h"
 
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#   define DIMG_SCALE_SIMD 1
+#   define DIMG_TARGET_SSE2 __attribute__((target("sse2")))
+#   define DIMG_TARGET_AVX2 __attribute__((target("avx2")))
+#   include <immintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#   define DIMG_SCALE_SIMD 1
+#   define DIMG_TARGET_SSE2
+#   define DIMG_TARGET_AVX2
+#   include <immintrin.h>
+#   include <intrin.h>
+#else
+#   define DIMG_SCALE_SIMD 0
+#endif
+
 typedef uint64_t ullong;    // krazy:exclude=typedefs
 typedef int64_t  llong;     // krazy:exclude=typedefs
 
@@ -292,8 +316,53 @@ void dimgScaleAARGB16(DImgScaleInfo* const isi, ullong* const dest,
                       int dow, int sow,
                       int clip_dx, int clip_dy, int clip_dw, int clip_dh);
 
+/**
+ * SIMD versions of the area sampling in 8 bits when scaling down both ways, the case
+ * of all thumbnails and previews. The result is identical to the plain code.
+ * Return false if the CPU has no suitable instructions or if the SIMD kernels are
+ * disabled, then the caller runs the plain code.
+ * Arguments:
+ *    isi:     scale info
+ *    dest:    destination image data, at row y_begin
+ *    dyy:     destination y location corresponding to start y of source section
+ *    dow:     destination scanline width
+ *    sow:     source scanline width
+ *    x_begin: first destination column
+ *    x_end:   destination column after the last one
+ *    y_begin: first destination row
+ *    y_end:   destination row after the last one
+ *    alpha:   if false, the Alpha byte is ignored and set to opaque
+ */
+bool dimgScaleDownAA(DImgScaleInfo* const isi, uint* const dest,
+                     int dyy, int dow, int sow,
+                     int x_begin, int x_end, int y_begin, int y_end, bool alpha);
+
+/**
+ * Same as dimgScaleDownAA() in 16 bits.
+ */
+bool dimgScaleDownAA16(DImgScaleInfo* const isi, ullong* const dest,
+                       int dyy, int dow, int sow,
+                       int x_begin, int x_end, int y_begin, int y_end, bool alpha);
+
+/**
+ * The destination rows are independent: call scaleRows(y, rows) on bands of the rows
+ * [y_begin, y_begin + rows[, in parallel when the amount of pixels to process is worth
+ * the threads. All bands share the same scale info.
+ */
+void dimgScaleBands(const std::function<void(int, int)>& scaleRows,
+                    int y_begin, int rows, qint64 pixels);
+
 } // namespace DImgScale
 
+namespace
+{
+
+/// See DImg::setSmoothScaleAccelerated()
+QAtomicInt s_scaleSimd(1);
+QAtomicInt s_scaleThreads(1);
+
+} // namespace
+
 using namespace DImgScale;
 
 /*
@@ -367,37 +436,50 @@ DImg DImg::smoothScaleClipped(int dw, int dh, int clipx, int clipy, int clipw, i
     DImgScaleInfo* const scaleinfo = dimgCalcScaleInfo(*this, w, h, dw, dh, true);
 
     DImg buffer(*this, clipw, cliph);
+    uchar* const data = buffer.bits();
 
-    if (sixteenBit())
+    auto scaleRows = [&](int y, int rows)
     {
-        if (hasAlpha())
-        {
-            dimgScaleAARGBA16(scaleinfo, reinterpret_cast<ullong*>(buffer.bits()),
-                              0, 0, dw, dh, clipw, w,
-                              clipx, clipy, clipw, cliph);
-        }
-        else
-        {
-            dimgScaleAARGB16(scaleinfo, reinterpret_cast<ullong*>(buffer.bits()),
-                             0, 0, dw, dh, clipw, w,
-                             clipx, clipy, clipw, cliph);
-        }
-    }
-    else
-    {
-        if (hasAlpha())
+        const qint64 offset = (qint64)(y - clipy) * clipw;
+
+        if (sixteenBit())
         {
-            dimgScaleAARGBA(scaleinfo, reinterpret_cast<uint*>(buffer.bits()),
-                            0, 0, dw, dh, clipw, w,
-                            clipx, clipy, clipw, cliph);
+            if (hasAlpha())
+            {
+                dimgScaleAARGBA16(scaleinfo, reinterpret_cast<ullong*>(data) + offset,
+                                  0, 0, dw, dh, clipw, w,
+                                  clipx, y, clipw, rows);
+            }
+            else
+            {
+                dimgScaleAARGB16(scaleinfo, reinterpret_cast<ullong*>(data) + offset,
+                                 0, 0, dw, dh, clipw, w,
+                                 clipx, y, clipw, rows);
+            }
         }
         else
         {
-            dimgScaleAARGB(scaleinfo, reinterpret_cast<uint*>(buffer.bits()),
-                           0, 0, dw, dh, clipw, w,
-                           clipx, clipy, clipw, cliph);
+            if (hasAlpha())
+            {
+                dimgScaleAARGBA(scaleinfo, reinterpret_cast<uint*>(data) + offset,
+                                0, 0, dw, dh, clipw, w,
+                                clipx, y, clipw, rows);
+            }
+            else
+            {
+                dimgScaleAARGB(scaleinfo, reinterpret_cast<uint*>(data) + offset,
+                               0, 0, dw, dh, clipw, w,
+                               clipx, y, clipw, rows);
+            }
         }
-    }
+    };
+
+    // The cost is the number of source pixels read for the clip, or of destination pixels when scaling up.
+
+    const qint64 pixels = qMax((qint64)clipw * cliph,
+                               (qint64)w * h * clipw / dw * cliph / dh);
+
+    dimgScaleBands(scaleRows, clipy, cliph, pixels);
 
     delete scaleinfo;
 
@@ -481,47 +563,47 @@ DImg DImg::smoothScaleSection(int sx, int sy,
     DImgScaleInfo* const scaleinfo = dimgCalcScaleInfo(*this, sw, sh, dw, dh, true);
 
     DImg buffer(*this, dw, dh);
+    uchar* const data = buffer.bits();
+    const int dxx     = (sx * dw) / sw;
+    const int dyy     = (sy * dh) / sh;
 
-    if (sixteenBit())
-    {
-        if (hasAlpha())
-        {
-            dimgScaleAARGBA16(scaleinfo, reinterpret_cast<ullong*>(buffer.bits()),
-                              ((sx * dw) / sw),
-                              ((sy * dh) / sh),
-                              dw, dh,
-                              dw, w);
-        }
-        else
-        {
-            dimgScaleAARGB16(scaleinfo, reinterpret_cast<ullong*>(buffer.bits()),
-                             ((sx * dw) / sw),
-                             ((sy * dh) / sh),
-                             dw, dh,
-                             dw, w);
-        }
-    }
-    else
+    auto scaleRows = [&](int y, int rows)
     {
-        if (hasAlpha())
+        const qint64 offset = (qint64)y * dw;
+
+        if (sixteenBit())
         {
-            dimgScaleAARGBA(scaleinfo,
-                            reinterpret_cast<uint*>(buffer.bits()),
-                            ((sx * dw) / sw),
-                            ((sy * dh) / sh),
-                            dw, dh,
-                            dw, w);
+            if (hasAlpha())
+            {
+                dimgScaleAARGBA16(scaleinfo, reinterpret_cast<ullong*>(data) + offset,
+                                  dxx, dyy, dw, dh, dw, w,
+                                  0, y, dw, rows);
+            }
+            else
+            {
+                dimgScaleAARGB16(scaleinfo, reinterpret_cast<ullong*>(data) + offset,
+                                 dxx, dyy, dw, dh, dw, w,
+                                 0, y, dw, rows);
+            }
         }
         else
         {
-            dimgScaleAARGB(scaleinfo,
-                           reinterpret_cast<uint*>(buffer.bits()),
-                           ((sx * dw) / sw),
-                           ((sy * dh) / sh),
-                           dw, dh,
-                           dw, w);
+            if (hasAlpha())
+            {
+                dimgScaleAARGBA(scaleinfo, reinterpret_cast<uint*>(data) + offset,
+                                dxx, dyy, dw, dh, dw, w,
+                                0, y, dw, rows);
+            }
+            else
+            {
+                dimgScaleAARGB(scaleinfo, reinterpret_cast<uint*>(data) + offset,
+                               dxx, dyy, dw, dh, dw, w,
+                               0, y, dw, rows);
+            }
         }
-    }
+    };
+
+    dimgScaleBands(scaleRows, 0, dh, qMax((qint64)sw * sh, (qint64)dw * dh));
 
     delete scaleinfo;
 
@@ -1143,6 +1225,11 @@ void DImgScale::dimgScaleAARGBA(DImgScaleInfo* const isi, uint* const dest,
          * psllw (16 - d), %mmb; pmulh %mmc, %mmb
          */
 
+        if (dimgScaleDownAA(isi, dest, dyy, dow, sow, x_begin, x_end, y_begin, y_end, true))
+        {
+            return;
+        }
+
         int Cx, Cy, i, j;
         uint* pix = nullptr;
         int a, r, g, b, ax, rx, gx, bx;
@@ -1601,6 +1688,11 @@ void DImgScale::dimgScaleAARGB(DImgScaleInfo* const isi, uint* const dest,
     {
         // 'Correct' version, with math units prepared for MMXification
 
+        if (dimgScaleDownAA(isi, dest, dyy, dow, sow, x_begin, x_end, y_begin, y_end, false))
+        {
+            return;
+        }
+
         int Cx, Cy, i, j;
         uint* pix = nullptr;
         int r, g, b, rx, gx, bx;
@@ -2047,6 +2139,11 @@ void DImgScale::dimgScaleAARGB16(DImgScaleInfo* const isi, ullong* const dest,
     {
         // 'Correct' version, with math units prepared for MMXification
 
+        if (dimgScaleDownAA16(isi, dest, dyy, dow, sow, x_begin, x_end, y_begin, y_end, false))
+        {
+            return;
+        }
+
         int Cx, Cy, i, j;
         ullong* pix = nullptr;
         llong r, g, b, rx, gx, bx;
@@ -2523,6 +2620,11 @@ void DImgScale::dimgScaleAARGBA16(DImgScaleInfo* const isi, ullong* const dest,
          * psllw (16 - d), %mmb; pmulh %mmc, %mmb
          */
 
+        if (dimgScaleDownAA16(isi, dest, dyy, dow, sow, x_begin, x_end, y_begin, y_end, true))
+        {
+            return;
+        }
+
         int Cx, Cy, i, j;
         ullong* pix = nullptr;
         llong a, r, g, b, ax, rx, gx, bx;
@@ -2652,4 +2754,370 @@ void DImgScale::dimgScaleAARGBA16(DImgScaleInfo* const isi, ullong* const dest,
     }
 }
 
+// ----------------------------------------------------------------------------------------------
+
+namespace
+{
+
+#if DIMG_SCALE_SIMD
+
+bool dimgCpuHasSSE2()
+{
+
+#   if defined(__x86_64__) || defined(_M_X64) || defined(_MSC_VER)
+
+    // Part of x86-64, and the default target of MSVC in 32 bits.
+
+    return true;
+
+#   else
+
+    return __builtin_cpu_supports("sse2");
+
+#   endif
+
+}
+
+bool dimgCpuHasAVX2()
+{
+
+#   if defined(_MSC_VER)
+
+    int info[4];
+    __cpuid(info, 0);
+
+    if (info[0] < 7)
+    {
+        return false;
+    }
+
+    // AVX and OS support of the YMM registers.
+
+    __cpuid(info, 1);
+
+    const bool osxsave = (info[2] & (1 << 27));
+    const bool avx     = (info[2] & (1 << 28));
+
+    if (!osxsave || !avx || ((_xgetbv(0) & 0x6) != 0x6))
+    {
+        return false;
+    }
+
+    __cpuidex(info, 7, 0);
+
+    return (info[1] & (1 << 5));
+
+#   else
+
+    return __builtin_cpu_supports("avx2");
+
+#   endif
+
+}
+
+/**
+ * The 8 bits kernel holds the 4 channels of one pixel in the 32 bits lanes of a register.
+ * The values and the weights are below 2^15, so pmaddwd computes (value * weight)
+ * exactly as the plain code does.
+ */
+DIMG_TARGET_SSE2
+inline __m128i dimgLoadPixelSSE2(const uint* const pix)
+{
+    const __m128i zero = _mm_setzero_si128();
+
+    return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128((int)*pix), zero), zero);
+}
+
+DIMG_TARGET_SSE2
+inline __m128i dimgWeightSSE2(const __m128i& values, int weight, int shift)
+{
+    return _mm_srai_epi32(_mm_madd_epi16(values, _mm_set1_epi32(weight)), shift);
+}
+
+/**
+ * Sum of the source pixels covered by one destination column on one source line,
+ * rx, gx, bx and ax in the plain code.
+ */
+DIMG_TARGET_SSE2
+inline __m128i dimgSumLineSSE2(const uint* pix, int xap, int Cx)
+{
+    __m128i sum = dimgWeightSSE2(dimgLoadPixelSSE2(pix), xap, 9);
+    ++pix;
+    int i;
+
+    for (i = (1 << 14) - xap ; i > Cx ; i -= Cx)
+    {
+        sum = _mm_add_epi32(sum, dimgWeightSSE2(dimgLoadPixelSSE2(pix), Cx, 9));
+        ++pix;
+    }
+
+    if (i > 0)
+    {
+        sum = _mm_add_epi32(sum, dimgWeightSSE2(dimgLoadPixelSSE2(pix), i, 9));
+    }
+
+    return sum;
+}
+
+DIMG_TARGET_SSE2
+void dimgScaleDownSSE2(DImgScaleInfo* const isi, uint* const dest,
+                       int dyy, int dow, int sow,
+                       int x_begin, int x_end, int y_begin, int y_end, bool alpha)
+{
+    uint** const ypoints  = isi->ypoints;
+    int* const   xpoints  = isi->xpoints;
+    int* const   xapoints = isi->xapoints;
+    int* const   yapoints = isi->yapoints;
+    const __m128i mask    = _mm_set1_epi32(0xFF);
+
+    for (int y = y_begin ; y < y_end ; ++y)
+    {
+        const int Cy  = YAP >> 16;
+        const int yap = YAP & 0xffff;
+        uint* dptr    = dest + (y - y_begin) * dow;
+
+        for (int x = x_begin ; x < x_end ; ++x)
+        {
+            const int Cx  = XAP >> 16;
+            const int xap = XAP & 0xffff;
+            uint* sptr    = ypoints[dyy + y] + xpoints[x];
+            __m128i sum   = dimgWeightSSE2(dimgSumLineSSE2(sptr, xap, Cx), yap, 14);
+            sptr         += sow;
+            int j;
+
+            for (j = (1 << 14) - yap ; j > Cy ; j -= Cy)
+            {
+                sum   = _mm_add_epi32(sum, dimgWeightSSE2(dimgSumLineSSE2(sptr, xap, Cx), Cy, 14));
+                sptr += sow;
+            }
+
+            if (j > 0)
+            {
+                sum = _mm_add_epi32(sum, dimgWeightSSE2(dimgSumLineSSE2(sptr, xap, Cx), j, 14));
+            }
+
+            // The plain code stores the low byte of (value >> 5).
+
+            sum   = _mm_and_si128(_mm_srai_epi32(sum, 5), mask);
+            sum   = _mm_packs_epi32(sum, sum);
+            *dptr = (uint)_mm_cvtsi128_si32(_mm_packus_epi16(sum, sum));
+
+            if (!alpha)
+            {
+                A_VAL(dptr) = 0xFF;
+            }
+
+            ++dptr;
+        }
+    }
+}
+
+/**
+ * The 16 bits kernel holds the 4 channels of one pixel in the 64 bits lanes of a register.
+ * pmuludq multiplies the low 32 bits of the lanes to 64 bits, like the llong of the plain code.
+ */
+DIMG_TARGET_AVX2
+inline __m256i dimgLoadPixelAVX2(const ullong* const pix)
+{
+    return _mm256_cvtepu16_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pix)));
+}
+
+DIMG_TARGET_AVX2
+inline __m256i dimgWeightAVX2(const __m256i& values, int weight, int shift)
+{
+    return _mm256_srli_epi64(_mm256_mul_epu32(values, _mm256_set1_epi64x(weight)), shift);
+}
+
+DIMG_TARGET_AVX2
+inline __m256i dimgSumLineAVX2(const ullong* pix, int xap, int Cx)
+{
+    __m256i sum = dimgWeightAVX2(dimgLoadPixelAVX2(pix), xap, 9);
+    ++pix;
+    int i;
+
+    for (i = (1 << 14) - xap ; i > Cx ; i -= Cx)
+    {
+        sum = _mm256_add_epi64(sum, dimgWeightAVX2(dimgLoadPixelAVX2(pix), Cx, 9));
+        ++pix;
+    }
+
+    if (i > 0)
+    {
+        sum = _mm256_add_epi64(sum, dimgWeightAVX2(dimgLoadPixelAVX2(pix), i, 9));
+    }
+
+    return sum;
+}
+
+DIMG_TARGET_AVX2
+void dimgScaleDownAVX2(DImgScaleInfo* const isi, ullong* const dest,
+                       int dyy, int dow, int sow,
+                       int x_begin, int x_end, int y_begin, int y_end, bool alpha)
+{
+    ullong** const ypoints = isi->ypoints16;
+    int* const     xpoints = isi->xpoints;
+    int* const    xapoints = isi->xapoints;
+    int* const    yapoints = isi->yapoints;
+    const __m256i mask     = _mm256_set1_epi64x(0xFFFF);
+    const __m256i lows     = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+
+    for (int y = y_begin ; y < y_end ; ++y)
+    {
+        const int Cy  = YAP >> 16;
+        const int yap = YAP & 0xffff;
+        ullong* dptr  = dest + (y - y_begin) * dow;
+
+        for (int x = x_begin ; x < x_end ; ++x)
+        {
+            const int Cx  = XAP >> 16;
+            const int xap = XAP & 0xffff;
+            ullong* sptr  = ypoints[dyy + y] + xpoints[x];
+            __m256i sum   = dimgWeightAVX2(dimgSumLineAVX2(sptr, xap, Cx), yap, 14);
+            sptr         += sow;
+            int j;
+
+            for (j = (1 << 14) - yap ; j > Cy ; j -= Cy)
+            {
+                sum   = _mm256_add_epi64(sum, dimgWeightAVX2(dimgSumLineAVX2(sptr, xap, Cx), Cy, 14));
+                sptr += sow;
+            }
+
+            if (j > 0)
+            {
+                sum = _mm256_add_epi64(sum, dimgWeightAVX2(dimgSumLineAVX2(sptr, xap, Cx), j, 14));
+            }
+
+            // The plain code stores the low 16 bits of (value >> 5).
+
+            sum                 = _mm256_and_si256(_mm256_srli_epi64(sum, 5), mask);
+            const __m128i words = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(sum, lows));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(dptr), _mm_packus_epi32(words, words));
+
+            if (!alpha)
+            {
+                A_VAL16(dptr) = 0xFFFF;
+            }
+
+            ++dptr;
+        }
+    }
+}
+
+#endif // DIMG_SCALE_SIMD
+
+} // namespace
+
+bool DImgScale::dimgScaleDownAA(DImgScaleInfo* const isi, uint* const dest,
+                                int dyy, int dow, int sow,
+                                int x_begin, int x_end, int y_begin, int y_end, bool alpha)
+{
+
+#if DIMG_SCALE_SIMD
+
+    static const bool hasSSE2 = dimgCpuHasSSE2();
+
+    if (hasSSE2 && s_scaleSimd.loadRelaxed() && isi->ypoints && isi->xpoints)
+    {
+        dimgScaleDownSSE2(isi, dest, dyy, dow, sow, x_begin, x_end, y_begin, y_end, alpha);
+
+        return true;
+    }
+
+#else
+
+    Q_UNUSED(isi);
+    Q_UNUSED(dest);
+    Q_UNUSED(dyy);
+    Q_UNUSED(dow);
+    Q_UNUSED(sow);
+    Q_UNUSED(x_begin);
+    Q_UNUSED(x_end);
+    Q_UNUSED(y_begin);
+    Q_UNUSED(y_end);
+    Q_UNUSED(alpha);
+
+#endif
+
+    return false;
+}
+
+bool DImgScale::dimgScaleDownAA16(DImgScaleInfo* const isi, ullong* const dest,
+                                  int dyy, int dow, int sow,
+                                  int x_begin, int x_end, int y_begin, int y_end, bool alpha)
+{
+
+#if DIMG_SCALE_SIMD
+
+    static const bool hasAVX2 = dimgCpuHasAVX2();
+
+    if (hasAVX2 && s_scaleSimd.loadRelaxed() && isi->ypoints16 && isi->xpoints)
+    {
+        dimgScaleDownAVX2(isi, dest, dyy, dow, sow, x_begin, x_end, y_begin, y_end, alpha);
+
+        return true;
+    }
+
+#else
+
+    Q_UNUSED(isi);
+    Q_UNUSED(dest);
+    Q_UNUSED(dyy);
+    Q_UNUSED(dow);
+    Q_UNUSED(sow);
+    Q_UNUSED(x_begin);
+    Q_UNUSED(x_end);
+    Q_UNUSED(y_begin);
+    Q_UNUSED(y_end);
+    Q_UNUSED(alpha);
+
+#endif
+
+    return false;
+}
+
+void DImgScale::dimgScaleBands(const std::function<void(int, int)>& scaleRows,
+                               int y_begin, int rows, qint64 pixels)
+{
+    // Below one megapixel, or with a few rows per thread, the threads cost more than they save.
+
+    const int threads = s_scaleThreads.loadRelaxed() ? QThreadPool::globalInstance()->maxThreadCount() : 1;
+    const int bands   = qMin(threads, rows / 16);
+
+    if ((bands < 2) || (pixels < 1024 * 1024))
+    {
+        scaleRows(y_begin, rows);
+
+        return;
+    }
+
+    QList<QFuture<void> > tasks;
+
+    for (int band = 1 ; band < bands ; ++band)
+    {
+        const int begin = y_begin + (int)((qint64)rows *  band      / bands);
+        const int end   = y_begin + (int)((qint64)rows * (band + 1) / bands);
+
+        tasks.append(QtConcurrent::run([&scaleRows, begin, end]()
+            {
+                scaleRows(begin, end - begin);
+            }
+        ));
+    }
+
+    // The first band runs in the calling thread, which would only wait otherwise.
+
+    scaleRows(y_begin, rows / bands);
+
+    Q_FOREACH (QFuture<void> t, tasks)
+    {
+        t.waitForFinished();
+    }
+}
+
+void DImg::setSmoothScaleAccelerated(bool simd, bool multithreaded)
+{
+    s_scaleSimd.storeRelaxed(simd ? 1 : 0);
+    s_scaleThreads.storeRelaxed(multithreaded ? 1 : 0);
+}
+
 } // namespace Digikam
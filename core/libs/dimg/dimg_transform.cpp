@@ -31,9 +31,11 @@ void DImg::crop(int x, int y, int w, int h)
         return;
     }
 
-    uint  oldw = width();
-    uint  oldh = height();
-    QScopedArrayPointer<uchar> old(stripImageData());
+    uint  oldw           = width();
+    uint  oldh           = height();
+    const size_t oldSize = m_priv->bufferSize();
+    uchar* const old     = m_priv->data;
+    m_priv->data         = nullptr;
 
     // set new image data, bits(), width(), height() change
 
@@ -42,7 +44,9 @@ void DImg::crop(int x, int y, int w, int h)
 
     // copy image region (x|y), wxh, from old data to point (0|0) of new data
 
-    bitBlt(old.data(), bits(), x, y, w, h, 0, 0, oldw, oldh, width(), height(), sixteenBit(), bytesDepth(), bytesDepth());
+    bitBlt(old, bits(), x, y, w, h, 0, 0, oldw, oldh, width(), height(), sixteenBit(), bytesDepth(), bytesDepth());
+
+    Private::releaseBuffer(old, oldSize);
 }
 
 void DImg::resize(int w, int h)
@@ -52,10 +56,14 @@ void DImg::resize(int w, int h)
         return;
     }
 
-    DImg image   = smoothScale(w, h);
+    DImg image          = smoothScale(w, h);
+
+    // The buffer of the scaled image is kept in the pool.
 
-    delete [] m_priv->data;
-    m_priv->data = image.stripImageData();
+    Private::releaseBuffer(m_priv->data, m_priv->bufferSize());
+    m_priv->data        = image.m_priv->data;
+    image.m_priv->data  = nullptr;
+    image.m_priv->null  = true;
     setImageDimension(w, h);
 }
 
@@ -77,7 +85,7 @@ void DImg::rotate(ANGLE angle)
 
             if (sixteenBit())
             {
-                ullong* newData = DImgLoader::new_failureTolerant<ullong>(w * h);
+                ullong* newData = reinterpret_cast<ullong*>(Private::allocateBuffer((size_t)w * h * 8));
                 ullong* from    = reinterpret_cast<ullong*>(m_priv->data);
                 ullong* to      = nullptr;
 
@@ -94,12 +102,12 @@ void DImg::rotate(ANGLE angle)
 
                 switchDims = true;
 
-                delete [] m_priv->data;
+                Private::releaseBuffer(m_priv->data, m_priv->bufferSize());
                 m_priv->data = (uchar*)newData;
             }
             else
             {
-                uint* newData = DImgLoader::new_failureTolerant<uint>(w * h);
+                uint* newData = reinterpret_cast<uint*>(Private::allocateBuffer((size_t)w * h * 4));
                 uint* from    = reinterpret_cast<uint*>(m_priv->data);
                 uint* to      = nullptr;
 
@@ -116,7 +124,7 @@ void DImg::rotate(ANGLE angle)
 
                 switchDims = true;
 
-                delete [] m_priv->data;
+                Private::releaseBuffer(m_priv->data, m_priv->bufferSize());
                 m_priv->data = (uchar*)newData;
             }
 
@@ -209,7 +217,7 @@ void DImg::rotate(ANGLE angle)
 
             if (sixteenBit())
             {
-                ullong* newData = DImgLoader::new_failureTolerant<ullong>(w * h);
+                ullong* newData = reinterpret_cast<ullong*>(Private::allocateBuffer((size_t)w * h * 8));
                 ullong* from    = reinterpret_cast<ullong*>(m_priv->data);
                 ullong* to      = nullptr;
 
@@ -226,12 +234,12 @@ void DImg::rotate(ANGLE angle)
 
                 switchDims = true;
 
-                delete [] m_priv->data;
+                Private::releaseBuffer(m_priv->data, m_priv->bufferSize());
                 m_priv->data = (uchar*)newData;
             }
             else
             {
-                uint* newData = DImgLoader::new_failureTolerant<uint>(w * h);
+                uint* newData = reinterpret_cast<uint*>(Private::allocateBuffer((size_t)w * h * 4));
                 uint* from    = reinterpret_cast<uint*>(m_priv->data);
                 uint* to      = nullptr;
 
@@ -248,7 +256,7 @@ void DImg::rotate(ANGLE angle)
 
                 switchDims = true;
 
-                delete [] m_priv->data;
+                Private::releaseBuffer(m_priv->data, m_priv->bufferSize());
                 m_priv->data = (uchar*)newData;
             }
 
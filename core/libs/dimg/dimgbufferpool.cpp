@@ -0,0 +1,351 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-17
+ * Description : Pool of the pixel buffers of DImg
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "dimgbufferpool.h"
+
+// C++ includes
+
+#include <new>
+
+// Qt includes
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+
+#ifdef Q_OS_LINUX
+#   include <sys/mman.h>
+#   include <unistd.h>
+#endif
+
+// KDE includes
+
+#include <kmemoryinfo.h>
+
+// Local includes
+
+#include "digikam_debug.h"
+
+namespace Digikam
+{
+
+class Q_DECL_HIDDEN DImgBufferPool::Private
+{
+public:
+
+    Private() = default;
+
+    /**
+     * The size class of a buffer: size rounded to 1/8 of its highest power of two.
+     * A request is rounded up, a buffer of the given capacity is rounded down.
+     */
+    static size_t sizeClass(size_t size, bool roundUp)
+    {
+        size_t power = 1;
+
+        while ((power << 1) <= size)
+        {
+            power <<= 1;
+        }
+
+        const size_t step = qMax((size_t)1, power / 8);
+
+        return (roundUp ? (((size + step - 1) / step) * step)
+                        : ((size / step) * step));
+    }
+
+    void adviseHugePages(uchar* const data, size_t size) const;
+    void cache(uchar* const data, size_t capacity);
+    void evict(quint64 maximum);
+
+public:
+
+    mutable QMutex                    mutex;
+
+    bool                              hugePages         = false;
+    quint64                           maximumCached     = 0;
+    size_t                            minimumSize       = 256 * 1024;
+
+    QHash<uchar*, size_t>             capacities;       ///< The buffers managed by the pool, with their size.
+    QHash<size_t, QList<uchar*> >     freeBuffers;      ///< The cached buffers by size class.
+    QList<uchar*>                     releaseOrder;     ///< The cached buffers, the least recently released first.
+
+    Statistics                        stats;
+};
+
+void DImgBufferPool::Private::adviseHugePages(uchar* const data, size_t size) const
+{
+
+#if defined(Q_OS_LINUX) && defined(MADV_HUGEPAGE)
+
+    if (!hugePages)
+    {
+        return;
+    }
+
+    // Only the whole pages inside the buffer.
+
+    const quintptr page  = (quintptr)sysconf(_SC_PAGESIZE);
+    const quintptr begin = ((quintptr)data + page - 1) & ~(page - 1);
+    const quintptr end   = ((quintptr)data + size)     & ~(page - 1);
+
+    if (end > begin)
+    {
+        madvise((void*)begin, end - begin, MADV_HUGEPAGE);
+    }
+
+#else
+
+    Q_UNUSED(data);
+    Q_UNUSED(size);
+
+#endif
+
+}
+
+void DImgBufferPool::Private::cache(uchar* const data, size_t capacity)
+{
+    freeBuffers[sizeClass(capacity, false)] << data;
+    releaseOrder << data;
+
+    stats.cachedBuffers++;
+    stats.cachedBytes += capacity;
+}
+
+void DImgBufferPool::Private::evict(quint64 maximum)
+{
+    while (!releaseOrder.isEmpty() && (stats.cachedBytes > maximum))
+    {
+        uchar* const data     = releaseOrder.takeFirst();
+        const size_t capacity = capacities.take(data);
+
+        freeBuffers[sizeClass(capacity, false)].removeOne(data);
+
+        stats.cachedBuffers--;
+        stats.cachedBytes -= capacity;
+        stats.evictions++;
+
+        delete [] data;
+    }
+}
+
+// -----------------------------------------------------------------------------------------------
+
+class Q_DECL_HIDDEN DImgBufferPoolCreator
+{
+public:
+
+    DImgBufferPool object;
+};
+
+Q_GLOBAL_STATIC(DImgBufferPoolCreator, creator)
+
+DImgBufferPool* DImgBufferPool::instance()
+{
+    // The images destroyed after the pool at exit free their buffers directly.
+
+    if (creator.isDestroyed())
+    {
+        return nullptr;
+    }
+
+    return &creator->object;
+}
+
+DImgBufferPool::DImgBufferPool()
+    : d(new Private)
+{
+    KMemoryInfo memInfo;
+    setCacheSize(memInfo.isNull() ? 256
+                                  : qBound(64, (int)(memInfo.totalPhysical() / 1024.0 / 1024.0 * 0.03), 1024));
+}
+
+DImgBufferPool::~DImgBufferPool()
+{
+    clear();
+
+    // The buffers still used by images are freed with delete[].
+
+    delete d;
+}
+
+uchar* DImgBufferPool::allocate(size_t size)
+{
+    QMutexLocker lock(&d->mutex);
+
+    if ((d->maximumCached == 0) || (size < d->minimumSize))
+    {
+        lock.unlock();
+
+        return (new (std::nothrow) uchar[size]);
+    }
+
+    const size_t sizeClass = Private::sizeClass(size, true);
+    d->stats.requests++;
+
+    QHash<size_t, QList<uchar*> >::iterator it = d->freeBuffers.find(sizeClass);
+
+    if ((it != d->freeBuffers.end()) && !it->isEmpty())
+    {
+        // The most recently released buffer, the most likely to be still in the CPU caches.
+
+        uchar* const data     = it->takeLast();
+        const size_t capacity = d->capacities.value(data);
+
+        d->releaseOrder.removeOne(data);
+
+        d->stats.reuses++;
+        d->stats.cachedBuffers--;
+        d->stats.cachedBytes -= capacity;
+        d->stats.usedBytes   += capacity;
+
+        return data;
+    }
+
+    uchar* data = new (std::nothrow) uchar[sizeClass];
+
+    if (!data && !d->releaseOrder.isEmpty())
+    {
+        // The cached buffers can be in the way.
+
+        d->evict(0);
+        data = new (std::nothrow) uchar[sizeClass];
+    }
+
+    if (!data)
+    {
+        return nullptr;
+    }
+
+    d->adviseHugePages(data, sizeClass);
+    d->capacities.insert(data, sizeClass);
+
+    d->stats.usedBytes += sizeClass;
+    d->stats.peakBytes  = qMax(d->stats.peakBytes, d->stats.usedBytes + d->stats.cachedBytes);
+
+    return data;
+}
+
+void DImgBufferPool::release(uchar* const data, size_t size)
+{
+    if (!data)
+    {
+        return;
+    }
+
+    QMutexLocker lock(&d->mutex);
+
+    QHash<uchar*, size_t>::iterator it = d->capacities.find(data);
+    size_t capacity                    = size;
+
+    if (it != d->capacities.end())
+    {
+        capacity            = it.value();
+        d->stats.usedBytes -= capacity;
+    }
+    else
+    {
+        if ((d->maximumCached == 0) || (size < d->minimumSize))
+        {
+            lock.unlock();
+            delete [] data;
+
+            return;
+        }
+
+        // Allocated by a loader with new[], the buffer can serve the next requests too.
+
+        d->capacities.insert(data, capacity);
+        d->stats.adoptions++;
+    }
+
+    if (capacity > d->maximumCached)
+    {
+        d->capacities.remove(data);
+        lock.unlock();
+        delete [] data;
+
+        return;
+    }
+
+    d->cache(data, capacity);
+    d->evict(d->maximumCached);
+    d->stats.peakBytes = qMax(d->stats.peakBytes, d->stats.usedBytes + d->stats.cachedBytes);
+}
+
+void DImgBufferPool::take(uchar* const data)
+{
+    if (!data)
+    {
+        return;
+    }
+
+    QMutexLocker lock(&d->mutex);
+
+    QHash<uchar*, size_t>::iterator it = d->capacities.find(data);
+
+    if (it != d->capacities.end())
+    {
+        d->stats.usedBytes -= it.value();
+        d->capacities.erase(it);
+    }
+}
+
+void DImgBufferPool::setCacheSize(int megabytes)
+{
+    QMutexLocker lock(&d->mutex);
+
+    d->maximumCached = (quint64)qMax(0, megabytes) * 1024 * 1024;
+    d->evict(d->maximumCached);
+
+    qCDebug(DIGIKAM_DIMG_LOG) << "DImg buffer pool size:" << megabytes << "MB";
+}
+
+int DImgBufferPool::cacheSize() const
+{
+    QMutexLocker lock(&d->mutex);
+
+    return (int)(d->maximumCached / 1024 / 1024);
+}
+
+void DImgBufferPool::setMinimumBufferSize(size_t bytes)
+{
+    QMutexLocker lock(&d->mutex);
+
+    d->minimumSize = bytes;
+}
+
+void DImgBufferPool::setHugePages(bool enable)
+{
+    QMutexLocker lock(&d->mutex);
+
+    d->hugePages = enable;
+}
+
+void DImgBufferPool::clear()
+{
+    QMutexLocker lock(&d->mutex);
+
+    d->evict(0);
+}
+
+DImgBufferPool::Statistics DImgBufferPool::statistics() const
+{
+    QMutexLocker lock(&d->mutex);
+
+    return d->stats;
+}
+
+} // namespace Digikam
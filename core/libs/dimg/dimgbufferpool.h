@@ -0,0 +1,128 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-17
+ * Description : Pool of the pixel buffers of DImg
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#pragma once
+
+// Qt includes
+
+#include <QtGlobal>
+
+// Local includes
+
+#include "digikam_export.h"
+
+namespace Digikam
+{
+
+/**
+ * Keeps the large pixel buffers released by DImg to reuse them for the next images of about
+ * the same size, instead of returning them to the heap. This avoids the fragmentation of the
+ * heap by the batch processing and the filters, which allocate and free many full size images.
+ *
+ * The buffers are sorted in size classes, 8 for each power of two: a buffer is at most 12.5%
+ * larger than the requested size. The memory of the cached buffers is capped, the least recently
+ * released buffers are freed first. All buffers are allocated with new[]: the ownership of a
+ * buffer can be given to code which frees it with delete[], after calling take().
+ */
+class DIGIKAM_EXPORT DImgBufferPool
+{
+public:
+
+    class Statistics
+    {
+    public:
+
+        Statistics() = default;
+
+        /**
+         * The part of the requests served by a cached buffer.
+         */
+        double reuseRate() const
+        {
+            return (requests ? ((double)reuses / (double)requests) : 0.0);
+        }
+
+    public:
+
+        quint64 requests        = 0;    ///< Allocations of pooled sizes.
+        quint64 reuses          = 0;    ///< Requests served by a cached buffer.
+        quint64 adoptions       = 0;    ///< Buffers not allocated by the pool, cached when released.
+        quint64 evictions       = 0;    ///< Cached buffers freed to respect the cap.
+        quint64 cachedBuffers   = 0;
+        quint64 cachedBytes     = 0;
+        quint64 usedBytes       = 0;    ///< Pooled buffers currently used by images.
+        quint64 peakBytes       = 0;    ///< Maximum of usedBytes + cachedBytes.
+    };
+
+public:
+
+    static DImgBufferPool* instance();
+
+    /**
+     * Return a buffer of at least size bytes, or nullptr if the memory cannot be allocated.
+     */
+    uchar*     allocate(size_t size);
+
+    /**
+     * Give back a buffer of size bytes, allocated by allocate() or with new[].
+     */
+    void       release(uchar* const data, size_t size);
+
+    /**
+     * The buffer is not managed by the pool anymore, it will be freed with delete[].
+     */
+    void       take(uchar* const data);
+
+    /**
+     * Maximum memory of the cached buffers, in megabytes. 0 disables the pool.
+     * The default is 3% of the physical memory, between 64 and 1024 MB.
+     */
+    void       setCacheSize(int megabytes);
+    int        cacheSize()                                const;
+
+    /**
+     * The smaller buffers are allocated and freed directly. Default is 256 KB.
+     */
+    void       setMinimumBufferSize(size_t bytes);
+
+    /**
+     * On Linux, ask the kernel to back the new buffers with transparent huge pages.
+     */
+    void       setHugePages(bool enable);
+
+    /**
+     * Free all cached buffers.
+     */
+    void       clear();
+
+    Statistics statistics()                               const;
+
+private:
+
+    DImgBufferPool();
+    ~DImgBufferPool();
+
+    // Disable
+    DImgBufferPool(const DImgBufferPool&)            = delete;
+    DImgBufferPool& operator=(const DImgBufferPool&) = delete;
+
+private:
+
+    class Private;
+    Private* const d = nullptr;
+
+    friend class DImgBufferPoolCreator;
+};
+
+} // namespace Digikam
@@ -0,0 +1,121 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-17
+ * Description : OpenCV matrix sharing the pixel data of a DImg
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "dimgmatview.h"
+
+namespace Digikam
+{
+
+namespace
+{
+
+/**
+ * Reduce the 16 bits BGRA rows to 8 bits 3 channels rows.
+ */
+class Q_DECL_HIDDEN SixteenBitReducer : public cv::ParallelLoopBody
+{
+public:
+
+    SixteenBitReducer(const cv::Mat& src, cv::Mat& dst, DImgMatView::ChannelOrder order)
+        : m_src  (src),
+          m_dst  (dst),
+          m_red  ((order == DImgMatView::RGB) ? 0 : 2),
+          m_blue ((order == DImgMatView::RGB) ? 2 : 0)
+    {
+    }
+
+    void operator()(const cv::Range& range) const override
+    {
+        for (int y = range.start ; y < range.end ; ++y)
+        {
+            const ushort* src = m_src.ptr<ushort>(y);
+            uchar* dst        = m_dst.ptr<uchar>(y);
+
+            for (int x = 0 ; x < m_src.cols ; ++x)
+            {
+                dst[m_blue] = (uchar)qMin(255, (src[0] + 128) >> 8);
+                dst[1]      = (uchar)qMin(255, (src[1] + 128) >> 8);
+                dst[m_red]  = (uchar)qMin(255, (src[2] + 128) >> 8);
+
+                src        += 4;
+                dst        += 3;
+            }
+        }
+    }
+
+private:
+
+    const cv::Mat& m_src;
+    cv::Mat&       m_dst;
+    const int      m_red;
+    const int      m_blue;
+};
+
+} // namespace
+
+DImgMatView::DImgMatView(const DImg& image)
+    : m_image(image)
+{
+    if (!m_image.isNull())
+    {
+        m_mat = cv::Mat(m_image.height(), m_image.width(),
+                        m_image.sixteenBit() ? CV_16UC4 : CV_8UC4,
+                        m_image.bits());
+    }
+}
+
+DImgMatView::~DImgMatView()
+{
+}
+
+bool DImgMatView::isNull() const
+{
+    return m_mat.empty();
+}
+
+const DImg& DImgMatView::image() const
+{
+    return m_image;
+}
+
+const cv::Mat& DImgMatView::mat() const
+{
+    return m_mat;
+}
+
+cv::Mat DImgMatView::toEightBitThreeChannels(ChannelOrder order) const
+{
+    cv::Mat result;
+
+    if (m_mat.empty())
+    {
+        return result;
+    }
+
+    if (m_mat.depth() == CV_8U)
+    {
+        cv::cvtColor(m_mat, result, (order == RGB) ? cv::COLOR_BGRA2RGB : cv::COLOR_BGRA2BGR);
+    }
+    else
+    {
+        // cvtColor() then convertTo() would write two full size matrices.
+
+        result.create(m_mat.rows, m_mat.cols, CV_8UC3);
+        cv::parallel_for_(cv::Range(0, m_mat.rows), SixteenBitReducer(m_mat, result, order));
+    }
+
+    return result;
+}
+
+} // namespace Digikam
@@ -0,0 +1,74 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-17
+ * Description : OpenCV matrix sharing the pixel data of a DImg
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#pragma once
+
+// Local includes
+
+#include "digikam_opencv.h"
+#include "digikam_export.h"
+#include "dimg.h"
+
+namespace Digikam
+{
+
+/**
+ * A cv::Mat header over the pixels of a DImg, without copy. The DImg layout is the one of OpenCV:
+ * 4 interleaved channels in Blue, Green, Red, Alpha order, CV_8UC4 or CV_16UC4.
+ * The view keeps a reference on the image, the pixel data stay valid while it exists,
+ * as long as the image is not changed in place (by convertDepth(), crop(), resize()...).
+ */
+class DIGIKAM_EXPORT DImgMatView
+{
+public:
+
+    enum ChannelOrder
+    {
+        BGR = 0,    ///< The OpenCV order.
+        RGB
+    };
+
+public:
+
+    explicit DImgMatView(const DImg& image);
+    ~DImgMatView();
+
+    bool           isNull()                                            const;
+    const DImg&    image()                                             const;
+
+    /**
+     * The matrix sharing the pixels of the image, empty if the image is null.
+     */
+    const cv::Mat& mat()                                               const;
+
+    /**
+     * Return a 3 channels 8 bits matrix, as expected by the detectors and the DNN models.
+     * The alpha channel is dropped, the channels are reordered and the 16 bits samples are
+     * reduced in a single pass over the pixels.
+     */
+    cv::Mat        toEightBitThreeChannels(ChannelOrder order = BGR)   const;
+
+private:
+
+    // Disable
+    DImgMatView(const DImgMatView&)            = delete;
+    DImgMatView& operator=(const DImgMatView&) = delete;
+
+private:
+
+    DImg    m_image;        ///< Shallow copy, holding the pixel data.
+    cv::Mat m_mat;
+};
+
+} // namespace Digikam
@@ -20,8 +20,17 @@
 // Qt includes
 
 #include <QFile>
+#include <QList>
+#include <QPair>
+#include <QColor>
+#include <QMutex>
 #include <QImage>
+#include <QThread>
+#include <QFuture>
+#include <QMutexLocker>
+#include <QSharedPointer>
 #include <QVarLengthArray>
+#include <QtConcurrent>    // krazy:exclude=includes
 
 // KDE includes
 
@@ -51,7 +60,8 @@ public:
                 (intent         == other.intent)         &&
                 (transformFlags == other.transformFlags) &&
                 (proofProfile   == other.proofProfile)   &&
-                (proofIntent    == other.proofIntent)
+                (proofIntent    == other.proofIntent)    &&
+                (alarmColor     == other.alarmColor)
                );
     }
 
@@ -65,8 +75,190 @@ public:
     int        transformFlags   = 0;
     IccProfile proofProfile;
     int        proofIntent      = INTENT_ABSOLUTE_COLORIMETRIC;
+    QColor     alarmColor;                                          ///< Set when checking the gamut.
 };
 
+// --------------------------------------------------------------------------------------------
+
+/**
+ * A compiled LittleCMS transform, shared by the IccTransform instances using the same description.
+ */
+class Q_DECL_HIDDEN IccTransformHandle
+{
+public:
+
+    explicit IccTransformHandle(cmsHTRANSFORM handle)
+        : handle(handle)
+    {
+    }
+
+    ~IccTransformHandle()
+    {
+        LcmsLock lock;
+        dkCmsDeleteTransform(handle);
+    }
+
+public:
+
+    cmsHTRANSFORM handle = nullptr;
+
+private:
+
+    // Disable
+    IccTransformHandle(const IccTransformHandle&)            = delete;
+    IccTransformHandle& operator=(const IccTransformHandle&) = delete;
+};
+
+typedef QSharedPointer<IccTransformHandle> IccTransformHandlePtr;
+
+/**
+ * The recently used compiled transforms. The same conversions are applied to many images,
+ * to the working space when loading or to the monitor profile when displaying, and compiling
+ * a transform costs more than applying it to a preview.
+ */
+class Q_DECL_HIDDEN IccTransformCache
+{
+public:
+
+    IccTransformCache() = default;
+
+    IccTransformHandlePtr find(const TransformDescription& description)
+    {
+        QMutexLocker lock(&mutex);
+
+        for (int i = 0 ; i < entries.size() ; ++i)
+        {
+            if (entries.at(i).first == description)
+            {
+                // Most recently used last.
+
+                entries.move(i, entries.size() - 1);
+
+                return entries.last().second;
+            }
+        }
+
+        return IccTransformHandlePtr();
+    }
+
+    void insert(const TransformDescription& description, const IccTransformHandlePtr& handle)
+    {
+        IccTransformHandlePtr evicted;
+
+        {
+            QMutexLocker lock(&mutex);
+
+            if (entries.size() >= maxEntries)
+            {
+                evicted = entries.takeFirst().second;
+            }
+
+            entries << qMakePair(description, handle);
+        }
+
+        // The transform is deleted here if no IccTransform uses it, outside of the cache mutex.
+    }
+
+public:
+
+    static const int                                          maxEntries = 8;
+
+    QMutex                                                    mutex;
+    QList<QPair<TransformDescription, IccTransformHandlePtr> > entries;
+};
+
+Q_GLOBAL_STATIC(IccTransformCache, iccTransformCache)
+
+// --------------------------------------------------------------------------------------------
+
+/**
+ * Apply the transform to rows of pixels, ten scanlines in a batch.
+ * If inPlace is false, the input and output formats differ and each batch is copied first.
+ */
+static void transformRows(cmsHTRANSFORM handle, uchar* data, int width, int rows,
+                          int bytesDepth, bool inPlace, DImgLoaderObserver* const observer)
+{
+    const qint64 pixels        = (qint64)width * rows;
+    const qint64 pixelsPerStep = (qint64)width * 10;
+
+    // see dimgloader.cpp, granularity().
+
+    qint64 granularity         = 1;
+
+    if (observer)
+    {
+        granularity = qMax((qint64)1, (qint64)((pixels / (20 * 0.9)) / observer->granularity()));
+    }
+
+    qint64 checkPoint          = pixels;
+    QVarLengthArray<uchar> buffer(inPlace ? 0 : pixelsPerStep * bytesDepth);
+
+    for (qint64 p = pixels ; p > 0 ; p -= pixelsPerStep)
+    {
+        const qint64 pixelsThisStep = qMin(p, pixelsPerStep);
+        const qint64 size           = pixelsThisStep * bytesDepth;
+
+        if (inPlace)
+        {
+            dkCmsDoTransform(handle, data, data, pixelsThisStep);
+        }
+        else
+        {
+            memcpy(buffer.data(), data, size);
+            dkCmsDoTransform(handle, buffer.data(), data, pixelsThisStep);
+        }
+
+        data                       += size;
+
+        if (observer && (p <= checkPoint))
+        {
+            checkPoint -= granularity;
+            observer->progressInfo(0.1F + 0.9F * (1.0F - float(p) / float(pixels)));
+        }
+    }
+}
+
+/**
+ * Apply the transform to the image in bands of rows run in parallel. The transforms are created
+ * with cmsFLAGS_NOCACHE, they have no state changed by cmsDoTransform() and can be used by several
+ * threads at once. The first band runs in the calling thread, which reports the progress.
+ */
+static void transformImage(cmsHTRANSFORM handle, uchar* const data, int width, int height,
+                           int bytesDepth, bool inPlace, DImgLoaderObserver* const observer)
+{
+    const int minBandRows = 16;
+    int bands             = 1;
+
+    if (((qint64)width * height) >= (256 * 1024))
+    {
+        bands = qBound(1, QThread::idealThreadCount(), height / minBandRows);
+    }
+
+    const int bandRows    = (height + bands - 1) / bands;
+    QList<QFuture<void> > tasks;
+
+    for (int y = bandRows ; y < height ; y += bandRows)
+    {
+        uchar* const bandData = data + (qint64)y * width * bytesDepth;
+        const int rows        = qMin(bandRows, height - y);
+
+        tasks.append(QtConcurrent::run([=]()
+            {
+                transformRows(handle, bandData, width, rows, bytesDepth, inPlace, nullptr);
+            }
+        ));
+    }
+
+    transformRows(handle, data, width, qMin(bandRows, height), bytesDepth, inPlace, observer);
+
+    Q_FOREACH (QFuture<void> t, tasks)
+    {
+        t.waitForFinished();
+    }
+}
+
+// --------------------------------------------------------------------------------------------
+
 class Q_DECL_HIDDEN IccTransform::Private : public QSharedData
 {
 public:
@@ -98,8 +290,6 @@ public:
         builtinProfile     = other.builtinProfile;
 
         close();
-        handle             = nullptr;
-        currentDescription = TransformDescription();
 
         return *this;
     }
@@ -111,13 +301,10 @@ public:
 
     void close()
     {
-        if (handle)
-        {
-            currentDescription = TransformDescription();
-            LcmsLock lock;
-            dkCmsDeleteTransform(handle);
-            handle             = nullptr;
-        }
+        // The compiled transform stays in the cache for the next images.
+
+        currentDescription = TransformDescription();
+        handle.clear();
     }
 
     IccProfile& sRGB()
@@ -177,7 +364,7 @@ public:
     IccProfile                    proofProfile;
     IccProfile                    builtinProfile;
 
-    cmsHTRANSFORM                 handle            = nullptr;
+    IccTransformHandlePtr         handle;
     TransformDescription          currentDescription;
 };
 
@@ -418,9 +605,13 @@ TransformDescription IccTransform::getDescription(const DImg& image)
 {
     TransformDescription description;
 
-    description.inputProfile  = d->effectiveInputProfile();
-    description.outputProfile = d->outputProfile;
-    description.intent        = renderingIntentToLcmsIntent(d->intent);
+    description.inputProfile   = d->effectiveInputProfile();
+    description.outputProfile  = d->outputProfile;
+    description.intent         = renderingIntentToLcmsIntent(d->intent);
+
+    // Without the cache of the last pixel, the transform can be applied by several threads.
+
+    description.transformFlags = cmsFLAGS_NOCACHE;
 
     if (d->useBPC)
     {
@@ -474,9 +665,10 @@ TransformDescription IccTransform::getDescription(const QImage&)
 {
     TransformDescription description;
 
-    description.inputProfile  = d->effectiveInputProfile();
-    description.outputProfile = d->outputProfile;
-    description.intent        = renderingIntentToLcmsIntent(d->intent);
+    description.inputProfile   = d->effectiveInputProfile();
+    description.outputProfile  = d->outputProfile;
+    description.intent         = renderingIntentToLcmsIntent(d->intent);
+    description.transformFlags = cmsFLAGS_NOCACHE;
 
     if (d->useBPC)
     {
@@ -502,6 +694,7 @@ TransformDescription IccTransform::getProofingDescription(const DImg& image)
     {
         dkCmsSetAlarmCodes(d->checkGamutColor.red(), d->checkGamutColor.green(), d->checkGamutColor.blue());
         description.transformFlags |= cmsFLAGS_GAMUTCHECK;
+        description.alarmColor      = d->checkGamutColor;
     }
 
     return description;
@@ -522,21 +715,35 @@ bool IccTransform::open(TransformDescription& description)
     }
 
     d->currentDescription = description;
+    d->handle             = iccTransformCache->find(description);
 
-    LcmsLock lock;
-    d->handle = dkCmsCreateTransform(description.inputProfile,
-                                     description.inputFormat,
-                                     description.outputProfile,
-                                     description.outputFormat,
-                                     description.intent,
-                                     description.transformFlags);
+    if (d->handle)
+    {
+        return true;
+    }
+
+    cmsHTRANSFORM handle  = nullptr;
 
-    if (!d->handle)
+    {
+        LcmsLock lock;
+        handle = dkCmsCreateTransform(description.inputProfile,
+                                      description.inputFormat,
+                                      description.outputProfile,
+                                      description.outputFormat,
+                                      description.intent,
+                                      description.transformFlags);
+    }
+
+    if (!handle)
     {
         qCDebug(DIGIKAM_DIMG_LOG) << "LCMS internal error: cannot create a color transform instance";
+        d->currentDescription = TransformDescription();
         return false;
     }
 
+    d->handle = IccTransformHandlePtr(new IccTransformHandle(handle));
+    iccTransformCache->insert(description, d->handle);
+
     return true;
 }
 
@@ -555,23 +762,37 @@ bool IccTransform::openProofing(TransformDescription& description)
     }
 
     d->currentDescription = description;
+    d->handle             = iccTransformCache->find(description);
 
-    LcmsLock lock;
-    d->handle = dkCmsCreateProofingTransform(description.inputProfile,
-                                             description.inputFormat,
-                                             description.outputProfile,
-                                             description.outputFormat,
-                                             description.proofProfile,
-                                             description.intent,
-                                             description.proofIntent,
-                                             description.transformFlags);
+    if (d->handle)
+    {
+        return true;
+    }
+
+    cmsHTRANSFORM handle  = nullptr;
 
-    if (!d->handle)
+    {
+        LcmsLock lock;
+        handle = dkCmsCreateProofingTransform(description.inputProfile,
+                                              description.inputFormat,
+                                              description.outputProfile,
+                                              description.outputFormat,
+                                              description.proofProfile,
+                                              description.intent,
+                                              description.proofIntent,
+                                              description.transformFlags);
+    }
+
+    if (!handle)
     {
         qCDebug(DIGIKAM_DIMG_LOG) << "LCMS internal error: cannot create a color transform instance";
+        d->currentDescription = TransformDescription();
         return false;
     }
 
+    d->handle = IccTransformHandlePtr(new IccTransformHandle(handle));
+    iccTransformCache->insert(description, d->handle);
+
     return true;
 }
 
@@ -695,84 +916,15 @@ bool IccTransform::apply(QImage& qimage)
 
 void IccTransform::transform(DImg& image, const TransformDescription& description, DImgLoaderObserver* const observer)
 {
-    const int bytesDepth    = image.bytesDepth();
-    const int pixels        = image.width() * image.height();
-
-    // convert ten scanlines in a batch
-
-    const int pixelsPerStep = image.width() * 10;
-    uchar* data             = image.bits();
-
-    // see dimgloader.cpp, granularity().
-
-    int granularity         = 1;
-
-    if (observer)
-    {
-        granularity = (int)((pixels / (20 * 0.9)) / observer->granularity());
-    }
-
-    int checkPoint = pixels;
-
     // it is safe to use the same input and output buffer if the format is the same
 
-    if (description.inputFormat == description.outputFormat)
-    {
-        for (int p = pixels ; p > 0 ; p -= pixelsPerStep)
-        {
-            int pixelsThisStep =  qMin(p, pixelsPerStep);
-            int size           =  pixelsThisStep * bytesDepth;
-            LcmsLock lock;
-            dkCmsDoTransform(d->handle, data, data, pixelsThisStep);
-            data               += size;
-
-            if (observer && (p <= checkPoint))
-            {
-                checkPoint -= granularity;
-                observer->progressInfo(0.1F + 0.9F * (1.0F - float(p) / float(pixels)));
-            }
-        }
-    }
-    else
-    {
-        QVarLengthArray<uchar> buffer(pixelsPerStep * bytesDepth);
-
-        for (int p = pixels ; p > 0 ; p -= pixelsPerStep)
-        {
-            int pixelsThisStep  = qMin(p, pixelsPerStep);
-            int size            = pixelsThisStep * bytesDepth;
-            LcmsLock lock;
-            memcpy(buffer.data(), data, size);
-            dkCmsDoTransform(d->handle, buffer.data(), data, pixelsThisStep);
-            data               += size;
-
-            if (observer && (p <= checkPoint))
-            {
-                checkPoint -= granularity;
-                observer->progressInfo(0.1F + 0.9F * (1.0F - float(p) / float(pixels)));
-            }
-        }
-    }
+    transformImage(d->handle->handle, image.bits(), image.width(), image.height(), image.bytesDepth(),
+                   (description.inputFormat == description.outputFormat), observer);
 }
 
 void IccTransform::transform(QImage& image, const TransformDescription&)
 {
-    const int bytesDepth    = 4;
-    const int pixels        = image.width() * image.height();
-
-    // convert ten scanlines in a batch
-
-    const int pixelsPerStep = image.width() * 10;
-    uchar* data             = image.bits();
-
-    for (int p = pixels ; p > 0 ; p -= pixelsPerStep)
-    {
-        int pixelsThisStep =  qMin(p, pixelsPerStep);
-        int size           =  pixelsThisStep * bytesDepth;
-        LcmsLock lock;
-        dkCmsDoTransform(d->handle, data, data, pixelsThisStep);
-        data               += size;
-    }
+    transformImage(d->handle->handle, image.bits(), image.width(), image.height(), 4, true, nullptr);
 }
 
 void IccTransform::close()
@@ -74,6 +74,26 @@ int DImgLoader::granularity(DImgLoaderObserver* const observer, int total, float
     return (granularity ? granularity : 1);
 }
 
+int DImgLoader::scaledLoadingFactor(uint width, uint height) const
+{
+    const int scaledLoadingSize = imageGetAttribute(QLatin1String("scaledLoadingSize")).toInt();
+
+    if ((scaledLoadingSize <= 0) || !(m_loadFlags & LoadImageData))
+    {
+        return 1;
+    }
+
+    const quint64 size = qMax(width, height);
+    int factor         = 1;
+
+    while ((factor < 128) && (((quint64)scaledLoadingSize * factor * 2) <= size))
+    {
+        factor *= 2;
+    }
+
+    return factor;
+}
+
 unsigned char*& DImgLoader::imageData()
 {
     return m_image->m_priv->data;
@@ -148,7 +168,7 @@ void DImgLoader::loadingFailed()
 {
     if (m_image->m_priv->data)
     {
-        delete [] m_image->m_priv->data;
+        DImg::Private::releaseBuffer(m_image->m_priv->data, m_image->m_priv->bufferSize());
     }
 
     m_image->m_priv->data   = nullptr;
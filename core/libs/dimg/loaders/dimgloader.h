@@ -132,6 +132,14 @@ protected:
     virtual bool            saveMetadata(const QString& filePath);
     virtual int             granularity(DImgLoaderObserver* const observer, int total, float progressSlice = 1.0F);
 
+    /**
+     * Return the power of two reduction factor to apply to an image of size width x height
+     * when the "scaledLoadingSize" attribute is set by the thumbnail and preview loading,
+     * or 1 for a full size loading. The largest side of the reduced image is not smaller
+     * than the requested size, as with the scaled decoding of the JPEG loader.
+     */
+    int                     scaledLoadingFactor(uint width, uint height)           const;
+
 protected:
 
     DImg*     m_image       = nullptr;
@@ -0,0 +1,175 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-17
+ * Description : reduce image data while it is decoded, for the scaled loading
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "dimgloaderdecimator.h"
+
+// Qt includes
+
+#include <QVector>
+
+// Local includes
+
+#include "dimgloader.h"
+
+namespace Digikam
+{
+
+class Q_DECL_HIDDEN DImgLoaderDecimator::Private
+{
+public:
+
+    Private() = default;
+
+    /**
+     * Write the average of the accumulated rows as one row of the reduced image.
+     */
+    template <typename Type>
+    void flush()
+    {
+        Type* dst = reinterpret_cast<Type*>(data) + (quint64)outRow * outWidth * 4;
+
+        for (uint x = 0 ; x < outWidth ; ++x)
+        {
+            const quint32 columns = qMin((uint)factor, width - x * factor);
+            const quint32 count   = columns * blockRows;
+
+            for (int c = 0 ; c < 4 ; ++c)
+            {
+                quint32& sum = sums[x * 4 + c];
+                *dst++       = (Type)((sum + count / 2) / count);
+                sum          = 0;
+            }
+        }
+
+        ++outRow;
+        blockRows = 0;
+    }
+
+    template <typename Type>
+    void addRow(const Type* src)
+    {
+        quint32* sum = sums.data();
+
+        for (uint x = 0 ; x < width ; )
+        {
+            const uint end = qMin(x + factor, width);
+
+            for ( ; x < end ; ++x)
+            {
+                sum[0] += src[0];
+                sum[1] += src[1];
+                sum[2] += src[2];
+                sum[3] += src[3];
+                src    += 4;
+            }
+
+            sum += 4;
+        }
+
+        ++blockRows;
+        ++row;
+
+        if ((blockRows == (uint)factor) || (row == height))
+        {
+            flush<Type>();
+        }
+    }
+
+public:
+
+    uint             width      = 0;
+    uint             height     = 0;
+    bool             sixteenBit = false;
+    int              factor     = 1;
+
+    uint             outWidth   = 0;
+    uint             outHeight  = 0;
+    uint             outRow     = 0;
+
+    uint             row        = 0;        ///< Next row of the full size image.
+    uint             blockRows  = 0;        ///< Rows accumulated in sums.
+
+    /**
+     * Sums of the channels of each reduced pixel on the current block of rows.
+     * The factor is limited to 128: 65535 * 128 * 128 fits in 32 bits.
+     */
+    QVector<quint32> sums;
+    uchar*           data       = nullptr;
+};
+
+DImgLoaderDecimator::DImgLoaderDecimator(uint width, uint height, bool sixteenBit, int factor)
+    : d(new Private)
+{
+    d->width      = width;
+    d->height     = height;
+    d->sixteenBit = sixteenBit;
+    d->factor     = qBound(1, factor, 128);
+    d->outWidth   = (width  + d->factor - 1) / d->factor;
+    d->outHeight  = (height + d->factor - 1) / d->factor;
+    d->data       = DImgLoader::new_failureTolerant(d->outWidth, d->outHeight, sixteenBit ? 8 : 4);
+    d->sums.fill(0, d->outWidth * 4);
+}
+
+DImgLoaderDecimator::~DImgLoaderDecimator()
+{
+    delete [] d->data;
+    delete d;
+}
+
+bool DImgLoaderDecimator::isValid() const
+{
+    return (d->data != nullptr);
+}
+
+uint DImgLoaderDecimator::width() const
+{
+    return d->outWidth;
+}
+
+uint DImgLoaderDecimator::height() const
+{
+    return d->outHeight;
+}
+
+void DImgLoaderDecimator::addRows(const uchar* const rows, uint count)
+{
+    if (!d->data)
+    {
+        return;
+    }
+
+    const quint64 rowBytes = (quint64)d->width * (d->sixteenBit ? 8 : 4);
+
+    for (uint i = 0 ; (i < count) && (d->row < d->height) ; ++i)
+    {
+        if (d->sixteenBit)
+        {
+            d->addRow(reinterpret_cast<const ushort*>(rows + i * rowBytes));
+        }
+        else
+        {
+            d->addRow(rows + i * rowBytes);
+        }
+    }
+}
+
+uchar* DImgLoaderDecimator::takeData()
+{
+    uchar* const data = d->data;
+    d->data           = nullptr;
+
+    return data;
+}
+
+} // namespace Digikam
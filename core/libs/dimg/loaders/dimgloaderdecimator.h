@@ -0,0 +1,77 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-17
+ * Description : reduce image data while it is decoded, for the scaled loading
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#pragma once
+
+// Qt includes
+
+#include <QtGlobal>
+
+// Local includes
+
+#include "digikam_export.h"
+
+namespace Digikam
+{
+
+/**
+ * Used by the image loaders which cannot decode a reduced resolution directly,
+ * when the "scaledLoadingSize" attribute is set (see DImgLoader::scaledLoadingFactor()).
+ * The rows of the full size image are given in the DImg pixel format as they are decoded,
+ * and each block of factor x factor pixels is averaged to one pixel of the reduced image.
+ * Only factor rows of the full size image have to be in memory at the same time.
+ */
+class DIGIKAM_EXPORT DImgLoaderDecimator
+{
+public:
+
+    DImgLoaderDecimator(uint width, uint height, bool sixteenBit, int factor);
+    ~DImgLoaderDecimator();
+
+    /**
+     * Return false if the memory for the reduced image cannot be allocated.
+     */
+    bool   isValid()                                  const;
+
+    /**
+     * Size of the reduced image.
+     */
+    uint   width()                                    const;
+    uint   height()                                   const;
+
+    /**
+     * Add the next count rows of the full size image, from top to bottom.
+     * The rows are in the DImg pixel format: BGRA, 8 or 16 bits per channel.
+     */
+    void   addRows(const uchar* const rows, uint count);
+
+    /**
+     * Return the data of the reduced image when all rows are added, allocated with new[].
+     * The caller takes the ownership.
+     */
+    uchar* takeData();
+
+private:
+
+    // Disable
+    DImgLoaderDecimator(const DImgLoaderDecimator&)            = delete;
+    DImgLoaderDecimator& operator=(const DImgLoaderDecimator&) = delete;
+
+private:
+
+    class Private;
+    Private* const d = nullptr;
+};
+
+} // namespace Digikam
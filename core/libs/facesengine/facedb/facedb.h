@@ -36,6 +36,7 @@ namespace Digikam
 {
 
 class KDTree;
+class HNSWIndex;
 
 class FaceDb
 {
@@ -92,6 +93,18 @@ public:
      */
     KDTree* reconstructTree()                                                   const;
 
+    /**
+     * @brief reconstructIndex: build the HNSW index of the face embeddings in the database
+     * @return
+     */
+    HNSWIndex* reconstructIndex()                                               const;
+
+    /**
+     * @brief faceVectorIdentities: the identity of each face embedding, by id of embedding
+     * @return
+     */
+    QMap<int, int> faceVectorIdentities()                                       const;
+
     /**
      * @brief trainData: extract train data from database
      * @return
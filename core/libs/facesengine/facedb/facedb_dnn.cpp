@@ -75,6 +75,39 @@ KDTree* FaceDb::reconstructTree() const
     return tree;
 }
 
+HNSWIndex* FaceDb::reconstructIndex() const
+{
+    HNSWIndex* const index = new HNSWIndex(128);
+    DbEngineSqlQuery query = d->db->execQuery(QLatin1String("SELECT id, identity, embedding FROM FaceMatrices;"));
+
+    while (query.next())
+    {
+        int nodeId                    = query.value(0).toInt();
+        int identity                  = query.value(1).toInt();
+        cv::Mat recordedFaceEmbedding = cv::Mat(1, 128, CV_32F, query.value(2).toByteArray().data()).clone();
+
+        if (!index->add(nodeId, recordedFaceEmbedding, identity))
+        {
+            qCWarning(DIGIKAM_FACEDB_LOG) << "Error insert node" << nodeId;
+        }
+    }
+
+    return index;
+}
+
+QMap<int, int> FaceDb::faceVectorIdentities() const
+{
+    QMap<int, int> identities;
+    DbEngineSqlQuery query = d->db->execQuery(QLatin1String("SELECT id, identity FROM FaceMatrices;"));
+
+    while (query.next())
+    {
+        identities.insert(query.value(0).toInt(), query.value(1).toInt());
+    }
+
+    return identities;
+}
+
 cv::Ptr<cv::ml::TrainData> FaceDb::trainData() const
 {
     cv::Mat feature, label;
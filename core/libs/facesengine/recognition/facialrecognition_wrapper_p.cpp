@@ -58,7 +58,7 @@ FacialRecognitionWrapper::Private::Private()
         qCDebug(DIGIKAM_FACESENGINE_LOG) << "Failed to initialize face database";
     }
 
-    recognizer = new OpenCVDNNFaceRecognizer(OpenCVDNNFaceRecognizer::Tree);
+    recognizer = new OpenCVDNNFaceRecognizer(OpenCVDNNFaceRecognizer::HNSW);
 }
 
 FacialRecognitionWrapper::Private::~Private()
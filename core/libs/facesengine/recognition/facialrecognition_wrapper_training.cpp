@@ -52,7 +52,7 @@ void FacialRecognitionWrapper::Private::clear(const QList<int>& idsToClear, cons
 
     delete recognizer;
 
-    recognizer = new OpenCVDNNFaceRecognizer(OpenCVDNNFaceRecognizer::Tree);
+    recognizer = new OpenCVDNNFaceRecognizer(OpenCVDNNFaceRecognizer::HNSW);
 }
 
 // -------------------------------------------------------------------------------------
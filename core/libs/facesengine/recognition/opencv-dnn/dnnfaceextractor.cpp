@@ -17,12 +17,15 @@
 
 // Qt includes
 
+#include <QList>
 #include <QMutex>
+#include <QThread>
 #include <QString>
 #include <QFileInfo>
 #include <QMutexLocker>
 #include <QElapsedTimer>
 #include <QStandardPaths>
+#include <QWaitCondition>
 
 // Local includes
 
@@ -44,14 +47,27 @@ public:
         delete preprocessor;
     }
 
+    bool         readNet(cv::dnn::Net& net) const;
+
+    /**
+     * Take a network from the pool, a new one is read if all are used and the pool
+     * is not full, else wait for one. An empty network is returned if the model is not available.
+     */
+    cv::dnn::Net acquireNet();
+    void         releaseNet(const cv::dnn::Net& net);
+
 public:
 
     RecognitionPreprocessor* preprocessor       = nullptr;
 
     int                      ref                = 1;
 
-    cv::dnn::Net             net;
+    QString                  modelPath;
+    QList<cv::dnn::Net>      freeNets;
+    int                      createdNets        = 0;
+    int                      maxNets            = 1;
     QMutex                   mutex;
+    QWaitCondition           netReleased;
 
     // As we use OpenFace, we need to set appropriate values for image color space and image size
 
@@ -60,6 +76,92 @@ public:
     cv::Scalar               meanValToSubtract  = cv::Scalar(0.0, 0.0, 0.0);
 };
 
+bool DNNFaceExtractor::Private::readNet(cv::dnn::Net& net) const
+{
+    try
+    {
+
+#ifdef Q_OS_WIN
+
+        net = cv::dnn::readNetFromTorch(modelPath.toLocal8Bit().constData());
+
+#else
+
+        net = cv::dnn::readNetFromTorch(modelPath.toStdString());
+
+#endif
+
+#if (OPENCV_VERSION == QT_VERSION_CHECK(4, 7, 0))
+
+        net.enableWinograd(false);
+
+#endif
+
+    }
+    catch (cv::Exception& e)
+    {
+        qCWarning(DIGIKAM_FACEDB_LOG) << "cv::Exception:" << e.what();
+
+        return false;
+    }
+    catch (...)
+    {
+       qCWarning(DIGIKAM_FACEDB_LOG) << "Default exception from OpenCV";
+
+       return false;
+    }
+
+    return !net.empty();
+}
+
+cv::dnn::Net DNNFaceExtractor::Private::acquireNet()
+{
+    QMutexLocker lock(&mutex);
+
+    while (freeNets.isEmpty())
+    {
+        if (createdNets == 0)
+        {
+            return cv::dnn::Net();
+        }
+
+        if (createdNets < maxNets)
+        {
+            ++createdNets;
+            lock.unlock();
+
+            cv::dnn::Net net;
+
+            if (readNet(net))
+            {
+                qCDebug(DIGIKAM_FACEDB_LOG) << "Extractor network" << createdNets << "created";
+
+                return net;
+            }
+
+            lock.relock();
+            --createdNets;
+            maxNets = createdNets;
+
+            continue;
+        }
+
+        netReleased.wait(&mutex);
+    }
+
+    return freeNets.takeLast();
+}
+
+void DNNFaceExtractor::Private::releaseNet(const cv::dnn::Net& net)
+{
+    QMutexLocker lock(&mutex);
+
+    freeNets << net;
+    netReleased.wakeOne();
+}
+
+// -------------------------------------------------------------------------------
+
 DNNFaceExtractor::DNNFaceExtractor()
     : d(new Private)
 {
@@ -119,39 +221,24 @@ bool DNNFaceExtractor::loadModels()
 
     if (QFileInfo::exists(nnmodel))
     {
-        try
-        {
-            qCDebug(DIGIKAM_FACEDB_LOG) << "Extractor model:" << nnmodel;
+        qCDebug(DIGIKAM_FACEDB_LOG) << "Extractor model:" << nnmodel;
 
-#ifdef Q_OS_WIN
-
-            d->net = cv::dnn::readNetFromTorch(nnmodel.toLocal8Bit().constData());
-
-#else
-
-            d->net = cv::dnn::readNetFromTorch(nnmodel.toStdString());
-
-#endif
+        d->modelPath = nnmodel;
+        cv::dnn::Net net;
 
-#if (OPENCV_VERSION == QT_VERSION_CHECK(4, 7, 0))
-
-            d->net.enableWinograd(false);
-
-#endif
-
-        }
-        catch (cv::Exception& e)
+        if (!d->readNet(net))
         {
-            qCWarning(DIGIKAM_FACEDB_LOG) << "cv::Exception:" << e.what();
-
             return false;
         }
-        catch (...)
-        {
-           qCWarning(DIGIKAM_FACEDB_LOG) << "Default exception from OpenCV";
 
-           return false;
-        }
+        // One network per thread computing embeddings, the others are read on demand.
+
+        QMutexLocker lock(&d->mutex);
+
+        d->freeNets.clear();
+        d->freeNets << net;
+        d->createdNets = 1;
+        d->maxNets     = qBound(1, QThread::idealThreadCount() / 2, 4);
     }
     else
     {
@@ -248,45 +335,73 @@ cv::Mat DNNFaceExtractor::alignFace(const cv::Mat& inputImage) const
 
 cv::Mat DNNFaceExtractor::getFaceEmbedding(const cv::Mat& faceImage)
 {
-    cv::Mat face_descriptors;
-    cv::Mat alignedFace;
-/*
-    qCDebug(DIGIKAM_FACEDB_LOG) << "faceImage channels: " << faceImage.channels();
-    qCDebug(DIGIKAM_FACEDB_LOG) << "faceImage size: (" << faceImage.rows << ", " << faceImage.cols << ")\n";
-*/
-    QElapsedTimer timer;
+    return getFaceEmbeddings(std::vector<cv::Mat>(1, faceImage));
+}
+
+int DNNFaceExtractor::maximumBatchSize()
+{
+    return 32;
+}
 
+cv::Mat DNNFaceExtractor::getFaceEmbeddings(const std::vector<cv::Mat>& faceImages)
+{
+    cv::Mat faceDescriptors;
+
+    if (faceImages.empty())
+    {
+        return faceDescriptors;
+    }
+
+    QElapsedTimer timer;
     timer.start();
-/*
-    alignedFace = faceImage;
-*/
-    alignedFace = d->preprocessor->preprocess(faceImage);
 
-    qCDebug(DIGIKAM_FACEDB_LOG) << "Finish aligning face in " << timer.elapsed() << " ms";
-    qCDebug(DIGIKAM_FACEDB_LOG) << "Start neural network";
+    std::vector<cv::Mat> alignedFaces;
+    alignedFaces.reserve(faceImages.size());
+
+    for (const cv::Mat& faceImage : faceImages)
+    {
+        alignedFaces.push_back(d->preprocessor->preprocess(faceImage));
+    }
+
+    qCDebug(DIGIKAM_FACEDB_LOG) << "Finish aligning" << faceImages.size() << "faces in" << timer.elapsed() << "ms";
 
     timer.start();
 
-    cv::Mat blob = cv::dnn::blobFromImage(alignedFace, d->scaleFactor, d->imageSize, cv::Scalar(), true, false);
+    cv::dnn::Net net = d->acquireNet();
 
-    if (!d->net.empty())
+    if (net.empty())
     {
-        QMutexLocker lock(&d->mutex);
-        d->net.setInput(blob);
-        face_descriptors = d->net.forward();
+        return faceDescriptors;
     }
 
-    qCDebug(DIGIKAM_FACEDB_LOG) << "Finish computing face embedding in "
-                                << timer.elapsed() << " ms";
+    try
+    {
+        for (size_t first = 0 ; first < alignedFaces.size() ; first += maximumBatchSize())
+        {
+            const size_t last = qMin(first + (size_t)maximumBatchSize(), alignedFaces.size());
+            const std::vector<cv::Mat> batch(alignedFaces.begin() + first, alignedFaces.begin() + last);
 
-/*
-    cv::Mat blob = cv::dnn::blobFromImage(faceImage, 1.0 / 255, cv::Size(96, 96), cv::Scalar(0,0,0), false, true, CV_32F); // work for openface.nn4
-    cv::Mat blob = cv::dnn::blobFromImage(faceImage, 1.0 / 255, cv::Size(224,224), cv::Scalar(0,0,0), false, true, CV_32F);
-    net.setInput(blob);
-    cv::Mat face_descriptors = net.forward();
-*/
+            cv::Mat blob = cv::dnn::blobFromImages(batch, d->scaleFactor, d->imageSize, cv::Scalar(), true, false);
+            net.setInput(blob);
+
+            // The output has one row per face.
+
+            faceDescriptors.push_back(net.forward());
+        }
+    }
+    catch (...)
+    {
+        d->releaseNet(net);
+
+        throw;
+    }
+
+    d->releaseNet(net);
+
+    qCDebug(DIGIKAM_FACEDB_LOG) << "Finish computing" << faceImages.size() << "face embeddings in"
+                                << timer.elapsed() << "ms";
 
-    return face_descriptors;
+    return faceDescriptors;
 }
 
 } // namespace Digikam
@@ -54,6 +54,21 @@ public:
     cv::Mat alignFace(const cv::Mat& inputImage) const;
     cv::Mat getFaceEmbedding(const cv::Mat& faceImage);
 
+    /**
+     * Compute the embeddings of several faces, aligned first, with one forward pass of the
+     * neural network for each batch of at most maximumBatchSize() faces. The row i of the
+     * returned matrix is the embedding of faceImages[i]. An empty matrix is returned if the
+     * model is not available.
+     * The networks are taken from a small pool: several threads can compute embeddings
+     * at the same time with the same extractor.
+     */
+    cv::Mat getFaceEmbeddings(const std::vector<cv::Mat>& faceImages);
+
+    /**
+     * The maximum number of faces passed to the neural network at once.
+     */
+    static int maximumBatchSize();
+
     /**
      * Calculate different between 2 vectors
      */
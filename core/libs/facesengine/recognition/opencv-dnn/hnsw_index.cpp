@@ -0,0 +1,672 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam
+ *
+ * Date        : 2026-10-17
+ * Description : Hierarchical navigable small world graph index of face embeddings
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "hnsw_index.h"
+
+// C++ includes
+
+#include <cmath>
+#include <queue>
+#include <random>
+#include <vector>
+#include <algorithm>
+
+// Qt includes
+
+#include <QDir>
+#include <QFile>
+#include <QHash>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QSysInfo>
+#include <QDataStream>
+#include <QCryptographicHash>
+
+// Local includes
+
+#include "digikam_debug.h"
+#include "kd_node.h"
+
+namespace Digikam
+{
+
+namespace
+{
+
+const quint32 s_indexMagic   = 0x484E5357;  // "HNSW"
+const quint32 s_indexVersion = 1;
+
+} // namespace
+
+class Q_DECL_HIDDEN HNSWIndex::Private
+{
+
+public:
+
+    /**
+     * A node of the graph, with its neighbors in each layer where it is present.
+     */
+    class Node
+    {
+    public:
+
+        int                    nodeId   = 0;
+        int                    identity = 0;
+        bool                   removed  = false;
+        QVector<QVector<int> > links;               ///< Indexes of the neighbors, per layer.
+    };
+
+    /**
+     * Square distance to the query and index of a node.
+     */
+    typedef std::pair<float, int> Candidate;
+
+public:
+
+    Private(int dim, int m, int efConstruction)
+        : nbDimension   (dim),
+          m             (qMax(2, m)),
+          efConstruction(qMax(m, efConstruction)),
+          levelFactor   (1.0 / log((double)qMax(2, m)))
+    {
+    }
+
+    const float* vector(int index) const
+    {
+        return (vectors.data() + (size_t)index * nbDimension);
+    }
+
+    float distance(const float* const pos1, const float* const pos2) const
+    {
+        float sqrDistance = 0.0F;
+
+        for (int i = 0 ; i < nbDimension ; ++i)
+        {
+            const float diff = pos1[i] - pos2[i];
+            sqrDistance     += diff * diff;
+        }
+
+        return sqrDistance;
+    }
+
+    int maxLinks(int level) const
+    {
+        return ((level == 0) ? (2 * m) : m);
+    }
+
+    int  randomLevel();
+    int  closestNode(const float* const query, int entry, int level)                             const;
+    std::vector<Candidate> searchLayer(const float* const query, int entry, int ef, int level)   const;
+    QVector<int> selectNeighbors(const std::vector<Candidate>& candidates, int maxNbLinks)      const;
+    void shrinkLinks(int index, int level);
+    void insert(int index, int level);
+    void append(int nodeId, const float* const position, int identity);
+    void rebuild();
+    void clear();
+
+public:
+
+    int                 nbDimension     = 0;
+    int                 m               = 16;
+    int                 efConstruction  = 100;
+    int                 efSearch        = 64;
+    double              levelFactor     = 0.0;
+
+    std::vector<Node>   nodes;
+    std::vector<float>  vectors;                    ///< The vectors of the nodes, contiguous.
+    QHash<int, int>     indexes;                    ///< Index of the node of each id, removed nodes excepted.
+    int                 entryPoint      = -1;
+    int                 maxLevel        = -1;
+    int                 removedCount    = 0;
+
+    std::mt19937        generator       = std::mt19937(42);
+};
+
+int HNSWIndex::Private::randomLevel()
+{
+    std::uniform_real_distribution<double> distribution(0.0, 1.0);
+
+    return (int)(-log(qMax(distribution(generator), 1.0e-12)) * levelFactor);
+}
+
+int HNSWIndex::Private::closestNode(const float* const query, int entry, int level) const
+{
+    // Greedy walk towards the query, used in the layers above the one searched.
+
+    float best   = distance(query, vector(entry));
+    bool changed = true;
+
+    while (changed)
+    {
+        changed = false;
+
+        for (int neighbor : nodes[entry].links.at(level))
+        {
+            const float dist = distance(query, vector(neighbor));
+
+            if (dist < best)
+            {
+                best    = dist;
+                entry   = neighbor;
+                changed = true;
+            }
+        }
+    }
+
+    return entry;
+}
+
+std::vector<HNSWIndex::Private::Candidate> HNSWIndex::Private::searchLayer(const float* const query,
+                                                                           int entry, int ef, int level) const
+{
+    std::vector<bool> visited(nodes.size(), false);
+
+    // Closest candidate to explore first, farthest result to replace first.
+
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate> > candidates;
+    std::priority_queue<Candidate>                                                   results;
+
+    const float dist = distance(query, vector(entry));
+    candidates.emplace(dist, entry);
+    results.emplace(dist, entry);
+    visited[entry]   = true;
+
+    while (!candidates.empty())
+    {
+        const Candidate current = candidates.top();
+
+        if ((current.first > results.top().first) && ((int)results.size() >= ef))
+        {
+            break;
+        }
+
+        candidates.pop();
+
+        for (int neighbor : nodes[current.second].links.at(level))
+        {
+            if (visited[neighbor])
+            {
+                continue;
+            }
+
+            visited[neighbor]        = true;
+            const float neighborDist = distance(query, vector(neighbor));
+
+            if (((int)results.size() < ef) || (neighborDist < results.top().first))
+            {
+                candidates.emplace(neighborDist, neighbor);
+                results.emplace(neighborDist, neighbor);
+
+                if ((int)results.size() > ef)
+                {
+                    results.pop();
+                }
+            }
+        }
+    }
+
+    std::vector<Candidate> found(results.size());
+
+    for (int i = (int)found.size() - 1 ; i >= 0 ; --i)
+    {
+        found[i] = results.top();
+        results.pop();
+    }
+
+    return found;
+}
+
+QVector<int> HNSWIndex::Private::selectNeighbors(const std::vector<Candidate>& candidates, int maxNbLinks) const
+{
+    // A candidate closer to a selected neighbor than to the node is reached through it.
+    // This keeps links in all directions, and the graph connected between the clusters.
+
+    QVector<int> selected;
+    QVector<int> discarded;
+
+    for (const Candidate& candidate : candidates)
+    {
+        if (selected.size() >= maxNbLinks)
+        {
+            break;
+        }
+
+        bool diverse = true;
+
+        for (int neighbor : qAsConst(selected))
+        {
+            if (distance(vector(candidate.second), vector(neighbor)) < candidate.first)
+            {
+                diverse = false;
+                break;
+            }
+        }
+
+        if (diverse)
+        {
+            selected << candidate.second;
+        }
+        else
+        {
+            discarded << candidate.second;
+        }
+    }
+
+    // The free links are used for the closest discarded candidates.
+
+    for (int i = 0 ; (i < discarded.size()) && (selected.size() < maxNbLinks) ; ++i)
+    {
+        selected << discarded.at(i);
+    }
+
+    return selected;
+}
+
+void HNSWIndex::Private::shrinkLinks(int index, int level)
+{
+    const QVector<int>& links = nodes[index].links.at(level);
+    std::vector<Candidate> candidates;
+    candidates.reserve(links.size());
+
+    for (int neighbor : links)
+    {
+        candidates.emplace_back(distance(vector(index), vector(neighbor)), neighbor);
+    }
+
+    std::sort(candidates.begin(), candidates.end());
+
+    nodes[index].links[level] = selectNeighbors(candidates, maxLinks(level));
+}
+
+void HNSWIndex::Private::insert(int index, int level)
+{
+    nodes[index].links.resize(level + 1);
+
+    if (entryPoint < 0)
+    {
+        entryPoint = index;
+        maxLevel   = level;
+
+        return;
+    }
+
+    const float* const query = vector(index);
+    int entry                = entryPoint;
+
+    for (int l = maxLevel ; l > level ; --l)
+    {
+        entry = closestNode(query, entry, l);
+    }
+
+    for (int l = qMin(level, maxLevel) ; l >= 0 ; --l)
+    {
+        const std::vector<Candidate> found = searchLayer(query, entry, efConstruction, l);
+        const QVector<int> neighbors       = selectNeighbors(found, m);
+        nodes[index].links[l]              = neighbors;
+
+        for (int neighbor : neighbors)
+        {
+            nodes[neighbor].links[l] << index;
+
+            if (nodes[neighbor].links.at(l).size() > maxLinks(l))
+            {
+                shrinkLinks(neighbor, l);
+            }
+        }
+
+        entry = found.front().second;
+    }
+
+    if (level > maxLevel)
+    {
+        maxLevel   = level;
+        entryPoint = index;
+    }
+}
+
+void HNSWIndex::Private::append(int nodeId, const float* const position, int identity)
+{
+    const int index = (int)nodes.size();
+
+    Node node;
+    node.nodeId     = nodeId;
+    node.identity   = identity;
+    nodes.push_back(node);
+
+    vectors.insert(vectors.end(), position, position + nbDimension);
+    indexes.insert(nodeId, index);
+
+    insert(index, randomLevel());
+}
+
+void HNSWIndex::Private::rebuild()
+{
+    const std::vector<Node>  oldNodes   = nodes;
+    const std::vector<float> oldVectors = vectors;
+
+    clear();
+
+    for (size_t i = 0 ; i < oldNodes.size() ; ++i)
+    {
+        if (!oldNodes[i].removed)
+        {
+            append(oldNodes[i].nodeId, oldVectors.data() + i * nbDimension, oldNodes[i].identity);
+        }
+    }
+}
+
+void HNSWIndex::Private::clear()
+{
+    nodes.clear();
+    vectors.clear();
+    indexes.clear();
+
+    entryPoint   = -1;
+    maxLevel     = -1;
+    removedCount = 0;
+}
+
+// -------------------------------------------------------------------------------------
+
+HNSWIndex::HNSWIndex(int dim, int m, int efConstruction)
+    : d(new Private(dim, m, efConstruction))
+{
+}
+
+HNSWIndex::~HNSWIndex()
+{
+    delete d;
+}
+
+bool HNSWIndex::add(int nodeId, const cv::Mat& position, int identity)
+{
+    if ((position.type() != CV_32F) || ((int)position.total() != d->nbDimension) || d->indexes.contains(nodeId))
+    {
+        return false;
+    }
+
+    const cv::Mat vector = position.isContinuous() ? position : position.clone();
+
+    d->append(nodeId, vector.ptr<float>(), identity);
+
+    return true;
+}
+
+bool HNSWIndex::remove(int nodeId)
+{
+    const int index = d->indexes.value(nodeId, -1);
+
+    if (index < 0)
+    {
+        return false;
+    }
+
+    d->nodes[index].removed = true;
+    d->indexes.remove(nodeId);
+    ++d->removedCount;
+
+    // The searches go through the removed nodes, the graph is built again when they are too many.
+
+    if ((d->removedCount * 2) > (int)d->nodes.size())
+    {
+        d->rebuild();
+    }
+
+    return true;
+}
+
+bool HNSWIndex::contains(int nodeId) const
+{
+    return d->indexes.contains(nodeId);
+}
+
+QVector<int> HNSWIndex::nodeIds() const
+{
+    return d->indexes.keys().toVector();
+}
+
+int HNSWIndex::size() const
+{
+    return d->indexes.size();
+}
+
+void HNSWIndex::setEfSearch(int ef)
+{
+    d->efSearch = qMax(1, ef);
+}
+
+QMap<double, QVector<int> > HNSWIndex::getClosestNeighbors(const cv::Mat& position,
+                                                           float sqRange,
+                                                           float cosThreshold,
+                                                           int maxNbNeighbors) const
+{
+    QMap<double, QVector<int> > closestNeighbors;
+
+    if ((d->entryPoint < 0) || (position.type() != CV_32F) || ((int)position.total() != d->nbDimension))
+    {
+        return closestNeighbors;
+    }
+
+    const cv::Mat vector     = position.isContinuous() ? position : position.clone();
+    const float* const query = vector.ptr<float>();
+    int entry                = d->entryPoint;
+
+    for (int l = d->maxLevel ; l > 0 ; --l)
+    {
+        entry = d->closestNode(query, entry, l);
+    }
+
+    // More candidates in proportion to the removed nodes, which are found too.
+
+    const int ef                                = (int)((qint64)qMax(d->efSearch, maxNbNeighbors) *
+                                                        (qint64)d->nodes.size() / qMax(1, size()));
+    const std::vector<Private::Candidate> found = d->searchLayer(query, entry, qMin(ef, (int)d->nodes.size()), 0);
+    int count                                   = 0;
+
+    for (const Private::Candidate& candidate : found)
+    {
+        if ((count >= maxNbNeighbors) || (candidate.first >= sqRange))
+        {
+            break;
+        }
+
+        const Private::Node& node = d->nodes[candidate.second];
+
+        if (
+            node.removed ||
+            (KDNode::cosDistance(query, d->vector(candidate.second), d->nbDimension) <= cosThreshold)
+           )
+        {
+            continue;
+        }
+
+        closestNeighbors[candidate.first].append(node.identity);
+        ++count;
+    }
+
+    return closestNeighbors;
+}
+
+QByteArray HNSWIndex::checksum() const
+{
+    QMap<int, int> identities;
+
+    for (const Private::Node& node : d->nodes)
+    {
+        if (!node.removed)
+        {
+            identities.insert(node.nodeId, node.identity);
+        }
+    }
+
+    return computeChecksum(identities);
+}
+
+QByteArray HNSWIndex::computeChecksum(const QMap<int, int>& identities)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+
+    for (QMap<int, int>::const_iterator it = identities.constBegin() ; it != identities.constEnd() ; ++it)
+    {
+        hash.addData(QByteArray::number(it.key()) + ':' + QByteArray::number(it.value()) + ';');
+    }
+
+    return hash.result().toHex();
+}
+
+bool HNSWIndex::save(const QString& filePath) const
+{
+    if (!QDir().mkpath(QFileInfo(filePath).absolutePath()))
+    {
+        return false;
+    }
+
+    QSaveFile file(filePath);
+
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        qCWarning(DIGIKAM_FACEDB_LOG) << "Cannot write face embeddings index" << filePath;
+
+        return false;
+    }
+
+    QDataStream out(&file);
+
+    // The vectors are written in the native byte order.
+
+    out << s_indexMagic
+        << s_indexVersion
+        << (qint32)QSysInfo::ByteOrder
+        << checksum()
+        << (qint32)d->nbDimension
+        << (qint32)d->m
+        << (qint32)d->entryPoint
+        << (qint32)d->maxLevel
+        << (qint32)d->nodes.size();
+
+    for (const Private::Node& node : d->nodes)
+    {
+        out << (qint32)node.nodeId << (qint32)node.identity << node.removed << node.links;
+    }
+
+    out.writeRawData(reinterpret_cast<const char*>(d->vectors.data()), (int)(d->vectors.size() * sizeof(float)));
+
+    return ((out.status() == QDataStream::Ok) && file.commit());
+}
+
+bool HNSWIndex::load(const QString& filePath, const QByteArray& checksum)
+{
+    QFile file(filePath);
+
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+
+    QDataStream in(&file);
+
+    quint32    magic      = 0;
+    quint32    version    = 0;
+    qint32     byteOrder  = 0;
+    QByteArray fileChecksum;
+    qint32     dim        = 0;
+    qint32     m          = 0;
+    qint32     entryPoint = -1;
+    qint32     maxLevel   = -1;
+    qint32     count      = 0;
+
+    in >> magic >> version >> byteOrder >> fileChecksum >> dim >> m >> entryPoint >> maxLevel >> count;
+
+    if (
+        (in.status()  != QDataStream::Ok)       ||
+        (magic        != s_indexMagic)          ||
+        (version      != s_indexVersion)        ||
+        (byteOrder    != QSysInfo::ByteOrder)   ||
+        (fileChecksum != checksum)              ||
+        (dim          != d->nbDimension)        ||
+        (m            <  2)                     ||
+        (count        <  0)                     ||
+        (entryPoint   >= count)                 ||
+        ((count > 0) && (entryPoint < 0))
+       )
+    {
+        return false;
+    }
+
+    std::vector<Private::Node> nodes(count);
+    QHash<int, int>            indexes;
+    int                        removedCount = 0;
+
+    for (int i = 0 ; i < count ; ++i)
+    {
+        Private::Node& node = nodes[i];
+        qint32 nodeId       = 0;
+        qint32 identity     = 0;
+
+        in >> nodeId >> identity >> node.removed >> node.links;
+
+        node.nodeId         = nodeId;
+        node.identity       = identity;
+
+        if (node.removed)
+        {
+            ++removedCount;
+        }
+        else
+        {
+            indexes.insert(nodeId, i);
+        }
+    }
+
+    // Check the links, a corrupted file must not crash the searches.
+
+    if ((count > 0) && (nodes[entryPoint].links.size() != (maxLevel + 1)))
+    {
+        return false;
+    }
+
+    for (const Private::Node& node : nodes)
+    {
+        for (int l = 0 ; l < node.links.size() ; ++l)
+        {
+            for (int neighbor : node.links.at(l))
+            {
+                if ((neighbor < 0) || (neighbor >= count) || (nodes[neighbor].links.size() <= l))
+                {
+                    return false;
+                }
+            }
+        }
+    }
+
+    std::vector<float> vectors((size_t)count * dim);
+    const int bytes = (int)(vectors.size() * sizeof(float));
+
+    if ((in.status() != QDataStream::Ok) || (in.readRawData(reinterpret_cast<char*>(vectors.data()), bytes) != bytes))
+    {
+        return false;
+    }
+
+    d->m            = m;
+    d->levelFactor  = 1.0 / log((double)m);
+    d->nodes.swap(nodes);
+    d->vectors.swap(vectors);
+    d->indexes      = indexes;
+    d->entryPoint   = entryPoint;
+    d->maxLevel     = maxLevel;
+    d->removedCount = removedCount;
+
+    return true;
+}
+
+} // namespace Digikam
@@ -0,0 +1,133 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam
+ *
+ * Date        : 2026-10-17
+ * Description : Hierarchical navigable small world graph index of face embeddings
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#pragma once
+
+// Qt includes
+
+#include <QMap>
+#include <QVector>
+#include <QString>
+#include <QByteArray>
+
+// Local includes
+
+#include "digikam_opencv.h"
+#include "digikam_export.h"
+
+namespace Digikam
+{
+
+/**
+ * Approximate nearest neighbors index of the face embeddings, kept in memory.
+ * The embeddings are the nodes of a hierarchy of proximity graphs, the search goes down
+ * from the sparse top layer to the complete bottom layer, in logarithmic time.
+ * See Malkov and Yashunin, "Efficient and robust approximate nearest neighbor search
+ * using Hierarchical Navigable Small World graphs".
+ *
+ * The nodes are identified by the id of the embedding in the FaceMatrices table.
+ * The removed nodes stay in the graph to keep it connected, until they are too many
+ * and the graph is built again. The index is not thread safe.
+ */
+class DIGIKAM_GUI_EXPORT HNSWIndex
+{
+
+public:
+
+    /**
+     * @param dim            : dimension of the vectors
+     * @param m              : links of a node per layer, twice in the bottom layer
+     * @param efConstruction : candidates examined to link a new node
+     */
+    explicit HNSWIndex(int dim, int m = 16, int efConstruction = 100);
+    ~HNSWIndex();
+
+    /**
+     * @brief add a new node to the index
+     * @param nodeId   : id of the face embedding in the database
+     * @param position : dim vector of floats
+     * @param identity : identity of this face vector
+     * @return false if the node exists already or the vector is not valid
+     */
+    bool add(int nodeId, const cv::Mat& position, int identity);
+
+    /**
+     * @brief remove a node from the results of the searches
+     * @return false if the node is not in the index
+     */
+    bool remove(int nodeId);
+
+    bool contains(int nodeId)                                                     const;
+
+    /**
+     * @return the ids of all nodes not removed
+     */
+    QVector<int> nodeIds()                                                        const;
+
+    /**
+     * @return the number of nodes not removed
+     */
+    int size()                                                                    const;
+
+    /**
+     * Candidates examined by a search, at least maxNbNeighbors. Larger is slower but
+     * finds more of the true nearest neighbors.
+     */
+    void setEfSearch(int ef);
+
+    /**
+     * @return Map of N-nearest neighbors with a square distance less than sqRange and a
+     * cosine similarity greater than cosThreshold, sorted by square distance.
+     * The values are the identities, as with KDTree::getClosestNeighbors().
+     */
+    QMap<double, QVector<int> > getClosestNeighbors(const cv::Mat& position,
+                                                    float          sqRange,
+                                                    float          cosThreshold,
+                                                    int            maxNbNeighbors)                  const;
+
+    /**
+     * @return the checksum of the nodes not removed, see computeChecksum()
+     */
+    QByteArray checksum()                                                                          const;
+
+    /**
+     * @brief checksum of the identities of a set of face embeddings
+     * @param identities : the identity of each embedding, by id of embedding
+     */
+    static QByteArray computeChecksum(const QMap<int, int>& identities);
+
+    /**
+     * @brief write the index to a file, with its checksum
+     */
+    bool save(const QString& filePath)                                                             const;
+
+    /**
+     * @brief read the index from a file
+     * @return false if the file cannot be read, or if it was saved with another checksum
+     *         or another dimension. The index is unchanged in this case.
+     */
+    bool load(const QString& filePath, const QByteArray& checksum);
+
+private:
+
+    // Disable
+    HNSWIndex(const HNSWIndex&)            = delete;
+    HNSWIndex& operator=(const HNSWIndex&) = delete;
+
+private:
+
+    class Private;
+    Private* const d = nullptr;
+};
+
+} // namespace Digikam
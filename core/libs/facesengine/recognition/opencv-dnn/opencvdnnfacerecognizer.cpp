@@ -74,62 +74,40 @@ void OpenCVDNNFaceRecognizer::train(const QList<QImage*>& images,
                                     const int             label,
                                     const QString&        context)
 {
-    cv::parallel_for_(cv::Range(0, images.size()), Private::ParallelTrainer(d, images, label, context));
+    const cv::Mat faceEmbeddings = d->faceEmbeddings(images);
 
-    d->newDataAdded = true;
-}
-
-int OpenCVDNNFaceRecognizer::recognize(QImage* inputImage)
-{
-    int id = -1;
+    // The embeddings are computed by batches, the database is written sequentially.
 
-    cv::Mat faceEmbedding = d->extractors[0]->getFaceEmbedding(prepareForRecognition(*inputImage));
-
-    switch (d->method)
+    for (int i = 0 ; i < faceEmbeddings.rows ; ++i)
     {
-        case SVM:
-        {
-            id = d->predictSVM(faceEmbedding);
-            break;
-        }
-
-        case OpenCV_KNN:
-        {
-            id = d->predictKNN(faceEmbedding);
-            break;
-        }
-
-        case Tree:
-        {
-            id = d->predictKDTree(faceEmbedding);
-            break;
-        }
-
-        case DB:
+        if (!d->insertData(faceEmbeddings.row(i), label, context))
         {
-            id = d->predictDb(faceEmbedding);
-            break;
-        }
-
-        default:
-        {
-            qCWarning(DIGIKAM_FACEDB_LOG) << "Not recognized classifying method";
+            qCWarning(DIGIKAM_FACEDB_LOG) << "Fail to register a face of identity" << label;
         }
     }
 
-    return id;
+    d->newDataAdded = true;
+}
+
+int OpenCVDNNFaceRecognizer::recognize(QImage* inputImage)
+{
+    return recognize(QList<QImage*>() << inputImage).value(0, -1);
 }
 
 QVector<int> OpenCVDNNFaceRecognizer::recognize(const QList<QImage*>& inputImages)
 {
-    QVector<int> ids;
+    QVector<int> ids(inputImages.size(), -1);
+
+    const cv::Mat faceEmbeddings = d->faceEmbeddings(inputImages);
 
-    cv::parallel_for_(cv::Range(0, inputImages.size()), Private::ParallelRecognizer(d, inputImages, ids));
+    for (int i = 0 ; i < faceEmbeddings.rows ; ++i)
+    {
+        ids[i] = d->predict(faceEmbeddings.row(i));
+    }
 
     return ids;
 }
 
-
 void OpenCVDNNFaceRecognizer::clearTraining(const QList<int>& idsToClear, const QString& trainingContext)
 {
     if (idsToClear.isEmpty())
@@ -140,6 +118,11 @@ void OpenCVDNNFaceRecognizer::clearTraining(const QList<int>& idsToClear, const
     {
         FaceDbAccess().db()->clearDNNTraining(idsToClear, trainingContext);
     }
+
+    if (d->method == HNSW)
+    {
+        d->syncIndex();
+    }
 /*
     FaceDbAccess().db()->clearTreeDb();
 */
@@ -38,6 +38,7 @@ public:
         OpenCV_KNN,
         Tree,
         DB,
+        HNSW            ///< Approximate K-nearest neighbors in memory, saved in a file between the sessions.
     };
 
     /**
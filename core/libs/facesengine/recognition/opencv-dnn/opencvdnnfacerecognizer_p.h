@@ -24,6 +24,8 @@
 // Qt includes
 
 #include <QElapsedTimer>
+#include <QCryptographicHash>
+#include <QStandardPaths>
 
 // Local includes
 
@@ -32,6 +34,7 @@
 #include "facedbaccess.h"
 #include "facedb.h"
 #include "kd_tree.h"
+#include "hnsw_index.h"
 
 namespace Digikam
 {
@@ -76,6 +79,12 @@ public:
                 break;
             }
 
+            case HNSW:
+            {
+                loadIndex();
+                break;
+            }
+
             default:
             {
                 qFatal("Invalid classifier");
@@ -93,7 +102,13 @@ public:
             extractor = extractors.erase(extractor);
         }
 
+        if (index && indexChanged)
+        {
+            saveIndex();
+        }
+
         delete tree;
+        delete index;
     }
 
 public:
@@ -106,9 +121,43 @@ public:
 
     int predictKDTree(const cv::Mat& faceEmbedding) const;
     int predictDb(const cv::Mat& faceEmbedding) const;
+    int predictIndex(const cv::Mat& faceEmbedding) const;
+
+    /**
+     * Vote for the identity of the closest neighbors, weighted by their distances.
+     */
+    int vote(const QMap<double, QVector<int> >& closestNeighbors) const;
+
+    /**
+     * Predict with the classifier of the method.
+     */
+    int predict(const cv::Mat& faceEmbedding);
+
+    /**
+     * The embeddings of the faces, one row per image, computed by batches in parallel.
+     * An empty matrix is returned if the extractor is not available.
+     */
+    cv::Mat faceEmbeddings(const QList<QImage*>& images);
 
     bool insertData(const cv::Mat& position, const int label, const QString& context = QString());
 
+    /**
+     * The index is read from its file if the face embeddings did not change since it was
+     * written, else it is built again from the database.
+     */
+    void loadIndex();
+    void saveIndex() const;
+
+    /**
+     * Remove from the index the face embeddings removed from the database.
+     */
+    void syncIndex();
+
+    /**
+     * One index file per face database.
+     */
+    static QString indexFilePath();
+
 public:
 
     Classifier                 method;
@@ -118,6 +167,8 @@ public:
     cv::Ptr<cv::ml::KNearest>  knn;
 
     KDTree*                    tree         = nullptr;
+    HNSWIndex*                 index        = nullptr;
+    bool                       indexChanged = false;
     int                        kNeighbors   = 5;
     float                      threshold    = 0.4F;
 
@@ -125,120 +176,51 @@ public:
 
 public:
 
-    class ParallelRecognizer;
-    class ParallelTrainer;
-};
-
-class OpenCVDNNFaceRecognizer::Private::ParallelRecognizer : public cv::ParallelLoopBody
-{
-public:
-
-    ParallelRecognizer(OpenCVDNNFaceRecognizer::Private* d,
-                       const QList<QImage*>& images,
-                       QVector<int>& ids)
-        : images    (images),
-          ids       (ids),
-          d         (d)
-    {
-        ids.resize(images.size());
-    }
-
-    void operator()(const cv::Range& range) const override
-    {
-        for(int i = range.start ; i < range.end ; ++i)
-        {
-            int id = -1;
-
-            cv::Mat faceEmbedding = d->extractors[i%(d->extractors.size())]->getFaceEmbedding(OpenCVDNNFaceRecognizer::prepareForRecognition(*images[i]));
-
-            switch (d->method)
-            {
-                case SVM:
-                {
-                    id = d->predictSVM(faceEmbedding);
-                    break;
-                }
-
-                case OpenCV_KNN:
-                {
-                    id = d->predictKNN(faceEmbedding);
-                    break;
-                }
-
-                case Tree:
-                {
-                    id = d->predictKDTree(faceEmbedding);
-                    break;
-                }
-
-                case DB:
-                {
-                    id = d->predictDb(faceEmbedding);
-                    break;
-                }
-
-                default:
-                {
-                    qCWarning(DIGIKAM_FACEDB_LOG) << "Not recognized classifying method";
-                }
-            }
-
-            ids[i] = id;
-        }
-    }
-
-private:
-
-    const QList<QImage*>&                   images;
-    QVector<int>&                           ids;
-
-    OpenCVDNNFaceRecognizer::Private* const d = nullptr;
-
-private:
-
-    Q_DISABLE_COPY(ParallelRecognizer)
+    class ParallelEmbedder;
 };
 
-class OpenCVDNNFaceRecognizer::Private::ParallelTrainer: public cv::ParallelLoopBody
+/**
+ * Each range of batches is computed with one forward pass per batch. The extractor uses
+ * a pool of networks, so the batches of different ranges are computed at the same time.
+ */
+class OpenCVDNNFaceRecognizer::Private::ParallelEmbedder : public cv::ParallelLoopBody
 {
 public:
 
-    ParallelTrainer(OpenCVDNNFaceRecognizer::Private* d,
-                    const QList<QImage*>& images,
-                    const int& id,
-                    const QString& context)
-        : images    (images),
-          id        (id),
-          context   (context),
+    ParallelEmbedder(OpenCVDNNFaceRecognizer::Private* d,
+                     const std::vector<cv::Mat>& faces,
+                     int batchSize,
+                     std::vector<cv::Mat>& embeddings)
+        : faces     (faces),
+          batchSize (batchSize),
+          embeddings(embeddings),
           d         (d)
     {
     }
 
     void operator()(const cv::Range& range) const override
     {
-        for(int i = range.start ; i < range.end ; ++i)
+        for (int i = range.start ; i < range.end ; ++i)
         {
-            cv::Mat faceEmbedding = d->extractors[i%(d->extractors.size())]->
-                getFaceEmbedding(OpenCVDNNFaceRecognizer::prepareForRecognition(*images[i]));
+            const size_t first = (size_t)i * batchSize;
+            const size_t last  = qMin(first + batchSize, faces.size());
 
-            if (!d->insertData(faceEmbedding, id, context))
-            {
-                qCWarning(DIGIKAM_FACEDB_LOG) << "Fail to register a face of identity" << id;
-            }
+            embeddings[i]      = d->extractors.first()->getFaceEmbeddings(std::vector<cv::Mat>(faces.begin() + first,
+                                                                                               faces.begin() + last));
         }
     }
 
 private:
 
-    const QList<QImage*>&                   images;
-    const int&                              id;
-    const QString&                          context;
+    const std::vector<cv::Mat>&             faces;
+    const int                               batchSize;
+    std::vector<cv::Mat>&                   embeddings;
 
     OpenCVDNNFaceRecognizer::Private* const d = nullptr;
 
 private:
 
-    Q_DISABLE_COPY(ParallelTrainer)
+    Q_DISABLE_COPY(ParallelEmbedder)
 };
 
 bool OpenCVDNNFaceRecognizer::Private::trainSVM()
@@ -307,21 +289,35 @@ int OpenCVDNNFaceRecognizer::Private::predictKDTree(const cv::Mat& faceEmbedding
 
     // Look for K-nearest neighbor which have the cosine distance greater than the threshold.
 
-    QMap<double, QVector<int> > closestNeighbors = tree->getClosestNeighbors(faceEmbedding, threshold, 0.8, kNeighbors);
+    return vote(tree->getClosestNeighbors(faceEmbedding, threshold, 0.8, kNeighbors));
+}
+
+int OpenCVDNNFaceRecognizer::Private::predictDb(const cv::Mat& faceEmbedding) const
+{
+    return vote(FaceDbAccess().db()->getClosestNeighborsTreeDb(faceEmbedding, threshold, 0.8, kNeighbors));
+}
+
+int OpenCVDNNFaceRecognizer::Private::predictIndex(const cv::Mat& faceEmbedding) const
+{
+    if (!index)
+    {
+        return -1;
+    }
+
+    return vote(index->getClosestNeighbors(faceEmbedding, threshold, 0.8, kNeighbors));
+}
 
+int OpenCVDNNFaceRecognizer::Private::vote(const QMap<double, QVector<int> >& closestNeighbors) const
+{
     QMap<int, QVector<double> > votingGroups;
 
     for (QMap<double, QVector<int> >::const_iterator iter  = closestNeighbors.cbegin();
                                                      iter != closestNeighbors.cend();
                                                      ++iter)
     {
-        for (QVector<int>::const_iterator node  = iter.value().cbegin();
-                                          node != iter.value().cend();
-                                          ++node)
+        for (int i = 0 ; i < iter.value().size() ; ++i)
         {
-            int label = (*node);
-
-            votingGroups[label].append(iter.key());
+            votingGroups[iter.value()[i]].append(iter.key());
         }
     }
 
@@ -349,44 +345,81 @@ int OpenCVDNNFaceRecognizer::Private::predictKDTree(const cv::Mat& faceEmbedding
     return prediction;
 }
 
-int OpenCVDNNFaceRecognizer::Private::predictDb(const cv::Mat& faceEmbedding) const
+int OpenCVDNNFaceRecognizer::Private::predict(const cv::Mat& faceEmbedding)
 {
-    QMap<double, QVector<int> > closestNeighbors = FaceDbAccess().db()->getClosestNeighborsTreeDb(faceEmbedding, threshold, 0.8, kNeighbors);
+    switch (method)
+    {
+        case SVM:
+        {
+            return predictSVM(faceEmbedding);
+        }
 
-    QMap<int, QVector<double> > votingGroups;
+        case OpenCV_KNN:
+        {
+            return predictKNN(faceEmbedding);
+        }
 
-    for (QMap<double, QVector<int> >::const_iterator iter  = closestNeighbors.cbegin();
-                                                     iter != closestNeighbors.cend();
-                                                     ++iter)
-    {
-        for (int i = 0 ; i < iter.value().size() ; ++i)
+        case Tree:
         {
-            votingGroups[iter.value()[i]].append(iter.key());
+            return predictKDTree(faceEmbedding);
         }
-    }
 
-    double maxScore = 0.0;
-    int prediction  = -1;
+        case DB:
+        {
+            return predictDb(faceEmbedding);
+        }
 
-    for (QMap<int, QVector<double> >::const_iterator group  = votingGroups.cbegin();
-                                                     group != votingGroups.cend();
-                                                     ++group)
-    {
-        double score = 0.0;
+        case HNSW:
+        {
+            return predictIndex(faceEmbedding);
+        }
 
-        for (int i = 0 ; i < group.value().size() ; ++i)
+        default:
         {
-            score += (threshold - group.value()[i]);
+            qCWarning(DIGIKAM_FACEDB_LOG) << "Not recognized classifying method";
+
+            return -1;
         }
+    }
+}
 
-        if (score > maxScore)
+cv::Mat OpenCVDNNFaceRecognizer::Private::faceEmbeddings(const QList<QImage*>& images)
+{
+    if (images.isEmpty())
+    {
+        return cv::Mat();
+    }
+
+    std::vector<cv::Mat> faces;
+    faces.reserve(images.size());
+
+    for (QImage* const image : images)
+    {
+        faces.push_back(OpenCVDNNFaceRecognizer::prepareForRecognition(*image));
+    }
+
+    // Small batches for the small groups, to use several networks at once.
+
+    const int threads    = qMax(1, cv::getNumThreads());
+    const int batchSize  = qBound(1, (int)((faces.size() + threads - 1) / threads), DNNFaceExtractor::maximumBatchSize());
+    const int batches    = (int)((faces.size() + batchSize - 1) / batchSize);
+    std::vector<cv::Mat> embeddings(batches);
+
+    cv::parallel_for_(cv::Range(0, batches), ParallelEmbedder(this, faces, batchSize, embeddings));
+
+    cv::Mat result;
+
+    for (const cv::Mat& batch : embeddings)
+    {
+        if (batch.empty())
         {
-            maxScore   = score;
-            prediction = group.key();
+            return cv::Mat();
         }
+
+        result.push_back(batch);
     }
 
-    return prediction;
+    return result;
 }
 
 bool OpenCVDNNFaceRecognizer::Private::insertData(const cv::Mat& nodePos, const int label, const QString& context)
@@ -422,8 +455,80 @@ bool OpenCVDNNFaceRecognizer::Private::insertData(const cv::Mat& nodePos, const
             return false;
         }
     }
+    else if (method == HNSW)
+    {
+        if (!index->add(nodeId, nodePos, label))
+        {
+            qCWarning(DIGIKAM_FACEDB_LOG) << "Error insert new node" << nodeId;
+
+            return false;
+        }
+
+        indexChanged = true;
+    }
 
     return true;
 }
 
+void OpenCVDNNFaceRecognizer::Private::loadIndex()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    const QString filePath = indexFilePath();
+    index                  = new HNSWIndex(128);
+
+    if (index->load(filePath, HNSWIndex::computeChecksum(FaceDbAccess().db()->faceVectorIdentities())))
+    {
+        qCDebug(DIGIKAM_FACEDB_LOG) << "Face embeddings index of" << index->size() << "faces loaded from"
+                                    << filePath << "in" << timer.elapsed() << "ms";
+
+        return;
+    }
+
+    delete index;
+    index        = FaceDbAccess().db()->reconstructIndex();
+    indexChanged = true;
+
+    qCDebug(DIGIKAM_FACEDB_LOG) << "Face embeddings index of" << index->size() << "faces built in"
+                                << timer.elapsed() << "ms";
+}
+
+void OpenCVDNNFaceRecognizer::Private::saveIndex() const
+{
+    const QString filePath = indexFilePath();
+
+    if (!index->save(filePath))
+    {
+        qCWarning(DIGIKAM_FACEDB_LOG) << "Cannot save face embeddings index to" << filePath;
+    }
+}
+
+void OpenCVDNNFaceRecognizer::Private::syncIndex()
+{
+    const QMap<int, int> identities = FaceDbAccess().db()->faceVectorIdentities();
+    const QVector<int> nodeIds      = index->nodeIds();
+
+    for (int nodeId : nodeIds)
+    {
+        if (!identities.contains(nodeId))
+        {
+            index->remove(nodeId);
+            indexChanged = true;
+        }
+    }
+}
+
+QString OpenCVDNNFaceRecognizer::Private::indexFilePath()
+{
+    const DbEngineParameters params = FaceDbAccess::parameters();
+    const QByteArray dbId           = QCryptographicHash::hash((params.databaseType             +
+                                                                params.hostName                 +
+                                                                params.getFaceDatabaseNameOrDir()).toUtf8(),
+                                                               QCryptographicHash::Sha1).toHex().left(16);
+
+    return (QStandardPaths::writableLocation(QStandardPaths::CacheLocation) +
+            QLatin1String("/facesengine/embeddings-") + QString::fromLatin1(dbId) + QLatin1String(".hnsw"));
+}
+
 } // namespace Digikam
@@ -15,6 +15,10 @@
 
 #include "abstract_detector.h"
 
+// C++ includes
+
+#include <algorithm>
+
 // Qt includes
 
 #include <QtMath>
@@ -22,6 +26,7 @@
 // Local includes
 
 #include "digikam_debug.h"
+#include "dimgmatview.h"
 #include "focuspoints_extractor.h"
 
 namespace Digikam
@@ -32,6 +37,11 @@ AbstractDetector::AbstractDetector(QObject* const parent)
 {
 }
 
+int AbstractDetector::minimumImageSize() const
+{
+    return 0;
+}
+
 /**
  * NOTE: Maybe this function will move to read_image() of imagequalityparser
  * in case all detectors of IQS use cv::Mat
@@ -45,31 +55,52 @@ cv::Mat AbstractDetector::prepareForDetection(const DImg& inputImage)
 
     try
     {
-        cv::Mat cvImage;
+        return DImgMatView(inputImage).toEightBitThreeChannels(DImgMatView::RGB);
+    }
+    catch (cv::Exception& e)
+    {
+        qCCritical(DIGIKAM_FACESENGINE_LOG) << "cv::Exception:" << e.what();
+    }
+    catch (...)
+    {
+        qCCritical(DIGIKAM_FACESENGINE_LOG) << "Default exception from OpenCV";
+    }
 
-        int type               = inputImage.sixteenBit() ? CV_16UC4 : CV_8UC4;
+    return cv::Mat();
+}
 
-        cv::Mat cvImageWrapper = cv::Mat(inputImage.height(), inputImage.width(), type, inputImage.bits());
+cv::Mat AbstractDetector::reduceForDetection(const cv::Mat& image, int minimumSize)
+{
+    if ((minimumSize <= 0) || image.empty())
+    {
+        return image;
+    }
 
-        cv::cvtColor(cvImageWrapper, cvImage, cv::COLOR_RGBA2BGR);
+    cv::Mat reduced = image;
 
-        if (type == CV_16UC4)
+    try
+    {
+        while ((std::min(reduced.cols, reduced.rows) / 2) >= minimumSize)
         {
-            cvImage.convertTo(cvImage, CV_8UC3, 1 / 256.0);
+            cv::Mat half;
+            cv::resize(reduced, half, cv::Size(reduced.cols / 2, reduced.rows / 2), 0, 0, cv::INTER_AREA);
+            reduced = half;
         }
-
-        return cvImage;
     }
     catch (cv::Exception& e)
     {
         qCCritical(DIGIKAM_FACESENGINE_LOG) << "cv::Exception:" << e.what();
+
+        return image;
     }
     catch (...)
     {
         qCCritical(DIGIKAM_FACESENGINE_LOG) << "Default exception from OpenCV";
+
+        return image;
     }
 
-    return cv::Mat();
+    return reduced;
 }
 
 } // namespace Digikam
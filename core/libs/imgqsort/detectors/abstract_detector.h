@@ -23,11 +23,12 @@
 
 #include "dimg.h"
 #include "digikam_opencv.h"
+#include "digikam_export.h"
 
 namespace Digikam
 {
 
-class AbstractDetector : public QObject
+class DIGIKAM_EXPORT AbstractDetector : public QObject
 {
     Q_OBJECT
 
@@ -38,9 +39,22 @@ public:
 
     virtual float detect(const cv::Mat& image) const = 0;
 
+    /**
+     * @return the minimal size in pixels of the smaller side of the image needed by the detector.
+     * The detectors measuring global properties of the image can run on a reduced image,
+     * see reduceForDetection(). 0, the default, means the full resolution is needed.
+     */
+    virtual int minimumImageSize()             const;
+
 public:
 
     static cv::Mat prepareForDetection(const DImg& inputImage);
+
+    /**
+     * @return the image halved with an area interpolation as long as the smaller side stays
+     * at least minimumSize, or the image itself if it cannot be reduced.
+     */
+    static cv::Mat reduceForDetection(const cv::Mat& image, int minimumSize);
 };
 
 } // namespace Digikam
@@ -43,10 +43,12 @@ float AestheticDetector::detect(const cv::Mat& image) const
 {
     try
     {
-        QMutexLocker locker(&s_modelMutex);
+        // The model is shared by all threads, only its inference is serialized.
 
         cv::Mat input = preprocess(image);
 
+        QMutexLocker locker(&s_modelMutex);
+
         if (!s_model.empty())
         {
             s_model.setInput(input);
@@ -79,10 +81,11 @@ cv::Mat AestheticDetector::preprocess(const cv::Mat& image) const
 {
     try
     {
-        cv::Mat img_rgb;
-        cv::cvtColor(image, img_rgb, cv::COLOR_BGR2RGB);
+        // The nearest neighbor sampling does not mix the channels, they are swapped on the small image.
+
         cv::Mat cv_resized;
-        cv::resize(img_rgb, cv_resized, cv::Size(299, 299), 0, 0, cv::INTER_NEAREST_EXACT);
+        cv::resize(image, cv_resized, cv::Size(299, 299), 0, 0, cv::INTER_NEAREST_EXACT);
+        cv::cvtColor(cv_resized, cv_resized, cv::COLOR_BGR2RGB);
         cv_resized.convertTo(cv_resized, CV_32FC3);
         cv_resized   = cv_resized.mul(1.0F / 127.5F);
         subtract(cv_resized, cv::Scalar(1, 1, 1), cv_resized);
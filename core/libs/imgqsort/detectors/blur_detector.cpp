@@ -53,6 +53,8 @@ public:
     bool                                have_focus_region       = false;
     int                                 ratio_expand_af_point   = 2;
     FocusPointsExtractor::ListAFPoints  af_points;
+
+    cv::Mat                             grayImage;
 };
 
 BlurDetector::BlurDetector(const DImg& image)
@@ -70,6 +72,11 @@ BlurDetector::~BlurDetector()
     delete d;
 }
 
+void BlurDetector::setGrayImage(const cv::Mat& grayImage)
+{
+    d->grayImage = grayImage;
+}
+
 float BlurDetector::detect(const cv::Mat& image) const
 {
     try
@@ -114,10 +121,18 @@ cv::Mat BlurDetector::edgeDetection(const cv::Mat& image) const
 {
     try
     {
-        // Convert the image to grayscale
+        // Convert the image to grayscale, if not done already
 
         cv::Mat image_gray;
-        cvtColor(image, image_gray, cv::COLOR_BGR2GRAY);
+
+        if (!d->grayImage.empty() && (d->grayImage.size() == image.size()))
+        {
+            image_gray = d->grayImage;
+        }
+        else
+        {
+            cvtColor(image, image_gray, cv::COLOR_BGR2GRAY);
+        }
 
         // Use laplacian to detect edge map
 
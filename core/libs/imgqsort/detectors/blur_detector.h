@@ -33,6 +33,12 @@ public:
 
     float detect(const cv::Mat& image)                          const override;
 
+    /**
+     * Set the grey version of the image given to detect(), if it is converted already,
+     * to not convert it again.
+     */
+    void  setGrayImage(const cv::Mat& grayImage);
+
 private:
 
     cv::Mat edgeDetection(const cv::Mat& image)                 const;
@@ -60,39 +60,42 @@ ExposureDetector::~ExposureDetector()
 
 float ExposureDetector::detect(const cv::Mat& image) const
 {
-    float overexposed  = percent_overexposed(image);
-    float underexposed = percent_underexposed(image);
+    const QVector<int> histogram = levelsHistogram(image);
+    const int total              = image.total();
+
+    float overexposed            = percent_overexposed(histogram, total);
+    float underexposed           = percent_underexposed(histogram, total);
 
     return std::max(overexposed, underexposed);
 }
 
-float ExposureDetector::percent_overexposed(const cv::Mat& image) const
+int ExposureDetector::minimumImageSize() const
 {
-    int over_exposed_pixel      = count_by_condition(image, d->threshold_overexposed, 255);
-    int demi_over_exposed_pixel = count_by_condition(image, d->threshold_demi_overexposed,d->threshold_overexposed);
-    int normal_pixel            = image.total() - over_exposed_pixel - demi_over_exposed_pixel;
-
-    return (static_cast<float>(static_cast<float>(over_exposed_pixel * d->weight_over_exposure + demi_over_exposed_pixel * d->weight_demi_over_exposure) /
-                               static_cast<float>(normal_pixel + over_exposed_pixel * d->weight_over_exposure + demi_over_exposed_pixel * d->weight_demi_over_exposure)));
+    return 256;
 }
 
-float ExposureDetector::percent_underexposed(const cv::Mat& image) const
+QVector<int> ExposureDetector::levelsHistogram(const cv::Mat& image) const
 {
-    int under_exposed_pixel      = count_by_condition(image, 0, d->threshold_underexposed);
-    int demi_under_exposed_pixel = count_by_condition(image, d->threshold_underexposed, d->threshold_demi_underexposed);
-    int normal_pixel             = image.total() - under_exposed_pixel - demi_under_exposed_pixel;
-
-    return (static_cast<float>(static_cast<float>(under_exposed_pixel * d->weight_under_exposure + demi_under_exposed_pixel * d->weight_demi_under_exposure) /
-                               static_cast<float>(normal_pixel + under_exposed_pixel * d->weight_under_exposure + demi_under_exposed_pixel * d->weight_demi_under_exposure)));
-}
+    QVector<int> histogram(256, 0);
 
-int ExposureDetector::count_by_condition(const cv::Mat& image, int minVal, int maxVal) const
-{
     try
     {
-        cv::Mat mat = (image >= minVal) & (image < maxVal);
-
-        return cv::countNonZero(mat);
+        cv::Mat grey = image;
+
+        if (grey.type() != CV_8UC1)
+        {
+            image.convertTo(grey, CV_8U);
+        }
+
+        for (int y = 0 ; y < grey.rows ; ++y)
+        {
+            const uchar* const row = grey.ptr<uchar>(y);
+
+            for (int x = 0 ; x < grey.cols ; ++x)
+            {
+                ++histogram[row[x]];
+            }
+        }
     }
     catch (cv::Exception& e)
     {
@@ -103,7 +106,41 @@ int ExposureDetector::count_by_condition(const cv::Mat& image, int minVal, int m
         qCCritical(DIGIKAM_FACESENGINE_LOG) << "Default exception from OpenCV";
     }
 
-    return 0;
+    return histogram;
+}
+
+float ExposureDetector::percent_overexposed(const QVector<int>& histogram, int total) const
+{
+    int over_exposed_pixel      = count_by_condition(histogram, d->threshold_overexposed, 255);
+    int demi_over_exposed_pixel = count_by_condition(histogram, d->threshold_demi_overexposed,d->threshold_overexposed);
+    int normal_pixel            = total - over_exposed_pixel - demi_over_exposed_pixel;
+
+    return (static_cast<float>(static_cast<float>(over_exposed_pixel * d->weight_over_exposure + demi_over_exposed_pixel * d->weight_demi_over_exposure) /
+                               static_cast<float>(normal_pixel + over_exposed_pixel * d->weight_over_exposure + demi_over_exposed_pixel * d->weight_demi_over_exposure)));
+}
+
+float ExposureDetector::percent_underexposed(const QVector<int>& histogram, int total) const
+{
+    int under_exposed_pixel      = count_by_condition(histogram, 0, d->threshold_underexposed);
+    int demi_under_exposed_pixel = count_by_condition(histogram, d->threshold_underexposed, d->threshold_demi_underexposed);
+    int normal_pixel             = total - under_exposed_pixel - demi_under_exposed_pixel;
+
+    return (static_cast<float>(static_cast<float>(under_exposed_pixel * d->weight_under_exposure + demi_under_exposed_pixel * d->weight_demi_under_exposure) /
+                               static_cast<float>(normal_pixel + under_exposed_pixel * d->weight_under_exposure + demi_under_exposed_pixel * d->weight_demi_under_exposure)));
+}
+
+int ExposureDetector::count_by_condition(const QVector<int>& histogram, int minVal, int maxVal) const
+{
+    // Pixels with a level in [minVal, maxVal[
+
+    int count = 0;
+
+    for (int level = std::max(minVal, 0) ; level < std::min(maxVal, (int)histogram.size()) ; ++level)
+    {
+        count += histogram[level];
+    }
+
+    return count;
 }
 
 } // namespace Digikam
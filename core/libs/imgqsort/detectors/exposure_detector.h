@@ -15,6 +15,10 @@
 
 #pragma once
 
+// Qt includes
+
+#include <QVector>
+
 // Local includes
 
 #include "abstract_detector.h"
@@ -22,7 +26,7 @@
 namespace Digikam
 {
 
-class ExposureDetector : public AbstractDetector
+class DIGIKAM_EXPORT ExposureDetector : public AbstractDetector
 {
     Q_OBJECT
 
@@ -33,12 +37,24 @@ public:
 
     float detect(const cv::Mat& image)                  const override;
 
+    /**
+     * The proportions of clipped pixels do not depend of the resolution.
+     */
+    int   minimumImageSize()                            const override;
+
 private:
 
-    float percent_underexposed(const cv::Mat& image)    const;
-    float percent_overexposed(const cv::Mat& image)     const;
+    /**
+     * @return the number of pixels of the grey image by level, computed in a single pass.
+     */
+    QVector<int> levelsHistogram(const cv::Mat& image)  const;
+
+    float percent_underexposed(const QVector<int>& histogram,
+                               int total)               const;
+    float percent_overexposed(const QVector<int>& histogram,
+                              int total)                const;
 
-    int count_by_condition(const cv::Mat& image,
+    int count_by_condition(const QVector<int>& histogram,
                            int minVal, int maxVal)      const;
 
     // Disable
@@ -62,6 +62,9 @@ void ImageQualityParser::startAnalyse()
 
     // TODO See bug #424441: if image is null, report a defective quality
 
+    // The color and grey images are converted once for all detectors. The detectors measuring
+    // global properties run on a reduced image, see AbstractDetector::minimumImageSize().
+
     cv::Mat cvImage    = AbstractDetector::prepareForDetection(d->image);
 
     cv::Mat grayImage;
@@ -89,6 +92,9 @@ void ImageQualityParser::startAnalyse()
                 AestheticDetector::s_loadModel();
             }
 
+            // The model input is sampled from the full resolution image: a reduced image
+            // would change the sampled pixels, and the score.
+
             aestheticDetector = std::unique_ptr<AestheticDetector>(new AestheticDetector());
             aestheticScore    = aestheticDetector->detect(cvImage);
         }
@@ -97,6 +103,7 @@ void ImageQualityParser::startAnalyse()
             if (d->imq.detectBlur)
             {
                 blurDetector = std::unique_ptr<BlurDetector>(new BlurDetector(d->image));
+                blurDetector->setGrayImage(grayImage);
 
                 pool.addDetector(cvImage, d->imq.blurWeight, blurDetector.get());
             }
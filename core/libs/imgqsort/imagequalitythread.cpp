@@ -33,7 +33,10 @@ ImageQualityThread::ImageQualityThread(QObject* const parent,
 
 void ImageQualityThread::run()
 {
-    float damageLevel = m_detector->detect(m_image);
+    // The image is reduced here, in parallel with the other detectors.
+
+    cv::Mat image     = AbstractDetector::reduceForDetection(m_image, m_detector->minimumImageSize());
+    float damageLevel = m_detector->detect(image);
     m_calculator->addDetectionResult(QString(), damageLevel, m_weight);
 }
 
@@ -122,205 +122,222 @@ static void jpegutils_jpeg_output_message(j_common_ptr cinfo)
     //qCDebug(DIGIKAM_GENERAL_LOG) << buffer;
 }
 
-bool loadJPEGScaled(QImage& image, const QString& path, int maximumSize)
+/**
+ * Decode the JPEG stream set as source of cinfo, reduced by the DCT scaling of libjpeg
+ * to the smallest size not below maximumSize. The errors are thrown by jpegutils_jpeg_error_exit().
+ */
+static bool jpegutils_jpeg_decompress_scaled(struct jpeg_decompress_struct* const cinfo,
+                                             QImage& image, int maximumSize)
 {
-    FileReadLocker lock(path);
+    jpeg_read_header(cinfo, true);
 
-    if (!isJpegImage(path))
+    int imgSize = qMax(cinfo->image_width, cinfo->image_height);
+    int scale   = 1;
+
+    // libjpeg supports 1/1, 1/2, 1/4, 1/8
+
+    while (maximumSize*scale*2 <= imgSize)
     {
-        return false;
+        scale *= 2;
     }
 
-#ifdef Q_OS_WIN
-
-    FILE* const inFile = _wfopen((const wchar_t*)path.utf16(), L"rb");
+    if (scale > 8)
+    {
+        scale = 8;
+    }
+/*
+    cinfo->scale_num = 1;
+    cinfo->scale_denom = scale;
+*/
+    cinfo->scale_denom *= scale;
 
-#else
+    switch (cinfo->jpeg_color_space)
+    {
+        case JCS_UNKNOWN:
+        {
+            break;
+        }
 
-    FILE* const inFile = fopen(path.toUtf8().constData(), "rb");
+        case JCS_GRAYSCALE:
+        case JCS_RGB:
+        case JCS_YCbCr:
+        {
+            cinfo->out_color_space = JCS_RGB;
+            break;
+        }
 
-#endif
+        case JCS_CMYK:
+        case JCS_YCCK:
+        {
+            cinfo->out_color_space = JCS_CMYK;
+            break;
+        }
 
-    if (!inFile)
-    {
-        return false;
+        default:
+        {
+            break;
+        }
     }
 
-    struct jpeg_decompress_struct cinfo;
-    struct jpeg_error_mgr         jerr;
+    jpeg_start_decompress(cinfo);
 
-    // JPEG error handling - thanks to Marcus Meissner
+    QImage img;
 
-    cinfo.err                 = jpeg_std_error(&jerr);
-    cinfo.err->error_exit     = jpegutils_jpeg_error_exit;
-    cinfo.err->emit_message   = jpegutils_jpeg_emit_message;
-    cinfo.err->output_message = jpegutils_jpeg_output_message;
+    // We only take RGB with 1 or 3 components, or CMYK with 4 components
 
-    try
+    if (!(
+           (
+             (cinfo->out_color_space    == JCS_RGB)  &&
+             ((cinfo->output_components == 3) || (cinfo->output_components == 1))
+           ) ||
+           (
+             (cinfo->out_color_space    == JCS_CMYK) &&
+             (cinfo->output_components  == 4)
+           )
+         )
+       )
     {
-        jpeg_create_decompress(&cinfo);
-        jpeg_stdio_src(&cinfo, inFile);
-        jpeg_read_header(&cinfo, true);
-
-        int imgSize = qMax(cinfo.image_width, cinfo.image_height);
-        int scale   = 1;
-
-        // libjpeg supports 1/1, 1/2, 1/4, 1/8
+        return false;
+    }
 
-        while (maximumSize*scale*2 <= imgSize)
+    switch (cinfo->output_components)
+    {
+        case 3:
+        case 4:
         {
-            scale *= 2;
+            img = QImage(cinfo->output_width, cinfo->output_height, QImage::Format_RGB32);
+            break;
         }
 
-        if (scale > 8)
+        case 1: // B&W image
         {
-            scale = 8;
-        }
-/*
-        cinfo.scale_num = 1;
-        cinfo.scale_denom = scale;
-*/
-        cinfo.scale_denom *= scale;
+            img = QImage(cinfo->output_width, cinfo->output_height, QImage::Format_Indexed8);
+            img.setColorCount(256);
 
-        switch (cinfo.jpeg_color_space)
-        {
-            case JCS_UNKNOWN:
+            for (int i = 0 ; i < 256 ; ++i)
             {
-                break;
+                img.setColor(i, qRgb(i, i, i));
             }
 
-            case JCS_GRAYSCALE:
-            case JCS_RGB:
-            case JCS_YCbCr:
-            {
-                cinfo.out_color_space = JCS_RGB;
-                break;
-            }
+            break;
+        }
+    }
+
+    uchar* const data = img.bits();
+    int bpl           = img.bytesPerLine();
+
+    while (cinfo->output_scanline < cinfo->output_height)
+    {
+        uchar* d = data + cinfo->output_scanline * bpl;
+        jpeg_read_scanlines(cinfo, &d, 1);
+    }
+
+    jpeg_finish_decompress(cinfo);
 
-            case JCS_CMYK:
-            case JCS_YCCK:
+    if (cinfo->output_components == 3)
+    {
+        // Expand 24->32 bpp.
+
+        for (uint j = 0 ; j < cinfo->output_height ; ++j)
+        {
+            uchar* in       = img.scanLine(j) + cinfo->output_width * 3;
+            QRgb* const out = reinterpret_cast<QRgb*>(img.scanLine(j));
+
+            for (uint i = cinfo->output_width ; --i ; )
             {
-                cinfo.out_color_space = JCS_CMYK;
-                break;
+                in    -= 3;
+                out[i] = qRgb(in[0], in[1], in[2]);
             }
+        }
+    }
+    else if (cinfo->out_color_space == JCS_CMYK)
+    {
+        for (uint j = 0 ; j < cinfo->output_height ; ++j)
+        {
+            uchar* in       = img.scanLine(j) + cinfo->output_width * 4;
+            QRgb* const out = reinterpret_cast<QRgb*>(img.scanLine(j));
 
-            default:
+            for (uint i = cinfo->output_width ; --i ; )
             {
-                break;
+                in    -= 4;
+                int k  = in[3];
+                out[i] = qRgb(k * in[0] / 255, k * in[1] / 255, k * in[2] / 255);
             }
         }
+    }
 
-        jpeg_start_decompress(&cinfo);
+    if      (cinfo->density_unit == 1)
+    {
+        img.setDotsPerMeterX(int(100. * cinfo->X_density / 2.54));
+        img.setDotsPerMeterY(int(100. * cinfo->Y_density / 2.54));
+    }
+    else if (cinfo->density_unit == 2)
+    {
+        img.setDotsPerMeterX(int(100. * cinfo->X_density));
+        img.setDotsPerMeterY(int(100. * cinfo->Y_density));
+    }
+/*
+    int newMax = qMax(cinfo->output_width, cinfo->output_height);
+    int newx   = maximumSize*cinfo->output_width  / newMax;
+    int newy   = maximumSize*cinfo->output_height / newMax;
+*/
 
-        QImage img;
+    image = img;
 
-        // We only take RGB with 1 or 3 components, or CMYK with 4 components
+    return true;
+}
 
-        if (!(
-               (
-                 (cinfo.out_color_space    == JCS_RGB)  &&
-                 ((cinfo.output_components == 3) || (cinfo.output_components == 1))
-               ) ||
-               (
-                 (cinfo.out_color_space    == JCS_CMYK) &&
-                 (cinfo.output_components  == 4)
-               )
-             )
-           )
-        {
-            jpeg_destroy_decompress(&cinfo);
-            fclose(inFile);
+static void jpegutils_jpeg_init_decompress(struct jpeg_decompress_struct* const cinfo,
+                                           struct jpeg_error_mgr* const jerr)
+{
+    // JPEG error handling - thanks to Marcus Meissner
 
-            return false;
-        }
+    cinfo->err                 = jpeg_std_error(jerr);
+    cinfo->err->error_exit     = jpegutils_jpeg_error_exit;
+    cinfo->err->emit_message   = jpegutils_jpeg_emit_message;
+    cinfo->err->output_message = jpegutils_jpeg_output_message;
+}
 
-        switch (cinfo.output_components)
-        {
-            case 3:
-            case 4:
-            {
-                img = QImage(cinfo.output_width, cinfo.output_height, QImage::Format_RGB32);
-                break;
-            }
+bool loadJPEGScaled(QImage& image, const QString& path, int maximumSize)
+{
+    FileReadLocker lock(path);
 
-            case 1: // B&W image
-            {
-                img = QImage(cinfo.output_width, cinfo.output_height, QImage::Format_Indexed8);
-                img.setColorCount(256);
+    if (!isJpegImage(path))
+    {
+        return false;
+    }
 
-                for (int i = 0 ; i < 256 ; ++i)
-                {
-                    img.setColor(i, qRgb(i, i, i));
-                }
+#ifdef Q_OS_WIN
 
-                break;
-            }
-        }
+    FILE* const inFile = _wfopen((const wchar_t*)path.utf16(), L"rb");
 
-        uchar* const data = img.bits();
-        int bpl           = img.bytesPerLine();
+#else
 
-        while (cinfo.output_scanline < cinfo.output_height)
-        {
-            uchar* d = data + cinfo.output_scanline * bpl;
-            jpeg_read_scanlines(&cinfo, &d, 1);
-        }
+    FILE* const inFile = fopen(path.toUtf8().constData(), "rb");
 
-        jpeg_finish_decompress(&cinfo);
+#endif
 
-        if (cinfo.output_components == 3)
-        {
-            // Expand 24->32 bpp.
+    if (!inFile)
+    {
+        return false;
+    }
 
-            for (uint j = 0 ; j < cinfo.output_height ; ++j)
-            {
-                uchar* in       = img.scanLine(j) + cinfo.output_width * 3;
-                QRgb* const out = reinterpret_cast<QRgb*>(img.scanLine(j));
+    struct jpeg_decompress_struct cinfo;
+    struct jpeg_error_mgr         jerr;
 
-                for (uint i = cinfo.output_width ; --i ; )
-                {
-                    in    -= 3;
-                    out[i] = qRgb(in[0], in[1], in[2]);
-                }
-            }
-        }
-        else if (cinfo.out_color_space == JCS_CMYK)
-        {
-            for (uint j = 0 ; j < cinfo.output_height ; ++j)
-            {
-                uchar* in       = img.scanLine(j) + cinfo.output_width * 4;
-                QRgb* const out = reinterpret_cast<QRgb*>(img.scanLine(j));
+    jpegutils_jpeg_init_decompress(&cinfo, &jerr);
 
-                for (uint i = cinfo.output_width ; --i ; )
-                {
-                    in    -= 4;
-                    int k  = in[3];
-                    out[i] = qRgb(k * in[0] / 255, k * in[1] / 255, k * in[2] / 255);
-                }
-            }
-        }
+    try
+    {
+        jpeg_create_decompress(&cinfo);
+        jpeg_stdio_src(&cinfo, inFile);
+
+        const bool ret = jpegutils_jpeg_decompress_scaled(&cinfo, image, maximumSize);
 
-        if      (cinfo.density_unit == 1)
-        {
-            img.setDotsPerMeterX(int(100. * cinfo.X_density / 2.54));
-            img.setDotsPerMeterY(int(100. * cinfo.Y_density / 2.54));
-        }
-        else if (cinfo.density_unit == 2)
-        {
-            img.setDotsPerMeterX(int(100. * cinfo.X_density));
-            img.setDotsPerMeterY(int(100. * cinfo.Y_density));
-        }
-/*
-        int newMax = qMax(cinfo.output_width, cinfo.output_height);
-        int newx   = maximumSize*cinfo.output_width  / newMax;
-        int newy   = maximumSize*cinfo.output_height / newMax;
-*/
         jpeg_destroy_decompress(&cinfo);
         fclose(inFile);
 
-        image = img;
-
-        return true;
+        return ret;
     }
     catch (std::runtime_error&)
     {
@@ -331,6 +348,48 @@ bool loadJPEGScaled(QImage& image, const QString& path, int maximumSize)
     }
 }
 
+bool loadJPEGScaled(QImage& image, const QByteArray& data, int maximumSize)
+{
+    // JPEG SOI marker.
+
+    if ((data.size() < 3) || ((uchar)data[0] != 0xFF) || ((uchar)data[1] != 0xD8) || ((uchar)data[2] != 0xFF))
+    {
+        return false;
+    }
+
+    struct jpeg_decompress_struct cinfo;
+    struct jpeg_error_mgr         jerr;
+
+    jpegutils_jpeg_init_decompress(&cinfo, &jerr);
+
+    try
+    {
+        jpeg_create_decompress(&cinfo);
+
+#ifdef Q_OS_WIN
+
+        jpeg_memory_src(&cinfo, (const JOCTET*)data.constData(), data.size());
+
+#else
+
+        jpeg_mem_src(&cinfo, (unsigned char*)data.constData(), data.size());
+
+#endif
+
+        const bool ret = jpegutils_jpeg_decompress_scaled(&cinfo, image, maximumSize);
+
+        jpeg_destroy_decompress(&cinfo);
+
+        return ret;
+    }
+    catch (std::runtime_error&)
+    {
+        jpeg_destroy_decompress(&cinfo);
+
+        return false;
+    }
+}
+
 JpegRotator::JpegRotator(const QString& file)
     : m_file    (file),
       m_destFile(file)
@@ -20,6 +20,7 @@
 
 #include <QString>
 #include <QImage>
+#include <QByteArray>
 
 // Local includes
 
@@ -112,6 +113,11 @@ private:
 };
 
 DIGIKAM_EXPORT bool loadJPEGScaled(QImage& image, const QString& path, int maximumSize);
+
+/**
+ * Same as above with the JPEG data in memory, as the embedded previews of the RAW files.
+ */
+DIGIKAM_EXPORT bool loadJPEGScaled(QImage& image, const QByteArray& data, int maximumSize);
 DIGIKAM_EXPORT bool jpegConvert(const QString& src,
                                 const QString& dest,
                                 const QString& documentName,
@@ -27,6 +27,7 @@
 // Local includes
 
 #include "digikam_debug.h"
+#include "dimgmatview.h"
 #include "dnnyolodetector.h"
 #include "dnnresnetdetector.h"
 
@@ -80,22 +81,7 @@ cv::Mat AutoTagsAssign::prepareForDetection(const DImg& inputImage) const
 
     try
     {
-        int type               = inputImage.sixteenBit() ? CV_16UC4 : CV_8UC4;
-        cv::Mat cvImageWrapper = cv::Mat(inputImage.height(), inputImage.width(), type, inputImage.bits());
-
-        if (inputImage.hasAlpha())
-        {
-            cvtColor(cvImageWrapper, cvImage, cv::COLOR_RGBA2BGR);
-        }
-        else
-        {
-            cvtColor(cvImageWrapper, cvImage, cv::COLOR_RGB2BGR);
-        }
-
-        if (type == CV_16UC4)
-        {
-            cvImage.convertTo(cvImage, CV_8UC3, 1 / 256.0);
-        }
+        cvImage = DImgMatView(inputImage).toEightBitThreeChannels(DImgMatView::RGB);
     }
     catch (cv::Exception& e)
     {
@@ -129,9 +115,10 @@ cv::Mat AutoTagsAssign::prepareForDetection(const QImage& inputImage) const
             case QImage::Format_ARGB32_Premultiplied:
             {
                 // I think we can ignore premultiplication when converting to grayscale
+                // The pixels are only read: the shared data are not detached.
 
                 cvImageWrapper = cv::Mat(qimage.height(), qimage.width(), CV_8UC4,
-                                         qimage.scanLine(0), qimage.bytesPerLine());
+                                         const_cast<uchar*>(qimage.constScanLine(0)), qimage.bytesPerLine());
                 cvtColor(cvImageWrapper, cvImage, cv::COLOR_RGBA2BGR);
                 break;
             }
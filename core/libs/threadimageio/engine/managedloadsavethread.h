@@ -154,7 +154,7 @@ public:
      */
     void stopSaving(const QString& filePath = QString());
 
-    void stopAllTasks();
+    virtual void stopAllTasks();
 
     /**
      * Append a task to save the image to the task list
@@ -18,6 +18,7 @@
 
 #include <QCache>
 #include <QHash>
+#include <QStandardPaths>
 
 // KDE includes
 
@@ -27,12 +28,57 @@
 
 #include "digikam_debug.h"
 #include "iccsettings.h"
+#include "loadingcachedisk.h"
 #include "metaengine.h"
 #include "thumbnailsize.h"
 
 namespace Digikam
 {
 
+/**
+ * An image of the memory cache. When the QCache evicts it, the image is moved to the disk cache,
+ * if it was put in the cache with disk parameters. Images removed explicitly are taken from the
+ * QCache and released with dropImage(), they are not stored.
+ */
+class Q_DECL_HIDDEN LoadingCacheImage
+{
+public:
+
+    LoadingCacheImage(const DImg& img, const QString& cacheKey, const QByteArray& diskParameters,
+                      const QString& filePath, LoadingCacheDisk* const diskCache)
+        : image         (img),
+          cacheKey      (cacheKey),
+          diskParameters(diskParameters),
+          filePath      (filePath),
+          diskCache     (diskCache)
+    {
+    }
+
+    ~LoadingCacheImage()
+    {
+        if (diskCache)
+        {
+            diskCache->store(cacheKey, diskParameters, filePath, image);
+        }
+    }
+
+public:
+
+    DImg              image;
+    QString           cacheKey;
+    QByteArray        diskParameters;
+    QString           filePath;
+    LoadingCacheDisk* diskCache = nullptr;
+
+private:
+
+    // Disable
+    LoadingCacheImage(const LoadingCacheImage&)            = delete;
+    LoadingCacheImage& operator=(const LoadingCacheImage&) = delete;
+};
+
+// --------------------------------------------------------------------------------------------------------------
+
 class Q_DECL_HIDDEN LoadingCache::Private
 {
 public:
@@ -47,10 +93,12 @@ public:
     void cleanUpImageFilePathHash();
     void cleanUpThumbnailFilePathHash();
     LoadingCacheFileWatch* fileWatch() const;
+    void dropImage(const QString& cacheKey);
+    void dropImages();
 
 public:
 
-    QCache<QString, DImg>           imageCache;
+    QCache<QString, LoadingCacheImage> imageCache;
     QCache<QString, QImage>         thumbnailImageCache;
     QCache<QString, QPixmap>        thumbnailPixmapCache;
     QMultiHash<QString, QString>    imageFilePathHash;
@@ -62,10 +110,30 @@ public:
 
     QWaitCondition                  condVar;
 
-    LoadingCacheFileWatch*          watch = nullptr;
-    LoadingCache*                   q     = nullptr;
+    LoadingCacheFileWatch*          watch     = nullptr;
+    LoadingCacheDisk*               diskCache = nullptr;
+    LoadingCache*                   q         = nullptr;
 };
 
+void LoadingCache::Private::dropImage(const QString& cacheKey)
+{
+    LoadingCacheImage* const entry = imageCache.take(cacheKey);
+
+    if (entry)
+    {
+        entry->diskCache = nullptr;
+        delete entry;
+    }
+}
+
+void LoadingCache::Private::dropImages()
+{
+    Q_FOREACH (const QString& cacheKey, imageCache.keys())
+    {
+        dropImage(cacheKey);
+    }
+}
+
 LoadingCacheFileWatch* LoadingCache::Private::fileWatch() const
 {
     // install default watch if no watch is set yet
@@ -168,6 +236,11 @@ LoadingCache::LoadingCache()
 
     setThumbnailCacheSize(10, 200);
 
+    // Second level for the previews evicted from memory
+
+    d->diskCache = new LoadingCacheDisk(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) +
+                                        QLatin1String("/previews"));
+
     // good place to call it here as LoadingCache is a singleton
 
     qRegisterMetaType<LoadingDescription>("LoadingDescription");
@@ -180,6 +253,11 @@ LoadingCache::LoadingCache()
 
 LoadingCache::~LoadingCache()
 {
+    // Do not store all images at exit: only the images evicted during the session are kept on disk.
+
+    d->dropImages();
+
+    delete d->diskCache;
     delete d->watch;
     delete d;
     m_instance = nullptr;
@@ -190,17 +268,34 @@ DImg* LoadingCache::retrieveImage(const QString& cacheKey) const
     QString filePath(d->imageFilePathHash.key(cacheKey));
     d->fileWatch()->checkFileWatch(filePath);
 
-    return d->imageCache[cacheKey];
+    LoadingCacheImage* const entry = d->imageCache[cacheKey];
+
+    return (entry ? &entry->image : nullptr);
+}
+
+DImg LoadingCache::retrieveDiskImage(const QString& cacheKey, const QByteArray& diskParameters,
+                                     const QString& filePath) const
+{
+    return d->diskCache->retrieve(cacheKey, diskParameters, filePath);
 }
 
-bool LoadingCache::putImage(const QString& cacheKey, const DImg& img, const QString& filePath) const
+bool LoadingCache::putImage(const QString& cacheKey, const DImg& img,
+                            const QString& filePath, const QByteArray& diskParameters) const
 {
     bool isInserted = false;
 
     if (isCacheable(img))
     {
+        // The replaced image, if any, is the same: it is not stored on disk.
+
+        d->dropImage(cacheKey);
+
         int cost   = img.numBytes() / 1024;
-        isInserted = d->imageCache.insert(cacheKey, new DImg(img), cost);
+        isInserted = d->imageCache.insert(cacheKey,
+                                          new LoadingCacheImage(img, cacheKey, diskParameters, filePath,
+                                                                (!diskParameters.isEmpty() && !filePath.isEmpty()) ? d->diskCache
+                                                                                                                   : nullptr),
+                                          cost);
 
         if (isInserted && !filePath.isEmpty())
         {
@@ -214,12 +309,12 @@ bool LoadingCache::putImage(const QString& cacheKey, const DImg& img, const QStr
 
 void LoadingCache::removeImage(const QString& cacheKey)
 {
-    d->imageCache.remove(cacheKey);
+    d->dropImage(cacheKey);
 }
 
 void LoadingCache::removeImages()
 {
-    d->imageCache.clear();
+    d->dropImages();
 }
 
 bool LoadingCache::isCacheable(const DImg& img) const
@@ -337,9 +432,11 @@ void LoadingCache::notifyFileChanged(const QString& filePath, bool notify)
 
     Q_FOREACH (const QString& cacheKey, keys)
     {
-        d->imageCache.remove(cacheKey);
+        d->dropImage(cacheKey);
     }
 
+    d->diskCache->remove(filePath);
+
     keys = d->thumbnailFilePathHash.values(filePath);
 
     Q_FOREACH (const QString& cacheKey, keys)
@@ -365,6 +462,10 @@ void LoadingCache::iccSettingsChanged(const ICCSettingsContainer& current, const
         LoadingCache::CacheLock lock(this);
         removeImages();
         removeThumbnails();
+
+        // The stored previews were converted for the previous display profile.
+
+        d->diskCache->clear();
     }
 }
 
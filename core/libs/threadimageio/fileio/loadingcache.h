@@ -152,6 +152,15 @@ public:
      */
     bool isCacheable(const DImg& img) const;
 
+    /**
+     * Retrieves an image evicted from the memory cache to the disk cache,
+     * or a null DImg if there is none or if the file changed since.
+     * The parameters are computed by LoadingCacheDisk::parametersHash().
+     * Unlike the other methods, call it without holding the CacheLock: it reads a file.
+     */
+    DImg retrieveDiskImage(const QString& cacheKey, const QByteArray& diskParameters,
+                           const QString& filePath) const;
+
     /**
      * Put image into for given string into the cache.
      * Returns true if image has been put in the cache, false otherwise.
@@ -159,8 +168,12 @@ public:
      * When it cannot be put in the cache it is deleted.
      * The third parameter specifies a file path that will be watched.
      * If this file changes, the object will be removed from the cache.
+     * If diskParameters is not empty, the image is stored in the disk cache with these
+     * parameters, see LoadingCacheDisk::parametersHash(), when it is evicted from memory.
+     * Use it for downscaled previews, cheap to store and slow to decode again.
      */
-    bool putImage(const QString& cacheKey, const DImg& img, const QString& filePath) const;
+    bool putImage(const QString& cacheKey, const DImg& img, const QString& filePath,
+                  const QByteArray& diskParameters = QByteArray()) const;
 
     /**
      * Remove entries for the given cacheKey from the cache
@@ -0,0 +1,552 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-17
+ * Description : On-disk second level of the loading cache for preview images
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "loadingcachedisk.h"
+
+// C++ includes
+
+#include <climits>
+
+// Qt includes
+
+#include <QHash>
+#include <QMap>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QDateTime>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QWaitCondition>
+#include <QCryptographicHash>
+
+// Local includes
+
+#include "digikam_debug.h"
+#include "dmetadata.h"
+#include "iccprofile.h"
+#include "icctransform.h"
+
+namespace Digikam
+{
+
+namespace
+{
+
+const quint32 entryMagic    = 0x444B5043;      // "DKPC"
+const quint32 entryVersion  = 2;
+
+/**
+ * At most this number of images wait for the writer. If the memory cache evicts faster,
+ * the images are not stored: this is only a cache.
+ */
+const int     maxPending    = 8;
+
+/**
+ * The DImg attributes set by the loaders and the preview task, restored with the pixels.
+ */
+const char* const storedAttributes[] =
+{
+    "format",
+    "detectedFileFormat",
+    "isReadOnly",
+    "originalColorModel",
+    "originalBitDepth",
+    "originalSize",
+    "originalFilePath",
+    "fromRawEmbeddedPreview",
+    "exifRotated",
+    "scaledLoadingSize",
+    "uniqueHash"
+};
+
+class Q_DECL_HIDDEN PendingImage
+{
+public:
+
+    QString    cacheKey;
+    QByteArray parameters;
+    QString    filePath;
+    DImg       image;
+};
+
+} // namespace
+
+class Q_DECL_HIDDEN LoadingCacheDisk::Private
+{
+public:
+
+    Private() = default;
+
+    /**
+     * Entries of the same file share the prefix, to remove them without an index.
+     */
+    QString filePrefix(const QString& filePath) const
+    {
+        return QString::fromLatin1(QCryptographicHash::hash(filePath.toUtf8(),
+                                                            QCryptographicHash::Sha1).toHex().left(16));
+    }
+
+    QString entryPath(const QString& filePath, const QString& cacheKey, const QByteArray& parameters) const
+    {
+        QCryptographicHash hash(QCryptographicHash::Sha1);
+        hash.addData(cacheKey.toUtf8());
+        hash.addData(parameters);
+
+        return (directory + QLatin1Char('/') + filePrefix(filePath) + QLatin1Char('-') +
+                QString::fromLatin1(hash.result().toHex().left(16)) +
+                QLatin1String(".dcache"));
+    }
+
+    /**
+     * Pending images are identified like the entries on disk.
+     */
+    static QString pendingKey(const QString& cacheKey, const QByteArray& parameters)
+    {
+        return (cacheKey + QLatin1Char('/') + QString::fromLatin1(parameters.toHex()));
+    }
+
+    QFileInfoList entries(const QString& pattern = QLatin1String("*.dcache")) const
+    {
+        // Least recently used first: a retrieved entry is touched.
+
+        return QDir(directory).entryInfoList(QStringList() << pattern, QDir::Files,
+                                             QDir::Time | QDir::Reversed);
+    }
+
+    qint64 write(const PendingImage& entry)                                 const;
+
+    /**
+     * Remove the least recently used entries until the directory size is below target.
+     * Returns the new directory size.
+     */
+    qint64 shrink(qint64 target)                                            const;
+
+public:
+
+    QString                      directory;
+    QHash<QString, PendingImage> pending;       ///< pendingKey() -> image waiting for the writer
+
+    QMutex                       mutex;
+    QWaitCondition               condVar;
+
+    bool                         running        = true;
+    qint64                       maxBytes       = 512LL * 1024 * 1024;
+    qint64                       usedBytes      = -1;
+};
+
+qint64 LoadingCacheDisk::Private::write(const PendingImage& entry) const
+{
+    const QFileInfo info(entry.filePath);
+
+    if (!info.exists())
+    {
+        return 0;
+    }
+
+    const DImg& img = entry.image;
+    QMap<QString, QVariant> attributes;
+
+    for (const char* const key : storedAttributes)
+    {
+        const QString name = QLatin1String(key);
+
+        if (img.hasAttribute(name))
+        {
+            attributes.insert(name, img.attribute(name));
+        }
+    }
+
+    IccProfile profile = img.getIccProfile();
+    const QString path = entryPath(entry.filePath, entry.cacheKey, entry.parameters);
+    QSaveFile file(path);
+
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        return 0;
+    }
+
+    // Fastest zlib level: the pixels are written once and read back often.
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_14);
+    stream << entryMagic << entryVersion
+           << entry.cacheKey << entry.parameters << info.size() << info.lastModified().toMSecsSinceEpoch()
+           << (quint32)img.width() << (quint32)img.height() << img.sixteenBit() << img.hasAlpha()
+           << attributes << profile.data()
+           << qCompress(img.bits(), (int)img.numBytes(), 1);
+
+    if ((stream.status() != QDataStream::Ok) || !file.commit())
+    {
+        return 0;
+    }
+
+    return QFileInfo(path).size();
+}
+
+qint64 LoadingCacheDisk::Private::shrink(qint64 target) const
+{
+    const QFileInfoList infos = entries();
+    qint64 total              = 0;
+
+    for (const QFileInfo& info : infos)
+    {
+        total += info.size();
+    }
+
+    for (const QFileInfo& info : infos)
+    {
+        if (total <= target)
+        {
+            break;
+        }
+
+        if (QFile::remove(info.filePath()))
+        {
+            total -= info.size();
+        }
+    }
+
+    return total;
+}
+
+// -------------------------------------------------------------------------------------
+
+LoadingCacheDisk::LoadingCacheDisk(const QString& directory)
+    : d(new Private)
+{
+    d->directory = directory;
+    QDir().mkpath(directory);
+}
+
+LoadingCacheDisk::~LoadingCacheDisk()
+{
+    shutDown();
+
+    delete d;
+}
+
+QByteArray LoadingCacheDisk::parametersHash(const LoadingDescription& description, bool exifRotate)
+{
+    const LoadingDescription::PreviewParameters& preview     = description.previewParameters;
+    const LoadingDescription::PostProcessingParameters& post = description.postProcessingParameters;
+
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_14);
+    stream << (qint32)preview.type << (qint32)preview.size << (qint32)preview.flags
+           << (qint32)preview.previewSettings.quality << (qint32)preview.previewSettings.rawLoading
+           << preview.previewSettings.convertToEightBit
+           << (qint32)post.colorManagement << exifRotate;
+
+    // The output profile of a display conversion changes all pixels.
+
+    IccProfile profile;
+
+    if      (post.hasProfile())
+    {
+        profile = post.profile();
+    }
+    else if (post.hasTransform())
+    {
+        profile = post.transform().outputProfile();
+    }
+
+    stream << profile.data();
+
+    return QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+}
+
+void LoadingCacheDisk::store(const QString& cacheKey, const QByteArray& parameters,
+                             const QString& filePath, const DImg& img)
+{
+    if (img.isNull() || filePath.isEmpty())
+    {
+        return;
+    }
+
+    QMutexLocker lock(&d->mutex);
+
+    if (!d->running || (d->maxBytes == 0) || (d->pending.size() >= maxPending))
+    {
+        return;
+    }
+
+    PendingImage entry;
+    entry.cacheKey   = cacheKey;
+    entry.parameters = parameters;
+    entry.filePath   = filePath;
+    entry.image      = img;
+    d->pending.insert(Private::pendingKey(cacheKey, parameters), entry);
+
+    if (!isRunning())
+    {
+        start(QThread::LowestPriority);
+    }
+
+    d->condVar.wakeAll();
+}
+
+DImg LoadingCacheDisk::retrieve(const QString& cacheKey, const QByteArray& parameters, const QString& filePath)
+{
+    {
+        QMutexLocker lock(&d->mutex);
+
+        if (d->maxBytes == 0)
+        {
+            return DImg();
+        }
+
+        auto it = d->pending.constFind(Private::pendingKey(cacheKey, parameters));
+
+        if ((it != d->pending.constEnd()) && (it.value().filePath == filePath))
+        {
+            return it.value().image;
+        }
+    }
+
+    const QString path = d->entryPath(filePath, cacheKey, parameters);
+    QFile file(path);
+
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return DImg();
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_14);
+
+    quint32    magic   = 0;
+    quint32    version = 0;
+    QString    key;
+    QByteArray params;
+    qint64     size    = 0;
+    qint64     mtime   = 0;
+
+    stream >> magic >> version >> key >> params >> size >> mtime;
+
+    const QFileInfo info(filePath);
+
+    if (
+        (stream.status() != QDataStream::Ok)                        ||
+        (magic   != entryMagic)                                     ||
+        (version != entryVersion)                                   ||
+        (key     != cacheKey)                                       ||
+        (params  != parameters)                                     ||
+        !info.exists()                                              ||
+        (size    != info.size())                                    ||
+        (mtime   != info.lastModified().toMSecsSinceEpoch())
+       )
+    {
+        // Another format, a hash collision or an original file changed since: the entry is stale.
+
+        file.close();
+        QFile::remove(path);
+
+        return DImg();
+    }
+
+    quint32                 width      = 0;
+    quint32                 height     = 0;
+    bool                    sixteenBit = false;
+    bool                    hasAlpha   = false;
+    QMap<QString, QVariant> attributes;
+    QByteArray              iccData;
+    QByteArray              compressed;
+
+    stream >> width >> height >> sixteenBit >> hasAlpha >> attributes >> iccData >> compressed;
+
+    QByteArray pixels = qUncompress(compressed);
+
+    if (
+        (stream.status() != QDataStream::Ok) ||
+        (pixels.size()   != (qint64)width * height * (sixteenBit ? 8 : 4))
+       )
+    {
+        qCWarning(DIGIKAM_GENERAL_LOG) << "Corrupted preview cache entry" << path;
+
+        file.close();
+        QFile::remove(path);
+
+        return DImg();
+    }
+
+    DImg img(width, height, sixteenBit, hasAlpha, reinterpret_cast<uchar*>(pixels.data()), true);
+
+    for (auto it = attributes.constBegin() ; it != attributes.constEnd() ; ++it)
+    {
+        img.setAttribute(it.key(), it.value());
+    }
+
+    if (!iccData.isEmpty())
+    {
+        img.setIccProfile(IccProfile(iccData));
+    }
+
+    // Reading the metadata is much cheaper than decoding the image.
+
+    img.setMetadata(DMetadata(filePath).data());
+
+    file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+
+    return img;
+}
+
+void LoadingCacheDisk::remove(const QString& filePath)
+{
+    {
+        QMutexLocker lock(&d->mutex);
+
+        for (auto it = d->pending.begin() ; it != d->pending.end() ; )
+        {
+            if (it.value().filePath == filePath)
+            {
+                it = d->pending.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    qint64 removed = 0;
+
+    Q_FOREACH (const QFileInfo& info, d->entries(d->filePrefix(filePath) + QLatin1String("-*.dcache")))
+    {
+        if (QFile::remove(info.filePath()))
+        {
+            removed += info.size();
+        }
+    }
+
+    if (removed)
+    {
+        QMutexLocker lock(&d->mutex);
+
+        if (d->usedBytes >= 0)
+        {
+            d->usedBytes = qMax(0LL, d->usedBytes - removed);
+        }
+    }
+}
+
+void LoadingCacheDisk::clear()
+{
+    QMutexLocker lock(&d->mutex);
+
+    d->pending.clear();
+    d->shrink(0);
+
+    if (d->usedBytes >= 0)
+    {
+        d->usedBytes = 0;
+    }
+}
+
+void LoadingCacheDisk::setMaximumSize(int megabytes)
+{
+    QMutexLocker lock(&d->mutex);
+
+    d->maxBytes = qMax(0LL, (qint64)megabytes * 1024 * 1024);
+
+    if (d->maxBytes == 0)
+    {
+        d->pending.clear();
+    }
+
+    d->condVar.wakeAll();
+}
+
+void LoadingCacheDisk::shutDown()
+{
+    // The images not written yet are dropped: it is only a cache, and it must not delay the exit.
+
+    {
+        QMutexLocker lock(&d->mutex);
+        d->running = false;
+        d->pending.clear();
+        d->condVar.wakeAll();
+    }
+
+    wait();
+}
+
+void LoadingCacheDisk::run()
+{
+    QMutexLocker lock(&d->mutex);
+
+    while (d->running)
+    {
+        if (d->usedBytes == -1)
+        {
+            lock.unlock();
+            const qint64 used = d->shrink(LLONG_MAX);
+            lock.relock();
+
+            d->usedBytes = used;
+        }
+
+        if (d->pending.isEmpty())
+        {
+            d->condVar.wait(&d->mutex);
+            continue;
+        }
+
+        const PendingImage entry = d->pending.constBegin().value();
+
+        lock.unlock();
+        const qint64 written     = d->write(entry);
+        lock.relock();
+
+        auto it = d->pending.find(Private::pendingKey(entry.cacheKey, entry.parameters));
+
+        if      (it == d->pending.end())
+        {
+            // Removed while it was written: the original file changed, or the cache was cleared.
+
+            if (written)
+            {
+                QFile::remove(d->entryPath(entry.filePath, entry.cacheKey, entry.parameters));
+            }
+
+            continue;
+        }
+        else if (it.value().image.bits() == entry.image.bits())
+        {
+            // Else it was replaced meanwhile, and the newer image is written next.
+
+            d->pending.erase(it);
+        }
+
+        d->usedBytes += written;
+
+        if ((d->maxBytes > 0) && (d->usedBytes > d->maxBytes))
+        {
+            const qint64 target = d->maxBytes / 10 * 9;
+
+            lock.unlock();
+            const qint64 used   = d->shrink(target);
+            lock.relock();
+
+            d->usedBytes = used;
+        }
+    }
+}
+
+} // namespace Digikam
+
+#include "moc_loadingcachedisk.cpp"
@@ -0,0 +1,108 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-17
+ * Description : On-disk second level of the loading cache for preview images
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#pragma once
+
+// Qt includes
+
+#include <QThread>
+#include <QString>
+
+// Local includes
+
+#include "digikam_export.h"
+#include "dimg.h"
+#include "loadingdescription.h"
+
+namespace Digikam
+{
+
+/**
+ * Preview images evicted from the memory of LoadingCache are moved here, and stored
+ * in the cache directory by a background thread, with the pixels compressed losslessly.
+ * Reading back a preview costs a file read and a decompression instead of decoding
+ * the original file again, which is seconds for a RAW file.
+ *
+ * An entry is identified by the cache key of the LoadingDescription and by a hash of the
+ * parameters which change the pixels but are not part of the key (see parametersHash()),
+ * and is only valid as long as the original file has the same size and modification time. The directory
+ * is bounded: the least recently used entries are removed when it is full.
+ *
+ * All methods are thread-safe and can be called without the CacheLock of LoadingCache.
+ */
+class DIGIKAM_EXPORT LoadingCacheDisk : public QThread
+{
+    Q_OBJECT
+
+public:
+
+    explicit LoadingCacheDisk(const QString& directory);
+    ~LoadingCacheDisk()                                                           override;
+
+    /**
+     * Return a hash of the preview settings, of the color management and of the Exif rotation
+     * applied to the image loaded for description. The cache key only contains the file path
+     * and the preview size.
+     */
+    static QByteArray parametersHash(const LoadingDescription& description, bool exifRotate);
+
+    /**
+     * Queue an image to be stored. The image is shared, it must not be modified later.
+     */
+    void store(const QString& cacheKey, const QByteArray& parameters,
+               const QString& filePath, const DImg& img);
+
+    /**
+     * Return the stored image for cacheKey and parameters, or a null DImg if there is none
+     * or if the original file changed.
+     */
+    DImg retrieve(const QString& cacheKey, const QByteArray& parameters, const QString& filePath);
+
+    /**
+     * Remove all images stored for filePath.
+     */
+    void remove(const QString& filePath);
+
+    /**
+     * Remove all images.
+     */
+    void clear();
+
+    /**
+     * Set the maximum size of the cache directory, in megabytes. 0 disables the cache.
+     */
+    void setMaximumSize(int megabytes);
+
+    /**
+     * Write the queued images and stop the background thread.
+     */
+    void shutDown();
+
+protected:
+
+    void run()                                                                    override;
+
+private:
+
+    // Disable
+    LoadingCacheDisk(const LoadingCacheDisk&)            = delete;
+    LoadingCacheDisk& operator=(const LoadingCacheDisk&) = delete;
+
+private:
+
+    class Private;
+    Private* const d = nullptr;
+};
+
+} // namespace Digikam
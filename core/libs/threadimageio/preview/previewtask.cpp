@@ -27,6 +27,7 @@
 #include "digikam_debug.h"
 #include "dmetadata.h"
 #include "jpegutils.h"
+#include "loadingcachedisk.h"
 #include "metaenginesettings.h"
 #include "previewloadthread.h"
 
@@ -154,180 +155,22 @@ void PreviewLoadingTask::execute()
             cache->notifyNewLoadingProcess(this, m_loadingDescription);
         }
 
-        // Preview is not in cache, we will load image from file.
+        // A preview evicted from memory to the disk cache was already scaled, rotated
+        // and post-processed: it is used as is if it was with the same parameters.
 
-        DImg::FORMAT format      = DImg::fileFormat(m_loadingDescription.filePath);
-        m_fromRawEmbeddedPreview = false;
+        QByteArray diskParameters;
 
-        if (format == DImg::RAW)
+        if (m_loadingDescription.previewParameters.size > 0)
         {
-            MetaEnginePreviews previews(m_loadingDescription.filePath);
-
-            // Check original image size using Exiv2.
-
-            QSize originalSize  = previews.originalSize();
-
-            // If not valid, get original size from LibRaw
-
-            if (!originalSize.isValid())
-            {
-                DRawInfo container;
-
-                if (DRawDecoder::rawFileIdentify(container, m_loadingDescription.filePath))
-                {
-                    originalSize = container.imageSize;
-                }
-            }
-
-            switch (m_loadingDescription.previewParameters.previewSettings.quality)
-            {
-                case PreviewSettings::FastPreview:
-                case PreviewSettings::FastButLargePreview:
-                {
-                    // Size calculations
-
-                    int sizeLimit = -1;
-                    int bestSize  = qMax(originalSize.width(), originalSize.height());
-
-                    // for RAWs, the alternative is the half preview, so best size is already originalSize / 2
-
-                    bestSize     /= 2;
-
-                    if (m_loadingDescription.previewParameters.previewSettings.quality == PreviewSettings::FastButLargePreview)
-                    {
-                        sizeLimit = qMin(m_loadingDescription.previewParameters.size, bestSize);
-                    }
-
-                    if (loadExiv2Preview(previews, sizeLimit))
-                    {
-                        break;
-                    }
-
-                    if (loadLibRawPreview(sizeLimit))
-                    {
-                        break;
-                    }
-
-                    loadHalfSizeRaw();
-                    break;
-                }
-
-                case PreviewSettings::HighQualityPreview:
-                {
-                    switch (m_loadingDescription.previewParameters.previewSettings.rawLoading)
-                    {
-                        case PreviewSettings::RawPreviewAutomatic:
-                        {
-                            // If we find a preview that is larger than half size (which is what we get from half-size original data), we take it
-
-                            int acceptableSize = qMax(lround(originalSize.width()  * 0.48), lround(originalSize.height() * 0.48));
-
-                            if (loadExiv2Preview(previews, acceptableSize))
-                            {
-                                break;
-                            }
-
-                            if (loadLibRawPreview(acceptableSize))
-                            {
-                                break;
-                            }
-
-                            loadHalfSizeRaw();
-                            break;
-                        }
-
-                        case PreviewSettings::RawPreviewFromEmbeddedPreview:
-                        {
-                            if (loadExiv2Preview(previews))
-                            {
-                                break;
-                            }
-
-                            if (loadLibRawPreview())
-                            {
-                                break;
-                            }
-
-                            loadHalfSizeRaw();
-                            break;
-                        }
-
-                        case PreviewSettings::RawPreviewFromRawHalfSize:
-                        {
-                            loadHalfSizeRaw();
-                            break;
-                        }
-
-                        case PreviewSettings::RawPreviewFromRawFullSize:
-                        {
-                            loadFullSizeRaw();
-                            break;
-                        }
-                    }
-                }
-            }
-
-            // So far, everything loaded QImage. Convert to DImg.
-
-            convertQImageToDImg();
-        }
-        else // Non-RAW images
-        {
-            qCDebug(DIGIKAM_GENERAL_LOG) << "Try to get preview from" << m_loadingDescription.filePath;
-            qCDebug(DIGIKAM_GENERAL_LOG) << "Preview quality: " << m_loadingDescription.previewParameters.previewSettings.quality;
-
-            bool isFast = (m_loadingDescription.previewParameters.previewSettings.quality == PreviewSettings::FastPreview);
-
-            switch (m_loadingDescription.previewParameters.previewSettings.quality)
-            {
-                case PreviewSettings::FastPreview:
-                case PreviewSettings::FastButLargePreview:
-                {
-                    if (isFast && loadImagePreview(m_loadingDescription.previewParameters.size))
-                    {
-                        convertQImageToDImg();
-                        break;
-                    }
-
-                    // Set a hint to try to load a JPEG or PGF with the fast scale-before-decoding method
-
-                    if (isFast)
-                    {
-                        m_img.setAttribute(QLatin1String("scaledLoadingSize"), m_loadingDescription.previewParameters.size);
-                    }
-
-                    m_img.load(m_loadingDescription.filePath, this, m_loadingDescription.rawDecodingSettings);
-                    break;
-                }
-
-                case PreviewSettings::HighQualityPreview:
-                {
-                    m_img.load(m_loadingDescription.filePath, this, m_loadingDescription.rawDecodingSettings);
-                    break;
-                }
-            }
+            diskParameters = LoadingCacheDisk::parametersHash(m_loadingDescription,
+                                                              MetaEngineSettings::instance()->settings().exifRotate);
+            m_img          = cache->retrieveDiskImage(m_loadingDescription.cacheKey(), diskParameters,
+                                                      m_loadingDescription.filePath);
         }
 
-        if (continueQuery() && !m_img.isNull())
+        if (m_img.isNull())
         {
-            if (needToScale())
-            {
-                QSize scaledSize = m_img.size();
-                scaledSize.scale(m_loadingDescription.previewParameters.size,
-                                 m_loadingDescription.previewParameters.size,
-                                 Qt::KeepAspectRatio);
-                m_img = m_img.smoothScale(scaledSize.width(), scaledSize.height());
-            }
-
-            if (MetaEngineSettings::instance()->settings().exifRotate)
-            {
-                m_img.exifRotate(m_loadingDescription.filePath);
-            }
-
-            if (needsPostProcessing())
-            {
-                postProcess();
-            }
+            loadFromFile();
         }
 
         {
@@ -342,7 +185,7 @@ void PreviewLoadingTask::execute()
             if (continueQuery() && !m_img.isNull())
             {
                 cache->putImage(m_loadingDescription.cacheKey(), m_img,
-                                m_loadingDescription.filePath);
+                                m_loadingDescription.filePath, diskParameters);
 
                 // dispatch image to all listeners
 
@@ -415,6 +258,185 @@ void PreviewLoadingTask::execute()
     }
 }
 
+void PreviewLoadingTask::loadFromFile()
+{
+    // Preview is not in cache, we will load image from file.
+
+    DImg::FORMAT format      = DImg::fileFormat(m_loadingDescription.filePath);
+    m_fromRawEmbeddedPreview = false;
+
+    if (format == DImg::RAW)
+    {
+        MetaEnginePreviews previews(m_loadingDescription.filePath);
+
+        // Check original image size using Exiv2.
+
+        QSize originalSize  = previews.originalSize();
+
+        // If not valid, get original size from LibRaw
+
+        if (!originalSize.isValid())
+        {
+            DRawInfo container;
+
+            if (DRawDecoder::rawFileIdentify(container, m_loadingDescription.filePath))
+            {
+                originalSize = container.imageSize;
+            }
+        }
+
+        switch (m_loadingDescription.previewParameters.previewSettings.quality)
+        {
+            case PreviewSettings::FastPreview:
+            case PreviewSettings::FastButLargePreview:
+            {
+                // Size calculations
+
+                int sizeLimit = -1;
+                int bestSize  = qMax(originalSize.width(), originalSize.height());
+
+                // for RAWs, the alternative is the half preview, so best size is already originalSize / 2
+
+                bestSize     /= 2;
+
+                if (m_loadingDescription.previewParameters.previewSettings.quality == PreviewSettings::FastButLargePreview)
+                {
+                    sizeLimit = qMin(m_loadingDescription.previewParameters.size, bestSize);
+                }
+
+                if (loadExiv2Preview(previews, sizeLimit))
+                {
+                    break;
+                }
+
+                if (loadLibRawPreview(sizeLimit))
+                {
+                    break;
+                }
+
+                loadHalfSizeRaw();
+                break;
+            }
+
+            case PreviewSettings::HighQualityPreview:
+            {
+                switch (m_loadingDescription.previewParameters.previewSettings.rawLoading)
+                {
+                    case PreviewSettings::RawPreviewAutomatic:
+                    {
+                        // If we find a preview that is larger than half size (which is what we get from half-size original data), we take it
+
+                        int acceptableSize = qMax(lround(originalSize.width()  * 0.48), lround(originalSize.height() * 0.48));
+
+                        if (loadExiv2Preview(previews, acceptableSize))
+                        {
+                            break;
+                        }
+
+                        if (loadLibRawPreview(acceptableSize))
+                        {
+                            break;
+                        }
+
+                        loadHalfSizeRaw();
+                        break;
+                    }
+
+                    case PreviewSettings::RawPreviewFromEmbeddedPreview:
+                    {
+                        if (loadExiv2Preview(previews))
+                        {
+                            break;
+                        }
+
+                        if (loadLibRawPreview())
+                        {
+                            break;
+                        }
+
+                        loadHalfSizeRaw();
+                        break;
+                    }
+
+                    case PreviewSettings::RawPreviewFromRawHalfSize:
+                    {
+                        loadHalfSizeRaw();
+                        break;
+                    }
+
+                    case PreviewSettings::RawPreviewFromRawFullSize:
+                    {
+                        loadFullSizeRaw();
+                        break;
+                    }
+                }
+            }
+        }
+
+        // So far, everything loaded QImage. Convert to DImg.
+
+        convertQImageToDImg();
+    }
+    else // Non-RAW images
+    {
+        qCDebug(DIGIKAM_GENERAL_LOG) << "Try to get preview from" << m_loadingDescription.filePath;
+        qCDebug(DIGIKAM_GENERAL_LOG) << "Preview quality: " << m_loadingDescription.previewParameters.previewSettings.quality;
+
+        bool isFast = (m_loadingDescription.previewParameters.previewSettings.quality == PreviewSettings::FastPreview);
+
+        switch (m_loadingDescription.previewParameters.previewSettings.quality)
+        {
+            case PreviewSettings::FastPreview:
+            case PreviewSettings::FastButLargePreview:
+            {
+                if (isFast && loadImagePreview(m_loadingDescription.previewParameters.size))
+                {
+                    convertQImageToDImg();
+                    break;
+                }
+
+                // Set a hint to try to load a JPEG or PGF with the fast scale-before-decoding method
+
+                if (isFast)
+                {
+                    m_img.setAttribute(QLatin1String("scaledLoadingSize"), m_loadingDescription.previewParameters.size);
+                }
+
+                m_img.load(m_loadingDescription.filePath, this, m_loadingDescription.rawDecodingSettings);
+                break;
+            }
+
+            case PreviewSettings::HighQualityPreview:
+            {
+                m_img.load(m_loadingDescription.filePath, this, m_loadingDescription.rawDecodingSettings);
+                break;
+            }
+        }
+    }
+
+    if (continueQuery() && !m_img.isNull())
+    {
+        if (needToScale())
+        {
+            QSize scaledSize = m_img.size();
+            scaledSize.scale(m_loadingDescription.previewParameters.size,
+                             m_loadingDescription.previewParameters.size,
+                             Qt::KeepAspectRatio);
+            m_img = m_img.smoothScale(scaledSize.width(), scaledSize.height());
+        }
+
+        if (MetaEngineSettings::instance()->settings().exifRotate)
+        {
+            m_img.exifRotate(m_loadingDescription.filePath);
+        }
+
+        if (needsPostProcessing())
+        {
+            postProcess();
+        }
+    }
+}
+
 bool PreviewLoadingTask::needToScale()
 {
     switch (m_loadingDescription.previewParameters.previewSettings.quality)
@@ -608,7 +630,7 @@ bool PreviewLoadingTask::loadImagePreview(int sizeLimit)
             (qMax(img.width(), img.height()) > (uint)sizeLimit)
            )
         {
-            m_qimage = img.copyQImage();
+            m_qimage = img.sharedQImage();
             return true;
         }
     }
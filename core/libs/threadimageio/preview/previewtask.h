@@ -39,6 +39,7 @@ public:
 
 private:
 
+    void loadFromFile();
     bool loadExiv2Preview(MetaEnginePreviews& previews, int sizeLimit = -1);
     bool loadLibRawPreview(int sizeLimit = -1);
     bool loadHalfSizeRaw();
@@ -47,6 +47,39 @@ public:
         ThumbnailDatabase
     };
 
+    /**
+     * The sources of the RAW thumbnails, in the order they are tried.
+     */
+    enum RawThumbnailSource
+    {
+        ExifThumbnail = 0,          ///< The Exif thumbnail, used only if large enough.
+        EmbeddedPreview,            ///< The embedded JPEG preview, decoded reduced with the DCT scaling.
+        HalfSizeDecoding,           ///< The half size demosaicing of the RAW data.
+        NumberOfRawThumbnailSources
+    };
+
+    /**
+     * Time spent to create the thumbnails from a RAW source, for all the ThumbnailCreator instances.
+     */
+    class SourceTiming
+    {
+    public:
+
+        SourceTiming() = default;
+
+        qint64 averageTime() const
+        {
+            return (attempts ? (totalTime / attempts) : 0);
+        }
+
+    public:
+
+        qint64 attempts     = 0;
+        qint64 successes    = 0;
+        qint64 totalTime    = 0;    ///< In microseconds, including the failed attempts.
+        qint64 maximumTime  = 0;    ///< In microseconds.
+    };
+
 public:
 
     /**
@@ -170,6 +203,13 @@ public:
     static QString identifierForDetail(const ThumbnailInfo& info,
                                        const QRect& rect);
 
+    /**
+     * Returns the time spent to create the RAW thumbnails from the source,
+     * to check the cost of each step of the RAW thumbnail policy.
+     */
+    static SourceTiming rawSourceTiming(RawThumbnailSource source);
+    static void resetRawSourceTimings();
+
 private:
 
     void initialize();
@@ -188,6 +228,9 @@ private:
                            const QRect& detailRect,
                            IccProfile* const profile)                               const;
     QImage loadImagePreview(const DMetadata& metadata)                              const;
+    QImage loadRawThumbnail(const QString& path,
+                            const DMetadata& metadata,
+                            bool* const fromEmbeddedPreview)                        const;
     QImage loadPNG(const QString& path)                                             const;
 
     QImage handleAlphaChannel(const QImage& thumb)                                  const;
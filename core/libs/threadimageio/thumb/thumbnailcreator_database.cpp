@@ -28,146 +28,35 @@ void ThumbnailCreator::storeInDatabase(const ThumbnailInfo& info, const Thumbnai
 
     dbInfo.id               = d->dbIdForReplacement;
     d->dbIdForReplacement   = -1;
-    dbInfo.type             = DatabaseThumbnail::PGF;
+    dbInfo.type             = ThumbsDbCodec::storageType();
     dbInfo.modificationDate = info.modificationDate;
     dbInfo.orientationHint  = image.exifOrientation;
 
-    if      (dbInfo.type == DatabaseThumbnail::PGF)
+    if (!ThumbsDbCodec::encode(image.qimage, dbInfo.type, dbInfo.data))
     {
-        // NOTE: see bug #233094: using PGF compression level 4 there. Do not use a value > 4,
-        // else image is blurred due to down-sampling.
-
-        if (!PGFUtils::writePGFImageData(image.qimage, dbInfo.data, 4))
-        {
-            qCWarning(DIGIKAM_GENERAL_LOG) << "Cannot save PGF thumb in DB";
-            return;
-        }
+        qCWarning(DIGIKAM_GENERAL_LOG) << "Cannot save" << ThumbsDbCodec::typeName(dbInfo.type) << "thumb in DB";
+        return;
     }
-    else if (dbInfo.type == DatabaseThumbnail::JPEG)
-    {
-        QBuffer buffer(&dbInfo.data);
-        buffer.open(QIODevice::WriteOnly);
-        image.qimage.save(&buffer, "JPEG", 90);  // Here we will use JPEG quality = 90 to reduce artifacts.
-        buffer.close();
 
-        if (dbInfo.data.isNull())
-        {
-            qCWarning(DIGIKAM_GENERAL_LOG) << "Cannot save JPEG thumb in DB";
-            return;
-        }
-    }
-    else if (dbInfo.type == DatabaseThumbnail::JPEG2000)
-    {
-        QBuffer buffer(&dbInfo.data);
-        buffer.open(QIODevice::WriteOnly);
-        image.qimage.save(&buffer, "JP2");
-        buffer.close();
+    // The thumbnail is written later with others in one transaction, see ThumbnailWriteQueue.
 
-        if (dbInfo.data.isNull())
-        {
-            qCWarning(DIGIKAM_GENERAL_LOG) << "Cannot save JPEG2000 thumb in DB";
-            return;
-        }
-    }
-    else if (dbInfo.type == DatabaseThumbnail::PNG)
-    {
-        QBuffer buffer(&dbInfo.data);
-        buffer.open(QIODevice::WriteOnly);
-        image.qimage.save(&buffer, "PNG", 0);
-        buffer.close();
+    ThumbnailWriteQueue::instance()->enqueue(info, dbInfo);
+}
 
-        if (dbInfo.data.isNull())
-        {
-            qCWarning(DIGIKAM_GENERAL_LOG) << "Cannot save PNG thumb in DB";
-            return;
-        }
-    }
+ThumbsDbInfo ThumbnailCreator::loadThumbsDbInfo(const ThumbnailInfo& info) const
+{
+    ThumbsDbInfo dbInfo;
 
-    ThumbsDbAccess access;
-    BdEngineBackend::QueryState lastQueryState = BdEngineBackend::QueryState(BdEngineBackend::ConnectionError);
+    // A thumbnail not yet written in the database takes precedence
 
-    while (lastQueryState == BdEngineBackend::ConnectionError)
+    if (ThumbnailWriteQueue::instance()->find(info, dbInfo))
     {
-        lastQueryState = access.backend()->beginTransaction();
-
-        if (BdEngineBackend::NoErrors != lastQueryState)
-        {
-            continue;
-        }
-
-        // Insert thumbnail data
-
-        if (dbInfo.id == -1)
-        {
-            QVariant id;
-            lastQueryState = access.db()->insertThumbnail(dbInfo, &id);
-
-            if (BdEngineBackend::NoErrors != lastQueryState)
-            {
-                continue;
-            }
-            else
-            {
-                dbInfo.id = id.toInt();
-            }
-        }
-        else
-        {
-            lastQueryState = access.db()->replaceThumbnail(dbInfo);
-
-            if (BdEngineBackend::NoErrors != lastQueryState)
-            {
-                continue;
-            }
-        }
-
-        // Insert lookup data used to locate thumbnail data
+        d->dbIdForReplacement = dbInfo.id;
 
-        if (!info.customIdentifier.isNull())
-        {
-            lastQueryState = access.db()->insertCustomIdentifier(info.customIdentifier, dbInfo.id);
-
-            if (BdEngineBackend::NoErrors != lastQueryState)
-            {
-                continue;
-            }
-        }
-        else
-        {
-            if (!info.uniqueHash.isNull())
-            {
-                lastQueryState = access.db()->insertUniqueHash(info.uniqueHash, info.fileSize, dbInfo.id);
-
-                if (BdEngineBackend::NoErrors != lastQueryState)
-                {
-                    continue;
-                }
-            }
-
-            if (!info.filePath.isNull())
-            {
-                lastQueryState = access.db()->insertFilePath(info.filePath, dbInfo.id);
-
-                if (BdEngineBackend::NoErrors != lastQueryState)
-                {
-                    continue;
-                }
-            }
-        }
-
-        lastQueryState = access.backend()->commitTransaction();
-
-        if (BdEngineBackend::NoErrors != lastQueryState)
-        {
-            continue;
-        }
+        return dbInfo;
     }
-}
 
-ThumbsDbInfo ThumbnailCreator::loadThumbsDbInfo(const ThumbnailInfo& info) const
-{
     ThumbsDbAccess access;
-    ThumbsDbInfo   dbInfo;
 
     // Custom identifier takes precedence
 
@@ -231,54 +120,13 @@ ThumbnailImage ThumbnailCreator::loadFromDatabase(const ThumbnailInfo& info) con
         return ThumbnailImage();
     }
 
-    // Read QImage from data blob
-
-    if      (dbInfo.type == DatabaseThumbnail::PGF)
-    {
-        if (!PGFUtils::readPGFImageData(dbInfo.data, image.qimage))
-        {
-            qCWarning(DIGIKAM_GENERAL_LOG) << "Cannot load PGF thumb from DB";
-            return ThumbnailImage();
-        }
-    }
-    else if (dbInfo.type == DatabaseThumbnail::JPEG)
-    {
-        QBuffer buffer(&dbInfo.data);
-        buffer.open(QIODevice::ReadOnly);
-        image.qimage.load(&buffer, "JPEG");
-        buffer.close();
-
-        if (dbInfo.data.isNull())
-        {
-            qCWarning(DIGIKAM_GENERAL_LOG) << "Cannot load JPEG thumb from DB";
-            return ThumbnailImage();
-        }
-    }
-    else if (dbInfo.type == DatabaseThumbnail::JPEG2000)
-    {
-        QBuffer buffer(&dbInfo.data);
-        buffer.open(QIODevice::ReadOnly);
-        image.qimage.load(&buffer, "JP2");
-        buffer.close();
+    // Read QImage from data blob. Each thumbnail is decoded with its own format,
+    // the format of the new thumbnails can be different.
 
-        if (dbInfo.data.isNull())
-        {
-            qCWarning(DIGIKAM_GENERAL_LOG) << "Cannot load JPEG2000 thumb from DB";
-            return ThumbnailImage();
-        }
-    }
-    else if (dbInfo.type == DatabaseThumbnail::PNG)
+    if (!ThumbsDbCodec::decode(dbInfo.data, dbInfo.type, image.qimage))
     {
-        QBuffer buffer(&dbInfo.data);
-        buffer.open(QIODevice::ReadOnly);
-        image.qimage.load(&buffer, "PNG");
-        buffer.close();
-
-        if (dbInfo.data.isNull())
-        {
-            qCWarning(DIGIKAM_GENERAL_LOG) << "Cannot load PNG thumb from DB";
-            return ThumbnailImage();
-        }
+        qCWarning(DIGIKAM_GENERAL_LOG) << "Cannot load" << ThumbsDbCodec::typeName(dbInfo.type) << "thumb from DB";
+        return ThumbnailImage();
     }
 
     // Give priority to main database's rotation flag
@@ -303,6 +151,8 @@ ThumbnailImage ThumbnailCreator::loadFromDatabase(const ThumbnailInfo& info) con
 
 void ThumbnailCreator::deleteFromDatabase(const ThumbnailInfo& info) const
 {
+    ThumbnailWriteQueue::instance()->remove(info);
+
     ThumbsDbAccess access;
     BdEngineBackend::QueryState lastQueryState = BdEngineBackend::QueryState(BdEngineBackend::ConnectionError);
 
@@ -19,6 +19,55 @@
 namespace Digikam
 {
 
+namespace
+{
+
+class Q_DECL_HIDDEN RawSourceTimings
+{
+public:
+
+    RawSourceTimings() = default;
+
+    void record(ThumbnailCreator::RawThumbnailSource source, const QElapsedTimer& timer, bool success)
+    {
+        const qint64 time = timer.nsecsElapsed() / 1000;
+
+        QMutexLocker lock(&mutex);
+
+        ThumbnailCreator::SourceTiming& timing = timings[source];
+        timing.attempts                       += 1;
+        timing.successes                      += success ? 1 : 0;
+        timing.totalTime                      += time;
+        timing.maximumTime                     = qMax(timing.maximumTime, time);
+    }
+
+public:
+
+    QMutex                         mutex;
+    ThumbnailCreator::SourceTiming timings[ThumbnailCreator::NumberOfRawThumbnailSources];
+};
+
+Q_GLOBAL_STATIC(RawSourceTimings, s_rawSourceTimings)
+
+} // namespace
+
+ThumbnailCreator::SourceTiming ThumbnailCreator::rawSourceTiming(RawThumbnailSource source)
+{
+    QMutexLocker lock(&s_rawSourceTimings->mutex);
+
+    return s_rawSourceTimings->timings[source];
+}
+
+void ThumbnailCreator::resetRawSourceTimings()
+{
+    QMutexLocker lock(&s_rawSourceTimings->mutex);
+
+    for (int i = 0 ; i < NumberOfRawThumbnailSources ; ++i)
+    {
+        s_rawSourceTimings->timings[i] = SourceTiming();
+    }
+}
+
 ThumbnailImage ThumbnailCreator::createThumbnail(const ThumbnailInfo& info, const QRect& detailRect) const
 {
     const QString path = info.filePath;
@@ -125,26 +174,19 @@ ThumbnailImage ThumbnailCreator::createThumbnail(const ThumbnailInfo& info, cons
 
             // Trying to load with libraw: RAW files.
 
-            if (qimage.isNull())
+            if (qimage.isNull() && DRawDecoder::isRawFile(QUrl::fromLocalFile(path)))
             {
-                qCDebug(DIGIKAM_GENERAL_LOG) << "Trying to get thumbnail from Embedded preview with libraw for" << path;
+                qimage = loadRawThumbnail(path, *metadata, &fromEmbeddedPreview);
 
-                if (DRawDecoder::loadEmbeddedPreview(qimage, path))
+                if (fromEmbeddedPreview)
                 {
-                    fromEmbeddedPreview = true;
-                    profile             = metadata->getIccProfile();
+                    profile = metadata->getIccProfile();
                 }
-            }
 
-            if (qimage.isNull())
-            {
-                qCDebug(DIGIKAM_GENERAL_LOG) << "Trying to get thumbnail from half preview with libraw for" << path;
-
-                // TODO: Use DImg based loader instead?
-                // We store thumbnails unrotated, loading
-                // half preview from libraw unrotated here.
-
-                DRawDecoder::loadHalfPreview(qimage, path, false);
+                if (d->observer && !d->observer->continueQuery())
+                {
+                    return ThumbnailImage();
+                }
             }
 
             // Special case with DNG file. See bug #338081
@@ -249,7 +291,116 @@ QImage ThumbnailCreator::loadWithDImgScaled(const QString& path, IccProfile* con
         *profile = img.getIccProfile();
     }
 
-    return img.copyQImage();
+    return img.sharedQImage();
+}
+
+QImage ThumbnailCreator::loadRawThumbnail(const QString& path,
+                                          const DMetadata& metadata,
+                                          bool* const fromEmbeddedPreview) const
+{
+    // The sources are tried from the cheapest. An image smaller than the stored size
+    // is kept, and used only if the next sources fail.
+
+    const int     storageSize = d->storageSize();
+    QImage        fallback;
+    bool          fallbackEmbedded = false;
+    QElapsedTimer timer;
+
+    // The Exif thumbnail is already in the metadata, usually 160x120.
+
+    timer.start();
+    QImage qimage = metadata.getExifThumbnail(false);
+    bool large    = (qMax(qimage.width(), qimage.height()) >= storageSize);
+    s_rawSourceTimings->record(ExifThumbnail, timer, large);
+
+    if (large)
+    {
+        qCDebug(DIGIKAM_GENERAL_LOG) << "Get thumbnail from Exif thumbnail for" << path
+                                     << "in" << timer.elapsed() << "ms";
+
+        *fromEmbeddedPreview = true;
+
+        return qimage;
+    }
+
+    if (!qimage.isNull())
+    {
+        fallback         = qimage;
+        fallbackEmbedded = true;
+    }
+
+    if (d->observer && !d->observer->continueQuery())
+    {
+        return QImage();
+    }
+
+    // The embedded preview is a JPEG of several megapixels, libjpeg decodes it
+    // reduced up to 8 times without computing the full size image.
+
+    qCDebug(DIGIKAM_GENERAL_LOG) << "Trying to get thumbnail from Embedded preview with libraw for" << path;
+
+    timer.start();
+    QByteArray data;
+    qimage = QImage();
+
+    if (DRawDecoder::loadEmbeddedPreview(data, path))
+    {
+        if (!JPEGUtils::loadJPEGScaled(qimage, data, storageSize))
+        {
+            // Some cameras embed a bitmap instead of a JPEG.
+
+            qimage.loadFromData(data);
+        }
+    }
+
+    large = (qMax(qimage.width(), qimage.height()) >= storageSize);
+    s_rawSourceTimings->record(EmbeddedPreview, timer, large);
+
+    if (large)
+    {
+        qCDebug(DIGIKAM_GENERAL_LOG) << "Get thumbnail from Embedded preview for" << path
+                                     << "in" << timer.elapsed() << "ms";
+
+        *fromEmbeddedPreview = true;
+
+        return qimage;
+    }
+
+    if (qMax(qimage.width(), qimage.height()) > qMax(fallback.width(), fallback.height()))
+    {
+        fallback         = qimage;
+        fallbackEmbedded = true;
+    }
+
+    if (d->observer && !d->observer->continueQuery())
+    {
+        return QImage();
+    }
+
+    qCDebug(DIGIKAM_GENERAL_LOG) << "Trying to get thumbnail from half preview with libraw for" << path;
+
+    // TODO: Use DImg based loader instead?
+    // We store thumbnails unrotated, loading
+    // half preview from libraw unrotated here.
+
+    timer.start();
+    qimage = QImage();
+    DRawDecoder::loadHalfPreview(qimage, path, false);
+    s_rawSourceTimings->record(HalfSizeDecoding, timer, !qimage.isNull());
+
+    if (!qimage.isNull())
+    {
+        qCDebug(DIGIKAM_GENERAL_LOG) << "Get thumbnail from half preview for" << path
+                                     << "in" << timer.elapsed() << "ms";
+
+        *fromEmbeddedPreview = false;
+
+        return qimage;
+    }
+
+    *fromEmbeddedPreview = fallbackEmbedded;
+
+    return fallback;
 }
 
 QImage ThumbnailCreator::loadImageDetail(const ThumbnailInfo& info,
@@ -363,7 +514,7 @@ QImage ThumbnailCreator::loadImageDetail(const ThumbnailInfo& info,
     QRect mappedDetail = TagRegion::mapFromOriginalSize(img, detailRect);
     img.crop(mappedDetail.intersected(QRect(0, 0, img.width(), img.height())));
 
-    return img.copyQImage();
+    return img.sharedQImage();
 }
 
 QImage ThumbnailCreator::loadImagePreview(const DMetadata& metadata) const
@@ -391,7 +542,7 @@ QImage ThumbnailCreator::loadImagePreview(const DMetadata& metadata) const
 
         if (img.load(metadata.getFilePath(), loadFlags, d->observer, d->fastRawSettings))
         {
-            image = img.copyQImage();
+            image = img.sharedQImage();
         }
     }
 
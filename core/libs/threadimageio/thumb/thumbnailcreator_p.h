@@ -25,6 +25,9 @@
 #include <QBuffer>
 #include <QPainter>
 #include <QIODevice>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QElapsedTimer>
 #include <QFileInfo>
 #include <QUrlQuery>
 #include <QApplication>
@@ -60,7 +63,9 @@
 #include "thumbsdbaccess.h"
 #include "thumbsdb.h"
 #include "thumbsdbbackend.h"
+#include "thumbsdbcodec.h"
 #include "thumbnailsize.h"
+#include "thumbnailwritequeue.h"
 
 #ifdef HAVE_MEDIAPLAYER
 #   include "videothumbnailer.h"
@@ -16,6 +16,10 @@
 
 #include "thumbnailloadthread_p.h"
 
+// C++ includes
+
+#include <algorithm>
+
 namespace Digikam
 {
 
@@ -105,12 +109,26 @@ ThumbnailLoadThread::~ThumbnailLoadThread()
 {
     shutDown();
 
+    qDeleteAll(d->workers);
+
     delete d->creator;
     delete d;
 }
 
 ThumbnailLoadThread* ThumbnailLoadThread::defaultIconViewThread()
 {
+    // The icon view decodes the visible thumbnails in parallel. Half of the cores are kept
+    // for the user interface, and the number of RAW files decoded at once is bounded,
+    // each of them can use hundreds of megabytes.
+
+    static bool workersCreated = false;
+
+    if (!workersCreated)
+    {
+        workersCreated = true;
+        defaultIconViewObject->setWorkerCount(qBound(1, QThread::idealThreadCount() / 2, 8));
+    }
+
     return defaultIconViewObject;
 }
 
@@ -129,6 +147,15 @@ void ThumbnailLoadThread::cleanUp()
 
     defaultIconViewThread()->wait();
     defaultThread()->wait();
+
+    Q_FOREACH (ThumbnailLoadThread* const worker, defaultIconViewThread()->d->workers)
+    {
+        worker->wait();
+    }
+
+    // Write the pending thumbnails while the database is still open.
+
+    ThumbnailWriteQueue::instance()->shutDown();
 }
 
 void ThumbnailLoadThread::initializeThumbnailDatabase(const DbEngineParameters& params, ThumbnailInfoProvider* const provider)
@@ -140,6 +167,11 @@ void ThumbnailLoadThread::initializeThumbnailDatabase(const DbEngineParameters&
                                         "and these will not be switched to use the database. ";
     }
 
+    // The pending thumbnails belong to the previous database. The writer is started
+    // again with the first thumbnail created for the new one.
+
+    ThumbnailWriteQueue::instance()->shutDown();
+
     ThumbsDbAccess::setParameters(params);
 
     if (ThumbsDbAccess::checkReadyForUse(nullptr))
@@ -155,6 +187,11 @@ void ThumbnailLoadThread::initializeThumbnailDatabase(const DbEngineParameters&
     }
 }
 
+void ThumbnailLoadThread::writePendingThumbnails()
+{
+    ThumbnailWriteQueue::instance()->flush();
+}
+
 void ThumbnailLoadThread::setDisplayingWidget(QWidget* const widget)
 {
     static_d->profile = IccManager::displayProfile(widget);
@@ -168,6 +205,11 @@ void ThumbnailLoadThread::setThumbnailSize(int size, bool forFace)
     {
         d->creator->setThumbnailSize(size);
     }
+
+    Q_FOREACH (ThumbnailLoadThread* const worker, d->workers)
+    {
+        worker->setThumbnailSize(size, forFace);
+    }
 }
 
 int ThumbnailLoadThread::maximumThumbnailSize()
@@ -207,6 +249,168 @@ ThumbnailCreator* ThumbnailLoadThread::thumbnailCreator() const
     return d->creator;
 }
 
+void ThumbnailLoadThread::setWorkerCount(int count)
+{
+    if ((count <= 1) || !d->workers.isEmpty() || d->dispatcher)
+    {
+        return;
+    }
+
+    // Each worker has its own ThumbnailCreator, the creators are not shared between threads.
+
+    for (int i = 0 ; i < count ; ++i)
+    {
+        ThumbnailLoadThread* const worker = new ThumbnailLoadThread;
+        worker->d->dispatcher             = this;
+
+        d->workers << worker;
+        d->assigned.insert(worker, 0);
+    }
+}
+
+int ThumbnailLoadThread::workerCount() const
+{
+    return qMax(1, d->workers.size());
+}
+
+void ThumbnailLoadThread::addPriorityProvider(ThumbnailPriorityProvider* const provider)
+{
+    QMutexLocker lock(&d->queueMutex);
+
+    if (!d->priorityProviders.contains(provider))
+    {
+        d->priorityProviders << provider;
+    }
+}
+
+void ThumbnailLoadThread::removePriorityProvider(ThumbnailPriorityProvider* const provider)
+{
+    QMutexLocker lock(&d->queueMutex);
+    d->priorityProviders.removeAll(provider);
+}
+
+void ThumbnailLoadThread::updatePriorities(int maxDistance)
+{
+    QMutexLocker lock(&d->queueMutex);
+
+    if (d->priorityProviders.isEmpty() || d->queue.isEmpty())
+    {
+        return;
+    }
+
+    typedef QPair<int, ThumbnailPendingTask> DistanceTask;
+
+    QList<DistanceTask>         sorted;
+    QList<ThumbnailPendingTask> preloaded;
+    int                         canceled = 0;
+
+    Q_FOREACH (const ThumbnailPendingTask& task, d->queue)
+    {
+        if (task.preload)
+        {
+            preloaded << task;
+            continue;
+        }
+
+        // The nearest distance of the views showing this thumbnail.
+
+        int distance = -1;
+
+        Q_FOREACH (ThumbnailPriorityProvider* const provider, d->priorityProviders)
+        {
+            const int viewDistance = provider->distanceToViewport(task.description.filePath);
+
+            if ((viewDistance >= 0) && ((distance < 0) || (viewDistance < distance)))
+            {
+                distance = viewDistance;
+            }
+        }
+
+        if      (distance < 0)
+        {
+            // Unknown, requested by another view.
+
+            distance = 0;
+        }
+        else if (distance > maxDistance)
+        {
+            d->queuedKeys.remove(task.description.cacheKey());
+            ++canceled;
+            continue;
+        }
+
+        sorted << DistanceTask(distance, task);
+    }
+
+    // Stable: at the same distance, the last requested thumbnail stays first.
+
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [](const DistanceTask& a, const DistanceTask& b)
+                     {
+                         return (a.first < b.first);
+                     }
+    );
+
+    d->queue.clear();
+
+    Q_FOREACH (const DistanceTask& task, sorted)
+    {
+        d->queue << task.second;
+    }
+
+    d->queue << preloaded;
+
+    if (canceled)
+    {
+        qCDebug(DIGIKAM_GENERAL_LOG) << "Canceled" << canceled << "thumbnails out of the viewport";
+    }
+}
+
+void ThumbnailLoadThread::stopAllTasks()
+{
+    {
+        QMutexLocker lock(&d->queueMutex);
+
+        d->queue.clear();
+        d->queuedKeys.clear();
+        d->runningKeys.clear();
+
+        for (auto it = d->assigned.begin() ; it != d->assigned.end() ; ++it)
+        {
+            it.value() = 0;
+        }
+    }
+
+    Q_FOREACH (ThumbnailLoadThread* const worker, d->workers)
+    {
+        worker->stopAllTasks();
+    }
+
+    ManagedLoadSaveThread::stopAllTasks();
+}
+
+void ThumbnailLoadThread::taskHasFinished()
+{
+    QString cacheKey;
+
+    if (d->dispatcher)
+    {
+        LoadingTask* const task = dynamic_cast<LoadingTask*>(m_currentTask);
+
+        if (task)
+        {
+            cacheKey = task->loadingDescription().cacheKey();
+        }
+    }
+
+    ManagedLoadSaveThread::taskHasFinished();
+
+    if (d->dispatcher)
+    {
+        d->dispatcher->d->workerFinished(this, cacheKey);
+    }
+}
+
 int ThumbnailLoadThread::thumbnailToPixmapSize(int size) const
 {
     return d->pixmapSizeForThumbnailSize(size);
@@ -328,6 +532,14 @@ void ThumbnailLoadThread::findGroup(QList<ThumbnailIdentifier>& identifiers, int
     }
 
     QList<LoadingDescription> descriptions = d->makeDescriptions(identifiers, size);
+
+    if (!d->workers.isEmpty())
+    {
+        d->enqueue(descriptions, false);
+
+        return;
+    }
+
     ManagedLoadSaveThread::prependThumbnailGroup(descriptions);
 }
 
@@ -367,6 +579,14 @@ void ThumbnailLoadThread::findGroup(const QList<QPair<ThumbnailIdentifier, QRect
     }
 
     QList<LoadingDescription> descriptions = d->makeDescriptions(idsAndRects, size);
+
+    if (!d->workers.isEmpty())
+    {
+        d->enqueue(descriptions, false);
+
+        return;
+    }
+
     ManagedLoadSaveThread::prependThumbnailGroup(descriptions);
 }
 
@@ -400,6 +620,14 @@ void ThumbnailLoadThread::preloadGroup(QList<ThumbnailIdentifier>& identifiers,
     }
 
     QList<LoadingDescription> descriptions = d->makeDescriptions(identifiers, size);
+
+    if (!d->workers.isEmpty())
+    {
+        d->enqueue(descriptions, true);
+
+        return;
+    }
+
     ManagedLoadSaveThread::preloadThumbnailGroup(descriptions);
 }
 
@@ -422,6 +650,13 @@ void ThumbnailLoadThread::pregenerateGroup(const QList<ThumbnailIdentifier>& ide
         descriptions[i].previewParameters.flags |= LoadingDescription::PreviewParameters::OnlyPregenerate;
     }
 
+    if (!d->workers.isEmpty())
+    {
+        d->enqueue(descriptions, true);
+
+        return;
+    }
+
     ManagedLoadSaveThread::preloadThumbnailGroup(descriptions);
 }
 
@@ -439,6 +674,13 @@ void ThumbnailLoadThread::load(const LoadingDescription& description, bool prelo
         return;
     }
 
+    if (!d->workers.isEmpty())
+    {
+        d->enqueue(QList<LoadingDescription>() << description, preload);
+
+        return;
+    }
+
     if (preload)
     {
         ManagedLoadSaveThread::preloadThumbnail(description);
@@ -484,6 +726,15 @@ bool ThumbnailLoadThread::checkSize(int size)
  */
 void ThumbnailLoadThread::thumbnailLoaded(const LoadingDescription& loadingDescription, const QImage& img)
 {
+    if (d->dispatcher)
+    {
+        // A worker: the results are sent by the thread it works for.
+
+        d->dispatcher->thumbnailLoaded(loadingDescription, img);
+
+        return;
+    }
+
     // call parent to send signalThumbnailLoaded(LoadingDescription, QImage) - signal is part of public API
 
     ManagedLoadSaveThread::thumbnailLoaded(loadingDescription, img);
@@ -624,6 +875,21 @@ void ThumbnailLoadThread::storeDetailThumbnail(const QString& filePath, const QR
     d->creator->storeDetailThumbnail(filePath, detailRect, image);
 }
 
+void ThumbnailLoadThread::storeThumbnail(const QString& filePath, const DImg& preview)
+{
+    DImg image(preview);
+
+    if (image.wasExifRotated())
+    {
+        // A deep copy, the preview is shared.
+
+        image = preview.copy();
+        image.reverseExifRotate(filePath);
+    }
+
+    d->creator->store(filePath, image.copyQImage());
+}
+
 int ThumbnailLoadThread::storedSize() const
 {
     return d->creator->storedSize();
@@ -32,6 +32,28 @@ class DbEngineParameters;
 class ThumbnailCreator;
 class ThumbnailInfoProvider;
 
+class DIGIKAM_EXPORT ThumbnailPriorityProvider
+{
+public:
+
+    ThumbnailPriorityProvider()          = default;
+    virtual ~ThumbnailPriorityProvider() = default;
+
+    /**
+     * Return the distance, in items, of the thumbnail of filePath to the visible part
+     * of the view: 0 if it is visible, -1 if the view does not show this file, or does
+     * not know yet. The thread can be shared by other views, -1 does not cancel the thumbnail.
+     * Only called from the main thread, by ThumbnailLoadThread::updatePriorities().
+     */
+    virtual int distanceToViewport(const QString& filePath) = 0;
+
+private:
+
+    Q_DISABLE_COPY(ThumbnailPriorityProvider)
+};
+
+// --------------------------------------------------------------------------------------------------
+
 class DIGIKAM_EXPORT ThumbnailLoadThread : public ManagedLoadSaveThread
 {
     Q_OBJECT
@@ -59,6 +81,14 @@ public:
      */
     static void initializeThumbnailDatabase(const DbEngineParameters& params, ThumbnailInfoProvider* const provider = nullptr);
 
+    /**
+     * The created thumbnails are written to the database in batches, by a background thread.
+     * Write the pending ones now. Call this method before changing the thumbnails database
+     * directly, for instance to rename a file path, so that a pending thumbnail is not written
+     * afterwards with stale identifiers, and before listing the stored thumbnails.
+     */
+    static void writePendingThumbnails();
+
     /**
      * For color management, this sets the widget the thumbnails will be color managed for.
      * (currently it is only possible to set one global widget)
@@ -204,6 +234,41 @@ public:
      */
     void setSendSurrogatePixmap(bool send);
 
+    /**
+     * Decode the thumbnails in count worker threads instead of this thread.
+     * The API is unchanged: the pending thumbnails of all find(), findGroup() and preload
+     * methods are kept in one queue, in the same order as the single thread would
+     * process them, and are given to the workers as soon as they are free.
+     * A thumbnail requested twice is never decoded twice: the queue is deduplicated,
+     * and the workers share their loading processes through the LoadingCache.
+     * Call this method once, before loading thumbnails. Default: 1, no worker.
+     */
+    void setWorkerCount(int count);
+    int  workerCount()                                                                  const;
+
+    /**
+     * Add a view giving the priority of the pending thumbnails, see updatePriorities().
+     * Several views can share a thread, each one gives the distance of its own thumbnails.
+     * The provider must be removed before being deleted.
+     */
+    void addPriorityProvider(ThumbnailPriorityProvider* const provider);
+    void removePriorityProvider(ThumbnailPriorityProvider* const provider);
+
+    /**
+     * With workers, sort the pending thumbnails by distance to the viewport, and cancel
+     * the ones further than maxDistance items in all views. The view requests them again
+     * when they are painted. The thumbnails of which no view knows the distance, as the ones
+     * of other views sharing this thread, are kept with the visible ones.
+     * Preloaded thumbnails are not touched.
+     * Call this method from the main thread, after the view was scrolled.
+     */
+    void updatePriorities(int maxDistance);
+
+    /**
+     * Stop the tasks of this thread and of its workers, and clear the pending thumbnails.
+     */
+    void stopAllTasks()                                                                 override;
+
     /**
      * Stores the given detail thumbnail on disk.
      * Use this if possible because generation of detail thumbnails
@@ -216,6 +281,14 @@ public:
                               bool isFace = false);
     int  storedSize() const;
 
+    /**
+     * Stores a preview of PreviewLoadThread as thumbnail of the whole image.
+     * The thumbnails are stored unrotated and rotated when loaded, following the orientation
+     * of the database, so the Exif rotation of the preview is reverted before storing.
+     * The preview should at least have storedSize().
+     */
+    void storeThumbnail(const QString& filePath, const DImg& preview);
+
     /**
      * This is a tool to force regeneration of thumbnails.
      * All thumbnail files for the given file will be removed from disk,
@@ -235,6 +308,9 @@ public:
     /// NOTE: For internal use - may only be used from the thread
     ThumbnailCreator* thumbnailCreator() const;
 
+    /// NOTE: For internal use - called by the tasks from the thread
+    void taskHasFinished()                                                                override;
+
 protected:
 
     void thumbnailLoaded(const LoadingDescription& loadingDescription, const QImage& img) override;
@@ -124,6 +124,113 @@ QList<LoadingDescription> ThumbnailLoadThread::Private::makeDescriptions(const Q
     return descriptions;
 }
 
+void ThumbnailLoadThread::Private::enqueue(const QList<LoadingDescription>& descriptions, bool preload)
+{
+    QMutexLocker lock(&queueMutex);
+
+    // Loaded thumbnails are put in front, in the order of the list, as prependThumbnailGroup() does.
+    // Preloaded thumbnails are appended, and never replace a thumbnail already pending.
+
+    int index = 0;
+
+    Q_FOREACH (const LoadingDescription& description, descriptions)
+    {
+        const QString cacheKey = description.cacheKey();
+
+        if (runningKeys.contains(cacheKey))
+        {
+            continue;
+        }
+
+        if (queuedKeys.contains(cacheKey))
+        {
+            if (preload)
+            {
+                continue;
+            }
+
+            for (int i = 0 ; i < queue.size() ; ++i)
+            {
+                if (queue.at(i).description.cacheKey() == cacheKey)
+                {
+                    queue.removeAt(i);
+
+                    if (i < index)
+                    {
+                        --index;
+                    }
+
+                    break;
+                }
+            }
+        }
+
+        queuedKeys.insert(cacheKey);
+
+        if (preload)
+        {
+            queue.append(ThumbnailPendingTask(description, true));
+        }
+        else
+        {
+            queue.insert(index, ThumbnailPendingTask(description, false));
+            ++index;
+        }
+    }
+
+    dispatch();
+}
+
+void ThumbnailLoadThread::Private::dispatch()
+{
+    // Must be called with the queue mutex locked.
+    // A worker gets one task at a time: the other pending thumbnails stay here,
+    // where they can still be sorted and canceled by updatePriorities().
+
+    Q_FOREACH (ThumbnailLoadThread* const worker, workers)
+    {
+        if (queue.isEmpty())
+        {
+            return;
+        }
+
+        if (assigned.value(worker) > 0)
+        {
+            continue;
+        }
+
+        const ThumbnailPendingTask task = queue.takeFirst();
+        const QString cacheKey          = task.description.cacheKey();
+        queuedKeys.remove(cacheKey);
+        runningKeys.insert(cacheKey);
+        ++assigned[worker];
+
+        if (task.preload)
+        {
+            worker->preloadThumbnail(task.description);
+        }
+        else
+        {
+            worker->loadThumbnail(task.description);
+        }
+    }
+}
+
+void ThumbnailLoadThread::Private::workerFinished(ThumbnailLoadThread* const worker, const QString& cacheKey)
+{
+    QMutexLocker lock(&queueMutex);
+
+    runningKeys.remove(cacheKey);
+    int& count = assigned[worker];
+
+    if (count > 0)
+    {
+        --count;
+    }
+
+    dispatch();
+}
+
 void ThumbnailImageCatcher::Private::reset()
 {
     intermediate.clear();
@@ -25,6 +25,7 @@
 #include <QEventLoop>
 #include <QPainter>
 #include <QHash>
+#include <QSet>
 #include <QIcon>
 #include <QMimeType>
 #include <QMimeDatabase>
@@ -39,9 +40,11 @@
 #include "iccmanager.h"
 #include "iccprofile.h"
 #include "loadingcache.h"
+#include "loadsavetask.h"
 #include "thumbsdbaccess.h"
 #include "thumbnailsize.h"
 #include "thumbnailcreator.h"
+#include "thumbnailwritequeue.h"
 
 namespace Digikam
 {
@@ -63,6 +66,25 @@ public:
 
 // -------------------------------------------------------------------
 
+class Q_DECL_HIDDEN ThumbnailPendingTask
+{
+
+public:
+
+    ThumbnailPendingTask() = default;
+
+    ThumbnailPendingTask(const LoadingDescription& description, bool preload)
+        : description(description),
+          preload    (preload)
+    {
+    }
+
+    LoadingDescription description;
+    bool               preload      = false;
+};
+
+// -------------------------------------------------------------------
+
 class Q_DECL_HIDDEN ThumbnailLoadThreadStaticPriv
 {
 public:
@@ -106,8 +128,23 @@ public:
 
     QList<LoadingDescription>          lastDescriptions;
 
+    /// With workers: the pending thumbnails, in the order they are given to the workers.
+
+    ThumbnailLoadThread*               dispatcher           = nullptr;   ///< For a worker, the thread it works for.
+    QList<ThumbnailLoadThread*>        workers;
+    QHash<ThumbnailLoadThread*, int>   assigned;                         ///< Number of tasks given to each worker.
+    QList<ThumbnailPendingTask>        queue;
+    QSet<QString>                      queuedKeys;
+    QSet<QString>                      runningKeys;
+    QMutex                             queueMutex;
+    QList<ThumbnailPriorityProvider*>  priorityProviders;
+
 public:
 
+    void                      enqueue(const QList<LoadingDescription>& descriptions, bool preload);
+    void                      dispatch();
+    void                      workerFinished(ThumbnailLoadThread* const worker, const QString& cacheKey);
+
     LoadingDescription        createLoadingDescription(const ThumbnailIdentifier& identifier, int size, bool setLastDescription = true);
     LoadingDescription        createLoadingDescription(const ThumbnailIdentifier& identifier, int size,
                                                        const QRect& detailRect, bool setLastDescription = true);
@@ -0,0 +1,451 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-17
+ * Description : Write-behind queue storing thumbnails in database by batches
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "thumbnailwritequeue.h"
+
+// Qt includes
+
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QWaitCondition>
+#include <QElapsedTimer>
+
+// Local includes
+
+#include "digikam_debug.h"
+#include "thumbsdbaccess.h"
+#include "thumbsdbbackend.h"
+
+namespace Digikam
+{
+
+Q_GLOBAL_STATIC(ThumbnailWriteQueue, writeQueue)
+
+namespace
+{
+
+class Q_DECL_HIDDEN PendingThumbnail
+{
+public:
+
+    ThumbnailInfo info;
+    ThumbsDbInfo  dbInfo;
+};
+
+/**
+ * Key identifying a thumbnail, with the same precedence as ThumbnailCreator::loadThumbsDbInfo().
+ */
+QString pendingKey(const ThumbnailInfo& info)
+{
+    if (!info.customIdentifier.isEmpty())
+    {
+        return (QLatin1String("id:") + info.customIdentifier);
+    }
+
+    if (!info.filePath.isEmpty())
+    {
+        return (QLatin1String("path:") + info.filePath);
+    }
+
+    return (QLatin1String("hash:") + info.uniqueHash + QLatin1Char(':') + QString::number(info.fileSize));
+}
+
+} // namespace
+
+class Q_DECL_HIDDEN ThumbnailWriteQueue::Private
+{
+public:
+
+    Private() = default;
+
+    /**
+     * Look up a pending thumbnail as the database does: custom identifier first,
+     * then unique hash and file size, then file path checked against the hash.
+     * Must be called with the mutex locked.
+     */
+    const PendingThumbnail* findPending(const QHash<QString, PendingThumbnail>& map,
+                                        const ThumbnailInfo& info) const
+    {
+        if (map.isEmpty())
+        {
+            return nullptr;
+        }
+
+        if (!info.customIdentifier.isEmpty())
+        {
+            auto it = map.constFind(pendingKey(info));
+
+            return ((it != map.constEnd()) ? &it.value() : nullptr);
+        }
+
+        if (!info.uniqueHash.isEmpty())
+        {
+            // The queue is bounded by a few batches, a linear scan is cheap enough.
+
+            for (auto it = map.constBegin() ; it != map.constEnd() ; ++it)
+            {
+                if ((it.value().info.uniqueHash == info.uniqueHash) &&
+                    (it.value().info.fileSize   == info.fileSize))
+                {
+                    return &it.value();
+                }
+            }
+        }
+
+        if (!info.filePath.isEmpty())
+        {
+            auto it = map.constFind(pendingKey(info));
+
+            if (
+                (it != map.constEnd()) &&
+                (info.uniqueHash.isNull()                       ||
+                 it.value().info.uniqueHash.isNull()            ||
+                 (it.value().info.uniqueHash == info.uniqueHash))
+               )
+            {
+                return &it.value();
+            }
+        }
+
+        return nullptr;
+    }
+
+    /**
+     * Wait until the thumbnails being written, if one matches info.
+     * Must be called with the mutex locked.
+     */
+    void waitForInFlight(const ThumbnailInfo& info)
+    {
+        while (findPending(inFlight, info))
+        {
+            flushed.wait(&mutex);
+        }
+    }
+
+public:
+
+    QHash<QString, PendingThumbnail> pending;
+    QHash<QString, PendingThumbnail> inFlight;
+
+    mutable QMutex                   mutex;
+    QMutex                           flushMutex;
+    QWaitCondition                   condVar;
+    QWaitCondition                   flushed;
+    QElapsedTimer                    oldestPending;
+
+    bool                             running        = true;
+    int                              batchSize      = 100;
+    int                              flushInterval  = 2000;
+};
+
+ThumbnailWriteQueue::ThumbnailWriteQueue()
+    : d(new Private)
+{
+}
+
+ThumbnailWriteQueue::~ThumbnailWriteQueue()
+{
+    shutDown();
+
+    delete d;
+}
+
+ThumbnailWriteQueue* ThumbnailWriteQueue::instance()
+{
+    return writeQueue;
+}
+
+void ThumbnailWriteQueue::setBatchSize(int size)
+{
+    QMutexLocker lock(&d->mutex);
+    d->batchSize = qMax(1, size);
+    d->condVar.wakeAll();
+}
+
+void ThumbnailWriteQueue::setFlushInterval(int msecs)
+{
+    QMutexLocker lock(&d->mutex);
+    d->flushInterval = qMax(0, msecs);
+    d->condVar.wakeAll();
+}
+
+void ThumbnailWriteQueue::enqueue(const ThumbnailInfo& info, const ThumbsDbInfo& dbInfo)
+{
+    bool flushNow = false;
+
+    {
+        QMutexLocker lock(&d->mutex);
+
+        const QString key = pendingKey(info);
+        auto it           = d->pending.find(key);
+
+        if (it != d->pending.end())
+        {
+            // A newer thumbnail for the same item: keep the id of the row to replace.
+
+            const int id      = it.value().dbInfo.id;
+            it.value().info   = info;
+            it.value().dbInfo = dbInfo;
+
+            if (dbInfo.id == -1)
+            {
+                it.value().dbInfo.id = id;
+            }
+        }
+        else
+        {
+            if (d->pending.isEmpty())
+            {
+                d->oldestPending.start();
+            }
+
+            PendingThumbnail entry;
+            entry.info   = info;
+            entry.dbInfo = dbInfo;
+            d->pending.insert(key, entry);
+        }
+
+        if (!d->running)
+        {
+            flushNow = true;
+        }
+        else
+        {
+            if (!isRunning())
+            {
+                start(QThread::LowPriority);
+            }
+
+            // Backpressure: the writer is late, the producers help to flush.
+
+            flushNow = (d->pending.size() >= 4 * d->batchSize);
+
+            if (d->pending.size() >= d->batchSize)
+            {
+                d->condVar.wakeAll();
+            }
+        }
+    }
+
+    if (flushNow)
+    {
+        flush();
+    }
+}
+
+bool ThumbnailWriteQueue::find(const ThumbnailInfo& info, ThumbsDbInfo& dbInfo) const
+{
+    QMutexLocker lock(&d->mutex);
+
+    const PendingThumbnail* const entry = d->findPending(d->pending, info);
+
+    if (entry)
+    {
+        dbInfo = entry->dbInfo;
+
+        return true;
+    }
+
+    // If the thumbnail is being written, wait for the commit: the database is then up to date.
+
+    d->waitForInFlight(info);
+
+    return false;
+}
+
+void ThumbnailWriteQueue::remove(const ThumbnailInfo& info)
+{
+    QMutexLocker lock(&d->mutex);
+
+    const PendingThumbnail* entry = nullptr;
+
+    while ((entry = d->findPending(d->pending, info)))
+    {
+        d->pending.remove(pendingKey(entry->info));
+    }
+
+    d->waitForInFlight(info);
+}
+
+void ThumbnailWriteQueue::flush()
+{
+    QMutexLocker flushLock(&d->flushMutex);
+
+    {
+        QMutexLocker lock(&d->mutex);
+
+        if (d->pending.isEmpty())
+        {
+            return;
+        }
+
+        d->inFlight.swap(d->pending);
+    }
+
+    if (!ThumbsDbAccess::isInitialized())
+    {
+        qCDebug(DIGIKAM_GENERAL_LOG) << "Thumbnails database closed, drop"
+                                     << d->inFlight.size() << "pending thumbnails";
+    }
+    else
+    {
+        ThumbsDbAccess access;
+        BdEngineBackend::QueryState lastQueryState = BdEngineBackend::QueryState(BdEngineBackend::ConnectionError);
+
+        // The whole batch is one transaction. On connection error, the batch is written again.
+
+        while (BdEngineBackend::ConnectionError == lastQueryState)
+        {
+            lastQueryState = access.backend()->beginTransaction();
+
+            if (BdEngineBackend::NoErrors != lastQueryState)
+            {
+                continue;
+            }
+
+            for (auto it = d->inFlight.constBegin() ; it != d->inFlight.constEnd() ; ++it)
+            {
+                const ThumbnailInfo& info = it.value().info;
+                ThumbsDbInfo dbInfo       = it.value().dbInfo;
+
+                // Insert thumbnail data
+
+                if (dbInfo.id == -1)
+                {
+                    QVariant id;
+                    lastQueryState = access.db()->insertThumbnail(dbInfo, &id);
+
+                    if (BdEngineBackend::NoErrors != lastQueryState)
+                    {
+                        break;
+                    }
+
+                    dbInfo.id = id.toInt();
+                }
+                else
+                {
+                    lastQueryState = access.db()->replaceThumbnail(dbInfo);
+
+                    if (BdEngineBackend::NoErrors != lastQueryState)
+                    {
+                        break;
+                    }
+                }
+
+                // Insert lookup data used to locate thumbnail data
+
+                if (!info.customIdentifier.isNull())
+                {
+                    lastQueryState = access.db()->insertCustomIdentifier(info.customIdentifier, dbInfo.id);
+
+                    if (BdEngineBackend::NoErrors != lastQueryState)
+                    {
+                        break;
+                    }
+                }
+                else
+                {
+                    if (!info.uniqueHash.isNull())
+                    {
+                        lastQueryState = access.db()->insertUniqueHash(info.uniqueHash, info.fileSize, dbInfo.id);
+
+                        if (BdEngineBackend::NoErrors != lastQueryState)
+                        {
+                            break;
+                        }
+                    }
+
+                    if (!info.filePath.isNull())
+                    {
+                        lastQueryState = access.db()->insertFilePath(info.filePath, dbInfo.id);
+
+                        if (BdEngineBackend::NoErrors != lastQueryState)
+                        {
+                            break;
+                        }
+                    }
+                }
+            }
+
+            if (BdEngineBackend::NoErrors != lastQueryState)
+            {
+                access.backend()->rollbackTransaction();
+                continue;
+            }
+
+            lastQueryState = access.backend()->commitTransaction();
+        }
+
+        if (BdEngineBackend::NoErrors != lastQueryState)
+        {
+            qCWarning(DIGIKAM_GENERAL_LOG) << "Cannot store" << d->inFlight.size()
+                                           << "thumbnails in database";
+        }
+    }
+
+    QMutexLocker lock(&d->mutex);
+    d->inFlight.clear();
+    d->flushed.wakeAll();
+
+    if (!d->pending.isEmpty())
+    {
+        d->oldestPending.start();
+    }
+}
+
+void ThumbnailWriteQueue::shutDown()
+{
+    {
+        QMutexLocker lock(&d->mutex);
+        d->running = false;
+        d->condVar.wakeAll();
+    }
+
+    wait();
+    flush();
+
+    QMutexLocker lock(&d->mutex);
+    d->running = true;
+}
+
+void ThumbnailWriteQueue::run()
+{
+    QMutexLocker lock(&d->mutex);
+
+    while (d->running)
+    {
+        if (d->pending.isEmpty())
+        {
+            d->condVar.wait(&d->mutex);
+            continue;
+        }
+
+        const qint64 elapsed = d->oldestPending.elapsed();
+
+        if ((d->pending.size() < d->batchSize) && (elapsed < d->flushInterval))
+        {
+            d->condVar.wait(&d->mutex, (unsigned long)(d->flushInterval - elapsed));
+            continue;
+        }
+
+        lock.unlock();
+        flush();
+        lock.relock();
+    }
+}
+
+} // namespace Digikam
+
+#include "moc_thumbnailwritequeue.cpp"
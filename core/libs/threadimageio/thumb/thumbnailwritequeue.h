@@ -0,0 +1,97 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-17
+ * Description : Write-behind queue storing thumbnails in database by batches
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#pragma once
+
+// Qt includes
+
+#include <QThread>
+
+// Local includes
+
+#include "thumbnailinfo.h"
+#include "thumbsdb.h"
+
+namespace Digikam
+{
+
+/**
+ * Thumbnails created by all ThumbnailTask are not written one by one in the thumbnails
+ * database, with one transaction (and one fsync with SQLite) each. They are queued here
+ * and written by a background thread in one transaction per batch. A batch is flushed
+ * when it reaches the batch size, or when the oldest pending thumbnail is older than
+ * the flush interval.
+ *
+ * Readers stay consistent: ThumbnailCreator looks up the pending thumbnails before
+ * querying the database, and deletion waits for an in-progress flush. As each batch is
+ * one transaction, a crash can only lose the pending thumbnails, which will be created
+ * again, but never leave a partially written batch in the database.
+ */
+class ThumbnailWriteQueue : public QThread
+{
+    Q_OBJECT
+
+public:
+
+    static ThumbnailWriteQueue* instance();
+
+    /**
+     * Queue a thumbnail to be stored. dbInfo.id is the id of the thumbnail to replace, or -1.
+     * If the queue is full, the caller flushes it synchronously.
+     */
+    void enqueue(const ThumbnailInfo& info, const ThumbsDbInfo& dbInfo);
+
+    /**
+     * Return true and fill dbInfo if a thumbnail for info is still pending.
+     */
+    bool find(const ThumbnailInfo& info, ThumbsDbInfo& dbInfo)      const;
+
+    /**
+     * Drop the pending thumbnail for info, waiting for a flush in progress.
+     */
+    void remove(const ThumbnailInfo& info);
+
+    /**
+     * Write all pending thumbnails to the database now.
+     */
+    void flush();
+
+    /**
+     * Flush the pending thumbnails and stop the background thread.
+     * The thread is started again by the next enqueue(), for instance after
+     * the thumbnails database was switched.
+     */
+    void shutDown();
+
+    void setBatchSize(int size);
+    void setFlushInterval(int msecs);
+
+public:
+
+    // For Q_GLOBAL_STATIC only
+
+    ThumbnailWriteQueue();
+    ~ThumbnailWriteQueue()                                                 override;
+
+protected:
+
+    void run()                                                             override;
+
+private:
+
+    class Private;
+    Private* const d = nullptr;
+};
+
+} // namespace Digikam
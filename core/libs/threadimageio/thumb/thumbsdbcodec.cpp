@@ -0,0 +1,394 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-17
+ * Description : Encoding of the thumbnails stored in the database
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "thumbsdbcodec.h"
+
+// C++ includes
+
+#include <cstring>
+
+// Qt includes
+
+#include <QBuffer>
+#include <QDataStream>
+#include <QImageReader>
+#include <QImageWriter>
+#include <QMutex>
+#include <QMutexLocker>
+
+// KDE includes
+
+#include <klocalizedstring.h>
+
+// Local includes
+
+#include "digikam_debug.h"
+#include "pgfutils.h"
+#include "thumbsdbaccess.h"
+#include "thumbsdbbackend.h"
+
+namespace Digikam
+{
+
+namespace
+{
+
+/**
+ * The key of the format of the new thumbnails in the Settings table of the thumbnails database.
+ */
+const QLatin1String storageTypeKey("ThumbnailStorageType");
+
+/**
+ * The storage type read from the database, -1 until it is read,
+ * and the parameters of the database which it was read from.
+ */
+QMutex              cachedStorageMutex;
+int                 cachedStorageType(-1);
+DbEngineParameters  cachedStorageParameters;
+
+const char* qtImageFormat(DatabaseThumbnail::Type type)
+{
+    switch (type)
+    {
+        case DatabaseThumbnail::JPEG:
+        {
+            return "JPEG";
+        }
+
+        case DatabaseThumbnail::JPEG2000:
+        {
+            return "JP2";
+        }
+
+        case DatabaseThumbnail::PNG:
+        {
+            return "PNG";
+        }
+
+        case DatabaseThumbnail::WEBP:
+        {
+            return "WEBP";
+        }
+
+        case DatabaseThumbnail::JXL:
+        {
+            return "JXL";
+        }
+
+        default:
+        {
+            return nullptr;
+        }
+    }
+}
+
+int qtImageQuality(DatabaseThumbnail::Type type)
+{
+    switch (type)
+    {
+        case DatabaseThumbnail::JPEG:
+        {
+            return 90;      // Here we will use JPEG quality = 90 to reduce artifacts.
+        }
+
+        case DatabaseThumbnail::PNG:
+        {
+            return 0;
+        }
+
+        case DatabaseThumbnail::WEBP:
+        case DatabaseThumbnail::JXL:
+        {
+            return 85;
+        }
+
+        default:
+        {
+            return -1;
+        }
+    }
+}
+
+bool encodeRaw(const QImage& image, QByteArray& data)
+{
+    // Without alpha channel, 3 bytes per pixel are enough.
+
+    const QImage packed = image.convertToFormat(image.hasAlphaChannel() ? QImage::Format_ARGB32
+                                                                        : QImage::Format_RGB888);
+
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_14);
+    stream << (quint32)packed.width() << (quint32)packed.height() << (qint32)packed.format()
+           << qCompress(packed.constBits(), (int)packed.sizeInBytes(), 1);
+
+    return (stream.status() == QDataStream::Ok);
+}
+
+bool decodeRaw(const QByteArray& data, QImage& image)
+{
+    quint32    width  = 0;
+    quint32    height = 0;
+    qint32     format = QImage::Format_Invalid;
+    QByteArray compressed;
+
+    QDataStream stream(data);
+    stream.setVersion(QDataStream::Qt_5_14);
+    stream >> width >> height >> format >> compressed;
+
+    if (
+        (stream.status() != QDataStream::Ok)                                    ||
+        ((format != QImage::Format_ARGB32) && (format != QImage::Format_RGB888))
+       )
+    {
+        return false;
+    }
+
+    const QByteArray pixels = qUncompress(compressed);
+    QImage decoded((int)width, (int)height, (QImage::Format)format);
+
+    if (decoded.isNull() || (pixels.size() != decoded.sizeInBytes()))
+    {
+        return false;
+    }
+
+    memcpy(decoded.bits(), pixels.constData(), pixels.size());
+    image = decoded;
+
+    return true;
+}
+
+} // namespace
+
+bool ThumbsDbCodec::encode(const QImage& image, DatabaseThumbnail::Type type, QByteArray& data)
+{
+    data.clear();
+
+    if      (type == DatabaseThumbnail::PGF)
+    {
+        // NOTE: see bug #233094: using PGF compression level 4 there. Do not use a value > 4,
+        // else image is blurred due to down-sampling.
+
+        return PGFUtils::writePGFImageData(image, data, 4);
+    }
+    else if (type == DatabaseThumbnail::RAW)
+    {
+        return encodeRaw(image, data);
+    }
+
+    const char* const format = qtImageFormat(type);
+
+    if (!format)
+    {
+        return false;
+    }
+
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    const bool ret = image.save(&buffer, format, qtImageQuality(type));
+    buffer.close();
+
+    return (ret && !data.isEmpty());
+}
+
+bool ThumbsDbCodec::decode(const QByteArray& data, DatabaseThumbnail::Type type, QImage& image)
+{
+    if      (type == DatabaseThumbnail::PGF)
+    {
+        return PGFUtils::readPGFImageData(data, image);
+    }
+    else if (type == DatabaseThumbnail::RAW)
+    {
+        return decodeRaw(data, image);
+    }
+
+    const char* const format = qtImageFormat(type);
+
+    if (!format)
+    {
+        return false;
+    }
+
+    return (image.loadFromData(data, format) && !image.isNull());
+}
+
+bool ThumbsDbCodec::isSupported(DatabaseThumbnail::Type type)
+{
+    if ((type == DatabaseThumbnail::PGF) || (type == DatabaseThumbnail::RAW))
+    {
+        return true;
+    }
+
+    const char* const format = qtImageFormat(type);
+
+    if (!format)
+    {
+        return false;
+    }
+
+    const QByteArray name = QByteArray(format).toLower();
+
+    return (
+            QImageWriter::supportedImageFormats().contains(name) &&
+            QImageReader::supportedImageFormats().contains(name)
+           );
+}
+
+QList<DatabaseThumbnail::Type> ThumbsDbCodec::supportedTypes()
+{
+    // JPEG is not listed: no alpha channel support.
+
+    QList<DatabaseThumbnail::Type> types;
+
+    for (DatabaseThumbnail::Type type : { DatabaseThumbnail::PGF,
+                                          DatabaseThumbnail::RAW,
+                                          DatabaseThumbnail::PNG,
+                                          DatabaseThumbnail::JPEG2000,
+                                          DatabaseThumbnail::WEBP,
+                                          DatabaseThumbnail::JXL })
+    {
+        if (isSupported(type))
+        {
+            types << type;
+        }
+    }
+
+    return types;
+}
+
+QString ThumbsDbCodec::typeName(DatabaseThumbnail::Type type)
+{
+    switch (type)
+    {
+        case DatabaseThumbnail::PGF:
+        {
+            return i18nc("@item: thumbnails format", "PGF (lossless, default)");
+        }
+
+        case DatabaseThumbnail::JPEG:
+        {
+            return i18nc("@item: thumbnails format", "JPEG");
+        }
+
+        case DatabaseThumbnail::JPEG2000:
+        {
+            return i18nc("@item: thumbnails format", "JPEG 2000");
+        }
+
+        case DatabaseThumbnail::PNG:
+        {
+            return i18nc("@item: thumbnails format", "PNG (lossless)");
+        }
+
+        case DatabaseThumbnail::WEBP:
+        {
+            return i18nc("@item: thumbnails format", "WebP (compact)");
+        }
+
+        case DatabaseThumbnail::JXL:
+        {
+            return i18nc("@item: thumbnails format", "JPEG-XL (compact)");
+        }
+
+        case DatabaseThumbnail::RAW:
+        {
+            return i18nc("@item: thumbnails format", "Uncompressed pixels (fastest)");
+        }
+
+        default:
+        {
+            return QString();
+        }
+    }
+}
+
+DatabaseThumbnail::Type ThumbsDbCodec::storageType()
+{
+    if (!ThumbsDbAccess::isInitialized())
+    {
+        // No database yet: the default is not cached, the database can have another setting.
+
+        return DatabaseThumbnail::PGF;
+    }
+
+    const DbEngineParameters parameters = ThumbsDbAccess::parameters();
+
+    {
+        QMutexLocker lock(&cachedStorageMutex);
+
+        if ((cachedStorageType >= 0) && (cachedStorageParameters == parameters))
+        {
+            return (DatabaseThumbnail::Type)cachedStorageType;
+        }
+    }
+
+    // The database is read without holding the mutex, the caller may hold a ThumbsDbAccess.
+
+    int  type  = DatabaseThumbnail::PGF;
+    bool ready = false;
+
+    {
+        ThumbsDbAccess access;
+
+        if (access.backend()->isReady())
+        {
+            ready            = true;
+            bool ok          = false;
+            const int stored = access.db()->getSetting(storageTypeKey).toInt(&ok);
+
+            if (
+                ok                                                          &&
+                (stored >= DatabaseThumbnail::PGF)                          &&
+                (stored <= DatabaseThumbnail::LastThumbnailType)            &&
+                isSupported((DatabaseThumbnail::Type)stored)
+               )
+            {
+                type = stored;
+            }
+        }
+    }
+
+    if (ready)
+    {
+        QMutexLocker lock(&cachedStorageMutex);
+
+        cachedStorageType       = type;
+        cachedStorageParameters = parameters;
+    }
+
+    return (DatabaseThumbnail::Type)type;
+}
+
+void ThumbsDbCodec::setStorageType(DatabaseThumbnail::Type type)
+{
+    if (!isSupported(type))
+    {
+        qCWarning(DIGIKAM_GENERAL_LOG) << "Thumbnails format" << type << "is not supported";
+
+        return;
+    }
+
+    if (ThumbsDbAccess::isInitialized())
+    {
+        ThumbsDbAccess().db()->setSetting(storageTypeKey, QString::number(type));
+
+        QMutexLocker lock(&cachedStorageMutex);
+
+        cachedStorageType       = type;
+        cachedStorageParameters = ThumbsDbAccess::parameters();
+    }
+
+    qCDebug(DIGIKAM_GENERAL_LOG) << "Thumbnails are stored in database as" << typeName(type);
+}
+
+} // namespace Digikam
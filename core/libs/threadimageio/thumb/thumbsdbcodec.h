@@ -0,0 +1,93 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-17
+ * Description : Encoding of the thumbnails stored in the database
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#pragma once
+
+// Qt includes
+
+#include <QByteArray>
+#include <QImage>
+#include <QList>
+#include <QString>
+
+// Local includes
+
+#include "digikam_export.h"
+#include "thumbsdb.h"
+
+namespace Digikam
+{
+
+/**
+ * The formats of the thumbnails in the database. The decoding speed of the thumbnails
+ * is traded against the size of the database:
+ *
+ * - RAW is the fastest to decode, the largest on disk.
+ * - PGF is the historical default, lossless and compact.
+ * - WEBP and JXL are the most compact, with a lossy compression.
+ *
+ * The format of the new thumbnails is stored in the settings of the thumbnails database.
+ * The existing thumbnails keep their format until they are converted, each one is decoded
+ * according to its own type.
+ */
+class DIGIKAM_EXPORT ThumbsDbCodec
+{
+public:
+
+    /**
+     * Encode image to data in the given format. Return false on failure.
+     */
+    static bool encode(const QImage& image, DatabaseThumbnail::Type type, QByteArray& data);
+
+    /**
+     * Decode data stored in the given format. Return false on failure.
+     */
+    static bool decode(const QByteArray& data, DatabaseThumbnail::Type type, QImage& image);
+
+    /**
+     * Return true if the format can be written and read with this build.
+     * WEBP and JXL depend on the Qt image plugins installed.
+     */
+    static bool isSupported(DatabaseThumbnail::Type type);
+
+    /**
+     * The formats which can be selected for the new thumbnails.
+     */
+    static QList<DatabaseThumbnail::Type> supportedTypes();
+
+    /**
+     * A translated name of the format, for the user interface.
+     */
+    static QString typeName(DatabaseThumbnail::Type type);
+
+    /**
+     * The format of the new thumbnails, read once per database from the thumbnails database
+     * settings. PGF if it is not set, not supported, or if the database is not ready yet.
+     */
+    static DatabaseThumbnail::Type storageType();
+
+    /**
+     * Change the format of the new thumbnails and store it in the thumbnails database settings.
+     * The existing thumbnails are not converted.
+     */
+    static void setStorageType(DatabaseThumbnail::Type type);
+
+private:
+
+    // Disable
+    ThumbsDbCodec()  = delete;
+    ~ThumbsDbCodec() = delete;
+};
+
+} // namespace Digikam
@@ -31,6 +31,8 @@
 namespace Digikam
 {
 
+class DImgTiledSource;
+
 class CachedPixmapKey
 {
 public:
@@ -71,9 +73,16 @@ public:
 
     void init(GraphicsDImgItem* const q);
 
+    /**
+     * Return the part drawRect of the image scaled to completeSize. complete is set
+     * to false if a tiled source has not decoded all of it yet, it must not be cached.
+     */
+    DImg scaledImage(const QSize& completeSize, const QRect& drawRect, bool* const complete) const;
+
 public:
 
     DImg                  image;
+    DImgTiledSource*      tiledSource = nullptr;
     ImageZoomSettings     zoomSettings;
     mutable CachedPixmaps cachedPixmaps;
 };
@@ -0,0 +1,550 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-17
+ * Description : Tiled image source decoding only the visible parts of large images
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "dimgtiledsource.h"
+
+// C++ includes
+
+#include <cmath>
+
+// Qt includes
+
+#include <QCache>
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QThreadPool>
+
+// KDE includes
+
+#include <kmemoryinfo.h>
+
+// Local includes
+
+#include "digikam_debug.h"
+#include "dimgloader.h"
+#include "dimgloaderobserver.h"
+#include "dcolor.h"
+#include "dmetadata.h"
+#include "iccprofile.h"
+
+namespace Digikam
+{
+
+namespace
+{
+
+/**
+ * Side of the tiles in the full resolution image.
+ */
+const int     tileSize     = 512;
+
+/**
+ * Minimum size of the overview. The loaders reduce by powers of two, it is between one and two times this.
+ */
+const int     overviewSize = 2048;
+
+/**
+ * Smaller images are decoded completely.
+ */
+const quint64 minPixels    = 64 * 1024 * 1024;
+
+/**
+ * Largest block, tile or strip, that the loader can decode for a tile. The strips are decoded
+ * as a whole, an image stored in one compressed strip would be decoded completely for each tile.
+ */
+const quint64 maxBlockPixels = 16 * tileSize * tileSize;
+
+} // namespace
+
+class Q_DECL_HIDDEN DImgTiledSource::Private
+{
+public:
+
+    Private() = default;
+
+    class Q_DECL_HIDDEN Worker : public QRunnable
+    {
+    public:
+
+        explicit Worker(Private* const d)
+            : d(d)
+        {
+        }
+
+        void run() override
+        {
+            d->work();
+        }
+
+    private:
+
+        Private* const d = nullptr;
+    };
+
+    /**
+     * Stops the decoding of the tiles and of the overview when the source is deleted.
+     */
+    class Q_DECL_HIDDEN Observer : public DImgLoaderObserver
+    {
+    public:
+
+        explicit Observer(Private* const d)
+            : d(d)
+        {
+        }
+
+        bool continueQuery() override
+        {
+            QMutexLocker lock(&d->mutex);
+
+            return d->running;
+        }
+
+    private:
+
+        Private* const d = nullptr;
+    };
+
+public:
+
+    static quint64 tileKey(int column, int row)
+    {
+        return (((quint64)row << 32) | (quint32)column);
+    }
+
+    QRect tileRect(quint64 key) const
+    {
+        return (QRect((int)(key & 0xFFFFFFFF) * tileSize, (int)(key >> 32) * tileSize, tileSize, tileSize)
+                .intersected(QRect(QPoint(0, 0), size)));
+    }
+
+    /**
+     * The number of tiles a view can use, the others have to stay cached.
+     */
+    int maxVisibleTiles() const
+    {
+        return qMax(4, tiles.maxCost() / (tileSize * tileSize * 8 / 1024) * 3 / 4);
+    }
+
+    DImg loadOverview();
+    DImg loadTile(quint64 key);
+
+    void startWorkers();
+    void work();
+
+public:
+
+    DImgTiledSource*       q                = nullptr;
+
+    QString                filePath;
+    QSize                  size;
+    bool                   valid            = false;
+
+    QMutex                 mutex;
+    bool                   running          = true;
+    bool                   overviewPending  = true;
+    bool                   regionLoading    = true;     ///< False if the loader cannot decode the regions.
+    bool                   depthKnown       = false;
+    bool                   sixteenBit       = false;
+    bool                   hasAlpha         = false;
+
+    DImg                   overview;
+    IccProfile             iccProfile;
+
+    QCache<quint64, DImg>  tiles;                       ///< Cost in kilobytes.
+    QList<quint64>         queue;                       ///< Tiles to decode, the last first.
+    QList<quint64>         inFlight;
+    int                    workers          = 0;
+    QThreadPool            pool;
+};
+
+// -------------------------------------------------------------------------------
+
+DImg DImgTiledSource::Private::loadOverview()
+{
+    Observer observer(this);
+
+    DImg img;
+    img.setAttribute(QLatin1String("scaledLoadingSize"), overviewSize);
+    img.load(filePath, DImgLoader::LoadItemInfo | DImgLoader::LoadICCData | DImgLoader::LoadImageData, &observer);
+
+    return img;
+}
+
+DImg DImgTiledSource::Private::loadTile(quint64 key)
+{
+    Observer observer(this);
+
+    DImg img;
+    img.setAttribute(QLatin1String("loadingRegion"), tileRect(key));
+    img.load(filePath, DImgLoader::LoadImageData, &observer);
+
+    return img;
+}
+
+void DImgTiledSource::Private::startWorkers()
+{
+    // Called with the mutex locked.
+
+    while (
+           running                                        &&
+           (workers < pool.maxThreadCount())              &&
+           (overviewPending || (queue.size() > workers))
+          )
+    {
+        ++workers;
+        pool.start(new Worker(this));
+    }
+}
+
+void DImgTiledSource::Private::work()
+{
+    QMutexLocker lock(&mutex);
+
+    while (running)
+    {
+        if (overviewPending)
+        {
+            overviewPending = false;
+
+            lock.unlock();
+            const DImg img  = loadOverview();
+            lock.relock();
+
+            if (!running)
+            {
+                break;
+            }
+
+            if (!img.isNull())
+            {
+                overview    = img;
+                iccProfile  = img.getIccProfile();
+                sixteenBit  = img.sixteenBit();
+                hasAlpha    = img.hasAlpha();
+                depthKnown  = true;
+            }
+
+            lock.unlock();
+            Q_EMIT q->signalTileLoaded();
+            lock.relock();
+
+            continue;
+        }
+
+        if (queue.isEmpty() || !regionLoading)
+        {
+            break;
+        }
+
+        const quint64 key = queue.takeLast();
+
+        if (tiles.contains(key) || inFlight.contains(key))
+        {
+            continue;
+        }
+
+        inFlight << key;
+
+        lock.unlock();
+        DImg tile         = loadTile(key);
+        lock.relock();
+
+        inFlight.removeOne(key);
+
+        if (!running)
+        {
+            break;
+        }
+
+        // Another loader, found from the magic bytes, can decode the whole image instead.
+
+        if (
+            tile.isNull()                                       ||
+            (tile.size() != tileRect(key).size())               ||
+            (depthKnown && (tile.sixteenBit() != sixteenBit))
+           )
+        {
+            // The overview is used instead.
+
+            qCDebug(DIGIKAM_WIDGETS_LOG) << "Region loading not available for" << filePath;
+
+            regionLoading = false;
+            queue.clear();
+
+            continue;
+        }
+
+        sixteenBit = tile.sixteenBit();
+        hasAlpha   = tile.hasAlpha();
+        depthKnown = true;
+
+        tiles.insert(key, new DImg(tile), qMax(1, (int)(tile.numBytes() / 1024)));
+
+        lock.unlock();
+        Q_EMIT q->signalTileLoaded();
+        lock.relock();
+    }
+
+    --workers;
+}
+
+// -------------------------------------------------------------------------------
+
+DImgTiledSource::DImgTiledSource(const QString& filePath, QObject* const parent)
+    : QObject(parent),
+      d      (new Private)
+{
+    d->q        = this;
+    d->filePath = filePath;
+
+    // A tenth of the memory available when the image is opened.
+
+    KMemoryInfo memInfo;
+    setCacheSize(memInfo.isNull() ? 256
+                                  : qBound(64, (int)(memInfo.availablePhysical() / 1024.0 / 1024.0 * 0.1), 1024));
+    d->pool.setMaxThreadCount(qBound(1, QThreadPool::globalInstance()->maxThreadCount() / 2, 4));
+
+    DImg info;
+
+    if (info.loadItemInfo(filePath, false, false, false, false))
+    {
+        d->size  = info.originalSize();
+        d->valid = d->size.isValid() && !d->size.isEmpty();
+    }
+
+    QMutexLocker lock(&d->mutex);
+
+    if (d->valid)
+    {
+        d->startWorkers();
+    }
+}
+
+DImgTiledSource::~DImgTiledSource()
+{
+    {
+        QMutexLocker lock(&d->mutex);
+        d->running = false;
+        d->queue.clear();
+    }
+
+    // The loaders check the observer of the decoding in progress, and stop at the next block.
+
+    d->pool.waitForDone();
+
+    delete d;
+}
+
+bool DImgTiledSource::isSupported(const QString& filePath)
+{
+    // The region loading is implemented by the TIFF loader, the other loaders ignore it.
+
+    if (DImg::fileFormat(filePath) != DImg::TIFF)
+    {
+        return false;
+    }
+
+    DImg info;
+
+    if (!info.loadItemInfo(filePath, false, false, false, false))
+    {
+        return false;
+    }
+
+    const QSize size = info.originalSize();
+
+    if (((quint64)size.width() * (quint64)size.height()) < minPixels)
+    {
+        return false;
+    }
+
+    // The image must be stored by tiles, or by strips small enough.
+
+    const QSize block = info.attribute(QLatin1String("regionLoadingBlock")).toSize();
+
+    if (block.isEmpty() || (((quint64)block.width() * (quint64)block.height()) > maxBlockPixels))
+    {
+        qCDebug(DIGIKAM_WIDGETS_LOG) << "Blocks of" << block << "too large for the tiled display of" << filePath;
+
+        return false;
+    }
+
+    // The tiles are in the stored orientation, the whole image is rotated when it is loaded.
+
+    const MetaEngine::ImageOrientation orientation = DMetadata(filePath).getItemOrientation();
+
+    return (
+            (orientation == MetaEngine::ORIENTATION_UNSPECIFIED) ||
+            (orientation == MetaEngine::ORIENTATION_NORMAL)
+           );
+}
+
+bool DImgTiledSource::isValid() const
+{
+    return d->valid;
+}
+
+QString DImgTiledSource::filePath() const
+{
+    return d->filePath;
+}
+
+QSize DImgTiledSource::size() const
+{
+    return d->size;
+}
+
+void DImgTiledSource::setCacheSize(int megabytes)
+{
+    QMutexLocker lock(&d->mutex);
+
+    d->tiles.setMaxCost(qMax(16, megabytes) * 1024);
+}
+
+DImg DImgTiledSource::scaledRegion(const QSize& completeSize, const QRect& drawRect, bool* const complete)
+{
+    *complete = true;
+
+    if (!d->valid || completeSize.isEmpty() || drawRect.isEmpty())
+    {
+        return DImg();
+    }
+
+    const double scale = (double)completeSize.width() / (double)d->size.width();
+
+    // The part of the full resolution image, and its tiles.
+
+    const QRect full   = QRect(QPoint((int)floor(drawRect.left()        / scale),
+                                      (int)floor(drawRect.top()         / scale)),
+                               QPoint((int)ceil((drawRect.right()  + 1) / scale) - 1,
+                                      (int)ceil((drawRect.bottom() + 1) / scale) - 1))
+                         .intersected(QRect(QPoint(0, 0), d->size));
+
+    const int firstColumn = full.left()   / tileSize;
+    const int lastColumn  = full.right()  / tileSize;
+    const int firstRow    = full.top()    / tileSize;
+    const int lastRow     = full.bottom() / tileSize;
+
+    QMutexLocker lock(&d->mutex);
+
+    const DImg overview   = d->overview;
+    const bool useTiles   = d->regionLoading                                                                 &&
+                            (overview.isNull() || (scale > ((double)overview.width() / d->size.width())))   &&
+                            (((lastColumn - firstColumn + 1) * (lastRow - firstRow + 1)) <= d->maxVisibleTiles());
+
+    if (!useTiles)
+    {
+        lock.unlock();
+
+        if (overview.isNull())
+        {
+            *complete = false;
+
+            return DImg();
+        }
+
+        DImg img = overview.smoothScaleClipped(completeSize.width(), completeSize.height(),
+                                               drawRect.x(), drawRect.y(),
+                                               drawRect.width(), drawRect.height());
+        img.setIccProfile(d->iccProfile);
+
+        return img;
+    }
+
+    QList<QPair<QRect, DImg> > found;
+    QList<quint64>             missing;
+
+    for (int row = firstRow ; row <= lastRow ; ++row)
+    {
+        for (int column = firstColumn ; column <= lastColumn ; ++column)
+        {
+            const quint64 key = Private::tileKey(column, row);
+            DImg* const tile  = d->tiles.object(key);
+
+            if (tile)
+            {
+                found << qMakePair(d->tileRect(key), *tile);
+            }
+            else
+            {
+                missing << key;
+            }
+        }
+    }
+
+    // The tiles of a previous view not decoded yet are not wanted anymore.
+
+    d->queue = missing;
+    d->startWorkers();
+
+    const bool depthKnown = d->depthKnown;
+    const bool sixteenBit = d->sixteenBit;
+    const bool hasAlpha   = d->hasAlpha;
+
+    lock.unlock();
+
+    *complete = missing.isEmpty();
+
+    if (!depthKnown)
+    {
+        return DImg();
+    }
+
+    DImg result(drawRect.width(), drawRect.height(), sixteenBit, hasAlpha);
+
+    if (!overview.isNull() && !missing.isEmpty())
+    {
+        DImg background = overview.smoothScaleClipped(completeSize.width(), completeSize.height(),
+                                                      drawRect.x(), drawRect.y(),
+                                                      drawRect.width(), drawRect.height());
+        result.bitBltImage(&background, 0, 0);
+    }
+    else
+    {
+        result.fill(DColor(0, 0, 0, 0, sixteenBit));
+    }
+
+    for (const QPair<QRect, DImg>& tile : found)
+    {
+        // The edges are rounded the same way for the neighbor tiles.
+
+        const int   x0     = (int)floor(tile.first.left()         * scale);
+        const int   y0     = (int)floor(tile.first.top()          * scale);
+        const int   x1     = (int)floor((tile.first.right()  + 1) * scale);
+        const int   y1     = (int)floor((tile.first.bottom() + 1) * scale);
+        const QRect dest   = QRect(x0, y0, x1 - x0, y1 - y0);
+        const QRect part   = dest.intersected(drawRect);
+
+        if (part.isEmpty())
+        {
+            continue;
+        }
+
+        DImg scaled        = tile.second.smoothScaleClipped(dest.width(), dest.height(),
+                                                            part.x() - x0, part.y() - y0,
+                                                            part.width(), part.height());
+        result.bitBltImage(&scaled, part.x() - drawRect.x(), part.y() - drawRect.y());
+    }
+
+    result.setIccProfile(d->iccProfile);
+
+    return result;
+}
+
+} // namespace Digikam
+
+#include "moc_dimgtiledsource.cpp"
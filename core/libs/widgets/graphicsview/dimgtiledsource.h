@@ -0,0 +1,99 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-17
+ * Description : Tiled image source decoding only the visible parts of large images
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#pragma once
+
+// Qt includes
+
+#include <QObject>
+#include <QString>
+#include <QSize>
+#include <QRect>
+
+// Local includes
+
+#include "digikam_export.h"
+#include "dimg.h"
+
+namespace Digikam
+{
+
+/**
+ * Display source for the images too large to be decoded before being shown, used by
+ * GraphicsDImgItem while the whole image is not available. A low resolution overview is
+ * decoded first, then the tiles of the full resolution intersecting the viewport, in a
+ * thread pool, using the region loading of the DImg loader (the "loadingRegion" attribute).
+ * The decoded tiles are kept in a least recently used cache of bounded size.
+ */
+class DIGIKAM_EXPORT DImgTiledSource : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    /**
+     * The file is opened and the overview decoding is started.
+     * Check isValid() for a file which cannot be displayed by tiles.
+     */
+    explicit DImgTiledSource(const QString& filePath, QObject* const parent = nullptr);
+    ~DImgTiledSource()                                                                 override;
+
+    /**
+     * Return true if the file is an image large enough to be displayed by tiles,
+     * in a format and an orientation which allow the region loading, and stored by
+     * tiles or by strips small enough to be decoded for each tile.
+     */
+    static bool isSupported(const QString& filePath);
+
+    bool    isValid()                                                            const;
+    QString filePath()                                                           const;
+
+    /**
+     * The size of the full resolution image.
+     */
+    QSize   size()                                                               const;
+
+    /**
+     * Return the part drawRect of the image scaled to completeSize, composed from the cached
+     * tiles, or from the overview where they are missing. The missing tiles are requested,
+     * signalTileLoaded() is emitted when they are available. complete is set to false if the
+     * result must be computed again later. A null image is returned if nothing is decoded yet.
+     */
+    DImg    scaledRegion(const QSize& completeSize, const QRect& drawRect, bool* const complete);
+
+    /**
+     * Maximum memory used by the decoded tiles, in megabytes.
+     */
+    void    setCacheSize(int megabytes);
+
+Q_SIGNALS:
+
+    /**
+     * Emitted from the decoding threads when the overview or a tile is available.
+     */
+    void signalTileLoaded();
+
+private:
+
+    // Disable
+    DImgTiledSource(const DImgTiledSource&)            = delete;
+    DImgTiledSource& operator=(const DImgTiledSource&) = delete;
+
+private:
+
+    class Private;
+    Private* const d = nullptr;
+};
+
+} // namespace Digikam
@@ -26,6 +26,7 @@
 // Local includes
 
 #include "dimg.h"
+#include "dimgtiledsource.h"
 #include "imagezoomsettings.h"
 
 namespace Digikam
@@ -132,10 +133,27 @@ void GraphicsDImgItem::GraphicsDImgItemPrivate::init(GraphicsDImgItem* const q)
     q->setAcceptedMouseButtons(Qt::NoButton);
 }
 
+DImg GraphicsDImgItem::GraphicsDImgItemPrivate::scaledImage(const QSize& completeSize,
+                                                            const QRect& drawRect,
+                                                            bool* const complete) const
+{
+    if (tiledSource && image.isNull())
+    {
+        return tiledSource->scaledRegion(completeSize, drawRect, complete);
+    }
+
+    *complete = true;
+
+    return image.smoothScaleClipped(completeSize.width(), completeSize.height(),
+                                    drawRect.x(), drawRect.y(),
+                                    drawRect.width(), drawRect.height());
+}
+
 GraphicsDImgItem::~GraphicsDImgItem()
 {
     Q_D(GraphicsDImgItem);
 
+    delete d->tiledSource;
     delete d;
 }
 
@@ -143,6 +161,9 @@ void GraphicsDImgItem::setImage(const DImg& img)
 {
     Q_D(GraphicsDImgItem);
 
+    delete d->tiledSource;
+    d->tiledSource = nullptr;
+
     d->image = img;
     d->zoomSettings.setImageSize(img.size(), img.originalSize());
     d->cachedPixmaps.clear();
@@ -158,6 +179,42 @@ DImg GraphicsDImgItem::image() const
     return d->image;
 }
 
+void GraphicsDImgItem::setTiledSource(DImgTiledSource* const source)
+{
+    Q_D(GraphicsDImgItem);
+
+    if (!source && !d->tiledSource)
+    {
+        return;
+    }
+
+    delete d->tiledSource;
+    d->tiledSource = source;
+    d->image       = DImg();
+
+    if (source)
+    {
+        connect(source, SIGNAL(signalTileLoaded()),
+                this, SLOT(slotTileLoaded()));
+
+        d->zoomSettings.setImageSize(source->size(), source->size());
+    }
+    else
+    {
+        d->zoomSettings.setImageSize(QSize());
+    }
+
+    d->cachedPixmaps.clear();
+    sizeHasChanged();
+
+    Q_EMIT imageChanged();
+}
+
+void GraphicsDImgItem::slotTileLoaded()
+{
+    update();
+}
+
 void GraphicsDImgItem::sizeHasChanged()
 {
     Q_D(GraphicsDImgItem);
@@ -255,17 +312,22 @@ void GraphicsDImgItem::paint(QPainter* painter, const QStyleOptionGraphicsItem*
     {
         // scale "as if" scaling to whole image, but clip output to our exposed region
 
+        bool  complete           = true;
         QSize scaledCompleteSize = QSizeF(dpr * completeSize.width(),
                                           dpr * completeSize.height()).toSize();
-        DImg scaledImage         = d->image.smoothScaleClipped(scaledCompleteSize.width(),
-                                                               scaledCompleteSize.height(),
-                                                               scaledDrawRect.x(),
-                                                               scaledDrawRect.y(),
-                                                               scaledDrawRect.width(),
-                                                               scaledDrawRect.height());
-        pix                      = scaledImage.convertToPixmap();
-        d->cachedPixmaps.insert(scaledDrawRect, pix);
-        painter->drawPixmap(drawRect, pix);
+        DImg scaledImage         = d->scaledImage(scaledCompleteSize, scaledDrawRect, &complete);
+
+        if (!scaledImage.isNull())
+        {
+            pix = scaledImage.convertToPixmap();
+
+            if (complete)
+            {
+                d->cachedPixmaps.insert(scaledDrawRect, pix);
+            }
+
+            painter->drawPixmap(drawRect, pix);
+        }
     }
 }
 
@@ -29,6 +29,7 @@ namespace Digikam
 {
 
 class DImg;
+class DImgTiledSource;
 class ImageZoomSettings;
 
 class DIGIKAM_EXPORT GraphicsDImgItem : public QGraphicsObject
@@ -47,6 +48,12 @@ public:
     void setImage(const DImg& img);
     DImg image()                                                const;
 
+    /**
+     * Draw the image from a tiled source until setImage() is called, for the images
+     * too large to be decoded before being shown. The item takes the ownership.
+     */
+    void setTiledSource(DImgTiledSource* const source);
+
     const ImageZoomSettings* zoomSettings()                     const;
     ImageZoomSettings*       zoomSettings();
 
@@ -75,6 +82,10 @@ protected:
 
     void contextMenuEvent(QGraphicsSceneContextMenuEvent* e)          override;
 
+private Q_SLOTS:
+
+    void slotTileLoaded();
+
 public:
 
     // Declared public because of DImgPreviewItemPrivate.
@@ -24,11 +24,13 @@
 #include <QString>
 #include <QDebug>
 #include <QSqlDatabase>
+#include <QRandomGenerator>
 
 // Local includes
 
 #include "digikam_debug.h"
 #include "haariface.h"
+#include "haarsignaturescorer.h"
 #include "duplicatesfinder.h"
 #include "albumselectors.h"
 #include "album.h"
@@ -631,6 +633,141 @@ void HaarIfaceTest::testReferenceFolderPartlySelected()
     }
 }
 
+namespace
+{
+
+/**
+ * Random signature with unique coefficients per channel. If a reference is given,
+ * about a half of the coefficients is taken from it to get some matches.
+ */
+Haar::SignatureData randomSignature(QRandomGenerator& rand, const Haar::SignatureData* const ref = nullptr)
+{
+    Haar::SignatureData sig;
+
+    for (int channel = 0 ; channel < 3 ; ++channel)
+    {
+        sig.avg[channel] = rand.bounded(1.0);
+        QSet<int> used;
+
+        for (int coef = 0 ; coef < Haar::NumberOfCoefficients ; )
+        {
+            int value = 0;
+
+            if (ref && rand.bounded(2))
+            {
+                value = ref->sig[channel][rand.bounded((int)Haar::NumberOfCoefficients)];
+            }
+            else
+            {
+                value = rand.bounded(1, (int)Haar::NumberOfPixelsSquared);
+                value = rand.bounded(2) ? value : -value;
+            }
+
+            if (!used.contains(value))
+            {
+                used << value;
+                sig.sig[channel][coef++] = value;
+            }
+        }
+    }
+
+    return sig;
+}
+
+/**
+ * The score as computed by HaarIface before the vectorized kernels.
+ */
+double referenceScore(const Haar::SignatureData& querySig, const Haar::SignatureData& targetSig)
+{
+    Haar::Weights weights(Haar::Weights::ScannedSketch);
+    Haar::SignatureMap queryMaps[3];
+    double score = 0.0;
+
+    for (int channel = 0 ; channel < 3 ; ++channel)
+    {
+        queryMaps[channel].fill(querySig.sig[channel]);
+        score += weights.weightForAverage(channel) * fabs(querySig.avg[channel] - targetSig.avg[channel]);
+    }
+
+    for (int channel = 0 ; channel < 3 ; ++channel)
+    {
+        for (int coef = 0 ; coef < Haar::NumberOfCoefficients ; ++coef)
+        {
+            const int x = targetSig.sig[channel][coef];
+
+            if (queryMaps[channel][x])
+            {
+                // Weight bin: max(i, j) of the pixel position, saturated at 5.
+
+                const int pos = qAbs(x);
+                const int bin = qMin(5, qMax(pos / (int)Haar::NumberOfPixels, pos % (int)Haar::NumberOfPixels));
+                score        -= weights.weight(bin, channel);
+            }
+        }
+    }
+
+    return score;
+}
+
+} // namespace
+
+void HaarIfaceTest::testScoringKernels()
+{
+    QRandomGenerator rand(20240909);
+    const int count = 1000;
+
+    const Haar::SignatureData query = randomSignature(rand);
+    QVector<Haar::SignatureData> targets;
+    QVector<qint16>              coefs;
+    QVector<double>              avgs;
+    QVector<double>              expected;
+
+    targets << query;
+
+    while (targets.size() < count)
+    {
+        targets << randomSignature(rand, (targets.size() % 4) ? &query : nullptr);
+    }
+
+    for (const Haar::SignatureData& target : qAsConst(targets))
+    {
+        for (int channel = 0 ; channel < 3 ; ++channel)
+        {
+            avgs << target.avg[channel];
+
+            for (int coef = 0 ; coef < Haar::NumberOfCoefficients ; ++coef)
+            {
+                coefs << (qint16)target.sig[channel][coef];
+            }
+        }
+
+        expected << referenceScore(query, target);
+    }
+
+    const QList<SignatureScorer::Kernel> kernels = { SignatureScorer::Scalar, SignatureScorer::AVX2 };
+
+    for (SignatureScorer::Kernel kernel : kernels)
+    {
+        if (!SignatureScorer::isSupported(kernel))
+        {
+            qCDebug(DIGIKAM_TESTS_LOG) << "Haar scoring kernel" << kernel << "not supported by this CPU";
+            continue;
+        }
+
+        SignatureScorer scorer(query, Haar::Weights::ScannedSketch, kernel);
+        QCOMPARE(scorer.kernel(), kernel);
+
+        QVector<double> scores(count);
+        scorer.score(coefs.constData(), avgs.constData(), count, scores.data());
+
+        for (int i = 0 ; i < count ; ++i)
+        {
+            QCOMPARE(scores.at(i), expected.at(i));
+            QCOMPARE(scorer.score(targets.at(i)), expected.at(i));
+        }
+    }
+}
+
 HaarIfaceTest::~HaarIfaceTest()
 {
 }
@@ -0,0 +1,189 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-17
+ * Description : Unit tests of the DImg pixel buffers pool
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "dimgbufferpool_utest.h"
+
+// Qt includes
+
+#include <QTest>
+
+// Local includes
+
+#include "dimg.h"
+#include "dimgbufferpool.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(DImgBufferPoolTest)
+
+DImgBufferPoolTest::DImgBufferPoolTest(QObject* const parent)
+    : QObject(parent)
+{
+}
+
+void DImgBufferPoolTest::init()
+{
+    DImgBufferPool* const pool = DImgBufferPool::instance();
+    QVERIFY(pool);
+
+    pool->clear();
+    pool->setCacheSize(64);
+    pool->setMinimumBufferSize(256 * 1024);
+}
+
+void DImgBufferPoolTest::testReuse()
+{
+    DImgBufferPool* const pool              = DImgBufferPool::instance();
+    const DImgBufferPool::Statistics before = pool->statistics();
+
+    uchar* const first = pool->allocate(1000 * 1000 * 4);
+    QVERIFY(first);
+    pool->release(first, 1000 * 1000 * 4);
+
+    QCOMPARE(pool->statistics().cachedBuffers, before.cachedBuffers + 1);
+
+    // A slightly smaller image of the same size class gets the same buffer.
+
+    uchar* const second = pool->allocate(990 * 1000 * 4);
+    QCOMPARE(second, first);
+    QCOMPARE(pool->statistics().reuses, before.reuses + 1);
+
+    // A much larger one cannot.
+
+    uchar* const third  = pool->allocate(2000 * 2000 * 4);
+    QVERIFY(third);
+    QVERIFY(third != second);
+
+    pool->release(second, 990 * 1000 * 4);
+    pool->release(third,  2000 * 2000 * 4);
+
+    QCOMPARE(pool->statistics().usedBytes, before.usedBytes);
+}
+
+void DImgBufferPoolTest::testAdoption()
+{
+    DImgBufferPool* const pool              = DImgBufferPool::instance();
+    const DImgBufferPool::Statistics before = pool->statistics();
+
+    // A buffer allocated with new[], as the loaders do.
+
+    const size_t size  = 1024 * 1024 * 4;
+    uchar* const data  = new uchar[size];
+    pool->release(data, size);
+
+    QCOMPARE(pool->statistics().adoptions, before.adoptions + 1);
+    QCOMPARE(pool->allocate(size), data);
+
+    pool->release(data, size);
+
+    // The small buffers are freed directly.
+
+    uchar* const small = new uchar[1024];
+    pool->release(small, 1024);
+
+    QCOMPARE(pool->statistics().adoptions, before.adoptions + 1);
+}
+
+void DImgBufferPoolTest::testTake()
+{
+    DImgBufferPool* const pool              = DImgBufferPool::instance();
+    const DImgBufferPool::Statistics before = pool->statistics();
+
+    const size_t size = 1024 * 1024 * 4;
+    uchar* const data = pool->allocate(size);
+    QVERIFY(data);
+    QVERIFY(pool->statistics().usedBytes > before.usedBytes);
+
+    pool->take(data);
+    QCOMPARE(pool->statistics().usedBytes, before.usedBytes);
+
+    delete [] data;
+}
+
+void DImgBufferPoolTest::testEviction()
+{
+    DImgBufferPool* const pool = DImgBufferPool::instance();
+    pool->setCacheSize(16);
+
+    const size_t size = 6 * 1024 * 1024;
+    QList<uchar*> buffers;
+
+    for (int i = 0 ; i < 4 ; ++i)
+    {
+        buffers << pool->allocate(size);
+        QVERIFY(buffers.last());
+    }
+
+    for (uchar* const data : qAsConst(buffers))
+    {
+        pool->release(data, size);
+    }
+
+    const DImgBufferPool::Statistics stats = pool->statistics();
+
+    QVERIFY(stats.cachedBytes <= 16 * 1024 * 1024);
+    QVERIFY(stats.evictions >= 2);
+
+    // The most recently released buffers are kept.
+
+    QCOMPARE(pool->allocate(size), buffers.last());
+    pool->release(buffers.last(), size);
+}
+
+void DImgBufferPoolTest::testDisabled()
+{
+    DImgBufferPool* const pool = DImgBufferPool::instance();
+    pool->setCacheSize(0);
+
+    QCOMPARE(pool->statistics().cachedBuffers, (quint64)0);
+
+    const size_t size = 1024 * 1024 * 4;
+    uchar* const data = pool->allocate(size);
+    QVERIFY(data);
+    pool->release(data, size);
+
+    QCOMPARE(pool->statistics().cachedBuffers, (quint64)0);
+}
+
+void DImgBufferPoolTest::testImageBuffers()
+{
+    DImgBufferPool* const pool = DImgBufferPool::instance();
+    const uchar* bits          = nullptr;
+
+    {
+        DImg img(1024, 768, false, true);
+        bits = img.bits();
+    }
+
+    // The pixels of the next image of the same size are in the same memory.
+
+    DImg img(1024, 768, false, true);
+    QCOMPARE((const uchar*)img.bits(), bits);
+
+    // Copies, transforms and depth conversions go through the pool too.
+
+    DImg copy = img.copy();
+    copy.convertToSixteenBit();
+    copy.rotate(DImg::ROT90);
+    copy.crop(10, 10, 500, 500);
+
+    QCOMPARE(copy.size(), QSize(500, 500));
+    QVERIFY(pool->statistics().requests >= 4);
+
+    // The stripped data belongs to the caller.
+
+    uchar* const stripped = img.stripImageData();
+    QVERIFY(img.isNull());
+    delete [] stripped;
+}
@@ -0,0 +1,39 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-17
+ * Description : Unit tests of the DImg pixel buffers pool
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#pragma once
+
+// Qt includes
+
+#include <QObject>
+
+class DImgBufferPoolTest : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    explicit DImgBufferPoolTest(QObject* const parent = nullptr);
+
+private Q_SLOTS:
+
+    void init();
+
+    void testReuse();
+    void testAdoption();
+    void testTake();
+    void testEviction();
+    void testDisabled();
+    void testImageBuffers();
+};
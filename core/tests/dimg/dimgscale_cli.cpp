@@ -0,0 +1,135 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-17
+ * Description : a command line tool to benchmark DImg smooth scaling
+ *               and to compare the accelerated and plain results
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+// C++ includes
+
+#include <cstring>
+
+// Qt includes
+
+#include <QList>
+#include <QSize>
+#include <QRect>
+#include <QElapsedTimer>
+#include <QCoreApplication>
+
+// Local includes
+
+#include "digikam_debug.h"
+#include "dimg.h"
+#include "dtestrandomimage.h"
+
+using namespace Digikam;
+
+namespace
+{
+
+/**
+ * Scale img with the given acceleration, return the elapsed time in ms.
+ */
+qint64 scale(const DImg& img, const QSize& size, const QRect& clip,
+             bool accelerated, DImg& result)
+{
+    DImg::setSmoothScaleAccelerated(accelerated, accelerated);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    if (clip.isValid())
+    {
+        result = img.smoothScaleClipped(size, clip);
+    }
+    else
+    {
+        result = img.smoothScale(size);
+    }
+
+    return timer.elapsed();
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+
+    qCDebug(DIGIKAM_TESTS_LOG) << "dimgscale_cli - benchmark DImg::smoothScale(), plain against SIMD and threads";
+
+    const QList<QSize> sources = QList<QSize>() << QSize(6000, 4000)
+                                                << QSize(4000, 3000)
+                                                << QSize(1920, 1080)
+                                                << QSize(640, 480)
+                                                << QSize(7, 5);
+
+    const QList<QSize> targets = QList<QSize>() << QSize(256, 256)
+                                                << QSize(1280, 1280)
+                                                << QSize(2560, 2560)
+                                                << QSize(3, 3);
+
+    int failures = 0;
+
+    Q_FOREACH (const QSize& source, sources)
+    {
+        for (int depth = 0 ; depth < 2 ; ++depth)
+        {
+            for (int alpha = 0 ; alpha < 2 ; ++alpha)
+            {
+                const DImg img = DTestRandomImage::dimg(source.width(), source.height(), (depth == 1), (alpha == 1));
+
+                Q_FOREACH (const QSize& target, targets)
+                {
+                    QSize size = source;
+                    size.scale(target, Qt::KeepAspectRatio);
+
+                    // The whole image, and a clip in the middle of it.
+
+                    const QList<QRect> clips = QList<QRect>() << QRect()
+                                                              << QRect(size.width() / 4, size.height() / 3,
+                                                                       qMax(1, size.width() / 2), qMax(1, size.height() / 2));
+
+                    Q_FOREACH (const QRect& clip, clips)
+                    {
+                        DImg plain;
+                        DImg accelerated;
+                        const qint64 plainTime       = scale(img, size, clip, false, plain);
+                        const qint64 acceleratedTime = scale(img, size, clip, true,  accelerated);
+
+                        const bool same              = (plain.numBytes() == accelerated.numBytes()) &&
+                                                       (memcmp(plain.bits(), accelerated.bits(), plain.numBytes()) == 0);
+
+                        if (!same)
+                        {
+                            ++failures;
+                        }
+
+                        qCDebug(DIGIKAM_TESTS_LOG) << source << "->" << size
+                                                   << (clip.isValid() ? "clipped" : "full")
+                                                   << (depth ? "16 bits" : "8 bits")
+                                                   << (alpha ? "alpha" : "no alpha")
+                                                   << ": plain" << plainTime << "ms, accelerated"
+                                                   << acceleratedTime << "ms"
+                                                   << (same ? "identical" : "DIFFERENT");
+                    }
+                }
+            }
+        }
+    }
+
+    DImg::setSmoothScaleAccelerated(true, true);
+
+    qCDebug(DIGIKAM_TESTS_LOG) << "Results different from the plain implementation:" << failures;
+
+    return ((failures == 0) ? 0 : 1);
+}
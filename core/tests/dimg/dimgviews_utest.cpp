@@ -0,0 +1,122 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-17
+ * Description : Unit tests of the DImg pixel data views
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "dimgviews_utest.h"
+
+// Qt includes
+
+#include <QTest>
+
+// Local includes
+
+#include "dimg.h"
+#include "dimgmatview.h"
+#include "dtestrandomimage.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(DImgViewsTest)
+
+DImgViewsTest::DImgViewsTest(QObject* const parent)
+    : QObject(parent)
+{
+}
+
+void DImgViewsTest::testSharedQImage()
+{
+    DImg img            = DTestRandomImage::dimg(67, 43, false, true);
+    const QImage copy   = img.copyQImage();
+    const QImage shared = img.sharedQImage();
+
+    QCOMPARE(shared.format(), copy.format());
+    QCOMPARE(shared, copy);
+
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+
+    QCOMPARE(shared.constBits(), const_cast<const uchar*>(img.bits()));
+
+#endif
+
+    // Writing to the QImage must not change the DImg.
+
+    QImage written = shared;
+    written.setPixel(0, 0, qRgba(1, 2, 3, 4));
+
+    QCOMPARE(img.copyQImage(), copy);
+
+    // The 16 bits images are copied.
+
+    DImg img16 = DTestRandomImage::dimg(31, 17, true, true);
+
+    QCOMPARE(img16.sharedQImage(), img16.copyQImage());
+}
+
+void DImgViewsTest::testSharedQImageLifetime()
+{
+    QImage shared;
+    QImage copy;
+
+    {
+        DImg img = DTestRandomImage::dimg(128, 96, false, true);
+        copy     = img.copyQImage();
+        shared   = img.sharedQImage();
+    }
+
+    // The pixel data are kept by the QImage after the DImg is destroyed.
+
+    QCOMPARE(shared, copy);
+}
+
+void DImgViewsTest::testMatView()
+{
+    DImg img = DTestRandomImage::dimg(67, 43, false, true);
+    DImgMatView view(img);
+
+    QVERIFY(!view.isNull());
+    QCOMPARE(view.mat().type(), CV_8UC4);
+    QCOMPARE((void*)view.mat().data, (void*)img.bits());
+
+    for (int order = DImgMatView::BGR ; order <= DImgMatView::RGB ; ++order)
+    {
+        cv::Mat expected;
+        cv::cvtColor(view.mat(), expected, (order == DImgMatView::RGB) ? cv::COLOR_BGRA2RGB : cv::COLOR_BGRA2BGR);
+
+        const cv::Mat result = view.toEightBitThreeChannels((DImgMatView::ChannelOrder)order);
+
+        QCOMPARE(result.type(), CV_8UC3);
+        QCOMPARE(cv::norm(result, expected, cv::NORM_INF), 0.0);
+    }
+
+    QVERIFY(DImgMatView(DImg()).isNull());
+    QVERIFY(DImgMatView(DImg()).toEightBitThreeChannels().empty());
+}
+
+void DImgViewsTest::testMatViewSixteenBit()
+{
+    DImg img = DTestRandomImage::dimg(67, 43, true, true);
+    DImgMatView view(img);
+
+    QCOMPARE(view.mat().type(), CV_16UC4);
+
+    // Former conversion: cvtColor() then convertTo(). The rounding of the halves may differ.
+
+    cv::Mat expected;
+    cv::cvtColor(view.mat(), expected, cv::COLOR_BGRA2RGB);
+    expected.convertTo(expected, CV_8UC3, 1 / 256.0);
+
+    const cv::Mat result = view.toEightBitThreeChannels(DImgMatView::RGB);
+
+    QCOMPARE(result.type(), CV_8UC3);
+    QVERIFY(cv::norm(result, expected, cv::NORM_INF) <= 1.0);
+}
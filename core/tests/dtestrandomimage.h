@@ -0,0 +1,75 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-17
+ * Description : Common functions to create reproducible random images
+ *               for the tests.
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#pragma once
+
+// Qt includes
+
+#include <QImage>
+#include <QRandomGenerator>
+
+// Local includes
+
+#include "dimg.h"
+
+/**
+ * \brief Functions to create images filled with random pixels.
+ *
+ * The generator is seeded with the image size, so the same image is created
+ * for the same arguments on each run.
+ */
+
+class DTestRandomImage
+{
+public:
+
+    /**
+     * A DImg with random values for all channels, including the alpha channel.
+     */
+    static Digikam::DImg dimg(int width, int height, bool sixteenBit, bool alpha)
+    {
+        Digikam::DImg img(width, height, sixteenBit, alpha);
+        QRandomGenerator generator(width * height);
+
+        // A pixel is 4 or 8 bytes.
+
+        generator.fillRange(reinterpret_cast<quint32*>(img.bits()), img.numBytes() / sizeof(quint32));
+
+        return img;
+    }
+
+    /**
+     * A QImage in ARGB32 format with a random alpha channel,
+     * or in RGB32 format with an opaque alpha channel.
+     */
+    static QImage qimage(int width, int height, bool alpha)
+    {
+        QImage image(width, height, alpha ? QImage::Format_ARGB32 : QImage::Format_RGB32);
+        QRandomGenerator generator(width * height);
+
+        for (int y = 0 ; y < height ; ++y)
+        {
+            QRgb* const line = reinterpret_cast<QRgb*>(image.scanLine(y));
+
+            for (int x = 0 ; x < width ; ++x)
+            {
+                line[x] = qRgba(generator.bounded(256), generator.bounded(256), generator.bounded(256),
+                                alpha ? generator.bounded(256) : 255);
+            }
+        }
+
+        return image;
+    }
+};
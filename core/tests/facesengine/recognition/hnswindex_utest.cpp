@@ -0,0 +1,251 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-17
+ * Description : Unit tests of the face embeddings HNSW index
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "hnswindex_utest.h"
+
+// C++ includes
+
+#include <cmath>
+#include <algorithm>
+
+// Qt includes
+
+#include <QTest>
+#include <QTemporaryDir>
+#include <QRandomGenerator>
+
+// Local includes
+
+#include "hnsw_index.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(HNSWIndexTest)
+
+/**
+ * Random vectors of unit length, as the face embeddings.
+ */
+static cv::Mat randomVectors(int count, int dim, quint32 seed)
+{
+    QRandomGenerator generator(seed);
+    cv::Mat vectors(count, dim, CV_32F);
+
+    for (int row = 0 ; row < count ; ++row)
+    {
+        float* const v = vectors.ptr<float>(row);
+        double norm    = 0.0;
+
+        for (int i = 0 ; i < dim ; ++i)
+        {
+            v[i]  = (float)(generator.generateDouble() - 0.5);
+            norm += v[i] * v[i];
+        }
+
+        for (int i = 0 ; i < dim ; ++i)
+        {
+            v[i] /= (float)sqrt(norm);
+        }
+    }
+
+    return vectors;
+}
+
+/**
+ * Index with the node ids 1 to count, the identity of a node is its id.
+ */
+static void fillIndex(HNSWIndex& index, const cv::Mat& vectors)
+{
+    for (int row = 0 ; row < vectors.rows ; ++row)
+    {
+        QVERIFY(index.add(row + 1, vectors.row(row), row + 1));
+    }
+}
+
+HNSWIndexTest::HNSWIndexTest(QObject* const parent)
+    : QObject(parent)
+{
+}
+
+void HNSWIndexTest::testRecall()
+{
+    const int dim          = 128;
+    const int k            = 5;
+    const cv::Mat vectors  = randomVectors(3000, dim, 1);
+    const cv::Mat queries  = randomVectors(100,  dim, 2);
+
+    HNSWIndex index(dim);
+    fillIndex(index, vectors);
+    QCOMPARE(index.size(), vectors.rows);
+
+    // The results are compared with an exhaustive search.
+
+    int found = 0;
+
+    for (int q = 0 ; q < queries.rows ; ++q)
+    {
+        QVector<QPair<float, int> > exact;
+
+        for (int row = 0 ; row < vectors.rows ; ++row)
+        {
+            exact << qMakePair((float)cv::norm(queries.row(q), vectors.row(row), cv::NORM_L2SQR), row + 1);
+        }
+
+        std::sort(exact.begin(), exact.end());
+
+        const QMap<double, QVector<int> > neighbors = index.getClosestNeighbors(queries.row(q), 10.0F, -1.0F, k);
+        QList<int> identities;
+
+        for (const QVector<int>& ids : neighbors)
+        {
+            for (int id : ids)
+            {
+                identities << id;
+            }
+        }
+
+        QCOMPARE(identities.size(), k);
+
+        for (int i = 0 ; i < k ; ++i)
+        {
+            if (identities.contains(exact.at(i).second))
+            {
+                ++found;
+            }
+        }
+    }
+
+    const double recall = (double)found / (queries.rows * k);
+    qDebug() << "Recall of the 5 nearest neighbors:" << recall;
+
+    QVERIFY(recall > 0.9);
+}
+
+void HNSWIndexTest::testThresholds()
+{
+    const int dim         = 16;
+    const cv::Mat vectors = randomVectors(200, dim, 3);
+
+    HNSWIndex index(dim);
+    fillIndex(index, vectors);
+
+    // A vector finds itself at distance 0.
+
+    QMap<double, QVector<int> > neighbors = index.getClosestNeighbors(vectors.row(10), 0.01F, 0.8F, 5);
+    QCOMPARE(neighbors.size(), 1);
+    QCOMPARE(neighbors.first(), QVector<int>() << 11);
+
+    // Nothing is found out of the range, or with an opposite direction.
+
+    QVERIFY(index.getClosestNeighbors(vectors.row(10), 0.0F, 0.8F, 5).isEmpty());
+    QVERIFY(index.getClosestNeighbors(-vectors.row(10), 1.0F, 0.8F, 5).isEmpty());
+
+    // Wrong dimension.
+
+    QVERIFY(index.getClosestNeighbors(randomVectors(1, dim + 1, 4), 10.0F, -1.0F, 5).isEmpty());
+    QVERIFY(!index.add(1000, randomVectors(1, dim + 1, 4), 1000));
+
+    // The ids are unique.
+
+    QVERIFY(!index.add(1, vectors.row(0), 1));
+}
+
+void HNSWIndexTest::testRemove()
+{
+    const int dim         = 32;
+    const cv::Mat vectors = randomVectors(500, dim, 5);
+
+    HNSWIndex index(dim);
+    fillIndex(index, vectors);
+
+    QVERIFY(index.remove(11));
+    QVERIFY(!index.remove(11));
+    QVERIFY(!index.contains(11));
+    QCOMPARE(index.size(), vectors.rows - 1);
+
+    QVERIFY(index.getClosestNeighbors(vectors.row(10), 0.01F, 0.8F, 5).isEmpty());
+
+    // Remove most of the nodes, the graph is built again on the way.
+
+    for (int id = 1 ; id <= 400 ; ++id)
+    {
+        index.remove(id);
+    }
+
+    QCOMPARE(index.size(), 100);
+
+    for (int row = 400 ; row < vectors.rows ; ++row)
+    {
+        const QMap<double, QVector<int> > neighbors = index.getClosestNeighbors(vectors.row(row), 0.01F, 0.8F, 1);
+        QCOMPARE(neighbors.size(), 1);
+        QCOMPARE(neighbors.first(), QVector<int>() << (row + 1));
+    }
+
+    // A removed id can be added again.
+
+    QVERIFY(index.add(1, vectors.row(0), 1));
+    QCOMPARE(index.size(), 101);
+}
+
+void HNSWIndexTest::testSaveLoad()
+{
+    const int dim         = 64;
+    const cv::Mat vectors = randomVectors(1000, dim, 6);
+
+    HNSWIndex index(dim);
+    fillIndex(index, vectors);
+    index.remove(5);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString filePath = dir.filePath(QLatin1String("index.hnsw"));
+
+    QVERIFY(index.save(filePath));
+
+    // The checksum is the one of the data in the database.
+
+    QMap<int, int> identities;
+
+    for (int id = 1 ; id <= vectors.rows ; ++id)
+    {
+        if (id != 5)
+        {
+            identities.insert(id, id);
+        }
+    }
+
+    QCOMPARE(index.checksum(), HNSWIndex::computeChecksum(identities));
+
+    HNSWIndex loaded(dim);
+    QVERIFY(loaded.load(filePath, HNSWIndex::computeChecksum(identities)));
+    QCOMPARE(loaded.size(), index.size());
+
+    for (int row = 0 ; row < 50 ; ++row)
+    {
+        QCOMPARE(loaded.getClosestNeighbors(vectors.row(row), 10.0F, -1.0F, 5),
+                 index.getClosestNeighbors(vectors.row(row), 10.0F, -1.0F, 5));
+    }
+
+    // The index must be built again after a change of the database.
+
+    identities.insert(5, 5);
+
+    HNSWIndex outdated(dim);
+    QVERIFY(!outdated.load(filePath, HNSWIndex::computeChecksum(identities)));
+    QCOMPARE(outdated.size(), 0);
+
+    HNSWIndex otherDim(dim * 2);
+    QVERIFY(!otherDim.load(filePath, index.checksum()));
+
+    QVERIFY(!loaded.load(dir.filePath(QLatin1String("missing.hnsw")), index.checksum()));
+}
@@ -0,0 +1,226 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-17
+ * Description : Unit tests of the disk cache of preview images
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "loadingcachedisk_utest.h"
+
+// Qt includes
+
+#include <QDir>
+#include <QFile>
+#include <QDateTime>
+#include <QTest>
+
+// Local includes
+
+#include "dimg.h"
+#include "iccprofile.h"
+#include "loadingcachedisk.h"
+#include "loadingdescription.h"
+#include "dtestrandomimage.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(LoadingCacheDiskTest)
+
+namespace
+{
+
+QByteArray pixels(const DImg& img)
+{
+    return QByteArray(reinterpret_cast<const char*>(img.bits()), (int)img.numBytes());
+}
+
+QByteArray previewParameters(const QString& filePath)
+{
+    LoadingDescription description(filePath, PreviewSettings(), 400);
+
+    return LoadingCacheDisk::parametersHash(description, true);
+}
+
+} // namespace
+
+LoadingCacheDiskTest::LoadingCacheDiskTest(QObject* const parent)
+    : QObject(parent)
+{
+}
+
+void LoadingCacheDiskTest::init()
+{
+    m_tempDir = new QTemporaryDir;
+    QVERIFY(m_tempDir->isValid());
+}
+
+void LoadingCacheDiskTest::cleanup()
+{
+    delete m_tempDir;
+    m_tempDir = nullptr;
+}
+
+QString LoadingCacheDiskTest::cacheDir() const
+{
+    return m_tempDir->filePath(QLatin1String("cache"));
+}
+
+QString LoadingCacheDiskTest::createFile(const QString& name) const
+{
+    const QString path = m_tempDir->filePath(name);
+
+    DTestRandomImage::qimage(64, 48, false).save(path, "PNG");
+
+    return path;
+}
+
+int LoadingCacheDiskTest::entryCount() const
+{
+    return QDir(cacheDir()).entryList(QStringList() << QLatin1String("*.dcache"), QDir::Files).count();
+}
+
+void LoadingCacheDiskTest::testStoreRetrieve()
+{
+    const QString filePath    = createFile(QLatin1String("image.png"));
+    const QByteArray params   = previewParameters(filePath);
+    const QString cacheKey    = filePath + QLatin1String("-previewImage-400");
+    DImg img                  = DTestRandomImage::dimg(400, 300, false, false);
+    img.setAttribute(QLatin1String("exifRotated"), true);
+
+    {
+        LoadingCacheDisk disk(cacheDir());
+        disk.store(cacheKey, params, filePath, img);
+
+        QTRY_COMPARE(entryCount(), 1);
+    }
+
+    // A new instance only finds the image on disk.
+
+    LoadingCacheDisk disk(cacheDir());
+    const DImg stored = disk.retrieve(cacheKey, params, filePath);
+
+    QVERIFY(!stored.isNull());
+    QCOMPARE(stored.size(), img.size());
+    QCOMPARE(stored.sixteenBit(), img.sixteenBit());
+    QCOMPARE(stored.hasAlpha(), img.hasAlpha());
+    QCOMPARE(pixels(stored), pixels(img));
+    QVERIFY(stored.attribute(QLatin1String("exifRotated")).toBool());
+
+    QVERIFY(disk.retrieve(filePath + QLatin1String("-previewImage-800"), params, filePath).isNull());
+
+    disk.remove(filePath);
+    QCOMPARE(entryCount(), 0);
+}
+
+void LoadingCacheDiskTest::testParameters()
+{
+    const QString filePath = createFile(QLatin1String("image.png"));
+    const QString cacheKey = filePath + QLatin1String("-previewImage-400");
+
+    LoadingDescription description(filePath, PreviewSettings(), 400,
+                                   LoadingDescription::ConvertForDisplay);
+    description.postProcessingParameters.setProfile(IccProfile::sRGB());
+
+    const QByteArray srgb    = LoadingCacheDisk::parametersHash(description, true);
+    const QByteArray rotated = LoadingCacheDisk::parametersHash(description, false);
+
+    description.postProcessingParameters.setProfile(IccProfile::adobeRGB());
+
+    const QByteArray adobe   = LoadingCacheDisk::parametersHash(description, true);
+
+    QVERIFY(srgb != rotated);
+    QVERIFY(srgb != adobe);
+
+    description.postProcessingParameters.setProfile(IccProfile::sRGB());
+
+    QCOMPARE(LoadingCacheDisk::parametersHash(description, true), srgb);
+
+    {
+        LoadingCacheDisk disk(cacheDir());
+        disk.store(cacheKey, srgb, filePath, DTestRandomImage::dimg(400, 300, false, false));
+
+        QTRY_COMPARE(entryCount(), 1);
+    }
+
+    // The same key converted for another display profile, or not rotated, is not the same image.
+
+    LoadingCacheDisk disk(cacheDir());
+
+    QVERIFY(disk.retrieve(cacheKey, adobe,   filePath).isNull());
+    QVERIFY(disk.retrieve(cacheKey, rotated, filePath).isNull());
+    QVERIFY(!disk.retrieve(cacheKey, srgb,   filePath).isNull());
+}
+
+void LoadingCacheDiskTest::testEviction()
+{
+    // Random pixels do not compress: an entry is about 640 KB, two do not fit in 1 MB.
+
+    const QString first      = createFile(QLatin1String("first.png"));
+    const QString second     = createFile(QLatin1String("second.png"));
+    const QString firstKey   = first  + QLatin1String("-previewImage-400");
+    const QString secondKey  = second + QLatin1String("-previewImage-400");
+    const QByteArray params  = previewParameters(first);
+    const DImg img           = DTestRandomImage::dimg(400, 400, false, false);
+
+    {
+        LoadingCacheDisk disk(cacheDir());
+        disk.setMaximumSize(1);
+
+        disk.store(firstKey, params, first, img);
+        QTRY_COMPARE(entryCount(), 1);
+
+        const QString firstEntry = QDir(cacheDir()).entryInfoList(QStringList() << QLatin1String("*.dcache"))
+                                                   .constFirst().filePath();
+
+        disk.store(secondKey, params, second, img);
+        QTRY_VERIFY(!QFile::exists(firstEntry));
+        QTRY_COMPARE(entryCount(), 1);
+    }
+
+    LoadingCacheDisk disk(cacheDir());
+
+    // The least recently used entry was removed.
+
+    QVERIFY(disk.retrieve(firstKey, params, first).isNull());
+
+    const DImg stored = disk.retrieve(secondKey, params, second);
+
+    QVERIFY(!stored.isNull());
+    QCOMPARE(pixels(stored), pixels(img));
+}
+
+void LoadingCacheDiskTest::testFileChanged()
+{
+    const QString filePath  = createFile(QLatin1String("image.png"));
+    const QByteArray params = previewParameters(filePath);
+    const QString cacheKey  = filePath + QLatin1String("-previewImage-400");
+
+    {
+        LoadingCacheDisk disk(cacheDir());
+        disk.store(cacheKey, params, filePath, DTestRandomImage::dimg(400, 300, false, false));
+
+        QTRY_COMPARE(entryCount(), 1);
+    }
+
+    // The original file is modified after the entry was written.
+
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.setFileTime(QDateTime::currentDateTime().addSecs(60), QFileDevice::FileModificationTime));
+    file.close();
+
+    LoadingCacheDisk disk(cacheDir());
+
+    QVERIFY(disk.retrieve(cacheKey, params, filePath).isNull());
+
+    // The stale entry is removed.
+
+    QCOMPARE(entryCount(), 0);
+}
@@ -0,0 +1,49 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-17
+ * Description : Unit tests of the disk cache of preview images
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#pragma once
+
+// Qt includes
+
+#include <QObject>
+#include <QTemporaryDir>
+
+class LoadingCacheDiskTest : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    explicit LoadingCacheDiskTest(QObject* const parent = nullptr);
+
+private Q_SLOTS:
+
+    void init();
+    void cleanup();
+
+    void testStoreRetrieve();
+    void testParameters();
+    void testEviction();
+    void testFileChanged();
+
+private:
+
+    QString cacheDir()                       const;
+    QString createFile(const QString& name)  const;
+    int     entryCount()                     const;
+
+private:
+
+    QTemporaryDir* m_tempDir = nullptr;
+};
@@ -0,0 +1,203 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-17
+ * Description : unit test for the orientation of the thumbnails stored from previews
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "thumbnailrotation_utest.h"
+
+// Qt includes
+
+#include <QTest>
+#include <QDir>
+#include <QFile>
+#include <QImage>
+#include <QSqlDatabase>
+
+// Local includes
+
+#include "digikam_debug.h"
+#include "dimg.h"
+#include "dmetadata.h"
+#include "metaengine.h"
+#include "dpluginloader.h"
+#include "dbengineparameters.h"
+#include "thumbsdbaccess.h"
+#include "thumbnailinfo.h"
+#include "thumbnailcreator.h"
+#include "thumbnailloadthread.h"
+#include "previewloadthread.h"
+
+using namespace Digikam;
+
+QTEST_MAIN(ThumbnailRotationTest)
+
+namespace
+{
+
+/**
+ * As the main database, gives the orientation of the file as hint.
+ */
+class TestInfoProvider : public ThumbnailInfoProvider
+{
+public:
+
+    TestInfoProvider() = default;
+
+    ThumbnailInfo thumbnailInfo(const ThumbnailIdentifier& identifier) override
+    {
+        ThumbnailInfo info   = ThumbnailCreator::fileThumbnailInfo(identifier.filePath);
+        info.orientationHint = DMetadata(identifier.filePath).getItemOrientation();
+
+        return info;
+    }
+};
+
+TestInfoProvider s_provider;
+
+/**
+ * A landscape image, red on the left half and blue on the right half.
+ * Saved with an Exif orientation rotating it by 90 degrees clockwise: shown in portrait,
+ * red on the top half.
+ */
+bool createRotatedJpeg(const QString& path)
+{
+    QImage image(320, 160, QImage::Format_RGB32);
+    image.fill(Qt::blue);
+
+    for (int y = 0 ; y < image.height() ; ++y)
+    {
+        for (int x = 0 ; x < image.width() / 2 ; ++x)
+        {
+            image.setPixel(x, y, qRgb(255, 0, 0));
+        }
+    }
+
+    if (!image.save(path, "JPEG", 95))
+    {
+        return false;
+    }
+
+    DMetadata meta(path);
+    meta.setItemOrientation(MetaEngine::ORIENTATION_ROT_90);
+
+    return meta.applyChanges(true);
+}
+
+bool isRed(const QImage& image, int x, int y)
+{
+    const QRgb color = image.pixel(x, y);
+
+    return ((qRed(color) > 200) && (qBlue(color) < 60));
+}
+
+bool isBlue(const QImage& image, int x, int y)
+{
+    const QRgb color = image.pixel(x, y);
+
+    return ((qBlue(color) > 200) && (qRed(color) < 60));
+}
+
+} // namespace
+
+ThumbnailRotationTest::ThumbnailRotationTest(QObject* const parent)
+    : QObject(parent)
+{
+}
+
+void ThumbnailRotationTest::initTestCase()
+{
+    MetaEngine::initializeExiv2();
+    QDir dir(qApp->applicationDirPath());
+    qputenv("DK_PLUGIN_PATH", dir.canonicalPath().toUtf8());
+    DPluginLoader::instance()->init();
+
+    if (DPluginLoader::instance()->allPlugins().isEmpty())
+    {
+        QWARN("Not able to found digiKam plugin in standard paths. Test is aborted...");
+        return;
+    }
+
+    if (!QSqlDatabase::isDriverAvailable(DbEngineParameters::SQLiteDatabaseType()))
+    {
+        QWARN("Qt SQlite plugin is missing. Test is aborted...");
+        return;
+    }
+
+    QVERIFY(m_tempDir.isValid());
+
+    DbEngineParameters params;
+    params.databaseType = DbEngineParameters::SQLiteDatabaseType();
+    params.setThumbsDatabasePath(m_tempDir.filePath(QLatin1String("thumbnails-digikam.db")));
+    params.legacyAndDefaultChecks();
+
+    ThumbnailLoadThread::initializeThumbnailDatabase(params.thumbnailParameters(), &s_provider);
+
+    QVERIFY(ThumbsDbAccess::isInitialized());
+
+    m_ready = true;
+}
+
+void ThumbnailRotationTest::cleanupTestCase()
+{
+    ThumbnailLoadThread::cleanUp();
+    ThumbsDbAccess::cleanUpDatabase();
+}
+
+void ThumbnailRotationTest::testStoredPreviewOrientation()
+{
+    if (!m_ready)
+    {
+        QSKIP("No image loader plugins or no thumbnails database.");
+    }
+
+    const QString analyzed  = m_tempDir.filePath(QLatin1String("analyzed.jpg"));
+    const QString generated = m_tempDir.filePath(QLatin1String("generated.jpg"));
+
+    QVERIFY(createRotatedJpeg(analyzed));
+    QVERIFY(QFile::copy(analyzed, generated));
+
+    // The thumbnail stored from a preview, as the collection analyzer does.
+
+    DImg preview = PreviewLoadThread::loadFastSynchronously(analyzed, 1024);
+
+    QVERIFY(!preview.isNull());
+    QVERIFY(preview.height() > preview.width());
+
+    {
+        ThumbnailLoadThread thread;
+        thread.setPixmapRequested(false);
+        thread.storeThumbnail(analyzed, preview);
+    }
+
+    ThumbnailCreator creator(ThumbnailCreator::ThumbnailDatabase);
+    creator.setThumbnailInfoProvider(&s_provider);
+
+    // Loaded as any thumbnail, only from the storage: it must be rotated once.
+
+    QImage stored = creator.load(ThumbnailIdentifier(analyzed), true);
+
+    QVERIFY(!stored.isNull());
+    QVERIFY(stored.height() > stored.width());
+    QVERIFY(isRed(stored,  stored.width() / 2, stored.height() / 4));
+    QVERIFY(isBlue(stored, stored.width() / 2, stored.height() * 3 / 4));
+
+    // The same as the thumbnail created from the file.
+
+    QImage reference = creator.load(ThumbnailIdentifier(generated));
+
+    QVERIFY(!reference.isNull());
+    QCOMPARE(stored.size(), reference.size());
+    QVERIFY(isRed(reference,  reference.width() / 2, reference.height() / 4));
+    QVERIFY(isBlue(reference, reference.width() / 2, reference.height() * 3 / 4));
+}
+
+#include "moc_thumbnailrotation_utest.cpp"
@@ -0,0 +1,41 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-17
+ * Description : unit test for the orientation of the thumbnails stored from previews
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#pragma once
+
+// Qt includes
+
+#include <QObject>
+#include <QTemporaryDir>
+
+class ThumbnailRotationTest : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    explicit ThumbnailRotationTest(QObject* const parent = nullptr);
+
+private Q_SLOTS:
+
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testStoredPreviewOrientation();
+
+private:
+
+    QTemporaryDir m_tempDir;
+    bool          m_ready = false;
+};
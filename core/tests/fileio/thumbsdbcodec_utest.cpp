@@ -0,0 +1,95 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-17
+ * Description : Unit tests of the thumbnails database formats
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "thumbsdbcodec_utest.h"
+
+// Qt includes
+
+#include <QTest>
+
+// Local includes
+
+#include "thumbsdbcodec.h"
+#include "dtestrandomimage.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(ThumbsDbCodecTest)
+
+ThumbsDbCodecTest::ThumbsDbCodecTest(QObject* const parent)
+    : QObject(parent)
+{
+}
+
+void ThumbsDbCodecTest::testRawRoundTrip()
+{
+    // Odd width: the lines of the packed image are padded.
+
+    const QImage image = DTestRandomImage::qimage(255, 170, false);
+    QByteArray data;
+    QImage decoded;
+
+    QVERIFY(ThumbsDbCodec::encode(image, DatabaseThumbnail::RAW, data));
+    QVERIFY(ThumbsDbCodec::decode(data, DatabaseThumbnail::RAW, decoded));
+
+    QCOMPARE(decoded.size(), image.size());
+    QVERIFY(!decoded.hasAlphaChannel());
+    QCOMPARE(decoded.convertToFormat(QImage::Format_RGB32), image);
+}
+
+void ThumbsDbCodecTest::testRawRoundTripAlpha()
+{
+    const QImage image = DTestRandomImage::qimage(256, 192, true);
+    QByteArray data;
+    QImage decoded;
+
+    QVERIFY(ThumbsDbCodec::encode(image, DatabaseThumbnail::RAW, data));
+    QVERIFY(ThumbsDbCodec::decode(data, DatabaseThumbnail::RAW, decoded));
+
+    QVERIFY(decoded.hasAlphaChannel());
+    QCOMPARE(decoded, image);
+}
+
+void ThumbsDbCodecTest::testSupportedFormats()
+{
+    const QImage image = DTestRandomImage::qimage(256, 192, true);
+
+    for (DatabaseThumbnail::Type type : ThumbsDbCodec::supportedTypes())
+    {
+        QByteArray data;
+        QImage decoded;
+
+        QVERIFY2(ThumbsDbCodec::encode(image, type, data),   qPrintable(ThumbsDbCodec::typeName(type)));
+        QVERIFY2(ThumbsDbCodec::decode(data, type, decoded), qPrintable(ThumbsDbCodec::typeName(type)));
+        QCOMPARE(decoded.size(), image.size());
+    }
+
+    QVERIFY(ThumbsDbCodec::isSupported(DatabaseThumbnail::PGF));
+    QVERIFY(ThumbsDbCodec::isSupported(DatabaseThumbnail::RAW));
+    QVERIFY(!ThumbsDbCodec::isSupported(DatabaseThumbnail::UndefinedType));
+}
+
+void ThumbsDbCodecTest::testCorruptedData()
+{
+    QByteArray data;
+    QImage decoded;
+
+    QVERIFY(ThumbsDbCodec::encode(DTestRandomImage::qimage(64, 64, false), DatabaseThumbnail::RAW, data));
+
+    data.chop(16);
+
+    QVERIFY(!ThumbsDbCodec::decode(data, DatabaseThumbnail::RAW, decoded));
+    QVERIFY(!ThumbsDbCodec::decode(QByteArray("not an image"), DatabaseThumbnail::RAW, decoded));
+    QVERIFY(decoded.isNull());
+}
@@ -0,0 +1,35 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-17
+ * Description : Unit tests of the thumbnails database formats
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#pragma once
+
+// Qt includes
+
+#include <QObject>
+
+class ThumbsDbCodecTest : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    explicit ThumbsDbCodecTest(QObject* const parent = nullptr);
+
+private Q_SLOTS:
+
+    void testRawRoundTrip();
+    void testRawRoundTripAlpha();
+    void testSupportedFormats();
+    void testCorruptedData();
+};
@@ -0,0 +1,221 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-17
+ * Description : an unit-test to check the image quality detectors on reduced images
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "detectreduced_utest.h"
+
+// C++ includes
+
+#include <cmath>
+#include <algorithm>
+
+// Qt includes
+
+#include <QTest>
+
+// Local includes
+
+#include "digikam_opencv.h"
+#include "abstract_detector.h"
+#include "exposure_detector.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(ImgQSortTestDetectReduced)
+
+namespace
+{
+
+enum TestImage
+{
+    Smooth = 0,     ///< Sinusoidal pattern over the whole range of levels.
+    Dark,           ///< Under-exposed pattern with noise.
+    Bright,         ///< Over-exposed pattern with noise.
+    Clipped         ///< Gradient with clipped white and black areas, with noise.
+};
+
+/**
+ * The noise comes from a linear congruential generator, to get the same images everywhere.
+ */
+cv::Mat testImage(int type, int width = 1024, int height = 684)
+{
+    cv::Mat image(height, width, CV_8UC1);
+    quint32 seed = 12345;
+
+    auto noise = [&seed](int amplitude)
+    {
+        seed = (seed * 1103515245U + 12345U) & 0x7FFFFFFFU;
+
+        return (int)(seed % (2 * amplitude + 1)) - amplitude;
+    };
+
+    for (int y = 0 ; y < height ; ++y)
+    {
+        uchar* const row = image.ptr<uchar>(y);
+
+        for (int x = 0 ; x < width ; ++x)
+        {
+            const double pattern = sin(x / 37.0) * cos(y / 53.0);
+            double value         = 0.0;
+
+            switch (type)
+            {
+                case Smooth:
+                {
+                    value = 128.0 + 127.0 * pattern;
+                    break;
+                }
+
+                case Dark:
+                {
+                    value = 22.0 + 18.0 * pattern + noise(12);
+                    break;
+                }
+
+                case Bright:
+                {
+                    value = 238.0 + 20.0 * pattern + noise(8);
+                    break;
+                }
+
+                default:    // Clipped
+                {
+                    value = x * 255.0 / (width - 1);
+
+                    if ((x >= 100) && (x < 300) && (y >= 100) && (y < 300))
+                    {
+                        value = 255.0;
+                    }
+
+                    if ((x >= 600) && (x < 800) && (y >= 300) && (y < 500))
+                    {
+                        value = 0.0;
+                    }
+
+                    value += noise(4);
+                    break;
+                }
+            }
+
+            row[x] = cv::saturate_cast<uchar>(cvRound(value));
+        }
+    }
+
+    return image;
+}
+
+/**
+ * The exposure score computed with a mask by range of levels, as done before the histogram.
+ */
+float referenceExposure(const cv::Mat& image)
+{
+    auto count = [&image](int minVal, int maxVal)
+    {
+        cv::Mat mat = (image >= minVal) & (image < maxVal);
+
+        return cv::countNonZero(mat);
+    };
+
+    const float total      = (float)image.total();
+
+    const float over       = count(245, 255);
+    const float demiOver   = count(235, 245);
+    const float overScore  = (over * 15 + demiOver) /
+                             (total - over - demiOver + over * 15 + demiOver);
+
+    const float under      = count(0, 15);
+    const float demiUnder  = count(15, 30);
+    const float underScore = (under * 15 + demiUnder * 6) /
+                             (total - under - demiUnder + under * 15 + demiUnder * 6);
+
+    return std::max(overScore, underScore);
+}
+
+} // namespace
+
+ImgQSortTestDetectReduced::ImgQSortTestDetectReduced(QObject* const parent)
+    : QObject(parent)
+{
+}
+
+void ImgQSortTestDetectReduced::testReduceForDetection()
+{
+    const cv::Mat image = testImage(Smooth);
+
+    // Halved as long as the smaller side stays large enough.
+
+    QCOMPARE(AbstractDetector::reduceForDetection(image, 256).cols,  512);
+    QCOMPARE(AbstractDetector::reduceForDetection(image, 256).rows,  342);
+    QCOMPARE(AbstractDetector::reduceForDetection(image, 100).cols,  256);
+    QCOMPARE(AbstractDetector::reduceForDetection(image, 100).rows,  171);
+
+    // Full resolution needed, or image too small.
+
+    QCOMPARE(AbstractDetector::reduceForDetection(image, 0).cols,    1024);
+    QCOMPARE(AbstractDetector::reduceForDetection(image, 400).cols,  1024);
+    QCOMPARE(AbstractDetector::reduceForDetection(image, 1000).rows, 684);
+
+    QVERIFY(AbstractDetector::reduceForDetection(cv::Mat(), 256).empty());
+}
+
+void ImgQSortTestDetectReduced::testExposureHistogram()
+{
+    // At full resolution, the score is the same as before.
+
+    ExposureDetector detector;
+
+    for (int type = Smooth ; type <= Clipped ; ++type)
+    {
+        const cv::Mat image = testImage(type);
+
+        QVERIFY2(qAbs(detector.detect(image) - referenceExposure(image)) < 1.0e-6F,
+                 qPrintable(QString::fromLatin1("Test image %1").arg(type)));
+    }
+}
+
+void ImgQSortTestDetectReduced::testExposureReduced_data()
+{
+    QTest::addColumn<int>("type");
+
+    QTest::newRow("smooth")  << (int)Smooth;
+    QTest::newRow("dark")    << (int)Dark;
+    QTest::newRow("bright")  << (int)Bright;
+    QTest::newRow("clipped") << (int)Clipped;
+}
+
+void ImgQSortTestDetectReduced::testExposureReduced()
+{
+    QFETCH(int, type);
+
+    // The averaging of the reduction lowers the noise, which moves a few pixels
+    // around the thresholds. The score must stay close to the full resolution one.
+
+    const float tolerance = 0.05F;
+
+    ExposureDetector detector;
+
+    const cv::Mat image   = testImage(type);
+    const cv::Mat reduced = AbstractDetector::reduceForDetection(image, detector.minimumImageSize());
+
+    QVERIFY(reduced.total() < image.total());
+
+    const float fullScore    = detector.detect(image);
+    const float reducedScore = detector.detect(reduced);
+
+    qDebug() << "Exposure score" << fullScore << "at" << image.cols << "x" << image.rows
+             << "," << reducedScore << "at" << reduced.cols << "x" << reduced.rows;
+
+    QVERIFY(qAbs(fullScore - reducedScore) < tolerance);
+}
+
+#include "moc_detectreduced_utest.cpp"
@@ -0,0 +1,35 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-17
+ * Description : an unit-test to check the image quality detectors on reduced images
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#pragma once
+
+// Qt includes
+
+#include <QObject>
+
+class ImgQSortTestDetectReduced : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    explicit ImgQSortTestDetectReduced(QObject* const parent = nullptr);
+
+private Q_SLOTS:
+
+    void testReduceForDetection();
+    void testExposureHistogram();
+    void testExposureReduced_data();
+    void testExposureReduced();
+};
@@ -0,0 +1,85 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-17
+ * Description : a command line tool to measure the RAW thumbnail creation
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+// Qt includes
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QImage>
+
+// Local includes
+
+#include "digikam_debug.h"
+#include "thumbnailcreator.h"
+#include "thumbnailinfo.h"
+
+using namespace Digikam;
+
+int main(int argc, char** argv)
+{
+    if (argc <= 1)
+    {
+        qCDebug(DIGIKAM_TESTS_LOG) << "rawthumb - Create thumbnails of RAW files and report the time spent by source";
+        qCDebug(DIGIKAM_TESTS_LOG) << "Usage: <rawfiles>";
+        return -1;
+    }
+
+    QApplication app(argc, argv);
+
+    ThumbnailCreator creator(256, ThumbnailCreator::FreeDesktopStandard);
+    creator.setOnlyLargeThumbnails(true);
+
+    for (int i = 1 ; i < argc ; ++i)
+    {
+        QString path = QFileInfo(QString::fromLocal8Bit(argv[i])).absoluteFilePath();
+
+        // Force the thumbnail to be created again.
+
+        creator.deleteThumbnailsFromDisk(path);
+
+        QElapsedTimer timer;
+        timer.start();
+
+        ThumbnailIdentifier id(path);
+        QImage image = creator.load(id);
+
+        if (!image.isNull())
+        {
+            qCDebug(DIGIKAM_TESTS_LOG) << "Thumbnail from" << path << image.size() << "in" << timer.elapsed() << "ms";
+        }
+        else
+        {
+            qCDebug(DIGIKAM_TESTS_LOG) << "Cannot create thumbnail from" << path << ":" << creator.errorString();
+        }
+    }
+
+    const char* const names[ThumbnailCreator::NumberOfRawThumbnailSources] =
+    {
+        "Exif thumbnail",
+        "Embedded preview",
+        "Half size decoding"
+    };
+
+    for (int i = 0 ; i < ThumbnailCreator::NumberOfRawThumbnailSources ; ++i)
+    {
+        ThumbnailCreator::SourceTiming timing = ThumbnailCreator::rawSourceTiming((ThumbnailCreator::RawThumbnailSource)i);
+
+        qCDebug(DIGIKAM_TESTS_LOG) << names[i] << ":" << timing.successes << "/" << timing.attempts << "used,"
+                                   << "average" << timing.averageTime() / 1000.0 << "ms,"
+                                   << "maximum" << timing.maximumTime   / 1000.0 << "ms";
+    }
+
+    return 0;
+}
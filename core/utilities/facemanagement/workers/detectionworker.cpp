@@ -58,10 +58,10 @@ QImage DetectionWorker::scaleForDetection(const DImg& image) const
 
     if (qMax(image.width(), image.height()) > (uint)recommendedSize)
     {
-        return image.smoothScale(recommendedSize, recommendedSize, Qt::KeepAspectRatio).copyQImage();
+        return image.smoothScale(recommendedSize, recommendedSize, Qt::KeepAspectRatio).sharedQImage();
     }
 
-    return image.copyQImage();
+    return image.sharedQImage();
 }
 
 void DetectionWorker::setAccuracyAndModel(double accuracy, bool yolo)
@@ -22,6 +22,17 @@
 namespace Digikam
 {
 
+namespace
+{
+
+/**
+ * Faces passed at once to the recognizer, at least, when the packages come faster than
+ * they are processed. This is the batch size of the face embedding neural network.
+ */
+const int recognitionBatchSize = 32;
+
+} // namespace
+
 RecognitionWorker::RecognitionWorker(FacePipeline::Private* const dd)
     : imageRetriever(dd),
       d             (dd)
@@ -31,6 +42,8 @@ RecognitionWorker::RecognitionWorker(FacePipeline::Private* const dd)
 RecognitionWorker::~RecognitionWorker()
 {
     wait();    // protect database
+
+    clearPending();
 }
 
 /**
@@ -54,10 +67,64 @@ void RecognitionWorker::process(const FacePipelineExtendedPackage::Ptr& package)
 
     // NOTE: cropped faces will be deleted by training provider
 
-    package->recognitionResults  = recognizer.recognizeFaces(images);
-    package->processFlags       |= FacePipelinePackage::ProcessedByRecognizer;
+    pendingPackages << package;
+    pendingImages   << images;
+    pendingCounts   << images.size();
+
+    // The faces of the packages already queued for this worker are recognized together.
+    // The flush is queued after them, so a lone package is not delayed.
+
+    if      (pendingImages.size() >= recognitionBatchSize)
+    {
+        slotRecognizePending();
+    }
+    else if (!flushQueued)
+    {
+        flushQueued = true;
+        QMetaObject::invokeMethod(this, "slotRecognizePending", Qt::QueuedConnection);
+    }
+}
+
+void RecognitionWorker::slotRecognizePending()
+{
+    flushQueued = false;
+
+    if (pendingPackages.isEmpty())
+    {
+        return;
+    }
+
+    const QList<Identity> results = recognizer.recognizeFaces(pendingImages);
+    int first                     = 0;
+
+    for (int i = 0 ; i < pendingPackages.size() ; ++i)
+    {
+        const FacePipelineExtendedPackage::Ptr& package = pendingPackages.at(i);
+
+        package->recognitionResults  = results.mid(first, pendingCounts.at(i));
+        package->processFlags       |= FacePipelinePackage::ProcessedByRecognizer;
+        first                       += pendingCounts.at(i);
+
+        Q_EMIT processed(package);
+    }
+
+    qCDebug(DIGIKAM_GENERAL_LOG) << "Recognized" << pendingImages.size() << "faces of"
+                                 << pendingPackages.size() << "images at once";
 
-    Q_EMIT processed(package);
+    pendingPackages.clear();
+    pendingImages.clear();
+    pendingCounts.clear();
+}
+
+void RecognitionWorker::clearPending()
+{
+    qDeleteAll(pendingImages);
+
+    pendingPackages.clear();
+    pendingImages.clear();
+    pendingCounts.clear();
+
+    flushQueued = false;
 }
 
 void RecognitionWorker::setThreshold(double threshold, bool)
@@ -70,6 +137,20 @@ void RecognitionWorker::aboutToDeactivate()
     imageRetriever.cancel();
 }
 
+void RecognitionWorker::aboutToQuitLoop()
+{
+    // The queued flush was removed with the posted events when deactivated.
+    // The pending packages are dropped, as the ones not yet received.
+    // This is done here, in the thread of the worker, not to race with process().
+
+    if (!pendingPackages.isEmpty())
+    {
+        qCDebug(DIGIKAM_GENERAL_LOG) << "Drop" << pendingPackages.size() << "images not yet recognized";
+    }
+
+    clearPending();
+}
+
 } // namespace Digikam
 
 #include "moc_recognitionworker.cpp"
@@ -42,6 +42,14 @@ public Q_SLOTS:
 protected:
 
     void aboutToDeactivate() override;
+    void aboutToQuitLoop()   override;
+
+private Q_SLOTS:
+
+    /**
+     * Recognize the faces of all pending packages at once.
+     */
+    void slotRecognizePending();
 
 Q_SIGNALS:
 
@@ -53,6 +61,20 @@ protected:
     FacialRecognitionWrapper     recognizer;
     FacePipeline::Private* const d              = nullptr;
 
+private:
+
+    /**
+     * Free the faces of the pending packages, which are not recognized.
+     */
+    void clearPending();
+
+private:
+
+    QList<FacePipelineExtendedPackage::Ptr> pendingPackages;
+    QList<QImage*>                          pendingImages;
+    QList<int>                              pendingCounts;      ///< The number of faces of each pending package.
+    bool                                    flushQueued         = false;
+
 private:
 
     // Disable
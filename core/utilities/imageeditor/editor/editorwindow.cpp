@@ -388,6 +388,15 @@ void EditorWindow::setupStandardActions()
     ac->addAction(QLatin1String("editorwindow_selectNone"), d->selectNoneAction);
     ac->setDefaultShortcut(d->selectNoneAction, QKeySequence(Qt::CTRL | Qt::SHIFT | Qt::Key_A));
 
+    d->loadForEditingAction = new QAction(QIcon::fromTheme(QLatin1String("document-edit")),
+                                          i18nc("@action", "Load for Editing"), this);
+    connect(d->loadForEditingAction, SIGNAL(triggered()), this, SLOT(slotLoadForEditing()));
+    ac->addAction(QLatin1String("editorwindow_loadforediting"), d->loadForEditingAction);
+    d->loadForEditingAction->setEnabled(false);
+    d->loadForEditingAction->setWhatsThis(i18nc("@info", "A very large image is only shown by tiles. "
+                                                         "This option loads the whole image for the "
+                                                         "editing tools, which can need a lot of memory."));
+
     // -- Standard 'View' menu actions ---------------------------------------------
 
     d->zoomPlusAction  = buildStdAction(StdZoomInAction, this, SLOT(slotIncreaseZoom()), this);
@@ -1504,7 +1513,26 @@ void EditorWindow::slotLoadingFinished(const QString& filename, bool success)
     unsetCursor();
     m_animLogo->stop();
 
-    if (success)
+    d->loadForEditingAction->setEnabled(false);
+
+    if (success && m_canvas->isViewOnly())
+    {
+        // Only the viewing actions work with a large image shown by tiles.
+
+        toggleActions(false);
+        toggleZoomActions(true);
+        m_forwardAction->setEnabled(true);
+        m_backwardAction->setEnabled(true);
+        m_firstAction->setEnabled(true);
+        m_lastAction->setEnabled(true);
+        d->loadForEditingAction->setEnabled(true);
+
+        DNotificationPopup::message(DNotificationPopup::Boxed,
+                                    i18nc("@info", "This large image is shown in view only mode.\n"
+                                                   "Use \"Edit > Load for Editing\" to edit it."),
+                                    m_canvas, m_canvas->mapToGlobal(QPoint(30, 30)));
+    }
+    else if (success)
     {
         colorManage();
 
@@ -1521,6 +1549,12 @@ void EditorWindow::slotLoadingFinished(const QString& filename, bool success)
     }
 }
 
+void EditorWindow::slotLoadForEditing()
+{
+    d->loadForEditingAction->setEnabled(false);
+    m_canvas->loadForEditing();
+}
+
 void EditorWindow::resetOrigin()
 {
     // With versioning, "only" resetting undo history does not work anymore
@@ -312,6 +312,7 @@ private Q_SLOTS:
     void slotToggleFitToWindow();
     void slotToggleOffFitToWindow();
     void slotFitToSelect();
+    void slotLoadForEditing();
     void slotIncreaseZoom();
     void slotDecreaseZoom();
     void slotCloseTool();
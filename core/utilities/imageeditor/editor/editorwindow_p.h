@@ -198,6 +198,7 @@ public:
     QAction*                     copyAction                         = nullptr;
     QAction*                     cropAction                         = nullptr;
     QAction*                     flipHorizAction                    = nullptr;
+    QAction*                     loadForEditingAction               = nullptr;
     QAction*                     flipVertAction                     = nullptr;
     QAction*                     rotateLeftAction                   = nullptr;
     QAction*                     rotateRightAction                  = nullptr;
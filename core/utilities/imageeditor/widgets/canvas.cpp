@@ -38,6 +38,7 @@
 #include "iofilesettings.h"
 #include "loadingcacheinterface.h"
 #include "imagepreviewitem.h"
+#include "dimgtiledsource.h"
 #include "previewlayout.h"
 #include "imagezoomsettings.h"
 #include "clickdragreleaseitem.h"
@@ -60,6 +61,13 @@ public:
     RubberItem*           rubber        = nullptr;
     ClickDragReleaseItem* wrapItem      = nullptr;
     EditorCore*           core          = nullptr;
+
+    /**
+     * A large image shown by tiles is not loaded for the editing tools
+     * until loadForEditing() is called.
+     */
+    QString               viewOnlyFile;
+    IOFileSettings*       viewOnlySettings = nullptr;
 };
 
 Canvas::Canvas(QWidget* const parent)
@@ -122,6 +130,12 @@ void Canvas::resetImage()
 {
     reset();
     d->core->resetImage();
+
+    if (isViewOnly())
+    {
+        d->viewOnlyFile.clear();
+        d->canvasItem->setTiledSource(nullptr);
+    }
 }
 
 void Canvas::reset()
@@ -146,9 +160,51 @@ void Canvas::load(const QString& filename, IOFileSettings* const IOFileSettings)
 
     Q_EMIT signalPrepareToLoad();
 
+    d->viewOnlyFile.clear();
+    d->viewOnlySettings = nullptr;
+
+    if (DImgTiledSource::isSupported(filename))
+    {
+        // A large image is only shown by tiles, to keep the memory bounded. The whole image,
+        // which can take several gigabytes, is only decoded when the editing tools are needed.
+
+        d->core->resetImage();
+        d->canvasItem->setTiledSource(new DImgTiledSource(filename));
+
+        d->viewOnlyFile     = filename;
+        d->viewOnlySettings = IOFileSettings;
+
+        viewport()->update();
+
+        Q_EMIT signalLoadingFinished(filename, true);
+
+        return;
+    }
+
+    d->canvasItem->setTiledSource(nullptr);
     d->core->load(filename, IOFileSettings);
 }
 
+bool Canvas::isViewOnly() const
+{
+    return !d->viewOnlyFile.isEmpty();
+}
+
+void Canvas::loadForEditing()
+{
+    if (!isViewOnly())
+    {
+        return;
+    }
+
+    const QString filename = d->viewOnlyFile;
+    d->viewOnlyFile.clear();
+
+    // The tiles are shown until the whole image is loaded.
+
+    d->core->load(filename, d->viewOnlySettings);
+}
+
 void Canvas::slotImageLoaded(const QString& filePath, bool success)
 {
     if (d->core->getImg())
@@ -52,6 +52,18 @@ public:
     void load(const QString& filename, IOFileSettings* const IOFileSettings);
     void preload(const QString& filename);
 
+    /**
+     * Return true if the current image is a large image only shown by tiles,
+     * without being loaded for the editing tools.
+     */
+    bool isViewOnly()                   const;
+
+    /**
+     * Load the whole image shown in view only mode, for the editing tools.
+     * The image is loaded in the background, as done by load().
+     */
+    void loadForEditing();
+
     void resetImage();
     void abortSaving();
     void setModified();
@@ -79,14 +79,15 @@ void ImagePreviewItem::paint(QPainter* painter, const QStyleOptionGraphicsItem*
 
     // scale "as if" scaling to whole image, but clip output to our exposed region
 
+    bool  complete           = true;
     QSize scaledCompleteSize = QSizeF(dpr * completeSize.width(),
                                       dpr * completeSize.height()).toSize();
-    DImg scaledImage         = d->image.smoothScaleClipped(scaledCompleteSize.width(),
-                                                           scaledCompleteSize.height(),
-                                                           scaledDrawRect.x(),
-                                                           scaledDrawRect.y(),
-                                                           scaledDrawRect.width(),
-                                                           scaledDrawRect.height());
+    DImg scaledImage         = d->scaledImage(scaledCompleteSize, scaledDrawRect, &complete);
+
+    if (scaledImage.isNull())
+    {
+        return;
+    }
 
     if (d->cachedPixmaps.find(scaledDrawRect, &pix, &pixSourceRect))
     {
@@ -129,7 +130,12 @@ void ImagePreviewItem::paint(QPainter* painter, const QStyleOptionGraphicsItem*
             pix = scaledImage.convertToPixmap();
         }
 
-        d->cachedPixmaps.insert(scaledDrawRect, pix);
+        // The parts of a tiled source not decoded yet are drawn again later.
+
+        if (complete)
+        {
+            d->cachedPixmaps.insert(scaledDrawRect, pix);
+        }
 
         painter->drawPixmap(drawRect, pix);
     }
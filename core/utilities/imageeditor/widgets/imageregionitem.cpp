@@ -108,14 +108,13 @@ void ImageRegionItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* o
 
     // scale "as if" scaling to whole image, but clip output to our exposed region
 
-    DImg scaledImage     = d->image.smoothScaleClipped(
-                                                       completeSize.width(),
-                                                       completeSize.height(),
-                                                       dd->drawRect.x(),
-                                                       dd->drawRect.y(),
-                                                       dd->drawRect.width(),
-                                                       dd->drawRect.height()
-                                                      );
+    bool complete        = true;
+    DImg scaledImage     = d->scaledImage(completeSize, dd->drawRect, &complete);
+
+    if (scaledImage.isNull())
+    {
+        return;
+    }
 
     if (d->cachedPixmaps.find(dd->drawRect, &pix, &pixSourceRect))
     {
@@ -158,7 +157,10 @@ void ImageRegionItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* o
             pix = scaledImage.convertToPixmap();
         }
 
-        d->cachedPixmaps.insert(dd->drawRect, pix);
+        if (complete)
+        {
+            d->cachedPixmaps.insert(dd->drawRect, pix);
+        }
 
         painter->drawPixmap(dd->drawRect.topLeft(), pix);
     }
@@ -51,6 +51,10 @@ MaintenanceDlg::MaintenanceDlg(QWidget* const parent)
                                                     d->configGroupName, options, AlbumSelectors::AlbumType::All, true);
     d->useLastSettings         = new QCheckBox(i18nc("@option:check", "Use the last saved active tools and settings"), options);
     d->useMutiCoreCPU          = new QCheckBox(i18nc("@option:check", "Work on all processor cores (when it's possible)"), options);
+    d->analyseCollection       = new QCheckBox(i18nc("@option:check", "Read each image once for all analysis tools"), options);
+    d->analyseCollection->setToolTip(i18nc("@info:tooltip",
+        "The thumbnails, finger-prints, faces detection, autotags and image quality tools "
+        "are processed together, in a single pass over the images."));
     d->expanderBox->insertItem(Private::Options, options, QIcon::fromTheme(QLatin1String("configure")), i18n("Common Options"), QLatin1String("Options"), true);
 
     // --------------------------------------------------------------------------------------
@@ -79,8 +83,34 @@ MaintenanceDlg::MaintenanceDlg(QWidget* const parent)
 
     // --------------------------------------------------------------------------------------
 
-    d->scanThumbs              = new QCheckBox(i18n("Scan for changed or non-cataloged items (faster)"));
-    d->expanderBox->insertItem(Private::Thumbnails, d->scanThumbs, QIcon::fromTheme(QLatin1String("view-process-all")),
+    d->thumbsBox               = new DVBox;
+    d->scanThumbs              = new QCheckBox(i18n("Scan for changed or non-cataloged items (faster)"), d->thumbsBox);
+
+    DHBox* const hbox14        = new DHBox(d->thumbsBox);
+    new QLabel(i18n("Format in database: "), hbox14);
+    QWidget* const space14     = new QWidget(hbox14);
+    hbox14->setStretchFactor(space14, 10);
+    d->thumbsFormat            = new QComboBox(hbox14);
+
+    Q_FOREACH (DatabaseThumbnail::Type type, ThumbsDbCodec::supportedTypes())
+    {
+        d->thumbsFormat->addItem(ThumbsDbCodec::typeName(type), (int)type);
+    }
+
+    d->thumbsFormat->setCurrentIndex(d->thumbsFormat->findData((int)ThumbsDbCodec::storageType()));
+    d->thumbsFormat->setToolTip(i18nc("@info:tooltip",
+        "<p>The format of the thumbnails stored in the database. It trades the speed of the thumbnails display "
+        "against the size of the database.</p>"
+        "<p><b>Uncompressed pixels</b>: the fastest to display, the largest database.</p>"
+        "<p><b>PGF</b>: lossless and compact, the default format.</p>"
+        "<p><b>WebP</b> and <b>JPEG-XL</b>: lossy, the smallest database.</p>"));
+
+    d->convertThumbs           = new QCheckBox(i18n("Convert the thumbnails already in the database to this format"), d->thumbsBox);
+    d->convertThumbs->setToolTip(i18nc("@info:tooltip",
+        "The existing thumbnails are transcoded in background, for the whole collection, "
+        "without being rebuilt from the images."));
+
+    d->expanderBox->insertItem(Private::Thumbnails, d->thumbsBox, QIcon::fromTheme(QLatin1String("view-process-all")),
                                i18n("Rebuild Thumbnails"), QLatin1String("Thumbnails"), false);
     d->expanderBox->setCheckBoxVisible(Private::Thumbnails, true);
 
@@ -323,7 +353,7 @@ void MaintenanceDlg::slotItemToggled(int index, bool b)
     {
         case Private::Thumbnails:
         {
-            d->scanThumbs->setEnabled(b);
+            d->thumbsBox->setEnabled(b);
             break;
         }
 
@@ -54,6 +54,7 @@
 #include "autotagsassignment.h"
 #include "autotagsassign.h"
 #include "localizeselector.h"
+#include "thumbsdbcodec.h"
 
 namespace Digikam
 {
@@ -86,9 +87,12 @@ public:
     const QString configGroupName                       = QLatin1String("MaintenanceDlg Settings");
     const QString configUseLastSettings                 = QLatin1String("UseLastSettings");
     const QString configUseMutiCoreCPU                  = QLatin1String("UseMutiCoreCPU");
+    const QString configAnalyseCollection               = QLatin1String("AnalyseCollection");
     const QString configNewItems                        = QLatin1String("NewItems");
     const QString configThumbnails                      = QLatin1String("Thumbnails");
     const QString configScanThumbs                      = QLatin1String("ScanThumbs");
+    const QString configThumbsFormat                    = QLatin1String("ThumbsFormat");
+    const QString configConvertThumbs                   = QLatin1String("ConvertThumbs");
     const QString configFingerPrints                    = QLatin1String("FingerPrints");
     const QString configScanFingerPrints                = QLatin1String("ScanFingerPrints");
     const QString configDuplicates                      = QLatin1String("Duplicates");
@@ -118,9 +122,12 @@ public:
     QLabel*                   logo                      = nullptr;
     QLabel*                   title                     = nullptr;
     QCheckBox*                scanThumbs                = nullptr;
+    QCheckBox*                convertThumbs             = nullptr;
+    QComboBox*                thumbsFormat              = nullptr;
     QCheckBox*                scanFingerPrints          = nullptr;
     QCheckBox*                useLastSettings           = nullptr;
     QCheckBox*                useMutiCoreCPU            = nullptr;
+    QCheckBox*                analyseCollection         = nullptr;
     QCheckBox*                cleanThumbsDb             = nullptr;
     QCheckBox*                cleanFacesDb              = nullptr;
     QCheckBox*                cleanSimilarityDb         = nullptr;
@@ -139,6 +146,7 @@ public:
     DVBox*                    vbox3                     = nullptr;
     DVBox*                    vbox4                     = nullptr;
     DVBox*                    vbox5                     = nullptr;
+    DVBox*                    thumbsBox                 = nullptr;
     DVBox*                    duplicatesBox             = nullptr;
     DIntRangeBox*             similarityRange           = nullptr;
     QComboBox*                faceScannedHandling       = nullptr;
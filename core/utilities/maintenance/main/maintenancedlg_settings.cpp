@@ -25,6 +25,7 @@ MaintenanceSettings MaintenanceDlg::settings() const
     prm.albums                              = d->albumSelectors->selectedAlbums();
     prm.tags                                = d->albumSelectors->selectedTags();
     prm.useMutiCoreCPU                      = d->useMutiCoreCPU->isChecked();
+    prm.analyseCollection                   = d->analyseCollection->isChecked();
     prm.newItems                            = d->expanderBox->isChecked(Private::NewItems);
     prm.databaseCleanup                     = d->expanderBox->isChecked(Private::DbCleanup);
     prm.cleanThumbDb                        = d->cleanThumbsDb->isChecked();
@@ -33,6 +34,8 @@ MaintenanceSettings MaintenanceDlg::settings() const
     prm.shrinkDatabases                     = d->shrinkDatabases->isChecked();
     prm.thumbnails                          = d->expanderBox->isChecked(Private::Thumbnails);
     prm.scanThumbs                          = d->scanThumbs->isChecked();
+    prm.thumbsFormat                        = d->thumbsFormat->itemData(d->thumbsFormat->currentIndex()).toInt();
+    prm.convertThumbs                       = d->convertThumbs->isChecked();
     prm.fingerPrints                        = d->expanderBox->isChecked(Private::FingerPrints);
     prm.scanFingerPrints                    = d->scanFingerPrints->isChecked();
     prm.duplicates                          = d->expanderBox->isChecked(Private::Duplicates);
@@ -89,6 +92,7 @@ void MaintenanceDlg::readSettings()
         MaintenanceSettings prm;
 
         d->useMutiCoreCPU->setChecked(group.readEntry(d->configUseMutiCoreCPU,                                  prm.useMutiCoreCPU));
+        d->analyseCollection->setChecked(group.readEntry(d->configAnalyseCollection,                            prm.analyseCollection));
         d->expanderBox->setChecked(Private::NewItems,           group.readEntry(d->configNewItems,              prm.newItems));
 
         d->expanderBox->setChecked(Private::DbCleanup,          group.readEntry(d->configCleanupDatabase,       prm.databaseCleanup));
@@ -99,6 +103,9 @@ void MaintenanceDlg::readSettings()
 
         d->expanderBox->setChecked(Private::Thumbnails,         group.readEntry(d->configThumbnails,            prm.thumbnails));
         d->scanThumbs->setChecked(group.readEntry(d->configScanThumbs,                                          prm.scanThumbs));
+        int thumbsFormat = d->thumbsFormat->findData(group.readEntry(d->configThumbsFormat,                     (int)ThumbsDbCodec::storageType()));
+        d->thumbsFormat->setCurrentIndex(thumbsFormat);
+        d->convertThumbs->setChecked(group.readEntry(d->configConvertThumbs,                                    prm.convertThumbs));
 
         d->expanderBox->setChecked(Private::FingerPrints,       group.readEntry(d->configFingerPrints,          prm.fingerPrints));
         d->scanFingerPrints->setChecked(group.readEntry(d->configScanFingerPrints,                              prm.scanFingerPrints));
@@ -165,6 +172,7 @@ void MaintenanceDlg::writeSettings()
         MaintenanceSettings prm   = settings();
 
         group.writeEntry(d->configUseMutiCoreCPU,             prm.useMutiCoreCPU);
+        group.writeEntry(d->configAnalyseCollection,          prm.analyseCollection);
         group.writeEntry(d->configNewItems,                   prm.newItems);
         group.writeEntry(d->configCleanupDatabase,            prm.databaseCleanup);
         group.writeEntry(d->configCleanupThumbDatabase,       prm.cleanThumbDb);
@@ -173,6 +181,8 @@ void MaintenanceDlg::writeSettings()
         group.writeEntry(d->configShrinkDatabases,            prm.shrinkDatabases);
         group.writeEntry(d->configThumbnails,                 prm.thumbnails);
         group.writeEntry(d->configScanThumbs,                 prm.scanThumbs);
+        group.writeEntry(d->configThumbsFormat,               prm.thumbsFormat);
+        group.writeEntry(d->configConvertThumbs,              prm.convertThumbs);
         group.writeEntry(d->configFingerPrints,               prm.fingerPrints);
         group.writeEntry(d->configScanFingerPrints,           prm.scanFingerPrints);
         group.writeEntry(d->configDuplicates,                 prm.duplicates);
@@ -215,6 +225,7 @@ void MaintenanceDlg::slotUseLastSettings(bool checked)
         MaintenanceSettings prm;
 
         d->useMutiCoreCPU->setChecked(prm.useMutiCoreCPU);
+        d->analyseCollection->setChecked(prm.analyseCollection);
         d->expanderBox->setChecked(Private::NewItems,           prm.newItems);
 
         d->expanderBox->setChecked(Private::DbCleanup,          prm.databaseCleanup);
@@ -225,6 +236,8 @@ void MaintenanceDlg::slotUseLastSettings(bool checked)
 
         d->expanderBox->setChecked(Private::Thumbnails,         prm.thumbnails);
         d->scanThumbs->setChecked(prm.scanThumbs);
+        d->thumbsFormat->setCurrentIndex(d->thumbsFormat->findData((int)ThumbsDbCodec::storageType()));
+        d->convertThumbs->setChecked(prm.convertThumbs);
 
         d->expanderBox->setChecked(Private::FingerPrints,       prm.fingerPrints);
         d->scanFingerPrints->setChecked(prm.scanFingerPrints);
@@ -33,6 +33,7 @@
 #include "applicationsettings.h"
 #include "maintenancesettings.h"
 #include "newitemsfinder.h"
+#include "collectionanalyzer.h"
 #include "thumbsgenerator.h"
 #include "fingerprintsgenerator.h"
 #include "duplicatesfinder.h"
@@ -62,6 +63,7 @@ public:
     MaintenanceSettings    settings;
 
     NewItemsFinder*        newItemsFinder        = nullptr;
+    CollectionAnalyzer*    collectionAnalyzer    = nullptr;
     ThumbsGenerator*       thumbsGenerator       = nullptr;
     FingerPrintsGenerator* fingerPrintsGenerator = nullptr;
     DuplicatesFinder*      duplicatesFinder      = nullptr;
@@ -131,6 +133,11 @@ void MaintenanceMngr::slotToolCompleted(ProgressItem* tool)
         d->databaseCleaner = nullptr;
         stage3();
     }
+    else if (tool == dynamic_cast<ProgressItem*>(d->collectionAnalyzer))
+    {
+        d->collectionAnalyzer = nullptr;
+        stage3();
+    }
     else if (tool == dynamic_cast<ProgressItem*>(d->thumbsGenerator))
     {
         d->thumbsGenerator = nullptr;
@@ -172,6 +179,7 @@ void MaintenanceMngr::slotToolCanceled(ProgressItem* tool)
 {
     if (
         (tool == dynamic_cast<ProgressItem*>(d->newItemsFinder))        ||
+        (tool == dynamic_cast<ProgressItem*>(d->collectionAnalyzer))    ||
         (tool == dynamic_cast<ProgressItem*>(d->thumbsGenerator))       ||
         (tool == dynamic_cast<ProgressItem*>(d->fingerPrintsGenerator)) ||
         (tool == dynamic_cast<ProgressItem*>(d->duplicatesFinder))      ||
@@ -246,6 +254,18 @@ void MaintenanceMngr::stage3()
 {
     qCDebug(DIGIKAM_GENERAL_LOG) << "stage3";
 
+    if (d->settings.analyseCollection)
+    {
+        // Only once, this stage is called again when the analysis is done.
+
+        d->settings.analyseCollection = false;
+
+        if (analyseCollection())
+        {
+            return;
+        }
+    }
+
     if (d->settings.thumbnails)
     {
         bool rebuildAll = (d->settings.scanThumbs == false);
@@ -254,6 +274,7 @@ void MaintenanceMngr::stage3()
         list << d->settings.tags;
 
         d->thumbsGenerator = new ThumbsGenerator(rebuildAll, list);
+        d->thumbsGenerator->setStorageType((DatabaseThumbnail::Type)d->settings.thumbsFormat, d->settings.convertThumbs);
         d->thumbsGenerator->setNotificationEnabled(false);
         d->thumbsGenerator->setUseMultiCoreCPU(d->settings.useMutiCoreCPU);
         d->thumbsGenerator->start();
@@ -264,6 +285,108 @@ void MaintenanceMngr::stage3()
     }
 }
 
+bool MaintenanceMngr::analyseCollection()
+{
+    CollectionAnalyzerSettings prm;
+
+    // The thumbnails conversion reads the database only, it stays in the thumbnails generator.
+
+    if (d->settings.thumbnails)
+    {
+        prm.operations   |= CollectionAnalyzerSettings::Thumbnails;
+        prm.rebuildThumbs = (d->settings.scanThumbs == false);
+        prm.thumbsFormat  = d->settings.thumbsFormat;
+    }
+
+    if (d->settings.fingerPrints)
+    {
+        prm.operations         |= CollectionAnalyzerSettings::FingerPrints;
+        prm.rebuildFingerPrints = (d->settings.scanFingerPrints == false);
+    }
+
+    // The recognition works on the faces in the database, only the detection is shared.
+
+    if (d->settings.faceManagement && (d->settings.faceSettings.task == FaceScanSettings::Detect))
+    {
+        prm.operations   |= CollectionAnalyzerSettings::Faces;
+        prm.facesHandling = d->settings.faceSettings.alreadyScannedHandling;
+        prm.facesYoloV3   = ApplicationSettings::instance()->getFaceDetectionYoloV3();
+        prm.facesAccuracy = ApplicationSettings::instance()->getFaceDetectionAccuracy();
+    }
+
+    if (d->settings.autotagsAssignment)
+    {
+        prm.operations       |= CollectionAnalyzerSettings::AutoTags;
+        prm.autotagsScanMode  = d->settings.autotaggingScanMode;
+        prm.autotagsModel     = d->settings.modelSelectionMode;
+        prm.autotagsLanguages = d->settings.autotagsLanguages;
+    }
+
+    if (d->settings.qualitySort)
+    {
+        prm.operations     |= CollectionAnalyzerSettings::ImageQuality;
+        prm.qualityScanMode = d->settings.qualityScanMode;
+        prm.quality         = d->settings.quality;
+    }
+
+    // A single tool gains nothing to be processed here.
+
+    int count = 0;
+
+    for (int op = CollectionAnalyzerSettings::Thumbnails ;
+         op <= CollectionAnalyzerSettings::ImageQuality ; op <<= 1)
+    {
+        if (prm.operations & op)
+        {
+            ++count;
+        }
+    }
+
+    if (count < 2)
+    {
+        return false;
+    }
+
+    // The tools processed by the analysis are disabled for the next stages. The thumbnails generator
+    // still runs, to convert the existing thumbnails and to build the ones of the videos and audio files.
+
+    if (prm.operations & CollectionAnalyzerSettings::Thumbnails)
+    {
+        d->settings.scanThumbs = true;
+    }
+
+    if (prm.operations & CollectionAnalyzerSettings::FingerPrints)
+    {
+        d->settings.fingerPrints = false;
+    }
+
+    if (prm.operations & CollectionAnalyzerSettings::Faces)
+    {
+        d->settings.faceManagement = false;
+    }
+
+    if (prm.operations & CollectionAnalyzerSettings::AutoTags)
+    {
+        d->settings.autotagsAssignment = false;
+    }
+
+    if (prm.operations & CollectionAnalyzerSettings::ImageQuality)
+    {
+        d->settings.qualitySort = false;
+    }
+
+    AlbumList list;
+    list << d->settings.albums;
+    list << d->settings.tags;
+
+    d->collectionAnalyzer = new CollectionAnalyzer(prm, list);
+    d->collectionAnalyzer->setNotificationEnabled(false);
+    d->collectionAnalyzer->setUseMultiCoreCPU(d->settings.useMutiCoreCPU);
+    d->collectionAnalyzer->start();
+
+    return true;
+}
+
 void MaintenanceMngr::stage4()
 {
     qCDebug(DIGIKAM_GENERAL_LOG) << "stage4";
@@ -53,7 +53,7 @@ private:
 
     void stage1();  ///< Find New items
     void stage2();  ///< Database Cleanup
-    void stage3();  ///< Update Thumbnails Build
+    void stage3();  ///< Collection Analysis and Update Thumbnails Build
     void stage4();  ///< Similarity Finger-prints
     void stage5();  ///< Find Duplicates
     void stage6();  ///< Faces Management
@@ -61,6 +61,12 @@ private:
     void stage8();  ///< Autotags Assignment
     void stage9();  ///< Metadata Synchronizer
 
+    /**
+     * Start the collection analyzer in place of the per-image tools of the next stages.
+     * @return false if there is not enough tools to process together.
+     */
+    bool analyseCollection();
+
     void done();    ///< Called when all scheduled tools are done.
     void cancel();  ///< Called when a tool is canceled.
 
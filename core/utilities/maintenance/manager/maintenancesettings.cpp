@@ -28,9 +28,12 @@ QDebug operator<<(QDebug dbg, const MaintenanceSettings& s)
     dbg.nospace() << "Albums                 : " << s.albums.count()                      << Qt::endl;
     dbg.nospace() << "Tags                   : " << s.tags.count()                        << Qt::endl;
     dbg.nospace() << "useMutiCoreCPU         : " << s.useMutiCoreCPU                      << Qt::endl;
+    dbg.nospace() << "analyseCollection      : " << s.analyseCollection                   << Qt::endl;
     dbg.nospace() << "newItems               : " << s.newItems                            << Qt::endl;
     dbg.nospace() << "thumbnails             : " << s.thumbnails                          << Qt::endl;
     dbg.nospace() << "scanThumbs             : " << s.scanThumbs                          << Qt::endl;
+    dbg.nospace() << "thumbsFormat           : " << s.thumbsFormat                        << Qt::endl;
+    dbg.nospace() << "convertThumbs          : " << s.convertThumbs                       << Qt::endl;
     dbg.nospace() << "fingerPrints           : " << s.fingerPrints                        << Qt::endl;
     dbg.nospace() << "scanFingerPrints       : " << s.scanFingerPrints                    << Qt::endl;
     dbg.nospace() << "duplicates             : " << s.duplicates                          << Qt::endl;
@@ -29,6 +29,7 @@
 #include "imagequalitycontainer.h"
 #include "metadatasynchronizer.h"
 #include "imagequalitysorter.h"
+#include "thumbsdb.h"
 
 namespace Digikam
 {
@@ -53,6 +54,9 @@ public:
     /// Use Multi-core CPU to process items.
     bool                                    useMutiCoreCPU          = false;
 
+    /// Decode each image once for the thumbnails, fingerprints, faces detection, autotags and quality tools.
+    bool                                    analyseCollection       = false;
+
     /// Find new items on whole collection.
     bool                                    newItems                = false;
 
@@ -62,6 +66,12 @@ public:
     /// Rebuild all thumbnails or only scan missing items.
     bool                                    scanThumbs              = false;
 
+    /// Format of the thumbnails in the database (DatabaseThumbnail::Type). Undefined keeps the current format.
+    int                                     thumbsFormat            = DatabaseThumbnail::UndefinedType;
+
+    /// Convert the thumbnails already in the database to the format above.
+    bool                                    convertThumbs           = false;
+
     /// Generate finger-prints
     bool                                    fingerPrints            = false;
 
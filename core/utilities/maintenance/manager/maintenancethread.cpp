@@ -29,6 +29,8 @@
 #include "autotagsassignmenttask.h"
 #include "imagequalitytask.h"
 #include "imagequalitycontainer.h"
+#include "collectionanalyzertask.h"
+#include "collectionanalyzersettings.h"
 #include "databasetask.h"
 #include "maintenancedata.h"
 #include "imagequalityparser.h"
@@ -213,6 +215,35 @@ void MaintenanceThread::sortByImageQuality(const QStringList& paths, const Image
     appendJobs(collection);
 }
 
+void MaintenanceThread::analyseCollection(const QStringList& paths,
+                                          const QHash<QString, int>& itemOperations,
+                                          const CollectionAnalyzerSettings& settings)
+{
+    ActionJobCollection collection;
+
+    data->setImagePaths(paths);
+
+    for (int i = 1 ; i <= maximumNumberOfThreads() ; ++i)
+    {
+        CollectionAnalyzerTask* const t = new CollectionAnalyzerTask();
+        t->setSettings(settings);
+        t->setItemOperations(itemOperations);
+        t->setMaintenanceData(data);
+
+        connect(t, SIGNAL(signalFinished(QImage)),
+                this, SIGNAL(signalAdvance(QImage)));
+
+        connect(this, SIGNAL(signalCanceled()),
+                t, SLOT(slotCancel()), Qt::QueuedConnection);
+
+        collection.insert(t, 0);
+
+        qCDebug(DIGIKAM_GENERAL_LOG) << "Creating a collection analyzer task for analysing items.";
+    }
+
+    appendJobs(collection);
+}
+
 void MaintenanceThread::computeDatabaseJunk(bool thumbsDb, bool facesDb, bool similarityDb)
 {
     ActionJobCollection collection;
@@ -283,6 +314,30 @@ void MaintenanceThread::cleanThumbsDb(const QList<int>& thumbnailIds)
     appendJobs(collection);
 }
 
+void MaintenanceThread::convertThumbsDb(const QList<int>& thumbnailIds)
+{
+    ActionJobCollection collection;
+
+    data->setThumbnailIds(thumbnailIds);
+
+    for (int i = 1 ; i <= maximumNumberOfThreads() ; ++i)
+    {
+        DatabaseTask* const t = new DatabaseTask();
+
+        t->setMaintenanceData(data);
+        t->setMode(DatabaseTask::Mode::ConvertThumbsDb);
+
+        connect(t, SIGNAL(signalFinished()),
+                this, SIGNAL(signalAdvance()));
+
+        collection.insert(t, 0);
+
+        qCDebug(DIGIKAM_GENERAL_LOG) << "Creating a database task for converting thumbnails.";
+    }
+
+    appendJobs(collection);
+}
+
 void MaintenanceThread::cleanFacesDb(const QList<Identity>& staleIdentities)
 {
     ActionJobCollection collection;
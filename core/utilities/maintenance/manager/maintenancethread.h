@@ -18,6 +18,7 @@
 // Qt includes
 
 #include <QList>
+#include <QHash>
 
 // Local includes
 
@@ -33,6 +34,7 @@ namespace Digikam
 {
 
 class ImageQualityContainer;
+class CollectionAnalyzerSettings;
 class MaintenanceData;
 
 class MaintenanceThread : public ActionThreadBase
@@ -52,10 +54,14 @@ public:
     void generateFingerprints(const QList<qlonglong>& itemIds, bool rebuildAll);
     void generateTags(const QStringList& paths, int modelType, const QStringList& langs);
     void sortByImageQuality(const QStringList& paths, const ImageQualityContainer& quality);
+    void analyseCollection(const QStringList& paths,
+                           const QHash<QString, int>& itemOperations,
+                           const CollectionAnalyzerSettings& settings);
 
     void computeDatabaseJunk(bool thumbsDb = false, bool facesDb = false, bool similarityDb = false);
     void cleanCoreDb(const QList<qlonglong>& imageIds);
     void cleanThumbsDb(const QList<int>& thumbnailIds);
+    void convertThumbsDb(const QList<int>& thumbnailIds);
     void cleanFacesDb(const QList<Identity>& staleIdentities);
     void cleanSimilarityDb(const QList<qlonglong>& imageIds);
     void shrinkDatabases();
@@ -0,0 +1,258 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-17
+ * Description : collection analyzer maintenance tool.
+ *               Each image is decoded once for all analysis.
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "collectionanalyzer.h"
+
+// Qt includes
+
+#include <QSet>
+#include <QHash>
+#include <QIcon>
+#include <QString>
+#include <QApplication>
+
+// KDE includes
+
+#include <klocalizedstring.h>
+
+// Local includes
+
+#include "digikam_debug.h"
+#include "digikam_globals.h"
+#include "coredb.h"
+#include "albummanager.h"
+#include "coredbaccess.h"
+#include "thumbsdbaccess.h"
+#include "thumbsdbcodec.h"
+#include "thumbnailloadthread.h"
+#include "tagscache.h"
+#include "maintenancethread.h"
+
+namespace Digikam
+{
+
+class Q_DECL_HIDDEN CollectionAnalyzer::Private
+{
+public:
+
+    Private() = default;
+
+    /**
+     * @return the paths of the items of an album, physical or tag.
+     */
+    static QStringList albumPaths(Album* const album);
+
+public:
+
+    CollectionAnalyzerSettings settings;
+
+    QStringList                allPicturesPath;
+
+    AlbumList                  albumList;
+
+    MaintenanceThread*         thread    = nullptr;
+};
+
+QStringList CollectionAnalyzer::Private::albumPaths(Album* const album)
+{
+    if      (album->type() == Album::PHYSICAL)
+    {
+        return CoreDbAccess().db()->getItemURLsInAlbum(album->id());
+    }
+    else if (album->type() == Album::TAG)
+    {
+        return CoreDbAccess().db()->getItemURLsInTag(album->id());
+    }
+
+    return QStringList();
+}
+
+CollectionAnalyzer::CollectionAnalyzer(const CollectionAnalyzerSettings& settings,
+                                       const AlbumList& list,
+                                       ProgressItem* const parent)
+    : MaintenanceTool(QLatin1String("CollectionAnalyzer"), parent),
+      d              (new Private)
+{
+    d->settings  = settings;
+    d->albumList = list;
+    d->thread    = new MaintenanceThread(this);
+
+    connect(d->thread, SIGNAL(signalCompleted()),
+            this, SLOT(slotDone()));
+
+    connect(d->thread, SIGNAL(signalAdvance(QImage)),
+            this, SLOT(slotAdvance(QImage)));
+}
+
+CollectionAnalyzer::~CollectionAnalyzer()
+{
+    delete d;
+}
+
+void CollectionAnalyzer::setUseMultiCoreCPU(bool b)
+{
+    d->thread->setUseMultiCore(b);
+}
+
+void CollectionAnalyzer::slotCancel()
+{
+    d->thread->cancel();
+    MaintenanceTool::slotCancel();
+}
+
+void CollectionAnalyzer::slotStart()
+{
+    MaintenanceTool::slotStart();
+
+    setLabel(i18n("Collection Analysis"));
+
+    ProgressManager::addProgressItem(this);
+
+    const int operations = d->settings.operations;
+
+    if (
+        (operations & CollectionAnalyzerSettings::Thumbnails)                              &&
+        (d->settings.thumbsFormat != DatabaseThumbnail::UndefinedType)                     &&
+        ThumbsDbAccess::isInitialized()
+       )
+    {
+        // The new thumbnails are written in the selected format.
+
+        ThumbsDbCodec::setStorageType((DatabaseThumbnail::Type)d->settings.thumbsFormat);
+    }
+
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+
+    if (d->albumList.isEmpty())
+    {
+        d->albumList = AlbumManager::instance()->allPAlbums();
+    }
+
+    // The items already processed by each tool, depending of the scan modes.
+
+    QHash<QString, int> withThumbnail;
+    QSet<QString>       autotagged;
+    QSet<QString>       notLabeled;
+
+    if ((operations & CollectionAnalyzerSettings::Thumbnails) && !d->settings.rebuildThumbs)
+    {
+        ThumbnailLoadThread::writePendingThumbnails();
+
+        withThumbnail = ThumbsDbAccess().db()->getFilePathsWithThumbnail();
+    }
+
+    if (
+        (operations & CollectionAnalyzerSettings::AutoTags) &&
+        (d->settings.autotagsScanMode == AutotagsAssignment::NonAssignedItems)
+       )
+    {
+        const int rootTag = TagsCache::instance()->getOrCreateTag(QLatin1String("auto/"));
+
+        Q_FOREACH (const QString& path, CoreDbAccess().db()->getItemURLsInTag(rootTag, true))
+        {
+            autotagged.insert(path);
+        }
+    }
+
+    if (
+        (operations & CollectionAnalyzerSettings::ImageQuality) &&
+        (d->settings.qualityScanMode == ImageQualitySorter::NonAssignedItems)
+       )
+    {
+        const int noPickTag = TagsCache::instance()->tagForPickLabel(NoPickLabel);
+
+        Q_FOREACH (const QString& path, CoreDbAccess().db()->getItemsURLsWithTag(noPickTag))
+        {
+            notLabeled.insert(path);
+        }
+    }
+
+    // Get all digiKam albums collection pictures path, with the analysis to process for each one.
+
+    QHash<QString, int> itemOperations;
+
+    for (AlbumList::ConstIterator it = d->albumList.constBegin() ;
+         !canceled() && (it != d->albumList.constEnd()) ; ++it)
+    {
+        if (!(*it))
+        {
+            continue;
+        }
+
+        Q_FOREACH (const QString& path, Private::albumPaths(*it))
+        {
+            if (itemOperations.contains(path))
+            {
+                continue;
+            }
+
+            int itemOps = operations;
+
+            if (withThumbnail.contains(path))
+            {
+                itemOps &= ~CollectionAnalyzerSettings::Thumbnails;
+            }
+
+            if (
+                (d->settings.autotagsScanMode == AutotagsAssignment::NonAssignedItems) &&
+                autotagged.contains(path)
+               )
+            {
+                itemOps &= ~CollectionAnalyzerSettings::AutoTags;
+            }
+
+            if (
+                (d->settings.qualityScanMode == ImageQualitySorter::NonAssignedItems) &&
+                !notLabeled.contains(path)
+               )
+            {
+                itemOps &= ~CollectionAnalyzerSettings::ImageQuality;
+            }
+
+            itemOperations.insert(path, itemOps);
+
+            if (itemOps != CollectionAnalyzerSettings::NoOperation)
+            {
+                d->allPicturesPath << path;
+            }
+        }
+    }
+
+    QApplication::restoreOverrideCursor();
+
+    if (d->allPicturesPath.isEmpty())
+    {
+        slotDone();
+
+        return;
+    }
+
+    qCDebug(DIGIKAM_GENERAL_LOG) << "Collection analysis of" << d->allPicturesPath.count() << "items";
+
+    setTotalItems(d->allPicturesPath.count());
+
+    d->thread->analyseCollection(d->allPicturesPath, itemOperations, d->settings);
+    d->thread->start();
+}
+
+void CollectionAnalyzer::slotAdvance(const QImage& img)
+{
+    setThumbnail(QIcon(QPixmap::fromImage(img)));
+    advance(1);
+}
+
+} // namespace Digikam
+
+#include "moc_collectionanalyzer.cpp"
@@ -0,0 +1,68 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-17
+ * Description : collection analyzer maintenance tool.
+ *               Each image is decoded once for all analysis.
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#pragma once
+
+// Qt includes
+
+#include <QObject>
+
+// Local includes
+
+#include "album.h"
+#include "maintenancetool.h"
+#include "collectionanalyzersettings.h"
+
+class QImage;
+
+namespace Digikam
+{
+
+/**
+ * Processes the thumbnails, fingerprints, faces detection, autotags and image quality
+ * tools in a single pass: each image is decoded once at the largest size needed, and the
+ * analysis run on views downscaled from it.
+ * The non image files are left to the thumbnails generator, which must run after this tool
+ * to scan the missing thumbnails.
+ */
+class CollectionAnalyzer : public MaintenanceTool
+{
+    Q_OBJECT
+
+public:
+
+    /**
+     * Constructor using AlbumList as argument. If list is empty, whole Albums collection is processed.
+     */
+    explicit CollectionAnalyzer(const CollectionAnalyzerSettings& settings,
+                                const AlbumList& list = AlbumList(),
+                                ProgressItem* const parent = nullptr);
+    ~CollectionAnalyzer()           override;
+
+    void setUseMultiCoreCPU(bool b) override;
+
+private Q_SLOTS:
+
+    void slotStart()                override;
+    void slotCancel()               override;
+    void slotAdvance(const QImage&);
+
+private:
+
+    class Private;
+    Private* const d = nullptr;
+};
+
+} // namespace Digikam
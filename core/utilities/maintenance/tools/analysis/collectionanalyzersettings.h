@@ -0,0 +1,94 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-17
+ * Description : collection analyzer settings container.
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#pragma once
+
+// Qt includes
+
+#include <QStringList>
+
+// Local includes
+
+#include "autotagsassign.h"
+#include "autotagsassignment.h"
+#include "facescansettings.h"
+#include "imagequalitycontainer.h"
+#include "imagequalitysorter.h"
+#include "thumbsdb.h"
+
+namespace Digikam
+{
+
+class CollectionAnalyzerSettings
+{
+public:
+
+    /**
+     * The analysis processed on an item, as a combination of flags.
+     */
+    enum Operation
+    {
+        NoOperation  = 0x00,
+        Thumbnails   = 0x01,     ///< Store the thumbnail in the database.
+        FingerPrints = 0x02,     ///< Compute the Haar signature of the similarity database.
+        Faces        = 0x04,     ///< Detect the faces.
+        AutoTags     = 0x08,     ///< Assign the auto-tags.
+        ImageQuality = 0x10      ///< Assign the Pick Label from the image quality.
+    };
+
+public:
+
+    CollectionAnalyzerSettings()  = default;
+    ~CollectionAnalyzerSettings() = default;
+
+public:
+
+    /// The analysis to process, Operation flags.
+    int                                      operations          = NoOperation;
+
+    /// Rebuild all thumbnails or only the missing ones.
+    bool                                     rebuildThumbs       = false;
+
+    /// Format of the thumbnails in the database (DatabaseThumbnail::Type). Undefined keeps the current format.
+    int                                      thumbsFormat        = DatabaseThumbnail::UndefinedType;
+
+    /// Rebuild all fingerprints or only the dirty or missing ones.
+    bool                                     rebuildFingerPrints = false;
+
+    /// Handling of the items already scanned for faces.
+    FaceScanSettings::AlreadyScannedHandling facesHandling       = FaceScanSettings::Skip;
+
+    /// Face detection accuracy.
+    double                                   facesAccuracy       = 0.7;
+
+    /// Use Yolo V3 model to detect the faces.
+    bool                                     facesYoloV3         = false;
+
+    /// Autotags assignment scan mode.
+    int                                      autotagsScanMode    = AutotagsAssignment::AllItems;
+
+    /// Autotags detector model.
+    int                                      autotagsModel       = DetectorModel::YOLOV5NANO;
+
+    /// Autotags languages.
+    QStringList                              autotagsLanguages;
+
+    /// Mode to assign Pick Labels to items.
+    int                                      qualityScanMode     = ImageQualitySorter::AllItems;
+
+    /// Image Quality Sorting Settings.
+    ImageQualityContainer                    quality;
+};
+
+} // namespace Digikam
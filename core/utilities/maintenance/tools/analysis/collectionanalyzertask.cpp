@@ -0,0 +1,463 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-17
+ * Description : Thread actions task for collection analyzer.
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "collectionanalyzertask.h"
+
+// C++ includes
+
+#include <algorithm>
+
+// Qt includes
+
+#include <QPair>
+#include <QList>
+#include <QVariantMap>
+#include <QElapsedTimer>
+
+// Local includes
+
+#include "digikam_debug.h"
+#include "collectionanalyzersettings.h"
+#include "autotagsassignmenttask.h"
+#include "imagequalityparser.h"
+#include "thumbnailloadthread.h"
+#include "previewloadthread.h"
+#include "similaritydbaccess.h"
+#include "maintenancedata.h"
+#include "scancontroller.h"
+#include "similaritydb.h"
+#include "facedetector.h"
+#include "metadatahub.h"
+#include "faceutils.h"
+#include "haariface.h"
+#include "identity.h"
+#include "iteminfo.h"
+#include "dimg.h"
+
+namespace Digikam
+{
+
+class Q_DECL_HIDDEN CollectionAnalyzerTask::Private
+{
+public:
+
+    Private() = default;
+
+    /**
+     * @return the size of the image needed by an operation.
+     */
+    static int imageSize(int operation);
+
+    void processThumbnail(const ItemInfo& info, const DImg& image);
+    void processFingerPrint(const ItemInfo& info, const DImg& image);
+    void processFaces(const ItemInfo& info, const DImg& image);
+    void processAutoTags(const ItemInfo& info, const DImg& image);
+    void processQuality(const ItemInfo& info, const DImg& image);
+
+public:
+
+    /**
+     * The detectors resize their input to the size of their network, a larger image is useless.
+     * The quality detectors work on a reduced image too, as ImageQualityTask.
+     */
+    static const int           facesSize         = 2000;
+    static const int           autotagsSize      = 2000;
+    static const int           qualitySize       = 1024;
+
+    CollectionAnalyzerSettings settings;
+    QHash<QString, int>        operations;
+
+    MaintenanceData*           data              = nullptr;
+
+    ThumbnailLoadThread*       thumbThread       = nullptr;
+    FaceDetector*              faceDetector      = nullptr;     ///< Created at the first use.
+    AutoTagsAssign*            autotagsEngine    = nullptr;     ///< Created at the first use.
+    ImageQualityParser*        imgqsort          = nullptr;
+    HaarIface                  haarIface;
+
+    /// Time spent by each stage, in ms.
+    qint64                     decodeTime        = 0;
+    qint64                     scaleTime         = 0;
+    QHash<int, qint64>         operationTime;
+};
+
+int CollectionAnalyzerTask::Private::imageSize(int operation)
+{
+    switch (operation)
+    {
+        case CollectionAnalyzerSettings::Thumbnails:
+        {
+            return ThumbnailLoadThread::maximumThumbnailSize();
+        }
+
+        case CollectionAnalyzerSettings::FingerPrints:
+        {
+            return HaarIface::preferredSize();
+        }
+
+        case CollectionAnalyzerSettings::Faces:
+        {
+            return facesSize;
+        }
+
+        case CollectionAnalyzerSettings::AutoTags:
+        {
+            return autotagsSize;
+        }
+
+        default:    // CollectionAnalyzerSettings::ImageQuality
+        {
+            return qualitySize;
+        }
+    }
+}
+
+void CollectionAnalyzerTask::Private::processThumbnail(const ItemInfo& info, const DImg& image)
+{
+    // The preview is rotated following the Exif orientation, the rotation is reverted when stored.
+
+    thumbThread->storeThumbnail(info.filePath(), image);
+}
+
+void CollectionAnalyzerTask::Private::processFingerPrint(const ItemInfo& info, const DImg& image)
+{
+    // compute Haar fingerprint and store it to DB
+
+    haarIface.indexImage(info.id(), image);
+}
+
+void CollectionAnalyzerTask::Private::processFaces(const ItemInfo& info, const DImg& image)
+{
+    if (!faceDetector)
+    {
+        QVariantMap params;
+        params[QLatin1String("accuracy")]    = settings.facesAccuracy;
+        params[QLatin1String("useyolov3")]   = settings.facesYoloV3;
+        params[QLatin1String("specificity")] = 0.8;     // Same as DetectionWorker.
+
+        faceDetector = new FaceDetector;
+        faceDetector->setParameters(params);
+    }
+
+    QList<QRectF> detectedFaces = faceDetector->detectFaces(image);
+
+    qCDebug(DIGIKAM_GENERAL_LOG) << "Found" << detectedFaces.size() << "faces in"
+                                 << info.name() << image.size()
+                                 << image.originalSize();
+
+    // Write the results as the DatabaseWriter of the faces pipeline.
+
+    FaceUtils utils;
+
+    if      (settings.facesHandling == FaceScanSettings::Rescan)
+    {
+        utils.removeFaces(utils.unconfirmedFaceTagsIfaces(info.id()));
+    }
+    else if (settings.facesHandling == FaceScanSettings::ClearAll)
+    {
+        utils.removeAllFaces(info.id());
+    }
+
+    // mark the whole image as scanned-for-faces
+
+    utils.markAsScanned(info);
+
+    if (!detectedFaces.isEmpty())
+    {
+        QList<FaceTagsIface> databaseFaces = utils.writeUnconfirmedResults(info.id(),
+                                                                           detectedFaces,
+                                                                           QList<Identity>(),
+                                                                           image.originalSize());
+
+        utils.storeThumbnails(thumbThread, info.filePath(), databaseFaces, image);
+    }
+}
+
+void CollectionAnalyzerTask::Private::processAutoTags(const ItemInfo& info, const DImg& image)
+{
+    if (!autotagsEngine)
+    {
+        autotagsEngine = new AutoTagsAssign(DetectorModel(settings.autotagsModel));
+    }
+
+    AutotagsAssignmentTask::assignTags(info.filePath(),
+                                       autotagsEngine->generateTagsList(image),
+                                       settings.autotagsLanguages);
+}
+
+void CollectionAnalyzerTask::Private::processQuality(const ItemInfo& info, const DImg& image)
+{
+    PickLabel pick;
+    imgqsort = new ImageQualityParser(image, settings.quality, &pick);
+    imgqsort->startAnalyse();
+
+    ItemInfo item = info;
+    item.setPickLabel(pick);
+
+    MetadataHub hub;
+    hub.load(item);
+
+    ScanController::FileMetadataWrite writeScope(item);
+    writeScope.changed(hub.writeToMetadata(item, MetadataHub::WRITE_PICKLABEL));
+
+    delete imgqsort;
+    imgqsort = nullptr;
+}
+
+// -------------------------------------------------------
+
+CollectionAnalyzerTask::CollectionAnalyzerTask()
+    : ActionJob(),
+      d        (new Private)
+{
+    // Used to store the thumbnails only, no thumbnail is loaded.
+
+    d->thumbThread = new ThumbnailLoadThread;
+    d->thumbThread->setPixmapRequested(false);
+    d->thumbThread->setThumbnailSize(ThumbnailLoadThread::maximumThumbnailSize());
+}
+
+CollectionAnalyzerTask::~CollectionAnalyzerTask()
+{
+    slotCancel();
+    cancel();
+
+    d->thumbThread->stopAllTasks();
+    d->thumbThread->wait();
+
+    delete d->thumbThread;
+    delete d->faceDetector;
+    delete d->autotagsEngine;
+    delete d;
+}
+
+void CollectionAnalyzerTask::setSettings(const CollectionAnalyzerSettings& settings)
+{
+    d->settings = settings;
+}
+
+void CollectionAnalyzerTask::setItemOperations(const QHash<QString, int>& operations)
+{
+    d->operations = operations;
+}
+
+void CollectionAnalyzerTask::setMaintenanceData(MaintenanceData* const data)
+{
+    d->data = data;
+}
+
+void CollectionAnalyzerTask::slotCancel()
+{
+    if (d->imgqsort)
+    {
+        d->imgqsort->cancelAnalyse();
+    }
+}
+
+void CollectionAnalyzerTask::run()
+{
+    QElapsedTimer timer;
+    int           count = 0;
+
+    // While we have data (using this as check for non-null)
+
+    while (d->data)
+    {
+        if (m_cancel)
+        {
+            return;
+        }
+
+        QString path = d->data->getImagePath();
+
+        if (path.isEmpty())
+        {
+            break;
+        }
+
+        ItemInfo info = ItemInfo::fromLocalFile(path);
+        int ops       = d->operations.value(path, CollectionAnalyzerSettings::NoOperation);
+
+        if (info.isNull())
+        {
+            Q_EMIT signalFinished(QImage());
+
+            continue;
+        }
+
+        if (info.category() != DatabaseItem::Image)
+        {
+            // The thumbnails of the other files are built by the thumbnails generator, run after this tool
+            // to scan the missing items.
+
+            if ((ops & CollectionAnalyzerSettings::Thumbnails) && d->settings.rebuildThumbs)
+            {
+                ThumbnailLoadThread::deleteThumbnail(path);
+            }
+
+            Q_EMIT signalFinished(QImage());
+
+            continue;
+        }
+
+        // Drop the analysis not needed anymore for this item, as the dedicated tools.
+
+        if (
+            (ops & CollectionAnalyzerSettings::FingerPrints) &&
+            (
+             !info.isVisible()                                                                     ||
+             (!d->settings.rebuildFingerPrints && !SimilarityDbAccess().db()->hasDirtyOrMissingFingerprint(info))
+            )
+           )
+        {
+            ops &= ~CollectionAnalyzerSettings::FingerPrints;
+        }
+
+        if (
+            (ops & CollectionAnalyzerSettings::Faces)                 &&
+            (d->settings.facesHandling == FaceScanSettings::Skip)     &&
+            FaceUtils().hasBeenScanned(info)
+           )
+        {
+            ops &= ~CollectionAnalyzerSettings::Faces;
+        }
+
+        if (ops == CollectionAnalyzerSettings::NoOperation)
+        {
+            Q_EMIT signalFinished(QImage());
+
+            continue;
+        }
+
+        // The analysis are processed from the largest image needed to the smallest one,
+        // each view being downscaled from the previous one.
+
+        QList<QPair<int, int> > stages;
+
+        for (int op = CollectionAnalyzerSettings::Thumbnails ;
+             op <= CollectionAnalyzerSettings::ImageQuality ; op <<= 1)
+        {
+            if (ops & op)
+            {
+                stages << qMakePair(Private::imageSize(op), op);
+            }
+        }
+
+        std::stable_sort(stages.begin(), stages.end(),
+                         [](const QPair<int, int>& a, const QPair<int, int>& b)
+                         {
+                             return (a.first > b.first);
+                         }
+        );
+
+        // Decode the image once, at the largest size needed.
+
+        timer.start();
+
+        DImg view = PreviewLoadThread::loadFastSynchronously(path, stages.first().first);
+
+        d->decodeTime += timer.elapsed();
+
+        if (view.isNull() || m_cancel)
+        {
+            Q_EMIT signalFinished(QImage());
+
+            continue;
+        }
+
+        if ((ops & CollectionAnalyzerSettings::Thumbnails) && d->settings.rebuildThumbs)
+        {
+            // This removes the faces thumbnails too, it must be done before the faces detection.
+
+            ThumbnailLoadThread::deleteThumbnail(path);
+        }
+
+        for (const QPair<int, int>& stage : qAsConst(stages))
+        {
+            if (m_cancel)
+            {
+                return;
+            }
+
+            if (qMax(view.width(), view.height()) > (uint)stage.first)
+            {
+                timer.restart();
+
+                view = view.smoothScale(stage.first, stage.first, Qt::KeepAspectRatio);
+
+                d->scaleTime += timer.elapsed();
+            }
+
+            timer.restart();
+
+            switch (stage.second)
+            {
+                case CollectionAnalyzerSettings::Thumbnails:
+                {
+                    d->processThumbnail(info, view);
+                    break;
+                }
+
+                case CollectionAnalyzerSettings::FingerPrints:
+                {
+                    d->processFingerPrint(info, view);
+                    break;
+                }
+
+                case CollectionAnalyzerSettings::Faces:
+                {
+                    d->processFaces(info, view);
+                    break;
+                }
+
+                case CollectionAnalyzerSettings::AutoTags:
+                {
+                    d->processAutoTags(info, view);
+                    break;
+                }
+
+                default:    // CollectionAnalyzerSettings::ImageQuality
+                {
+                    d->processQuality(info, view);
+                    break;
+                }
+            }
+
+            d->operationTime[stage.second] += timer.elapsed();
+        }
+
+        ++count;
+
+        // Dispatch progress to Progress Manager
+
+        QImage qimg = view.smoothScale(22, 22, Qt::KeepAspectRatio).copyQImage();
+
+        Q_EMIT signalFinished(qimg);
+    }
+
+    qCDebug(DIGIKAM_GENERAL_LOG) << "Collection analysis of" << count << "images: decoding"
+                                 << d->decodeTime << "ms, downscaling" << d->scaleTime
+                                 << "ms, thumbnails" << d->operationTime.value(CollectionAnalyzerSettings::Thumbnails)
+                                 << "ms, fingerprints" << d->operationTime.value(CollectionAnalyzerSettings::FingerPrints)
+                                 << "ms, faces" << d->operationTime.value(CollectionAnalyzerSettings::Faces)
+                                 << "ms, autotags" << d->operationTime.value(CollectionAnalyzerSettings::AutoTags)
+                                 << "ms, quality" << d->operationTime.value(CollectionAnalyzerSettings::ImageQuality)
+                                 << "ms";
+
+    Q_EMIT signalDone();
+}
+
+} // namespace Digikam
+
+#include "moc_collectionanalyzertask.cpp"
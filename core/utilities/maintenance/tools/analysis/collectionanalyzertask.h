@@ -0,0 +1,73 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-17
+ * Description : Thread actions task for collection analyzer.
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#pragma once
+
+// Qt includes
+
+#include <QHash>
+#include <QImage>
+
+// Local includes
+
+#include "actionthreadbase.h"
+
+namespace Digikam
+{
+
+class CollectionAnalyzerSettings;
+class MaintenanceData;
+
+class CollectionAnalyzerTask : public ActionJob
+{
+    Q_OBJECT
+
+public:
+
+    explicit CollectionAnalyzerTask();
+    ~CollectionAnalyzerTask()   override;
+
+    void setSettings(const CollectionAnalyzerSettings& settings);
+
+    /**
+     * The CollectionAnalyzerSettings::Operation flags to process, by item path.
+     */
+    void setItemOperations(const QHash<QString, int>& operations);
+
+    void setMaintenanceData(MaintenanceData* const data = nullptr);
+
+Q_SIGNALS:
+
+    void signalFinished(const QImage&);
+
+public Q_SLOTS:
+
+    void slotCancel();
+
+protected:
+
+    void run()                  override;
+
+private:
+
+    // Disable
+    CollectionAnalyzerTask(QObject*) = delete;
+
+private:
+
+    class Private;
+    Private* const d = nullptr;
+};
+
+} // namespace Digikam
@@ -14,6 +14,13 @@
 
 #include "autotagsassignmenttask.h"
 
+// Qt includes
+
+#include <QQueue>
+#include <QFuture>
+#include <QElapsedTimer>
+#include <QtConcurrent>    // krazy:exclude=includes
+
 // Local includes
 
 #include "digikam_debug.h"
@@ -36,13 +43,54 @@ public:
 
     Private() = default;
 
+    /**
+     * Take the paths of the next batch from the shared queue.
+     */
+    QStringList nextBatch() const;
+
+    static QList<DImg> loadBatch(const QStringList& paths);
+
+public:
+
     const int loadCount        = 3;
     const int batchSize        = 16;
+    const int prefetchCount    = 2;         ///< Batches decoded ahead of the inference.
     MaintenanceData* data      = nullptr;
     QStringList      langs;
     int              modelType = DetectorModel::YOLOV5NANO;
 };
 
+QStringList AutotagsAssignmentTask::Private::nextBatch() const
+{
+    QStringList paths;
+
+    for (int i = 0 ; i < loadCount ; ++i)
+    {
+        const QString path = data->getImagePath();
+
+        if (path.isEmpty())
+        {
+            break;
+        }
+
+        paths << path;
+    }
+
+    return paths;
+}
+
+QList<DImg> AutotagsAssignmentTask::Private::loadBatch(const QStringList& paths)
+{
+    QList<DImg> images;
+
+    for (const QString& path : paths)
+    {
+        images << PreviewLoadThread::loadFastSynchronously(path, 2000);
+    }
+
+    return images;
+}
+
 // -------------------------------------------------------
 
 AutotagsAssignmentTask::AutotagsAssignmentTask()
@@ -74,6 +122,13 @@ void AutotagsAssignmentTask::setModelType(int modelType)
 }
 
 void AutotagsAssignmentTask::assignTags(const QString& pathImage, const QList<QString>& tagsList)
+{
+    assignTags(pathImage, tagsList, d->langs);
+}
+
+void AutotagsAssignmentTask::assignTags(const QString& pathImage,
+                                        const QList<QString>& tagsList,
+                                        const QStringList& langs)
 {
     bool tagsChanged           = false;
     const QString rootTag      = QLatin1String("auto/");
@@ -96,9 +151,9 @@ void AutotagsAssignmentTask::assignTags(const QString& pathImage, const QList<QS
     {
         int tagId = -1;
 
-        if (!d->langs.isEmpty())
+        if (!langs.isEmpty())
         {
-            Q_FOREACH (const QString& trLang, d->langs)
+            Q_FOREACH (const QString& trLang, langs)
             {
                 QString trOut;
                 QString error;
@@ -146,49 +201,90 @@ void AutotagsAssignmentTask::run()
 {
     // While we have data (using this as check for non-null)
 
-    while (d->data)
+    if (!d->data)
     {
-        if (m_cancel)
-        {
-            return;
-        }
+        Q_EMIT signalDone();
 
-        QList<DImg> inputImages;
+        return;
+    }
 
-        for (int i = 0 ; i < d->loadCount ; ++i)
-        {
-            // cppcheck-suppress knownConditionTrueFalse
-            if (m_cancel)
-            {
-                return;
-            }
+    // The network is read once for all batches of this task.
+
+    QScopedPointer<AutoTagsAssign> autotagsEngine;
 
-            QString path = d->data->getImagePath();
+    // The next batches are decoded in the global thread pool during the inference of the current one.
 
-            if (path.isEmpty())
+    QQueue<QFuture<QList<DImg> > > prefetch;
+
+    auto fillPrefetch = [this, &prefetch]()
+    {
+        while (!m_cancel && (prefetch.size() < d->prefetchCount))
+        {
+            const QStringList paths = d->nextBatch();
+
+            if (paths.isEmpty())
             {
                 break;
             }
 
-            inputImages << PreviewLoadThread::loadFastSynchronously(path, 2000);
+            prefetch.enqueue(QtConcurrent::run(&AutotagsAssignmentTask::Private::loadBatch, paths));
         }
+    };
+
+    qint64 loadTime      = 0;
+    qint64 inferenceTime = 0;
+    qint64 assignTime    = 0;
+    int    count         = 0;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    fillPrefetch();
+
+    while (!prefetch.isEmpty())
+    {
+        if (m_cancel)
+        {
+            return;
+        }
+
+        // Only the time waiting for the decoding is counted, not the overlapped part.
+
+        timer.restart();
+
+        const QList<DImg> inputImages = prefetch.dequeue().result();
+
+        loadTime += timer.elapsed();
+
+        fillPrefetch();
 
         if (inputImages.isEmpty())
         {
-            break;
+            continue;
         }
 
         qCDebug(DIGIKAM_AUTOTAGSENGINE_LOG) << "Current batch size:" << inputImages.size();
 
         // Run Autotags backend here
-        // Assign Tags in database using API from itemInfo
 
-        QElapsedTimer timer;
-        timer.start();
+        timer.restart();
+
+        if (!autotagsEngine)
+        {
+            autotagsEngine.reset(new AutoTagsAssign(DetectorModel(d->modelType)));
+
+            qCDebug(DIGIKAM_AUTOTAGSENGINE_LOG) << "Auto-tags model loaded in" << timer.elapsed() << "ms";
+        }
 
-        QScopedPointer<AutoTagsAssign> autotagsEngine(new AutoTagsAssign(DetectorModel(d->modelType)));
         QList<QList<QString> >tagsLists = autotagsEngine->generateTagsList(inputImages, d->batchSize);
 
+        const qint64 batchInference     = timer.elapsed();
+        inferenceTime                  += batchInference;
+
+        // Assign Tags in database using API from itemInfo
+
+        timer.restart();
+
         if (tagsLists.size() >= inputImages.size())
         {
             for (int j = 0 ; j < inputImages.size() ; ++j)
@@ -204,10 +300,18 @@ void AutotagsAssignmentTask::run()
             Q_EMIT signalFinished(QImage());
         }
 
-        qCDebug(DIGIKAM_AUTOTAGSENGINE_LOG) << "Assgin Tags process takes:"
-                                            << timer.elapsed() << "ms";
+        const qint64 batchAssign = timer.elapsed();
+        assignTime              += batchAssign;
+        count                   += inputImages.size();
+
+        qCDebug(DIGIKAM_AUTOTAGSENGINE_LOG) << "Auto-tags batch: inference" << batchInference
+                                            << "ms, tags assignment" << batchAssign << "ms";
     }
 
+    qCDebug(DIGIKAM_AUTOTAGSENGINE_LOG) << "Auto-tags of" << count << "images: waiting for decoding"
+                                        << loadTime << "ms, inference" << inferenceTime
+                                        << "ms, tags assignment" << assignTime << "ms";
+
     Q_EMIT signalDone();
 }
 
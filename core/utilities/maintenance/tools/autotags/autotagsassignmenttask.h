@@ -37,6 +37,13 @@ public:
     ~AutotagsAssignmentTask()     override;
 
     void assignTags(const QString& pathImage, const QList<QString>& tagsList);
+
+    /**
+     * Replace the auto-tags of the item by the tags found, translated in the languages.
+     */
+    static void assignTags(const QString& pathImage,
+                           const QList<QString>& tagsList,
+                           const QStringList& langs);
     void setMaintenanceData(MaintenanceData* const data = nullptr);
     void setLanguages(const QStringList& langs);
     void setModelType(int modelType);
@@ -24,6 +24,8 @@
 #include "iteminfo.h"
 #include "thumbsdb.h"
 #include "thumbsdbaccess.h"
+#include "thumbsdbcodec.h"
+#include "thumbnailloadthread.h"
 #include "coredb.h"
 #include "coredbaccess.h"
 #include "facialrecognition_wrapper.h"
@@ -136,6 +138,8 @@ void DatabaseTask::run()
 
         if (ThumbsDbAccess::isInitialized())
         {
+            ThumbnailLoadThread::writePendingThumbnails();
+
             if (ThumbsDbAccess().db()->integrityCheck())
             {
                 ThumbsDbAccess().db()->vacuum();
@@ -297,6 +301,10 @@ void DatabaseTask::run()
 
         if (d->scanThumbsDb && ThumbsDbAccess::isInitialized())
         {
+            // The thumbnails still queued are not stale, they must be listed.
+
+            ThumbnailLoadThread::writePendingThumbnails();
+
             // Thumbnails should be deleted, if the following conditions hold:
             // 1) The file path to which the thumb is assigned does not lead to an item
             // 2) The unique hash and file size are not used in core db for an item.
@@ -541,6 +549,85 @@ void DatabaseTask::run()
                                             << " due to error ";
         }
     }
+    else if (d->mode == Mode::ConvertThumbsDb)
+    {
+        // The thumbnails are transcoded outside of the database lock,
+        // and written by batches with one transaction each. A thumbnail
+        // regenerated meanwhile is not overwritten by its old image.
+
+        const DatabaseThumbnail::Type type = ThumbsDbCodec::storageType();
+        const int batchSize                = 32;
+        QList<QPair<ThumbsDbInfo, QByteArray> > batch;
+
+        while (d->data)
+        {
+            if (m_cancel)
+            {
+                return;
+            }
+
+            int thumbId = d->data->getThumbnailId();
+
+            if (thumbId != -1)
+            {
+                ThumbsDbInfo info = ThumbsDbAccess().db()->findById(thumbId);
+                QImage     image;
+                QByteArray data;
+
+                if (
+                    (info.type != type)                                &&
+                    ThumbsDbCodec::decode(info.data, info.type, image) &&
+                    ThumbsDbCodec::encode(image, type, data)
+                   )
+                {
+                    info.data.clear();
+                    batch << qMakePair(info, data);
+                }
+                else if (info.type != type)
+                {
+                    qCWarning(DIGIKAM_THUMBSDB_LOG) << "Could not convert the thumbnail" << thumbId;
+                }
+
+                Q_EMIT signalFinished();
+            }
+
+            if ((batch.size() >= batchSize) || ((thumbId == -1) && !batch.isEmpty()))
+            {
+                ThumbsDbAccess access;
+                BdEngineBackend::QueryState lastQueryState = access.backend()->beginTransaction();
+
+                for (const auto& converted : qAsConst(batch))
+                {
+                    if (BdEngineBackend::NoErrors == lastQueryState)
+                    {
+                        lastQueryState = access.db()->updateData(converted.first, type, converted.second);
+                    }
+                }
+
+                if (BdEngineBackend::NoErrors == lastQueryState)
+                {
+                    lastQueryState = access.backend()->commitTransaction();
+                }
+                else
+                {
+                    access.backend()->rollbackTransaction();
+                }
+
+                if (BdEngineBackend::NoErrors != lastQueryState)
+                {
+                    qCWarning(DIGIKAM_THUMBSDB_LOG) << "Could not write a batch of" << batch.size()
+                                                    << "converted thumbnails";
+                }
+
+                batch.clear();
+            }
+
+            if (thumbId == -1)
+            {
+                break;
+            }
+        }
+    }
     else if (d->mode == Mode::CleanRecognitionDb)
     {
         // While we have data (using this as check for non-null)
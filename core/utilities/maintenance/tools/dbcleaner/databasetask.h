@@ -43,7 +43,8 @@ public:
         CleanThumbsDb,
         CleanRecognitionDb,
         CleanSimilarityDb,
-        ShrinkDatabases
+        ShrinkDatabases,
+        ConvertThumbsDb
     };
 
 public:
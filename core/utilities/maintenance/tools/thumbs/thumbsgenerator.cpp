@@ -30,6 +30,7 @@
 
 // Local includes
 
+#include "digikam_debug.h"
 #include "coredb.h"
 #include "coredbalbuminfo.h"
 #include "albummanager.h"
@@ -38,6 +39,8 @@
 #include "iteminfo.h"
 #include "thumbsdbaccess.h"
 #include "thumbsdb.h"
+#include "thumbsdbcodec.h"
+#include "thumbnailloadthread.h"
 #include "maintenancethread.h"
 #include "digikam_config.h"
 
@@ -50,13 +53,15 @@ public:
 
     Private() = default;
 
-    bool               rebuildAll = true;
+    bool                    rebuildAll      = true;
+    bool                    convertExisting = false;
+    DatabaseThumbnail::Type storageType     = DatabaseThumbnail::UndefinedType;
 
-    AlbumList          albumList;
+    AlbumList               albumList;
 
-    QStringList        allPicturesPath;
+    QStringList             allPicturesPath;
 
-    MaintenanceThread* thread     = nullptr;
+    MaintenanceThread*      thread          = nullptr;
 };
 
 ThumbsGenerator::ThumbsGenerator(const bool rebuildAll,
@@ -103,6 +108,12 @@ void ThumbsGenerator::setUseMultiCoreCPU(bool b)
     d->thread->setUseMultiCore(b);
 }
 
+void ThumbsGenerator::setStorageType(DatabaseThumbnail::Type type, bool convertExisting)
+{
+    d->storageType     = type;
+    d->convertExisting = convertExisting;
+}
+
 void ThumbsGenerator::slotCancel()
 {
     d->thread->cancel();
@@ -117,6 +128,72 @@ void ThumbsGenerator::slotStart()
 
     ProgressManager::addProgressItem(this);
 
+    // The thumbnails still queued are listed too.
+
+    ThumbnailLoadThread::writePendingThumbnails();
+
+    if ((d->storageType != DatabaseThumbnail::UndefinedType) && ThumbsDbAccess::isInitialized())
+    {
+        ThumbsDbCodec::setStorageType(d->storageType);
+
+        if (d->convertExisting)
+        {
+            // The existing thumbnails are converted before the new ones are written,
+            // to never overwrite a new thumbnail with an old converted one.
+
+            const QList<int> thumbIds = ThumbsDbAccess().db()->findAllNotOfType(ThumbsDbCodec::storageType());
+
+            if (!thumbIds.isEmpty())
+            {
+                qCDebug(DIGIKAM_GENERAL_LOG) << "Converting" << thumbIds.count() << "thumbnails to"
+                                             << ThumbsDbCodec::typeName(ThumbsDbCodec::storageType());
+
+                disconnect(d->thread, SIGNAL(signalCompleted()),
+                           this, SLOT(slotDone()));
+
+                connect(d->thread, SIGNAL(signalCompleted()),
+                        this, SLOT(slotConversionDone()));
+
+                connect(d->thread, SIGNAL(signalAdvance()),
+                        this, SLOT(slotAdvanceConversion()));
+
+                setLabel(i18n("Thumbs conversion"));
+                setTotalItems(thumbIds.count());
+
+                d->thread->convertThumbsDb(thumbIds);
+                d->thread->start();
+
+                return;
+            }
+        }
+    }
+
+    generateThumbs();
+}
+
+void ThumbsGenerator::slotConversionDone()
+{
+    disconnect(d->thread, SIGNAL(signalCompleted()),
+               this, SLOT(slotConversionDone()));
+
+    disconnect(d->thread, SIGNAL(signalAdvance()),
+               this, SLOT(slotAdvanceConversion()));
+
+    connect(d->thread, SIGNAL(signalCompleted()),
+            this, SLOT(slotDone()));
+
+    if (canceled())
+    {
+        return;
+    }
+
+    setLabel(i18n("Thumbs"));
+
+    generateThumbs();
+}
+
+void ThumbsGenerator::generateThumbs()
+{
     QApplication::setOverrideCursor(Qt::WaitCursor);
 
     if (d->albumList.isEmpty())
@@ -201,7 +278,7 @@ void ThumbsGenerator::slotStart()
         return;
     }
 
-    setTotalItems(d->allPicturesPath.count());
+    incTotalItems(d->allPicturesPath.count());
 
     d->thread->generateThumbs(d->allPicturesPath);
     d->thread->start();
@@ -213,6 +290,11 @@ void ThumbsGenerator::slotAdvance(const QImage& img)
     advance(1);
 }
 
+void ThumbsGenerator::slotAdvanceConversion()
+{
+    advance(1);
+}
+
 } // namespace Digikam
 
 #include "moc_thumbsgenerator.cpp"
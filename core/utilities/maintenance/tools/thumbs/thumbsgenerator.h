@@ -23,6 +23,7 @@
 
 #include "album.h"
 #include "maintenancetool.h"
+#include "thumbsdb.h"
 
 namespace Digikam
 {
@@ -46,15 +47,24 @@ public:
 
     void setUseMultiCoreCPU(bool b) override;
 
+    /**
+     * Store the new thumbnails in the database with this format. If convertExisting is true,
+     * the thumbnails already in the database are transcoded first, for the whole collection.
+     */
+    void setStorageType(DatabaseThumbnail::Type type, bool convertExisting);
+
 private:
 
     void init(const bool rebuildAll);
+    void generateThumbs();
 
 private Q_SLOTS:
 
     void slotStart()                override;
     void slotCancel()               override;
     void slotAdvance(const QImage&);
+    void slotAdvanceConversion();
+    void slotConversionDone();
 
 private:
 
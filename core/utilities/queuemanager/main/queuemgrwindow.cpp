@@ -1029,6 +1029,12 @@ void QueueMgrWindow::slotQueueProcessed()
         return;
     }
 
+    DImgBufferPool::Statistics stats = DImgBufferPool::instance()->statistics();
+
+    qCDebug(DIGIKAM_GENERAL_LOG) << "DImg buffer pool: reuse rate" << stats.reuseRate()
+                                 << "of" << stats.requests << "requests, peak"
+                                 << stats.peakBytes / 1024 / 1024 << "MB, evictions" << stats.evictions;
+
     DNotificationWrapper(QLatin1String("batchqueuecompleted"), msg, this,
                          windowTitle());
     processingAborted();
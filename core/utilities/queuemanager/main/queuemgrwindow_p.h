@@ -81,6 +81,7 @@
 #include "digikamapp.h"
 #include "thememanager.h"
 #include "dimg.h"
+#include "dimgbufferpool.h"
 #include "dlogoaction.h"
 #include "albummanager.h"
 #include "imagewindow.h"